@@ -36,6 +36,7 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include <Wire.h>
+#include <vector>
 #include "app_hal.h"
 
 #include "feedback.h"
@@ -45,6 +46,16 @@
 
 #include "ui/custom_face.h"
 #include "common/api.h"
+#include "common/loop_scheduler/loop_scheduler.h"
+#include "common/event_queue/event_queue.h"
+#include "common/clock_tick/clock_tick.h"
+#include "common/ui_thread/ui_thread.h"
+#include "common/app_manager.h"
+#include "common/heap_tags/heap_tags.h"
+#include "common/sensor_service/sensor_service.h"
+#include "common/activity/activity.h"
+#include "common/wrist_wake/wrist_wake.h"
+#include "common/latency/latency.h"
 
 #include "main.h"
 #include "displays/pins.h"
@@ -74,6 +85,10 @@ Encoder myEnc(ENCODER_A, ENCODER_B);
 #ifdef ENABLE_APP_QMI8658C
 #include "FastIMU.h"
 #define QMI_ADDRESS 0x6B
+// QMI8658C registers, the ODR is the low nibble of CTRL2 (accel) and CTRL3 (gyro)
+#define QMI_CTRL2 0x03
+#define QMI_CTRL3 0x04
+#define QMI_CTRL7 0x08 // bit 0 accel enable, bit 1 gyro enable, both clear is standby
 #endif
 
 #ifdef ENABLE_RTC
@@ -85,6 +100,26 @@ RtcPCF8563<TwoWire> Rtc(Wire);
 #define F_NAME "FATFS"
 
 
+// The IMU (sensor task), touch (UI loop), RTC (BLE task) and IO extender (feedback
+// tasks) share one I2C bus, a transfer holds this for its duration
+static SemaphoreHandle_t i2cMutex = NULL;
+
+static void i2cLock()
+{
+  if (i2cMutex != NULL)
+  {
+    xSemaphoreTake(i2cMutex, portMAX_DELAY);
+  }
+}
+
+static void i2cUnlock()
+{
+  if (i2cMutex != NULL)
+  {
+    xSemaphoreGive(i2cMutex);
+  }
+}
+
 ChronosESP32 watch("Chronos C3");
 Preferences prefs;
 
@@ -101,15 +136,17 @@ static const uint32_t screenHeight = SCREEN_HEIGHT;
 const unsigned int lvBufferSize = screenWidth * buf_size;
 uint8_t lvBuffer[2][lvBufferSize];
 
-bool weatherUpdate = true, notificationsUpdate = true, weatherUpdateFace = true;
+// set by the UI loop when the matching event arrives, consumed when the screen is opened
+bool notificationsUpdate = true;
+
+// BLE callbacks -> hal_loop
+event_queue_t uiEvents;
 
 ChronosTimer screenTimer;
 ChronosTimer alertTimer;
 ChronosTimer searchTimer;
 
 Navigation nav;
-bool navChanged = false;
-bool navIcChanged = false;
 uint32_t navIcCRC = 0xFFFFFFFF;
 
 lv_obj_t *lastActScr;
@@ -118,11 +155,9 @@ lv_obj_t *lastActScr;
 bool alertSwitch = false;
 bool gameActive = false;
 bool readIMU = false;
-bool updateSeconds = false;
 bool hasUpdatedSec = false;
 bool navSwitch = false;
 
-static long oldPosition = 0;
 
 String customFacePaths[15];
 int customFaceIndex;
@@ -143,6 +178,9 @@ int lastCustom;
 #endif
 
 TaskHandle_t gameHandle = NULL;
+TaskHandle_t loopHandle = NULL;
+
+#define ENCODER_POLL_MS 10
 
 void showAlert();
 bool isDay();
@@ -251,7 +289,9 @@ void my_touchpad_read(lv_indev_t *indev_driver, lv_indev_data_t *data)
   //   touched = tft.getTouch(&touchX, &touchY);
   // }
 
+  i2cLock();
   touched = tft.getTouch(&touchX, &touchY);
+  i2cUnlock();
 
   if (!touched)
   {
@@ -307,7 +347,7 @@ void init_IO_extender()
 
 void set_pin_io(uint8_t pin_number, bool value)
 {
-
+  i2cLock();
   Wire.beginTransmission(PI4IO_I2C_ADDR);
   Wire.write(0x05); // test register
   Wire.endTransmission();
@@ -324,6 +364,7 @@ void set_pin_io(uint8_t pin_number, bool value)
   else
     Wire.write((1 << pin_number) | rxdata); // set pin high
   Wire.endTransmission();
+  i2cUnlock();
 
   // Wire.beginTransmission(PI4IO_I2C_ADDR);
   // Wire.write(0x05); // test register
@@ -377,6 +418,17 @@ bool wasError(const char *errorTopic = "")
 }
 #endif
 
+// fragmentation figures of the app info screen
+static size_t heapFree()
+{
+  return ESP.getFreeHeap();
+}
+
+static size_t heapLargestFree()
+{
+  return ESP.getMaxAllocHeap();
+}
+
 String heapUsage()
 {
   String usage;
@@ -633,42 +685,62 @@ bool setupFS()
   return true;
 }
 
-void listDir(const char *dirname, uint8_t levels)
+struct FileEntry
 {
+  String name;
+  int size;
+  bool isDir;
+};
 
-  lv_obj_clean(ui_fileManagerPanel);
+// entries of the listed directory, the file list only creates rows for the visible ones
+std::vector<FileEntry> dirEntries;
 
-  addListBack(driveList_cb);
+void bindDirEntry(lv_obj_t *row, int32_t index)
+{
+  if (index == 0)
+  {
+    bindListBack(row, driveList_cb);
+    return;
+  }
+  FileEntry &entry = dirEntries[index - 1];
+  if (entry.isDir)
+  {
+    bindListDir(row, entry.name.c_str());
+  }
+  else
+  {
+    bindListFile(row, entry.name.c_str(), entry.size);
+  }
+}
+
+void listDir(const char *dirname, uint8_t levels)
+{
+  dirEntries.clear();
 
   File root = FLASH.open(dirname);
   if (!root)
   {
     Serial.println("- failed to open directory");
-    return;
   }
-  if (!root.isDirectory())
+  else if (!root.isDirectory())
   {
     Serial.println(" - not a directory");
-    return;
   }
-
-  File file = root.openNextFile();
-  while (file)
+  else
   {
-    if (file.isDirectory())
+    File file = root.openNextFile();
+    while (file)
     {
-      addListDir(file.name());
+      dirEntries.push_back({file.name(), (int)file.size(), file.isDirectory()});
       // if (levels)
       // {
       //   listDir(file.path(), levels - 1);
       // }
+      file = root.openNextFile();
     }
-    else
-    {
-      addListFile(file.name(), file.size());
-    }
-    file = root.openNextFile();
   }
+
+  setFileList(dirEntries.size() + 1, bindDirEntry);
 }
 
 void flashDrive_cb(lv_event_t *e)
@@ -828,7 +900,7 @@ void onCustomDelete(lv_event_t *e)
   showError("Delete", "The watchface will be deleted from storage, ESP32 will restart after deletion");
   if (deleteCustomFace(customFacePaths[index]))
   {
-    lv_screen_load_anim(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0, false);
+    ui_transition_load(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
     ESP.restart();
   }
   else
@@ -939,75 +1011,97 @@ void simonTone(int type, int pitch)
   }
 }
 
+// wake the main loop early when BLE callbacks have raised a flag
+void wake_loop()
+{
+  loop_sched_wake();
+  if (loopHandle != NULL)
+  {
+    xTaskNotifyGive(loopHandle);
+  }
+}
+
 void connectionCallback(bool state)
 {
   Timber.d(state ? "Connected" : "Disconnected");
-  if (state)
+  event_queue_post(&uiEvents, EVENT_CONNECTION, state, 0);
+}
+
+// UI loop, caller is a copy made by ringerCallback (NULL once the call ended)
+void onRinger(void *arg)
+{
+  char *caller = (char *)arg;
+  lv_obj_t *actScr = lv_display_get_screen_active(lv_display_get_default());
+
+  if (caller != NULL)
   {
-    lv_obj_remove_state(ui_btStateButton, LV_STATE_CHECKED);
+    screenTimer.time = millis() + 50;
+    lastActScr = actScr;
+    ui_screen_get(&ui_callScreen);
+    lv_label_set_text(ui_callName, caller);
+    ui_transition_load(ui_callScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
+    free(caller);
   }
-  else
+  else if (actScr == ui_callScreen && lastActScr != nullptr)
   {
-    lv_obj_add_state(ui_btStateButton, LV_STATE_CHECKED);
+    // load last active screen
+    ui_transition_load(lastActScr, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
   }
-  lv_label_set_text_fmt(ui_appConnectionText, "Status\n%s", state ? "Connected" : "Disconnected");
+  screenTimer.active = true;
 }
 
 void ringerCallback(String caller, bool state)
 {
-  lv_disp_t *display = lv_display_get_default();
-  lv_obj_t *actScr = lv_display_get_screen_active(display);
-
+  wake_loop();
   if (state)
   {
     feedbackRun(T_CALLS);
-    screenTimer.time = millis() + 50;
-
-    lastActScr = actScr;
     Serial.print("Ringer: Incoming call from ");
     Serial.println(caller);
-    lv_label_set_text(ui_callName, caller.c_str());
-    lv_screen_load_anim(ui_callScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+    // the name has to outlive the callback, the closure keeps the start and the end in order
+    char *name = strdup(caller.c_str());
+    if (name != NULL && !ui_post(onRinger, name))
+    {
+      free(name);
+    }
   }
   else
   {
     feedbackTone(tone_off, 1, T_USER, true);
     Serial.println("Ringer dismissed");
-    // load last active screen
-    if (actScr == ui_callScreen && lastActScr != nullptr)
-    {
-      lv_screen_load_anim(lastActScr, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0, false);
-    }
+    ui_post(onRinger, NULL);
   }
-  screenTimer.active = true;
 }
 
 void notificationCallback(Notification notification)
 {
   Timber.d("Notification Received from " + notification.app + " at " + notification.time);
   Timber.d(notification.message);
-  notificationsUpdate = true;
+  event_queue_post(&uiEvents, EVENT_NOTIFICATIONS, 0, 0);
   // onNotificationsOpen(click);
   feedbackRun(T_NOTIFICATION);
-  showAlert();
+  event_queue_post(&uiEvents, EVENT_ALERT, 0, 0);
 }
 
 void configCallback(Config config, uint32_t a, uint32_t b)
 {
+  wake_loop();
   switch (config)
   {
   case CF_TIME:
     // time has been synced from BLE
 #ifdef ENABLE_RTC
     // set the RTC time
+    i2cLock();
     Rtc.SetDateTime(RtcDateTime(watch.getYear(), watch.getMonth() + 1, watch.getDay(), watch.getHour(true), watch.getMinute(), watch.getSecond()));
+    i2cUnlock();
 
 #endif
     // ui_update_seconds(watch.getSecond());
     if (!hasUpdatedSec)
     {
       hasUpdatedSec = true;
-      updateSeconds = true;
+      event_queue_post(&uiEvents, EVENT_TIME_SYNC, 0, 0);
     }
 
     break;
@@ -1027,59 +1121,21 @@ void configCallback(Config config, uint32_t a, uint32_t b)
 
     if (a)
     {
-      weatherUpdateFace = true;
+      event_queue_post(&uiEvents, EVENT_WEATHER, 0, 0);
     }
     if (a == 2)
     {
-      weatherUpdate = true;
+      event_queue_post(&uiEvents, EVENT_FORECAST, 0, 0);
     }
 
     break;
   case CF_FONT:
-    screenTimer.time = millis();
-    screenTimer.active = true;
-    if (((b >> 16) & 0xFFFF) == 0x01)
-    { // Style 1
-      if ((b & 0xFFFF) == 0x01)
-      { // TOP
-        lv_obj_set_style_text_color(ui_hourLabel, lv_color_hex(a), LV_PART_MAIN | LV_STATE_DEFAULT);
-      }
-      if ((b & 0xFFFF) == 0x02)
-      { // CENTER
-        lv_obj_set_style_text_color(ui_minuteLabel, lv_color_hex(a), LV_PART_MAIN | LV_STATE_DEFAULT);
-      }
-      if ((b & 0xFFFF) == 0x03)
-      { // BOTTOM
-        lv_obj_set_style_text_color(ui_dayLabel, lv_color_hex(a), LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_text_color(ui_dateLabel, lv_color_hex(a), LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_text_color(ui_weatherTemp, lv_color_hex(a), LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_obj_set_style_text_color(ui_amPmLabel, lv_color_hex(a), LV_PART_MAIN | LV_STATE_DEFAULT);
-      }
-    }
-
+    // one event per position, queued so none of them is lost
+    event_queue_push(&uiEvents, EVENT_FONT_COLOR, a, b);
     break;
   case CF_CAMERA:
-  {
-    lv_disp_t *display = lv_display_get_default();
-    lv_obj_t *actScr = lv_display_get_screen_active(display);
-
-    if (b)
-    {
-      screenTimer.time = millis() + 50;
-      lastActScr = actScr;
-      lv_screen_load_anim(ui_cameraScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
-      screenTimer.active = true;
-    }
-    else
-    {
-      if (actScr == ui_cameraScreen && lastActScr != nullptr)
-      {
-        lv_screen_load_anim(lastActScr, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0, false);
-      }
-      screenTimer.active = true;
-    }
-  }
-  break;
+    event_queue_push(&uiEvents, EVENT_CAMERA, b, 0);
+    break;
 
   case CF_APP:
     // state is saved internally
@@ -1087,21 +1143,21 @@ void configCallback(Config config, uint32_t a, uint32_t b)
     Serial.print(a); // int code = watch.getAppCode();
     Serial.print(" Version: ");
     Serial.println(watch.getAppVersion());
-    lv_label_set_text_fmt(ui_appDetailsText, "Chronos app\nv%s (%d)", watch.getAppVersion().c_str(), a);
+    event_queue_push(&uiEvents, EVENT_APP_INFO, a, 0);
     break;
   case CF_QR:
     if (a == 1)
     {
-      updateQrLinks();
+      event_queue_push(&uiEvents, EVENT_QR_LINKS, 0, 0);
     }
     break;
   case CF_NAV_DATA:
-    navChanged = true;
+    event_queue_post(&uiEvents, EVENT_NAV_DATA, 0, 0);
     break;
   case CF_NAV_ICON:
     if (a == 2)
     {
-      navIcChanged = true;
+      event_queue_post(&uiEvents, EVENT_NAV_ICON, b, 0);
       Timber.w("Navigation icon received. CRC 0x%04X", b);
     }
     break;
@@ -1113,31 +1169,87 @@ void configCallback(Config config, uint32_t a, uint32_t b)
       Serial.print(uint8_t(b >> 8));
       Serial.print("\tSize: ");
       Serial.println(uint8_t(b));
-      setNoContacts();
     }
     if (a == 1)
     {
       Serial.println("Received all contacts");
-      int n = uint8_t(b);      // contacts size -> watch.getContactCount();
-      int s = uint8_t(b >> 8); // sos contact index -> watch.getSOSContactIndex();
-
-      clearContactList();
-
-      for (int i = 0; i < n; i++)
-      {
-        Contact cn = watch.getContact(i);
-        Serial.print("Name: ");
-        Serial.print(cn.name);
-        Serial.print(s == i ? " [SOS]" : "");
-        Serial.print("\tNumber: ");
-        Serial.println(cn.number);
-        addContact(cn.name.c_str(), cn.number.c_str(), s == i);
-      }
+    }
+    if (a <= 1)
+    {
+      event_queue_push(&uiEvents, EVENT_CONTACTS, a, b);
     }
     break;
   }
 }
 
+// UI loop, face text colors from the app
+void setFontColor(uint32_t color, uint32_t target)
+{
+  screenTimer.time = millis();
+  screenTimer.active = true;
+  if (((target >> 16) & 0xFFFF) == 0x01)
+  { // Style 1
+    if ((target & 0xFFFF) == 0x01)
+    { // TOP
+      lv_obj_set_style_text_color(ui_hourLabel, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+    if ((target & 0xFFFF) == 0x02)
+    { // CENTER
+      lv_obj_set_style_text_color(ui_minuteLabel, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+    if ((target & 0xFFFF) == 0x03)
+    { // BOTTOM
+      lv_obj_set_style_text_color(ui_dayLabel, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_set_style_text_color(ui_dateLabel, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_set_style_text_color(ui_weatherTemp, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_set_style_text_color(ui_amPmLabel, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+  }
+}
+
+// UI loop, camera remote opened (state) or closed from the app
+void setCameraState(bool state)
+{
+  lv_obj_t *actScr = lv_display_get_screen_active(lv_display_get_default());
+
+  if (state)
+  {
+    screenTimer.time = millis() + 50;
+    lastActScr = actScr;
+    ui_screen_load(&ui_cameraScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
+  }
+  else if (actScr == ui_cameraScreen && lastActScr != nullptr)
+  {
+    ui_transition_load(lastActScr, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
+  }
+  screenTimer.active = true;
+}
+
+// UI loop, info = SOS index << 8 | count
+void updateContacts(bool received, uint32_t info)
+{
+  if (!received)
+  {
+    setNoContacts();
+    return;
+  }
+  int n = uint8_t(info);      // contacts size -> watch.getContactCount();
+  int s = uint8_t(info >> 8); // sos contact index -> watch.getSOSContactIndex();
+
+  clearContactList();
+
+  for (int i = 0; i < n; i++)
+  {
+    Contact cn = watch.getContact(i);
+    Serial.print("Name: ");
+    Serial.print(cn.name);
+    Serial.print(s == i ? " [SOS]" : "");
+    Serial.print("\tNumber: ");
+    Serial.println(cn.number);
+    addContact(cn.name.c_str(), cn.number.c_str(), s == i);
+  }
+}
+
 void onMessageClick(lv_event_t *e)
 {
 
@@ -1213,6 +1325,12 @@ int getPrefInt(const char *key, int def_value)
   return prefs.getInt(key, def_value);
 }
 
+void bindNotification(lv_obj_t *row, int32_t index)
+{
+  Notification notification = watch.getNotificationAt(index);
+  bindNotificationList(row, notification.icon, notification.message.c_str(), index);
+}
+
 void onNotificationsOpen(lv_event_t *e)
 {
   if (!notificationsUpdate)
@@ -1221,31 +1339,20 @@ void onNotificationsOpen(lv_event_t *e)
   }
   notificationsUpdate = false;
 
-  lv_obj_clean(ui_messageList);
-  int c = watch.getNotificationCount();
-  for (int i = 0; i < c; i++)
-  {
-    addNotificationList(watch.getNotificationAt(i).icon, watch.getNotificationAt(i).message.c_str(), i);
-  }
-  // addNotificationList(watch.getNotificationAt(0).icon, watch.getNotificationAt(0).message.c_str(), i);
+  setNotificationList(watch.getNotificationCount(), bindNotification);
 
   lv_obj_scroll_to_y(ui_messageList, 1, LV_ANIM_ON);
   lv_obj_remove_flag(ui_messageList, LV_OBJ_FLAG_HIDDEN);
   lv_obj_add_flag(ui_messagePanel, LV_OBJ_FLAG_HIDDEN);
 }
 
+// the weather screen is created on every visit, fill it each time
 void onWeatherLoad(lv_event_t *e)
 {
   lv_obj_remove_flag(ui_weatherPanel, LV_OBJ_FLAG_HIDDEN);
   lv_obj_add_flag(ui_forecastList, LV_OBJ_FLAG_HIDDEN);
   lv_obj_add_flag(ui_hourlyList, LV_OBJ_FLAG_HIDDEN);
 
-  if (!weatherUpdate)
-  {
-    return;
-  }
-  weatherUpdate = false;
-
   if (watch.getWeatherCount() > 0)
   {
     String updateTime = "Updated at\n" + watch.getWeatherTime();
@@ -1274,6 +1381,10 @@ void onWeatherLoad(lv_event_t *e)
   }
 }
 
+void onFilesLoad(lv_event_t *e)
+{
+}
+
 void onLoadHome(lv_event_t *e)
 {
   // if (isDay())
@@ -1328,7 +1439,7 @@ void onCustomFaceSelected(int pathIndex)
     ui_home = face_custom_root;
   }
 
-  lv_screen_load_anim(ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, false);
+  ui_transition_load(ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
 
   prefs.putString("custom", customFacePaths[pathIndex]);
 #endif
@@ -1355,8 +1466,8 @@ void onClickAlert(lv_event_t *e)
 
   // cancel alert timer
   alertTimer.active = false;
-  // change screen to notifications
-  lv_screen_load(ui_notificationScreen);
+  // change screen to notifications, ends a running transition first
+  ui_transition_load(ui_notificationScreen, LV_SCR_LOAD_ANIM_NONE, 0, 0);
 
   // enable screen for timeout + 5 seconds
   screenTimer.time = millis() + 5000;
@@ -1447,13 +1558,11 @@ void onVolumeDown(lv_event_t *e)
 
 void updateQrLinks()
 {
-#if LV_USE_QRCODE == 1
-  lv_obj_clean(ui_qrPanel);
   for (int i = 0; i < 9; i++)
   {
-    addQrList(i, watch.getQrAt(i).c_str());
+    ui_set_qr_link(i, watch.getQrAt(i).c_str());
   }
-#endif
+  ui_update_qr_links();
 }
 
 void onRTWState(bool state)
@@ -1464,8 +1573,11 @@ void gameLoop(void *pvParameters)
 {
   for (;;)
   {
-    ui_games_update();
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    // LVGL is not thread safe, the UI loop holds the lock except while it sleeps
+    ui_lock();
+    uint32_t next = ui_games_update();
+    ui_unlock();
+    vTaskDelay(next / portTICK_PERIOD_MS > 0 ? next / portTICK_PERIOD_MS : 1);
   }
 }
 
@@ -1625,14 +1737,50 @@ void dataCallback(uint8_t *data, int length)
   // Serial.println();
 }
 
+#ifdef ENABLE_APP_QMI8658C
+static bool imuReady = false;
+
+static uint8_t qmiRead(uint8_t reg)
+{
+  Wire.beginTransmission(QMI_ADDRESS);
+  Wire.write(reg);
+  Wire.endTransmission(false);
+  Wire.requestFrom(QMI_ADDRESS, 1);
+  return Wire.available() ? Wire.read() : 0;
+}
+
+static void qmiWrite(uint8_t reg, uint8_t value)
+{
+  Wire.beginTransmission(QMI_ADDRESS);
+  Wire.write(reg);
+  Wire.write(value);
+  Wire.endTransmission();
+}
+
+// 6DOF ODR code of the slowest rate at or above hz, from the QMI8658C datasheet
+static uint8_t qmiOdrCode(uint16_t hz)
+{
+  static const uint16_t rates[] = {28, 56, 112, 224, 448, 897};
+  uint8_t code = 0x08; // 28 Hz
+  for (int i = 0; i < 5 && hz > rates[i]; i++)
+  {
+    code--;
+  }
+  return code;
+}
+#endif
+
 void imu_init()
 {
 #ifdef ENABLE_APP_QMI8658C
+  i2cLock();
   int err = qmi8658c.init(calib, QMI_ADDRESS);
+  i2cUnlock();
   if (err != 0)
   {
     showError("IMU State", "Failed to init");
   }
+  imuReady = err == 0;
 #endif
 }
 
@@ -1641,6 +1789,7 @@ imu_data_t get_imu_data()
   imu_data_t qmi;
 #ifdef ENABLE_APP_QMI8658C
 
+  i2cLock();
   qmi8658c.update();
   qmi8658c.getAccel(&acc);
   qmi8658c.getGyro(&gyro);
@@ -1652,6 +1801,7 @@ imu_data_t get_imu_data()
   qmi.gy = gyro.gyroY;
   qmi.gz = gyro.gyroZ;
   qmi.temp = qmi8658c.getTemp();
+  i2cUnlock();
   qmi.success = true;
 #else
   qmi.success = false;
@@ -1666,6 +1816,88 @@ void imu_close()
 #endif
 }
 
+#ifdef ENABLE_APP_QMI8658C
+// FastIMU does not expose the QMI8658 FIFO, so the sensor task reads one sample per ODR
+// period. FastIMU sets the ranges at init, the rate and the enables are set here.
+static bool imuStart(uint16_t odr)
+{
+  if (!imuReady)
+  {
+    return false;
+  }
+  uint8_t code = qmiOdrCode(odr);
+  i2cLock();
+  qmiWrite(QMI_CTRL2, (qmiRead(QMI_CTRL2) & 0xF0) | code);
+  qmiWrite(QMI_CTRL3, (qmiRead(QMI_CTRL3) & 0xF0) | code);
+  qmiWrite(QMI_CTRL7, qmiRead(QMI_CTRL7) | 0x03);
+  i2cUnlock();
+  return true;
+}
+
+// accel and gyro off until the next stream opens
+static void imuStop()
+{
+  i2cLock();
+  qmiWrite(QMI_CTRL7, qmiRead(QMI_CTRL7) & ~0x03);
+  i2cUnlock();
+}
+
+static uint16_t imuRead(imu_sample_t *out, uint16_t max)
+{
+  i2cLock();
+  qmi8658c.update();
+  qmi8658c.getAccel(&acc);
+  qmi8658c.getGyro(&gyro);
+
+  out->ax = acc.accelX;
+  out->ay = acc.accelY;
+  out->az = acc.accelZ;
+  out->gx = gyro.gyroX;
+  out->gy = gyro.gyroY;
+  out->gz = gyro.gyroZ;
+  out->temp = qmi8658c.getTemp();
+  i2cUnlock();
+  return 1;
+}
+
+static const sensor_backend_t imuBackend = {imuStart, imuStop, imuRead, 0};
+
+// same as a touch, the screen comes on for the timeout
+static void onWristWake(wrist_wake_event_t event)
+{
+  screen_on();
+}
+#endif
+
+static uint32_t sensorClock()
+{
+  return micros();
+}
+
+#ifdef ENABLE_LATENCY
+static uint64_t latencyClock()
+{
+  return esp_timer_get_time();
+}
+
+static void latencyPrint(const latency_stats_t *stats)
+{
+  Timber.i("Latency %s: %u events, %u unchanged, p50 %uus p90 %uus p99 %uus max %uus", stats->screen, stats->count,
+           stats->unchanged, stats->p50_us, stats->p90_us, stats->p99_us, stats->max_us);
+}
+
+// the histograms keep growing, each report covers everything since boot
+static void latencyReport(lv_timer_t *timer)
+{
+  latency_iterate(latencyPrint);
+}
+#endif
+
+static uint32_t inputClock()
+{
+  return millis();
+}
+
 void contacts_app_launched()
 {
   clearContactList();
@@ -1748,6 +1980,16 @@ void hal_setup()
 
   Timber.i("Starting up device");
 
+  i2cMutex = xSemaphoreCreateMutex();
+  event_queue_init(&uiEvents, wake_loop);
+  // the encoder and button are polled by the loop itself, nothing to wake
+  input_bus_init(inputClock, NULL);
+  ui_thread_init(wake_loop);
+  heap_tags_init(heapFree, heapLargestFree);
+  clock_tick_subscribe(CLOCK_TICK_MINUTE | CLOCK_TICK_HOUR | CLOCK_TICK_DAY, onClockTick);
+  clock_tick_subscribe(CLOCK_TICK_SECOND, onFaceTick);
+  event_queue_post(&uiEvents, EVENT_WEATHER, 0, 0);
+
   prefs.begin("my-app");
 
   int rt = prefs.getInt("rotate", 0);
@@ -1808,6 +2050,11 @@ void hal_setup()
   static auto *lvInput = lv_indev_create();
   lv_indev_set_type(lvInput, LV_INDEV_TYPE_POINTER);
   lv_indev_set_read_cb(lvInput, my_touchpad_read);
+#ifdef ENABLE_LATENCY
+  latency_init(latencyClock);
+  latency_attach(lvDisplay, lvInput);
+  lv_timer_create(latencyReport, 30000, NULL);
+#endif
 
   // lv_log_register_print_cb(my_log_cb);
 
@@ -1879,7 +2126,7 @@ void hal_setup()
   watch.setBattery(85);
 
   String about = String(ui_info_text) + "\n" + chip + "\n" + watch.getAddress();
-  lv_label_set_text(ui_aboutText, about.c_str());
+  ui_settings_set_about(about.c_str());
 
 #if LV_USE_QRCODE == 1
   String address = watch.getAddress();
@@ -1908,9 +2155,7 @@ void hal_setup()
   alertSwitch = prefs.getBool("alerts", false);
   navSwitch = prefs.getBool("autonav", false);
 
-  lv_obj_scroll_to_y(ui_settingsList, 1, LV_ANIM_ON);
   lv_obj_scroll_to_y(ui_appList, 1, LV_ANIM_ON);
-  lv_obj_scroll_to_y(ui_appInfoPanel, 1, LV_ANIM_ON);
   lv_obj_scroll_to_y(ui_gameList, 1, LV_ANIM_ON);
 
   if (tm > 4)
@@ -1924,32 +2169,13 @@ void hal_setup()
 
   screenBrightness(br);
 
-  lv_dropdown_set_selected(ui_timeoutSelect, tm, LV_ANIM_OFF);
-  lv_dropdown_set_selected(ui_rotateSelect, rt, LV_ANIM_OFF);
-  lv_slider_set_value(ui_brightnessSlider, br, LV_ANIM_OFF);
+  ui_settings_set_timeout(tm);
+  ui_settings_set_rotation(rt);
+  ui_settings_set_brightness(br);
+  ui_settings_set_navigation(navSwitch);
 
   set_alert_states(alert_states);
 
-  if (circular)
-  {
-    lv_obj_add_state(ui_Switch2, LV_STATE_CHECKED);
-  }
-  else
-  {
-    lv_obj_remove_state(ui_Switch2, LV_STATE_CHECKED);
-  }
-
-#ifdef ENABLE_APP_NAVIGATION
-  if (navSwitch)
-  {
-    lv_obj_add_state(ui_navStateSwitch, LV_STATE_CHECKED);
-  }
-  else
-  {
-    lv_obj_remove_state(ui_navStateSwitch, LV_STATE_CHECKED);
-  }
-#endif
-
   screenTimer.active = true;
   screenTimer.time = millis();
 
@@ -1994,6 +2220,16 @@ void hal_setup()
   Rtc.SetSquareWavePin(PCF8563SquareWavePinMode_None);
 #endif
 
+  // the streams start the IMU on the sensor task, so they open once the IMU is set up
+  // and setup is done with the bus
+#ifdef ENABLE_APP_QMI8658C
+  sensor_service_init(&imuBackend, sensorClock);
+  activity_start();
+  wrist_wake_start(onWristWake);
+#else
+  sensor_service_init(NULL, sensorClock);
+#endif
+
   ui_update_seconds(watch.getSecond());
 
   lv_rand_set_seed(millis());
@@ -2020,136 +2256,218 @@ void hal_setup()
 
   ui_setup();
 
+  // hal_loop runs on this task, BLE callbacks notify it through this handle
+  loopHandle = xTaskGetCurrentTaskHandle();
+
   Serial.println(heapUsage());
 
   Timber.i("Setup done");
   Timber.i(about);
 }
 
-void hal_loop()
-{
+// default face texts, the labels point at these so updates do not allocate
+static char hourText[4];
+static char minuteText[4];
+static char dayText[16];
+static char dateText[12];
+static char amPmText[4];
+static lv_obj_t *lastHome = NULL;
 
-  if (!transfer)
+void onClockTick(const clock_tick_time_t *now, uint8_t changed)
+{
+  if (ui_home != ui_clockScreen)
   {
-    lv_timer_handler(); // Update the UI-
-    delay(5);
+    return;
+  }
+  tm t = watch.getTimeStruct();
+  if (changed & CLOCK_TICK_HOUR)
+  {
+    snprintf(hourText, sizeof(hourText), "%02d", watch.getHourC());
+    lv_label_set_text_static(ui_hourLabel, hourText);
+    strlcpy(amPmText, watch.getAmPmC(false).c_str(), sizeof(amPmText));
+    lv_label_set_text_static(ui_amPmLabel, amPmText);
+  }
+  if (changed & CLOCK_TICK_MINUTE)
+  {
+    snprintf(minuteText, sizeof(minuteText), "%02d", now->minute);
+    lv_label_set_text_static(ui_minuteLabel, minuteText);
+  }
+  if (changed & CLOCK_TICK_DAY)
+  {
+    strftime(dayText, sizeof(dayText), "%A", &t);
+    lv_label_set_text_static(ui_dayLabel, dayText);
+    strftime(dateText, sizeof(dateText), "%d\n%b", &t);
+    lv_label_set_text_static(ui_dateLabel, dateText);
+  }
+}
 
-    watch.loop();
+void onFaceTick(const clock_tick_time_t *now, uint8_t changed)
+{
+  if (ui_home != ui_clockScreen)
+  {
+    update_faces();
+  }
+}
 
-#if defined(M5_STACK_DIAL) || defined(VIEWE_KNOB_15)
-    long newPosition = read_encoder_position();
-    if (newPosition != oldPosition)
-    {
-      input_bus_emit_encoder_event(newPosition, newPosition - oldPosition);
-      oldPosition = newPosition;
-    }
-#endif
-#ifdef M5_STACK_DIAL
-    M5Dial.update();
-    if (M5Dial.BtnA.wasPressed())
+// runs on the UI loop, everything that touches LVGL after a BLE callback goes through here
+void onUiEvent(const event_t *event)
+{
+  switch (event->type)
+  {
+  case EVENT_NOTIFICATIONS:
+    notificationsUpdate = true;
+    break;
+  case EVENT_FORECAST:
+    // the weather screen reads it when it is next created
+    break;
+  case EVENT_WEATHER:
+    lv_label_set_text_fmt(ui_weatherTemp, "%d°C", watch.getWeatherAt(0).temp);
+    // set icon ui_weatherIcon
+    setWeatherIcon(ui_weatherIcon, watch.getWeatherAt(0).icon, isDay());
+    break;
+  case EVENT_TIME_SYNC:
+    ui_update_seconds(watch.getSecond());
+    // the 12/24h mode may have changed with it
+    clock_tick_invalidate();
+    break;
+  case EVENT_APP_INFO:
+    ui_set_app_version(watch.getAppVersion().c_str(), event->a);
+    break;
+  case EVENT_QR_LINKS:
+    updateQrLinks();
+    break;
+  case EVENT_CONNECTION:
+    ui_set_connected(event->a);
+    break;
+  case EVENT_ALERT:
+    showAlert();
+    break;
+  case EVENT_CAMERA:
+    setCameraState(event->a);
+    break;
+  case EVENT_FONT_COLOR:
+    setFontColor(event->a, event->b);
+    break;
+  case EVENT_CONTACTS:
+    updateContacts(event->a, event->b);
+    break;
+  case EVENT_NAV_DATA:
+  {
+    lv_obj_t *actScr = lv_display_get_screen_active(lv_display_get_default());
+    nav = watch.getNavigation();
+    if (!nav.active)
     {
-      input_bus_emit_button_event(true);
-      M5Dial.Encoder.readAndReset();
+      nav.directions = "Start navigation on Google maps";
+      nav.title = "Chronos";
+      nav.duration = watch.isConnected() ? "Inactive" : "Disconnected";
+      nav.eta = "Navigation";
+      nav.distance = "";
+      navIcCRC = 0xFFFFFFFF;
     }
-#endif
 
-    if (updateSeconds)
+    if (!nav.isNavigation)
     {
-      updateSeconds = false;
-      ui_update_seconds(watch.getSecond());
+      nav.directions = nav.title;
+      nav.title = "";
     }
 
-    if (ui_home == ui_clockScreen)
-    {
-      lv_label_set_text(ui_hourLabel, watch.getHourZ().c_str());
-      lv_label_set_text(ui_dayLabel, watch.getTime("%A").c_str());
-      lv_label_set_text(ui_minuteLabel, watch.getTime("%M").c_str());
-      lv_label_set_text(ui_dateLabel, watch.getTime("%d\n%b").c_str());
-      lv_label_set_text(ui_amPmLabel, watch.getAmPmC(false).c_str());
-    }
-    else
-    {
-      update_faces();
-    }
+    String navText = nav.eta + "\n" + nav.duration + " " + nav.distance;
 
-    lv_disp_t *display = lv_display_get_default();
-    lv_obj_t *actScr = lv_display_get_screen_active(display);
-    if (actScr != ui_home)
+#ifdef ENABLE_APP_NAVIGATION
+    if (actScr != get_nav_screen() && nav.active && navSwitch)
     {
+      lastActScr = actScr;
+      if (!get_nav_screen())
+      {
+        ui_navScreen_screen_init();
+      }
+      ui_transition_load(get_nav_screen(), LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
+      gameActive = true;
+      screenTimer.active = true;
     }
-
-    if (weatherUpdateFace)
+    if (actScr == get_nav_screen() && !nav.active && navSwitch && lastActScr != nullptr)
     {
-      lv_label_set_text_fmt(ui_weatherTemp, "%d°C", watch.getWeatherAt(0).temp);
-      // set icon ui_weatherIcon
-      setWeatherIcon(ui_weatherIcon, watch.getWeatherAt(0).icon, isDay());
-      weatherUpdateFace = false;
+      screenTimer.active = true;
+      ui_transition_load(lastActScr, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
     }
+#endif
+    navIconState(nav.active && nav.hasIcon);
+    navigateInfo(navText.c_str(), nav.title.c_str(), nav.directions.c_str());
+  }
+  break;
+  case EVENT_NAV_ICON:
+    nav = watch.getNavigation();
 
-    if (navChanged)
+    if (nav.iconCRC != navIcCRC)
     {
-      navChanged = false;
-      nav = watch.getNavigation();
-      if (!nav.active)
+      navIcCRC = nav.iconCRC;
+      navIconState(nav.active && nav.hasIcon);
+      for (int y = 0; y < 48; y++)
       {
-        nav.directions = "Start navigation on Google maps";
-        nav.title = "Chronos";
-        nav.duration = watch.isConnected() ? "Inactive" : "Disconnected";
-        nav.eta = "Navigation";
-        nav.distance = "";
-        navIcCRC = 0xFFFFFFFF;
+        for (int x = 0; x < 48; x++)
+        {
+          int byte_index = (y * 48 + x) / 8;
+          int bit_pos = 7 - (x % 8);
+          bool px_on = (nav.icon[byte_index] >> bit_pos) & 0x01;
+          setNavIconPx(x, y, px_on);
+        }
       }
+    }
+    break;
+  default:
+    break;
+  }
+}
 
-      if (!nav.isNavigation)
-      {
-        nav.directions = nav.title;
-        nav.title = "";
-      }
+void hal_loop()
+{
 
-      String navText = nav.eta + "\n" + nav.duration + " " + nav.distance;
+  if (!transfer)
+  {
+    loop_sched_begin(millis());
+    ui_lock();
+    loop_sched_add_delay(lv_timer_handler()); // Update the UI-
+#ifndef ENABLE_GAME_TASK
+    loop_sched_add_delay(ui_games_update());
+#endif
 
-#ifdef ENABLE_APP_NAVIGATION
-      if (actScr != get_nav_screen() && nav.active && navSwitch)
-      {
-        lastActScr = actScr;
-        if (!get_nav_screen())
-        {
-          ui_navScreen_screen_init();
-        }
-        lv_screen_load_anim(get_nav_screen(), LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
-        gameActive = true;
-        screenTimer.active = true;
-      }
-      if (actScr == get_nav_screen() && !nav.active && navSwitch && lastActScr != nullptr)
-      {
-        screenTimer.active = true;
-        lv_screen_load_anim(lastActScr, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0, false);
-      }
+    watch.loop();
+
+#if defined(M5_STACK_DIAL) || defined(VIEWE_KNOB_15)
+    // unchanged positions are not queued
+    input_bus_push_encoder(read_encoder_position());
+    loop_sched_add_delay(ENCODER_POLL_MS);
 #endif
-      navIconState(nav.active && nav.hasIcon);
-      navigateInfo(navText.c_str(), nav.title.c_str(), nav.directions.c_str());
+#ifdef M5_STACK_DIAL
+    M5Dial.update();
+    if (M5Dial.BtnA.wasPressed())
+    {
+      input_bus_push_button(true);
+      M5Dial.Encoder.readAndReset();
     }
-    if (navIcChanged)
+    if (M5Dial.BtnA.wasReleased())
     {
-      navIcChanged = false;
-      nav = watch.getNavigation();
+      input_bus_push_button(false);
+    }
+#endif
 
-      if (nav.iconCRC != navIcCRC)
-      {
-        navIcCRC = nav.iconCRC;
-        navIconState(nav.active && nav.hasIcon);
-        for (int y = 0; y < 48; y++)
-        {
-          for (int x = 0; x < 48; x++)
-          {
-            int byte_index = (y * 48 + x) / 8;
-            int bit_pos = 7 - (x % 8);
-            bool px_on = (nav.icon[byte_index] >> bit_pos) & 0x01;
-            setNavIconPx(x, y, px_on);
-          }
-        }
-      }
+    event_queue_drain(&uiEvents, onUiEvent);
+    ui_thread_drain();
+    // one encoder update per frame, however far it turned
+    loop_sched_add_delay(input_bus_dispatch());
+
+    if (ui_home != lastHome)
+    {
+      // another face, draw it right away
+      lastHome = ui_home;
+      clock_tick_invalidate();
     }
+    tm t = watch.getTimeStruct();
+    clock_tick_time_t now = {t.tm_sec, t.tm_min, t.tm_hour, t.tm_mday, 1 + t.tm_mon, 1900 + t.tm_year, t.tm_wday};
+    clock_tick_update(&now);
+
+    lv_disp_t *display = lv_display_get_default();
+    lv_obj_t *actScr = lv_display_get_screen_active(display);
 
     if (actScr == ui_appInfoScreen)
     {
@@ -2172,11 +2490,15 @@ void hal_loop()
         alertTimer.active = false;
         lv_obj_add_flag(ui_alertPanel, LV_OBJ_FLAG_HIDDEN);
       }
+      else
+      {
+        loop_sched_add_deadline(millis(), alertTimer.time + alertTimer.duration + 1);
+      }
     }
 
     if (screenTimer.active)
     {
-      uint8_t lvl = lv_slider_get_value(ui_brightnessSlider);
+      uint8_t lvl = ui_settings_get_brightness();
       screenBrightness(lvl);
 
       if (screenTimer.duration < 0)
@@ -2194,9 +2516,17 @@ void hal_loop()
         screenTimer.active = false;
 
         screenBrightness(0);
-        lv_screen_load(ui_home);
+        ui_transition_load(ui_home, LV_SCR_LOAD_ANIM_NONE, 0, 0);
+      }
+      else
+      {
+        loop_sched_add_deadline(millis(), screenTimer.time + screenTimer.duration + 1);
       }
     }
+
+    ui_unlock();
+    // sleep until the next deadline, BLE callbacks notify this task to wake up early
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(loop_sched_end(millis())));
   }
 
 #ifdef ENABLE_CUSTOM_FACE
@@ -2298,9 +2628,11 @@ void update_faces()
   int battery = watch.getPhoneBattery();
   bool connection = watch.isConnected();
 
-  int steps = 2735;
-  int distance = 17;
-  int kcal = 348;
+  activity_set_day(day);
+  const activity_t *activity = activity_get();
+  int steps = activity->steps;
+  int distance = activity->distance_m / 100; // 0.1 km
+  int kcal = activity->kcal;
   int bpm = 76;
   int oxygen = 97;
 
@@ -38,6 +38,15 @@
 
 #include <lvgl.h>
 #include "ui/ui.h"
+#include "common/loop_scheduler/loop_scheduler.h"
+#include "common/clock_tick/clock_tick.h"
+#include "common/ui_thread/ui_thread.h"
+#include "common/app_manager.h"
+#include "common/heap_tags/heap_tags.h"
+#include "common/sensor_service/sensor_service.h"
+#include "common/activity/activity.h"
+#include "common/wrist_wake/wrist_wake.h"
+#include "common/latency/latency.h"
 
 #include "ui/custom_face.h"
 
@@ -47,7 +56,12 @@
 
 #ifdef ENABLE_APP_QMI8658C
 #include "FastIMU.h"
+#include <Wire.h>
 #define QMI_ADDRESS 0x6B
+// QMI8658C registers, the ODR is the low nibble of CTRL2 (accel) and CTRL3 (gyro)
+#define QMI_CTRL2 0x03
+#define QMI_CTRL3 0x04
+#define QMI_CTRL7 0x08 // bit 0 accel enable, bit 1 gyro enable, both clear is standby
 #endif
 
 #define buf_size 20
@@ -201,6 +215,7 @@ struct HourlyForecast
 void update_faces();
 void setupContacts();
 void setupWeather();
+void setupFiles();
 
 // some pre-generated data just for preview
 Notification notifications[10] = {
@@ -333,6 +348,15 @@ void onWeatherLoad(lv_event_t *e)
   setupWeather();
 }
 
+void onFilesLoad(lv_event_t *e)
+{
+  // the demo files, unless the list was filled before the screen was opened
+  if (lv_obj_get_child_count(ui_fileManagerPanel) == 0)
+  {
+    setupFiles();
+  }
+}
+
 void onNotificationsOpen(lv_event_t *e) {}
 
 void onBrightnessChange(lv_event_t *e)
@@ -368,14 +392,16 @@ void onMusicPlay(lv_event_t *e)
 
 void onMusicPrevious(lv_event_t *e)
 {
+  ui_screen_get(&ui_callScreen);
   lv_label_set_text(ui_callName, "World");
-  lv_screen_load_anim(ui_callScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+  ui_transition_load(ui_callScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
 }
 
 void onMusicNext(lv_event_t *e)
 {
+  ui_screen_get(&ui_cameraScreen);
   lv_label_set_text(ui_cameraLabel, "Click capture to close to close");
-  lv_screen_load_anim(ui_cameraScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+  ui_transition_load(ui_cameraScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
 }
 
 void onStartSearch(lv_event_t *e) {}
@@ -454,7 +480,7 @@ void onMessageClick(lv_event_t *e)
 
 void onCaptureClick(lv_event_t *e)
 {
-  lv_screen_load_anim(ui_home, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+  ui_transition_load(ui_home, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
 }
 
 void addFaceList(lv_obj_t *parent, Face face) {}
@@ -467,6 +493,15 @@ void setupWeather()
 {
   // lv_obj_set_style_bg_image_src(ui_weatherScreen, &ui_img_753022056, LV_PART_MAIN | LV_STATE_DEFAULT);
 
+  lv_label_set_text_fmt(ui_weatherTemp, "%d°C", weather[0].temp);
+  setWeatherIcon(ui_weatherIcon, weather[0].icon, true);
+
+  // the weather screen is only created while it is shown
+  if (ui_weatherScreen == NULL)
+  {
+    return;
+  }
+
   lv_obj_remove_flag(ui_weatherPanel, LV_OBJ_FLAG_HIDDEN);
   lv_obj_add_flag(ui_forecastList, LV_OBJ_FLAG_HIDDEN);
 
@@ -477,9 +512,6 @@ void setupWeather()
 
   setWeatherIcon(ui_weatherCurrentIcon, weather[0].icon, true);
 
-  lv_label_set_text_fmt(ui_weatherTemp, "%d°C", weather[0].temp);
-  setWeatherIcon(ui_weatherIcon, weather[0].icon, true);
-
   lv_obj_clean(ui_forecastList);
 
   for (int i = 0; i < 7; i++)
@@ -495,14 +527,14 @@ void setupWeather()
   }
 }
 
-void setupNotifications()
+void bindNotification(lv_obj_t *row, int32_t index)
 {
-  lv_obj_clean(ui_messageList);
+  bindNotificationList(row, notifications[index].icon, notifications[index].message, index);
+}
 
-  for (int i = 0; i < 10; i++)
-  {
-    addNotificationList(notifications[i].icon, notifications[i].message, i);
-  }
+void setupNotifications()
+{
+  setNotificationList(10, bindNotification);
 
   lv_obj_scroll_to_y(ui_messageList, 1, LV_ANIM_ON);
   lv_obj_remove_flag(ui_messageList, LV_OBJ_FLAG_HIDDEN);
@@ -536,6 +568,39 @@ void setupContacts()
   }
 }
 
+#ifdef ENABLE_APP_QMI8658C
+static bool imuReady = false;
+
+static uint8_t qmiRead(uint8_t reg)
+{
+  Wire.beginTransmission(QMI_ADDRESS);
+  Wire.write(reg);
+  Wire.endTransmission(false);
+  Wire.requestFrom(QMI_ADDRESS, 1);
+  return Wire.available() ? Wire.read() : 0;
+}
+
+static void qmiWrite(uint8_t reg, uint8_t value)
+{
+  Wire.beginTransmission(QMI_ADDRESS);
+  Wire.write(reg);
+  Wire.write(value);
+  Wire.endTransmission();
+}
+
+// 6DOF ODR code of the slowest rate at or above hz, from the QMI8658C datasheet
+static uint8_t qmiOdrCode(uint16_t hz)
+{
+  static const uint16_t rates[] = {28, 56, 112, 224, 448, 897};
+  uint8_t code = 0x08; // 28 Hz
+  for (int i = 0; i < 5 && hz > rates[i]; i++)
+  {
+    code--;
+  }
+  return code;
+}
+#endif
+
 void imu_init()
 {
 #ifdef ENABLE_APP_QMI8658C
@@ -544,6 +609,7 @@ void imu_init()
   {
     showError("IMU State", "Failed to init");
   }
+  imuReady = err == 0;
 #endif
 }
 
@@ -577,6 +643,78 @@ void imu_close()
 #endif
 }
 
+#ifdef ENABLE_APP_QMI8658C
+// one sample per ODR period, polled from hal_loop(). FastIMU sets the ranges at init,
+// the rate and the enables are set here.
+static bool imuStart(uint16_t odr)
+{
+  if (!imuReady)
+  {
+    return false;
+  }
+  uint8_t code = qmiOdrCode(odr);
+  qmiWrite(QMI_CTRL2, (qmiRead(QMI_CTRL2) & 0xF0) | code);
+  qmiWrite(QMI_CTRL3, (qmiRead(QMI_CTRL3) & 0xF0) | code);
+  qmiWrite(QMI_CTRL7, qmiRead(QMI_CTRL7) | 0x03);
+  return true;
+}
+
+// accel and gyro off until the next stream opens
+static void imuStop()
+{
+  qmiWrite(QMI_CTRL7, qmiRead(QMI_CTRL7) & ~0x03);
+}
+
+static uint16_t imuRead(imu_sample_t *out, uint16_t max)
+{
+  qmi8658c.update();
+  qmi8658c.getAccel(&acc);
+  qmi8658c.getGyro(&gyro);
+
+  out->ax = acc.accelX;
+  out->ay = acc.accelY;
+  out->az = acc.accelZ;
+  out->gx = gyro.gyroX;
+  out->gy = gyro.gyroY;
+  out->gz = gyro.gyroZ;
+  out->temp = qmi8658c.getTemp();
+  return 1;
+}
+
+static const sensor_backend_t imuBackend = {imuStart, imuStop, imuRead, 0};
+
+// same as a touch, the screen comes on for the timeout
+static void onWristWake(wrist_wake_event_t event)
+{
+  screenTimer.time = millis();
+  screenTimer.active = true;
+}
+#endif
+
+static uint32_t sensorClock()
+{
+  return micros();
+}
+
+#ifdef ENABLE_LATENCY
+static uint64_t latencyClock()
+{
+  return time_us_64();
+}
+
+static void latencyPrint(const latency_stats_t *stats)
+{
+  Timber.i("Latency %s: %u events, %u unchanged, p50 %uus p90 %uus p99 %uus max %uus", stats->screen, stats->count,
+           stats->unchanged, stats->p50_us, stats->p90_us, stats->p99_us, stats->max_us);
+}
+
+// the histograms keep growing, each report covers everything since boot
+static void latencyReport(lv_timer_t *timer)
+{
+  latency_iterate(latencyPrint);
+}
+#endif
+
 void my_log_cb(const char *buf)
 {
   Serial.write(buf, strlen(buf));
@@ -606,6 +744,12 @@ static uint32_t my_tick(void)
   return millis();
 }
 
+// free heap for the app info screen, the largest free block is not known here
+static size_t heapFree(void)
+{
+  return rp2040.getFreeHeap();
+}
+
 void logCallback(Level level, unsigned long time, String message)
 {
   // Serial.print(message);
@@ -622,6 +766,45 @@ void my_log_cb(lv_log_level_t level, const char *buf)
   // Serial.write(buf, strlen(buf));
 }
 
+// default face texts, the labels point at these so updates do not allocate
+static char hourText[4];
+static char minuteText[4];
+static char dateText[12];
+static lv_obj_t *lastHome = NULL;
+
+void onClockTick(const clock_tick_time_t *now, uint8_t changed)
+{
+  if (ui_home != ui_clockScreen)
+  {
+    return;
+  }
+  if (changed & CLOCK_TICK_HOUR)
+  {
+    snprintf(hourText, sizeof(hourText), "%02d", now->hour);
+    lv_label_set_text_static(ui_hourLabel, hourText);
+  }
+  if (changed & CLOCK_TICK_MINUTE)
+  {
+    snprintf(minuteText, sizeof(minuteText), "%02d", now->minute);
+    lv_label_set_text_static(ui_minuteLabel, minuteText);
+  }
+  if (changed & CLOCK_TICK_DAY)
+  {
+    snprintf(dateText, sizeof(dateText), "%02d\n%s", now->day, months[now->month - 1]);
+    lv_label_set_text_static(ui_dateLabel, dateText);
+    lv_label_set_text_static(ui_dayLabel, daysWk[now->weekday]);
+    lv_label_set_text_static(ui_amPmLabel, "");
+  }
+}
+
+void onFaceTick(const clock_tick_time_t *now, uint8_t changed)
+{
+  if (ui_home != ui_clockScreen)
+  {
+    update_faces();
+  }
+}
+
 void hal_setup()
 {
 
@@ -679,6 +862,11 @@ void hal_setup()
   lvInput = lv_indev_create();
   lv_indev_set_type(lvInput, LV_INDEV_TYPE_POINTER);
   lv_indev_set_read_cb(lvInput, my_touchpad_read);
+#ifdef ENABLE_LATENCY
+  latency_init(latencyClock);
+  latency_attach(lvDisplay, lvInput);
+  lv_timer_create(latencyReport, 30000, NULL);
+#endif
 
   ui_init();
 
@@ -692,18 +880,28 @@ void hal_setup()
   setupNotifications();
   setupWeather();
 
-  setupFiles();
   setupContacts();
 
   circular = true;
 
-  lv_obj_scroll_to_y(ui_settingsList, 1, LV_ANIM_ON);
   lv_obj_scroll_to_y(ui_appList, 1, LV_ANIM_ON);
-  lv_obj_scroll_to_y(ui_appInfoPanel, 1, LV_ANIM_ON);
   lv_obj_scroll_to_y(ui_gameList, 1, LV_ANIM_ON);
-  lv_obj_add_state(ui_Switch2, LV_STATE_CHECKED);
 
-  lv_label_set_text_fmt(ui_aboutText, "%s\nPico RP2040\nA1:B2:C3:D4:E5:F6", ui_info_text);
+  char about[128];
+  lv_snprintf(about, sizeof(about), "%s\nPico RP2040\nA1:B2:C3:D4:E5:F6", ui_info_text);
+  ui_settings_set_about(about);
+
+  ui_thread_init(NULL);
+  heap_tags_init(heapFree, NULL);
+#ifdef ENABLE_APP_QMI8658C
+  sensor_service_init(&imuBackend, sensorClock);
+  activity_start();
+  wrist_wake_start(onWristWake);
+#else
+  sensor_service_init(NULL, sensorClock);
+#endif
+  clock_tick_subscribe(CLOCK_TICK_MINUTE | CLOCK_TICK_HOUR | CLOCK_TICK_DAY, onClockTick);
+  clock_tick_subscribe(CLOCK_TICK_SECOND, onFaceTick);
 
   ui_setup();
 
@@ -713,37 +911,26 @@ void hal_setup()
 void hal_loop()
 {
 
-  lv_timer_handler(); /* let the GUI do its work */
-  delay(5);           /* let this time pass */
-
-  if (ui_home == ui_clockScreen)
-  {
-    time_t now = time(0);
-    tm *ltm = localtime(&now);
-
-    int second = ltm->tm_sec;
-    int minute = ltm->tm_min;
-    int hour = ltm->tm_hour;
-    bool am = hour < 12;
-    int day = ltm->tm_mday;
-    int month = 1 + ltm->tm_mon;    // Month starts from 0
-    int year = 1900 + ltm->tm_year; // Year is since 1900
-    int weekday = ltm->tm_wday;
+  loop_sched_begin(millis());
+  loop_sched_add_delay(lv_timer_handler()); /* let the GUI do its work */
+  loop_sched_add_delay(ui_games_update());
+  loop_sched_add_delay(sensor_service_poll());
+  ui_thread_drain();
 
-    lv_label_set_text_fmt(ui_hourLabel, "%02d", hour);
-    lv_label_set_text_fmt(ui_dayLabel, "%s", daysWk[weekday]);
-    lv_label_set_text_fmt(ui_minuteLabel, "%02d", minute);
-    lv_label_set_text_fmt(ui_dateLabel, "%02d\n%s", day, months[month - 1]);
-    lv_label_set_text(ui_amPmLabel, "");
-  }
-  else
+  if (ui_home != lastHome)
   {
-    update_faces();
+    // another face, draw it right away
+    lastHome = ui_home;
+    clock_tick_invalidate();
   }
+  time_t t = time(0);
+  tm *ltm = localtime(&t);
+  clock_tick_time_t now = {ltm->tm_sec, ltm->tm_min, ltm->tm_hour, ltm->tm_mday, 1 + ltm->tm_mon, 1900 + ltm->tm_year, ltm->tm_wday};
+  clock_tick_update(&now);
 
   if (screenTimer.active)
   {
-    uint8_t lvl = lv_slider_get_value(ui_brightnessSlider);
+    uint8_t lvl = ui_settings_get_brightness();
     screenBrightness(lvl);
 
     if (screenTimer.duration < 0)
@@ -755,8 +942,25 @@ void hal_loop()
       screenTimer.active = false;
 
       screenBrightness(0);
-      lv_screen_load(ui_home);
+      ui_transition_load(ui_home, LV_SCR_LOAD_ANIM_NONE, 0, 0);
+    }
+    else
+    {
+      loop_sched_add_deadline(millis(), screenTimer.time + screenTimer.duration + 1);
+    }
+  }
+
+  /* sleep until the next deadline, the IMU has no FIFO and is read in between */
+  uint32_t wait = loop_sched_end(millis());
+  uint32_t until = millis() + wait;
+  for (uint32_t left = wait; left > 0; left = (int32_t)(until - millis()) > 0 ? until - millis() : 0)
+  {
+    uint32_t next = sensor_service_read();
+    if (next == 0)
+    {
+      break; /* samples are due for the UI */
     }
+    delay(next < left ? next : left);
   }
 }
 
@@ -803,9 +1007,11 @@ void update_faces()
   int battery = 75; // rand() % 100;
   bool connection = true;
 
-  int steps = 2735;
-  int distance = 17;
-  int kcal = 348;
+  activity_set_day(day);
+  const activity_t *activity = activity_get();
+  int steps = activity->steps;
+  int distance = activity->distance_m / 100; // 0.1 km
+  int kcal = activity->kcal;
   int bpm = 76;
   int oxygen = 97;
 
@@ -2,6 +2,10 @@
 #include <ctime>
 #include <cstring>
 #include <stdio.h>
+#include <stdlib.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 #define SDL_MAIN_HANDLED /*To fix SDL's "undefined reference to WinMain" issue*/
 #include SDL_INCLUDE_PATH
 #include "drivers/sdl/lv_sdl_mouse.h"
@@ -10,6 +14,20 @@
 
 #include "app_hal.h"
 #include "ui/ui.h"
+#include "common/loop_scheduler/loop_scheduler.h"
+#include "common/clock_tick/clock_tick.h"
+#include "common/ui_thread/ui_thread.h"
+#include "common/app_manager.h"
+#include "common/heap_tags/heap_tags.h"
+#include "common/activity/activity.h"
+#include "common/wrist_wake/wrist_wake.h"
+#include "common/input_bus/input_bus.h"
+#include "sim_clock.h"
+#include "sensor_replay.h"
+#include "input_replay.h"
+#include "bench.h"
+#include "common/profiler/profiler.h"
+#include "common/latency/latency.h"
 
 static lv_display_t *lvDisplay;
 static lv_indev_t *lvMouse;
@@ -48,8 +66,10 @@ void hal_setup(void);
 void hal_loop(void);
 
 void update_faces();
+void update_home();
 void setupContacts();
 void setupWeather();
+void setupFiles();
 
 // some pre-generated data just for preview
 Notification notifications[10] = {
@@ -104,23 +124,53 @@ HourlyForecast hourly[24] = {
 const char *daysWk[7] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
 const char *months[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 /**
- * A task to measure the elapsed time for LittlevGL
- * @param data unused
- * @return never return
+ * Tick source for LittlevGL, real or virtual depending on sim_clock
+ * @return elapsed milliseconds
  */
-static int tick_thread(void *data)
+static uint32_t my_tick(void)
 {
-    (void)data;
+    return sim_clock_ms();
+}
 
-    while (1)
+#ifdef ENABLE_PROFILER
+static uint64_t profiler_clock(void)
+{
+    return (uint64_t)((double)SDL_GetPerformanceCounter() * 1000000.0 / SDL_GetPerformanceFrequency());
+}
+
+static void profiler_exit(void)
+{
+    const char *path = getenv("PROFILE_TRACE");
+    if (path == NULL)
     {
-        SDL_Delay(5);   /*Sleep for 5 millisecond*/
-        lv_tick_inc(5); /*Tell LittelvGL that 5 milliseconds were elapsed*/
+        path = "trace.json";
     }
+    if (profiler_write(path))
+    {
+        printf("Profiler trace written to %s\n", path);
+    }
+}
+#endif
 
-    return 0;
+#if defined(ENABLE_LATENCY) && !defined(SIM_HEADLESS)
+static uint64_t latency_clock(void)
+{
+    return (uint64_t)((double)SDL_GetPerformanceCounter() * 1000000.0 / SDL_GetPerformanceFrequency());
 }
 
+static void latency_print(const latency_stats_t *stats)
+{
+    printf("Latency %-14s %4u events, %3u unchanged, p50 %.2fms p90 %.2fms p99 %.2fms max %.2fms\n", stats->screen,
+           stats->count, stats->unchanged, stats->p50_us / 1000.0, stats->p90_us / 1000.0, stats->p99_us / 1000.0,
+           stats->max_us / 1000.0);
+}
+
+static void latency_exit(void)
+{
+    latency_iterate(latency_print);
+}
+#endif
+
 void onLoadHome(lv_event_t *e) {}
 
 void onClickAlert(lv_event_t *e) {}
@@ -132,6 +182,15 @@ void onWeatherLoad(lv_event_t *e)
     setupWeather();
 }
 
+void onFilesLoad(lv_event_t *e)
+{
+    // the demo files, unless the list was filled before the screen was opened
+    if (lv_obj_get_child_count(ui_fileManagerPanel) == 0)
+    {
+        setupFiles();
+    }
+}
+
 void onNotificationsOpen(lv_event_t *e) {}
 
 void onBrightnessChange(lv_event_t *e) {}
@@ -151,14 +210,16 @@ void onMusicPlay(lv_event_t *e)
 
 void onMusicPrevious(lv_event_t *e)
 {
+    ui_screen_get(&ui_callScreen);
     lv_label_set_text(ui_callName, "World");
-    lv_screen_load_anim(ui_callScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+    ui_transition_load(ui_callScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
 }
 
 void onMusicNext(lv_event_t *e)
 {
+    ui_screen_get(&ui_cameraScreen);
     lv_label_set_text(ui_cameraLabel, "Click capture to close to close");
-    lv_screen_load_anim(ui_cameraScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+    ui_transition_load(ui_cameraScreen, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
 }
 
 void onStartSearch(lv_event_t *e) {}
@@ -237,7 +298,7 @@ void onMessageClick(lv_event_t *e)
 
 void onCaptureClick(lv_event_t *e)
 {
-    lv_screen_load_anim(ui_home, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+    ui_transition_load(ui_home, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0);
 }
 
 void addFaceList(lv_obj_t *parent, Face face) {}
@@ -250,6 +311,15 @@ void setupWeather()
 {
     // lv_obj_set_style_bg_image_src(ui_weatherScreen, &ui_img_753022056, LV_PART_MAIN | LV_STATE_DEFAULT);
 
+    lv_label_set_text_fmt(ui_weatherTemp, "%d°C", weather[0].temp);
+    setWeatherIcon(ui_weatherIcon, weather[0].icon, true);
+
+    // the weather screen is only created while it is shown
+    if (ui_weatherScreen == NULL)
+    {
+        return;
+    }
+
     lv_obj_remove_flag(ui_weatherPanel, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(ui_forecastList, LV_OBJ_FLAG_HIDDEN);
 
@@ -260,9 +330,6 @@ void setupWeather()
 
     setWeatherIcon(ui_weatherCurrentIcon, weather[0].icon, true);
 
-    lv_label_set_text_fmt(ui_weatherTemp, "%d°C", weather[0].temp);
-    setWeatherIcon(ui_weatherIcon, weather[0].icon, true);
-
     lv_obj_clean(ui_forecastList);
 
     for (int i = 0; i < 7; i++)
@@ -277,14 +344,14 @@ void setupWeather()
     }
 }
 
-void setupNotifications()
+void bindNotification(lv_obj_t *row, int32_t index)
 {
-    lv_obj_clean(ui_messageList);
+    bindNotificationList(row, notifications[index].icon, notifications[index].message, index);
+}
 
-    for (int i = 0; i < 10; i++)
-    {
-        addNotificationList(notifications[i].icon, notifications[i].message, i);
-    }
+void setupNotifications()
+{
+    setNotificationList(10, bindNotification);
 
     lv_obj_scroll_to_y(ui_messageList, 1, LV_ANIM_ON);
     lv_obj_remove_flag(ui_messageList, LV_OBJ_FLAG_HIDDEN);
@@ -318,6 +385,47 @@ void setupContacts()
     }
 }
 
+#ifdef __GLIBC__
+// free heap for the app info screen, glibc has no largest free block
+static size_t heap_free(void)
+{
+    return mallinfo2().fordblks;
+}
+#endif
+
+// posted UI work or a finished worker job, SDL_PushEvent may be called from any thread
+static void wake_loop(void)
+{
+    SDL_Event event = {};
+    event.type = SDL_USEREVENT;
+    SDL_PushEvent(&event);
+}
+
+#ifndef SIM_HEADLESS
+// the mouse wheel and its button stand in for the knob, called where SDL queues the event
+static int knob_watch(void *user, SDL_Event *event)
+{
+    LV_UNUSED(user);
+    static long position = 0;
+    if (event->type == SDL_MOUSEWHEEL)
+    {
+        position += event->wheel.y;
+        input_bus_push_encoder(position);
+    }
+    else if ((event->type == SDL_MOUSEBUTTONDOWN || event->type == SDL_MOUSEBUTTONUP) && event->button.button == SDL_BUTTON_MIDDLE)
+    {
+        input_bus_push_button(event->type == SDL_MOUSEBUTTONDOWN);
+    }
+    return 1;
+}
+#endif
+
+// the emulator screen never turns off, the wakes of a SENSOR_CSV replay are logged
+static void onWristWake(wrist_wake_event_t event)
+{
+    printf("Wrist %s at %ums\n", event == WRIST_WAKE_RAISE ? "raise" : "tilt", (unsigned)sim_clock_ms());
+}
+
 void hal_setup(void)
 {
 // Workaround for sdl2 `-m32` crash
@@ -326,86 +434,212 @@ void hal_setup(void)
     setenv("DBUS_FATAL_WARNINGS", "0", 1);
 #endif
 
+    sim_clock_init();
+
+#ifdef ENABLE_PROFILER
+    profiler_init(profiler_clock);
+    atexit(profiler_exit);
+#endif
+
     lv_init();
+    lv_tick_set_cb(my_tick);
 
+#ifdef SIM_HEADLESS
+    lvDisplay = bench_display_create(SDL_HOR_RES, SDL_VER_RES);
+    input_replay_init(lvDisplay);
+#else
     lvDisplay = lv_sdl_window_create(SDL_HOR_RES, SDL_VER_RES);
     lv_sdl_window_set_title(lvDisplay, "C3 Mini");
     lvMouse = lv_sdl_mouse_create();
     lvMousewheel = lv_sdl_mousewheel_create();
     lvKeyboard = lv_sdl_keyboard_create();
+    input_replay_init(lvDisplay);
+    input_replay_attach(lvMouse);
+    input_replay_attach(lvMousewheel);
+    input_replay_attach(lvKeyboard);
+    if (!input_replay_active())
+    {
+        SDL_AddEventWatch(knob_watch, NULL);
+    }
+#ifdef ENABLE_LATENCY
+    latency_init(latency_clock);
+    latency_attach(lvDisplay, lvMouse);
+    latency_attach(lvDisplay, lvMousewheel);
+    latency_attach(lvDisplay, lvKeyboard);
+    atexit(latency_exit);
+#endif
+#endif
 
+#ifdef SIM_HEADLESS
+    bench_boot_start();
+#endif
     ui_init();
 
     setupNotifications();
     // setupWeather();
 
-    setupFiles();
     setupContacts();
 
     circular = true;
 
-    lv_obj_scroll_to_y(ui_settingsList, 1, LV_ANIM_ON);
     lv_obj_scroll_to_y(ui_appList, 1, LV_ANIM_ON);
-    lv_obj_scroll_to_y(ui_appInfoPanel, 1, LV_ANIM_ON);
     lv_obj_scroll_to_y(ui_gameList, 1, LV_ANIM_ON);
-    lv_obj_add_state(ui_Switch2, LV_STATE_CHECKED);
 
     set_alert_states(3);
 
-    lv_label_set_text_fmt(ui_aboutText, "%s\nLVGL Simulator\nA1:B2:C3:D4:E5:F6", ui_info_text);
+    char about[128];
+    lv_snprintf(about, sizeof(about), "%s\nLVGL Simulator\nA1:B2:C3:D4:E5:F6", ui_info_text);
+    ui_settings_set_about(about);
 
-    time_t now = time(0);
-    tm *ltm = localtime(&now);
+    tm *ltm = sim_clock_tm();
     ui_update_seconds(ltm->tm_sec);
 
     lv_rand_set_seed(ltm->tm_sec);
 
+    ui_thread_init(wake_loop);
+    // the SDL event that pushed it already wakes the loop
+    input_bus_init(sim_clock_ms, NULL);
+#ifdef __GLIBC__
+    heap_tags_init(heap_free, NULL);
+#endif
+    sensor_service_init(sensor_replay_backend(), sensor_replay_clock);
+    activity_start();
+    wrist_wake_start(onWristWake);
+    clock_tick_subscribe(CLOCK_TICK_MINUTE | CLOCK_TICK_HOUR | CLOCK_TICK_DAY, onClockTick);
+    clock_tick_subscribe(CLOCK_TICK_SECOND, onFaceTick);
+
     ui_setup();
+}
+
+// default face texts, the labels point at these so updates do not allocate
+static char hourText[4];
+static char minuteText[4];
+static char dateText[12];
+static lv_obj_t *lastHome = NULL;
+
+void onClockTick(const clock_tick_time_t *now, uint8_t changed)
+{
+    if (ui_home != ui_clockScreen)
+    {
+        return;
+    }
+    if (changed & CLOCK_TICK_HOUR)
+    {
+        snprintf(hourText, sizeof(hourText), "%02d", now->hour);
+        lv_label_set_text_static(ui_hourLabel, hourText);
+    }
+    if (changed & CLOCK_TICK_MINUTE)
+    {
+        snprintf(minuteText, sizeof(minuteText), "%02d", now->minute);
+        lv_label_set_text_static(ui_minuteLabel, minuteText);
+    }
+    if (changed & CLOCK_TICK_DAY)
+    {
+        snprintf(dateText, sizeof(dateText), "%02d\n%s", now->day, months[now->month - 1]);
+        lv_label_set_text_static(ui_dateLabel, dateText);
+        lv_label_set_text_static(ui_dayLabel, daysWk[now->weekday]);
+        lv_label_set_text_static(ui_amPmLabel, "");
+    }
+}
 
-    /* Tick init.
-     * You have to call 'lv_tick_inc()' in periodically to inform LittelvGL about how much time were elapsed
-     * Create an SDL thread to do this*/
-    SDL_CreateThread(tick_thread, "tick", NULL);
+void onFaceTick(const clock_tick_time_t *now, uint8_t changed)
+{
+    if (ui_home != ui_clockScreen)
+    {
+        update_faces();
+    }
+}
+
+void update_home()
+{
+    PROFILER_BEGIN;
+    if (ui_home != lastHome)
+    {
+        // another face, draw it right away
+        lastHome = ui_home;
+        clock_tick_invalidate();
+    }
+
+    tm *ltm = sim_clock_tm();
+    clock_tick_time_t now = {ltm->tm_sec, ltm->tm_min, ltm->tm_hour, ltm->tm_mday, 1 + ltm->tm_mon, 1900 + ltm->tm_year, ltm->tm_wday};
+    clock_tick_update(&now);
+    PROFILER_END;
 }
 
 void hal_loop(void)
 {
-    uint32_t lastTick = SDL_GetTicks();
+#ifdef SIM_HEADLESS
+    bench_run();
+    return;
+#endif
+
+    char title[48];
+    uint32_t fastForwardMs = sim_clock_fast_forward() * 1000;
+    uint32_t started = SDL_GetTicks();
+    uint32_t loops = 0;
     while (1)
     {
-        SDL_Delay(5);
-        uint32_t current = SDL_GetTicks();
-        lv_tick_inc(current - lastTick);
-        lastTick = current;
-        lv_timer_handler();
+        loop_sched_begin(SDL_GetTicks());
+        ui_lock();
+#ifdef ENABLE_PROFILER
+        profiler_wrap_timers();
+#endif
+        PROFILER_BEGIN_TAG("frame");
+        loop_sched_add_delay(input_replay_poll());
+        loop_sched_add_delay(lv_timer_handler());
+        loop_sched_add_delay(sensor_service_poll());
+        ui_thread_drain();
+
+        update_home();
+
+        // fixed steps against the sim clock, wakes up when the next step is due
+        PROFILER_BEGIN_TAG("ui_games_update");
+        loop_sched_add_delay(ui_games_update());
+        PROFILER_END_TAG("ui_games_update");
+        // one encoder update per frame, however far it turned
+        loop_sched_add_delay(input_bus_dispatch());
+        PROFILER_END_TAG("frame");
+        input_replay_pass_end();
+
+        uint32_t wait = loop_sched_end(SDL_GetTicks());
+        if (loop_sched_stats_ready())
+        {
+            snprintf(title, sizeof(title), "C3 Mini | CPU %d%% | sleep %ums", loop_sched_busy_pct(), (unsigned)loop_sched_avg_sleep());
+            lv_sdl_window_set_title(lvDisplay, title);
+        }
+        ui_unlock();
 
-        if (ui_home == ui_clockScreen)
+        if (input_replay_done())
         {
-            time_t now = time(0);
-            tm *ltm = localtime(&now);
-
-            int second = ltm->tm_sec;
-            int minute = ltm->tm_min;
-            int hour = ltm->tm_hour;
-            bool am = hour < 12;
-            int day = ltm->tm_mday;
-            int month = 1 + ltm->tm_mon;    // Month starts from 0
-            int year = 1900 + ltm->tm_year; // Year is since 1900
-            int weekday = ltm->tm_wday;
-
-            lv_label_set_text_fmt(ui_hourLabel, "%02d", hour);
-            lv_label_set_text_fmt(ui_dayLabel, "%s", daysWk[weekday]);
-            lv_label_set_text_fmt(ui_minuteLabel, "%02d", minute);
-            lv_label_set_text_fmt(ui_dateLabel, "%02d\n%s", day, months[month - 1]);
-            lv_label_set_text(ui_amPmLabel, "");
+            exit(input_replay_report() > 0 ? 1 : 0);
         }
-        else
+        if (sim_clock_is_virtual())
         {
-            update_faces();
+            // jump straight to the next deadline instead of sleeping
+            sim_clock_advance(wait);
+            loops++;
+            if (fastForwardMs > 0 && sim_clock_ms() >= fastForwardMs)
+            {
+                printf("Fast-forwarded %us of virtual time in %ums (%u loops)\n",
+                       (unsigned)(fastForwardMs / 1000), (unsigned)(SDL_GetTicks() - started), (unsigned)loops);
+                return;
+            }
+            continue;
         }
 
-        // this works just okay on native, esp32 implementation is different
-        ui_games_update();
+        // sleep until the next deadline, input events wake us up early. SDL_WaitEventTimeout
+        // only peeks, the LVGL SDL driver reads the queue from its own timer, so an event that
+        // is still queued would end every wait at once until that timer runs. Its deadline is
+        // part of wait, so sleep through it instead.
+        SDL_PumpEvents();
+        if (SDL_HasEvents(SDL_FIRSTEVENT, SDL_LASTEVENT))
+        {
+            SDL_Delay(wait);
+        }
+        else
+        {
+            SDL_WaitEventTimeout(NULL, wait);
+        }
     }
 }
 
@@ -416,8 +650,7 @@ void contacts_app_launched()
 
 void calendar_app_launched(void)
 {
-    time_t now = time(0);
-    tm *ltm = localtime(&now);
+    tm *ltm = sim_clock_tm();
     int day = ltm->tm_mday;
     int month = 1 + ltm->tm_mon;    // Month starts from 0
     int year = 1900 + ltm->tm_year; // Year is since 1900
@@ -431,8 +664,7 @@ int32_t read_encoder_position()
 
 void update_faces()
 {
-    time_t now = time(0);
-    tm *ltm = localtime(&now);
+    tm *ltm = sim_clock_tm();
 
     // Extract time fields
     int second = ltm->tm_sec;
@@ -461,9 +693,11 @@ void update_faces()
     int battery = 75; // rand() % 100;
     bool connection = true;
 
-    int steps = 2735;
-    int distance = 17;
-    int kcal = 348;
+    activity_set_day(day);
+    const activity_t *activity = activity_get();
+    int steps = activity->steps;
+    int distance = activity->distance_m / 100; // 0.1 km
+    int kcal = activity->kcal;
     int bpm = 76;
     int oxygen = 97;
 
@@ -43,7 +43,8 @@
 
 #define ENABLE_APP_CALENDAR
 #define ENABLE_APP_SAMPLE
-// #define ENABLE_APP_QMI8658C
+#define ENABLE_APP_QMI8658C // IMU replayed from SENSOR_CSV, see sensor_replay.h
+#define ENABLE_APP_ATTITUDE
 #define ENABLE_APP_NAVIGATION
 #define ENABLE_APP_CONTACTS
 #define ENABLE_APP_TIMER
@@ -0,0 +1,1423 @@
+#ifdef SIM_HEADLESS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <malloc.h>
+#include <sys/stat.h>
+
+#include "bench.h"
+#include "sim_clock.h"
+#include "ui/ui.h"
+#include "common/profiler/profiler.h"
+#include "common/ui_thread/ui_thread.h"
+#include "common/app_manager.h"
+#include "common/heap_tags/heap_tags.h"
+#include "common/sensor_service/sensor_service.h"
+#include "common/activity/activity.h"
+#include "common/wrist_wake/wrist_wake.h"
+#include "common/input_bus/input_bus.h"
+#include "common/latency/latency.h"
+#include "common/loop_scheduler/loop_scheduler.h"
+#include "sensor_replay.h"
+#include "input_replay.h"
+#include "games/racing/racing.h"
+
+#define BENCH_BUF_LINES 40
+#define BENCH_DEFAULT_FRAMES 20
+#define BENCH_MAX_APPS 32
+#define BENCH_SETTLE_MS 600 // longer than the 500ms screen load animations
+#define BENCH_SCROLL_STEP 20 // pixels per scrolled frame
+#define BENCH_STYLE_ITEMS 50 // notifications in the local vs shared style rows
+#define BENCH_TRANSITION_MS 500
+#define BENCH_ROAD_STEP 3 // road pixels per frame while driving
+
+#define APP_ROUNDS 5        // passes over every app in BENCH_MODE=apps
+#define APP_HEAP_SLACK 4096 // heap growth between passes still treated as steady
+#define SENSOR_CHECK_MS 20000 // virtual time in BENCH_MODE=sensors
+#define LATENCY_GESTURES 20     // taps and swipes per screen in BENCH_MODE=latency
+#define LATENCY_MOVE_MS 10      // the finger moves this often during a swipe
+#define LATENCY_SWIPE_MS 200
+#define LATENCY_ANIM_DELAY_MS 100
+
+#define SNAPSHOT_TIME 1715422116  // Sat 11 May 2024 10:08:36 UTC
+#define SNAPSHOT_TOLERANCE 8      // per channel difference that still counts as equal
+#define SNAPSHOT_MAX_DIFF 0       // differing pixels allowed per face
+#define SNAPSHOT_REF_DIR "test/golden"
+#define SNAPSHOT_OUT_DIR "snapshots"
+
+extern Face faces[MAX_FACES];
+extern int numFaces;
+
+void update_home();
+
+typedef struct
+{
+    const char *name;
+    lv_obj_t **screen;
+} BenchScreen;
+
+typedef struct
+{
+    const char *name;
+    void (*launch)(lv_event_t *e);
+} BenchApp;
+
+static const BenchScreen screens[] = {
+    {"Weather", &ui_weatherScreen},
+    {"Notifications", &ui_notificationScreen},
+    {"App List", &ui_appListScreen},
+    {"Game List", &ui_gameListScreen},
+    {"Settings", &ui_settingsScreen},
+    {"Control", &ui_controlScreen},
+    {"Alert", &ui_alertScreen},
+    {"App Info", &ui_appInfoScreen},
+    {"Find Phone", &ui_findPhoneScreen},
+    {"Logo", &ui_logoScreen},
+    {"Connect", &ui_connectScreen},
+    {"Call", &ui_callScreen},
+    {"Camera", &ui_cameraScreen},
+    {"QR", &ui_qrScreen},
+    {"Files", &ui_filesScreen},
+};
+
+static BenchApp apps[BENCH_MAX_APPS];
+static int numApps = 0;
+
+static uint32_t flushAreas = 0;
+static uint64_t flushPixels = 0;
+
+static FILE *csv;
+static int frames = BENCH_DEFAULT_FRAMES;
+
+static uint64_t bootStart = 0;
+static size_t bootHeap = 0;
+
+// full frame copy of the flushed areas, only kept while taking snapshots
+static uint16_t *frame = NULL;
+
+static void bench_flush(lv_display_t *display, const lv_area_t *area, uint8_t *px_map)
+{
+    flushAreas++;
+    flushPixels += lv_area_get_size(area);
+
+    if (frame != NULL)
+    {
+        int32_t hor = lv_display_get_horizontal_resolution(display);
+        int32_t w = lv_area_get_width(area);
+        const uint16_t *src = (const uint16_t *)px_map;
+        for (int32_t y = area->y1; y <= area->y2; y++)
+        {
+            memcpy(&frame[y * hor + area->x1], src, w * sizeof(uint16_t));
+            src += w;
+        }
+    }
+    lv_display_flush_ready(display);
+}
+
+lv_display_t *bench_display_create(int32_t hor_res, int32_t ver_res)
+{
+    uint32_t size = hor_res * BENCH_BUF_LINES * (LV_COLOR_DEPTH / 8);
+    uint8_t *buf = (uint8_t *)malloc(size);
+
+    lv_display_t *display = lv_display_create(hor_res, ver_res);
+    lv_display_set_flush_cb(display, bench_flush);
+    lv_display_set_buffers(display, buf, NULL, size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    return display;
+}
+
+static uint64_t now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static size_t heap_used()
+{
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks;
+}
+
+void bench_boot_start(void)
+{
+    bootStart = now_us();
+    bootHeap = heap_used();
+}
+
+// ui_init and the first frame, screens created lazily are not part of it
+static void bench_boot(void)
+{
+    lv_display_t *display = lv_display_get_default();
+
+    flushAreas = 0;
+    flushPixels = 0;
+    lv_refr_now(display);
+    double ms = (now_us() - bootStart) / 1000.0;
+    size_t heap = heap_used() - bootHeap;
+
+    fprintf(csv, "%dx%d,boot,\"ui_init\",startup,1,%.3f,%llu,%u,%zu\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display),
+            ms, (unsigned long long)flushPixels, (unsigned)flushAreas, heap);
+    printf("boot   first frame after %.2fms, %zu bytes, %d screens created\n", ms, heap, ui_screen_count_created());
+}
+
+// run timers and animations until the screen has settled
+static void bench_settle(uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t += LV_DEF_REFR_PERIOD)
+    {
+        sim_clock_advance(LV_DEF_REFR_PERIOD);
+        lv_timer_handler();
+    }
+}
+
+static void bench_measure(const char *kind, const char *name, bool full, bool face)
+{
+    lv_display_t *display = lv_display_get_default();
+    lv_obj_t *actScr = lv_display_get_screen_active(display);
+    uint64_t total = 0;
+
+    flushAreas = 0;
+    flushPixels = 0;
+#ifdef ENABLE_PROFILER
+    profiler_wrap_timers();
+#endif
+
+    for (int i = 0; i < frames; i++)
+    {
+        if (full)
+        {
+            lv_obj_invalidate(actScr);
+        }
+        else
+        {
+            // one watch second, faces move their hands and labels
+            sim_clock_advance(1000);
+            if (face)
+            {
+                update_home();
+            }
+        }
+
+        uint64_t start = now_us();
+        if (full)
+        {
+            lv_refr_now(display);
+        }
+        else
+        {
+            lv_timer_handler();
+        }
+        total += now_us() - start;
+    }
+
+    fprintf(csv, "%dx%d,%s,\"%s\",%s,%d,%.3f,%llu,%.1f,%zu\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display),
+            kind, name, full ? "full" : "incremental", frames,
+            total / 1000.0 / frames, (unsigned long long)(flushPixels / frames), (double)flushAreas / frames, heap_used());
+}
+
+static void bench_target(const char *kind, const char *name, bool face)
+{
+    bench_measure(kind, name, true, face);
+    bench_measure(kind, name, false, face);
+    printf("%-6s %s\n", kind, name);
+}
+
+static void bench_bind_notification(lv_obj_t *row, int32_t index)
+{
+    bindNotificationList(row, index % 16, "Benchmark notification with a message long enough to wrap", index);
+}
+
+// build a notification list of the given size, heap_used is the heap taken by the rows
+// create adds a row per item, virtual only builds the recycled rows of the visible window
+static void bench_list(int items, bool virtualized)
+{
+    lv_display_t *display = lv_display_get_default();
+    char name[32];
+
+    lv_screen_load(ui_notificationScreen);
+    bench_settle(BENCH_SETTLE_MS);
+    lv_obj_clean(ui_messageList);
+    lv_refr_now(display);
+
+    size_t heapBefore = heap_used();
+    flushAreas = 0;
+    flushPixels = 0;
+
+    uint64_t start = now_us();
+    if (virtualized)
+    {
+        setNotificationList(items, bench_bind_notification);
+    }
+    else
+    {
+        for (int i = 0; i < items; i++)
+        {
+            addNotificationList(i % 16, "Benchmark notification with a message long enough to wrap", i);
+        }
+    }
+    lv_obj_update_layout(ui_messageList);
+    uint64_t created = now_us();
+    lv_refr_now(display);
+    uint64_t rendered = now_us();
+
+    size_t heapDelta = heap_used() - heapBefore;
+    const char *mode = virtualized ? "virtual" : "create";
+    snprintf(name, sizeof(name), "Notifications x%d", items);
+    fprintf(csv, "%dx%d,list,\"%s\",%s,1,%.3f,%llu,%u,%zu\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display),
+            name, mode, (rendered - start) / 1000.0, (unsigned long long)flushPixels, (unsigned)flushAreas, heapDelta);
+    printf("list   %s %s: create %.2fms, first frame %.2fms, %zu bytes\n", name, mode,
+           (created - start) / 1000.0, (rendered - created) / 1000.0, heapDelta);
+
+    lv_obj_clean(ui_messageList);
+}
+
+// a notification row the way the list built it before the shared ui_theme styles, every
+// property a local style on the row
+static void bench_local_notification(int appId, const char *message)
+{
+    lv_obj_t *item = lv_obj_create(ui_messageList);
+    lv_obj_set_width(item, 200);
+    lv_obj_set_height(item, LV_SIZE_CONTENT);
+    lv_obj_set_align(item, LV_ALIGN_CENTER);
+    lv_obj_set_flex_flow(item, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(item, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_START);
+    lv_obj_remove_flag(item, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_radius(item, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(item, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(item, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(item, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_opa(item, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(item, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_side(item, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_left(item, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_right(item, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_top(item, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_bottom(item, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    lv_obj_t *icon = lv_image_create(item);
+    lv_obj_set_width(icon, LV_SIZE_CONTENT);
+    lv_obj_set_height(icon, LV_SIZE_CONTENT);
+    lv_obj_set_align(icon, LV_ALIGN_CENTER);
+    lv_obj_add_flag(icon, LV_OBJ_FLAG_ADV_HITTEST);
+    lv_obj_remove_flag(icon, LV_OBJ_FLAG_SCROLLABLE);
+    setNotificationIcon(icon, appId);
+
+    lv_obj_t *text = lv_label_create(item);
+    lv_obj_set_width(text, 140);
+    lv_obj_set_height(text, LV_SIZE_CONTENT);
+    lv_obj_set_align(text, LV_ALIGN_CENTER);
+    lv_label_set_long_mode(text, LV_LABEL_LONG_DOT);
+    lv_label_set_text(text, message);
+}
+
+// build BENCH_STYLE_ITEMS notifications with local styles on every row (local) and with the
+// shared ui_theme styles (shared), ms_per_frame is the build and the first frame
+static void bench_styles(bool shared)
+{
+    lv_display_t *display = lv_display_get_default();
+    char name[32];
+
+    lv_screen_load(ui_notificationScreen);
+    bench_settle(BENCH_SETTLE_MS);
+    lv_obj_clean(ui_messageList);
+    lv_refr_now(display);
+
+    size_t heapBefore = heap_used();
+    flushAreas = 0;
+    flushPixels = 0;
+
+    uint64_t start = now_us();
+    for (int i = 0; i < BENCH_STYLE_ITEMS; i++)
+    {
+        if (shared)
+        {
+            addNotificationList(i % 16, "Benchmark notification with a message long enough to wrap", i);
+        }
+        else
+        {
+            bench_local_notification(i % 16, "Benchmark notification with a message long enough to wrap");
+        }
+    }
+    lv_obj_update_layout(ui_messageList);
+    uint64_t created = now_us();
+    lv_refr_now(display);
+    uint64_t rendered = now_us();
+
+    size_t heapDelta = heap_used() - heapBefore;
+    const char *mode = shared ? "shared" : "local";
+    snprintf(name, sizeof(name), "Notifications x%d", BENCH_STYLE_ITEMS);
+    fprintf(csv, "%dx%d,styles,\"%s\",%s,1,%.3f,%llu,%u,%zu\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display),
+            name, mode, (rendered - start) / 1000.0, (unsigned long long)flushPixels, (unsigned)flushAreas, heapDelta);
+    printf("styles %s %s: create %.2fms, first frame %.2fms, %zu bytes\n", name, mode,
+           (created - start) / 1000.0, (rendered - created) / 1000.0, heapDelta);
+
+    lv_obj_clean(ui_messageList);
+}
+
+// onScroll as it was before the circle table and the visible row window: a square root
+// and a translate_x write for every child on each scroll event, kept as the baseline of
+// the "scroll" rows
+static void bench_legacy_scroll(lv_event_t *e)
+{
+    lv_obj_t *list = (lv_obj_t *)lv_event_get_target(e);
+    lv_area_t list_a;
+    lv_obj_get_coords(list, &list_a);
+    lv_coord_t list_y_center = list_a.y1 + lv_area_get_height(&list_a) / 2;
+
+    lv_coord_t r = lv_obj_get_height(list) * 7 / 10;
+    uint32_t child_cnt = lv_obj_get_child_count(list);
+    for (uint32_t i = 0; i < child_cnt; i++)
+    {
+        lv_obj_t *child = lv_obj_get_child(list, i);
+        lv_area_t child_a;
+        lv_obj_get_coords(child, &child_a);
+
+        lv_coord_t child_y_center = child_a.y1 + lv_area_get_height(&child_a) / 2;
+        lv_coord_t diff_y = LV_ABS(child_y_center - list_y_center);
+
+        lv_coord_t x;
+        if (diff_y >= r)
+        {
+            x = r;
+        }
+        else
+        {
+            lv_sqrt_res_t res;
+            lv_sqrt((uint32_t)(r * r - diff_y * diff_y), &res, 0x8000);
+            x = r - res.i;
+        }
+
+        lv_obj_set_style_translate_x(child, circular ? x : 0, 0);
+    }
+}
+
+// scroll a notification list of the given size a row at a time, every row is a real object
+// so the scroll handler sees the full child count. legacy swaps onScroll for
+// bench_legacy_scroll on the list while it runs
+static void bench_scroll(int items, bool legacy)
+{
+    lv_display_t *display = lv_display_get_default();
+    lv_event_cb_t handler = legacy ? bench_legacy_scroll : onScroll;
+    char name[48];
+    uint64_t total = 0;
+
+    lv_screen_load(ui_notificationScreen);
+    bench_settle(BENCH_SETTLE_MS);
+    lv_obj_clean(ui_messageList);
+    if (legacy)
+    {
+        lv_obj_remove_event_cb(ui_messageList, onScroll);
+        lv_obj_add_event_cb(ui_messageList, bench_legacy_scroll, LV_EVENT_SCROLL, NULL);
+    }
+    for (int i = 0; i < items; i++)
+    {
+        addNotificationList(i % 16, "Benchmark notification with a message long enough to wrap", i);
+    }
+    lv_obj_update_layout(ui_messageList);
+    lv_obj_scroll_to_y(ui_messageList, 0, LV_ANIM_OFF);
+    lv_refr_now(display);
+
+    flushAreas = 0;
+    flushPixels = 0;
+    int32_t step = BENCH_SCROLL_STEP;
+    for (int i = 0; i < frames; i++)
+    {
+        // turn around at either end of the list
+        if ((step > 0 && lv_obj_get_scroll_bottom(ui_messageList) < step) || (step < 0 && lv_obj_get_scroll_y(ui_messageList) < -step))
+        {
+            step = -step;
+        }
+
+        uint64_t start = now_us();
+        lv_obj_scroll_by(ui_messageList, 0, -step, LV_ANIM_OFF);
+        lv_refr_now(display);
+        total += now_us() - start;
+    }
+
+    snprintf(name, sizeof(name), "Notifications x%d %s", items, circular ? "circular" : "flat");
+    fprintf(csv, "%dx%d,scroll,\"%s\",%s,%d,%.3f,%llu,%.1f,%zu\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display),
+            name, legacy ? "legacy" : "current", frames,
+            total / 1000.0 / frames, (unsigned long long)(flushPixels / frames), (double)flushAreas / frames, heap_used());
+    printf("scroll %s %s: %.2fms per frame\n", name, legacy ? "legacy" : "current", total / 1000.0 / frames);
+
+    lv_obj_clean(ui_messageList);
+    if (legacy)
+    {
+        lv_obj_remove_event_cb(ui_messageList, bench_legacy_scroll);
+        lv_obj_add_event_cb(ui_messageList, onScroll, LV_EVENT_SCROLL, NULL);
+    }
+}
+
+typedef struct
+{
+    const char *name;
+    lv_screen_load_anim_t anim;
+} BenchTransition;
+
+static const BenchTransition transitions[] = {
+    {"Over", LV_SCR_LOAD_ANIM_OVER_RIGHT},
+    {"Move", LV_SCR_LOAD_ANIM_MOVE_LEFT},
+    {"Fade in", LV_SCR_LOAD_ANIM_FADE_IN},
+    {"Fade out", LV_SCR_LOAD_ANIM_FADE_OUT},
+    {"Out", LV_SCR_LOAD_ANIM_OUT_BOTTOM},
+};
+
+// one home -> app list load, live screens or snapshots, ms_per_frame covers the animation frames
+static void bench_transition(const BenchTransition *transition, bool snapshot)
+{
+    lv_display_t *display = lv_display_get_default();
+    uint64_t total = 0;
+    int count = 0;
+
+    ui_transition_set_snapshot(false);
+    lv_screen_load(ui_home);
+    bench_settle(BENCH_SETTLE_MS);
+    lv_refr_now(display);
+
+    ui_transition_set_snapshot(snapshot);
+    size_t heapBefore = heap_used();
+    flushAreas = 0;
+    flushPixels = 0;
+
+    uint64_t start = now_us();
+    ui_transition_load(ui_appListScreen, transition->anim, BENCH_TRANSITION_MS, 0);
+    uint64_t setup = now_us() - start;
+    size_t heapDelta = heap_used() - heapBefore;
+
+    for (uint32_t t = 0; t < BENCH_TRANSITION_MS + LV_DEF_REFR_PERIOD; t += LV_DEF_REFR_PERIOD)
+    {
+        sim_clock_advance(LV_DEF_REFR_PERIOD);
+        start = now_us();
+        lv_timer_handler();
+        total += now_us() - start;
+        count++;
+    }
+
+    fprintf(csv, "%dx%d,transition,\"%s\",%s,%d,%.3f,%llu,%.1f,%zu\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display),
+            transition->name, snapshot ? "snapshot" : "live", count,
+            total / 1000.0 / count, (unsigned long long)(flushPixels / count), (double)flushAreas / count, heapDelta);
+    printf("trans  %s %s: %.2fms per frame, %.2fms setup, %zu bytes\n", transition->name, snapshot ? "snapshot" : "live",
+           total / 1000.0 / count, setup / 1000.0, heapDelta);
+
+    ui_transition_set_snapshot(true);
+}
+
+#ifdef ENABLE_GAME_RACING
+static lv_obj_t *bench_car(lv_obj_t *parent, const lv_image_dsc_t *src, int32_t x, int32_t y)
+{
+    lv_obj_t *car = lv_image_create(parent);
+    lv_image_set_src(car, src);
+    lv_obj_set_pos(car, x, y);
+    lv_obj_set_align(car, LV_ALIGN_TOP_MID);
+    lv_obj_remove_flag(car, LV_OBJ_FLAG_SCROLLABLE);
+    return car;
+}
+
+// the racing scene with a tiled road image and one lv_image per car (objects) or with a sprite
+// layer, driving scrolls the road and both cars, steering only moves the player
+static void bench_sprites(bool driving, bool layer)
+{
+    static ui_sprite_layer_t sprites;
+    lv_display_t *display = lv_display_get_default();
+    const int32_t carX = (150 - 64) / 2; // road center to layer coordinates
+    uint64_t total = 0;
+    lv_obj_t *road = NULL;
+    lv_obj_t *player = NULL;
+    lv_obj_t *npc = NULL;
+    int playerSprite = -1;
+    int npcSprite = -1;
+
+    lv_obj_t *screen = lv_obj_create(NULL);
+    lv_obj_remove_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), 0);
+    lv_obj_t *panel = lv_obj_create(screen);
+    lv_obj_set_size(panel, 150, 240);
+    lv_obj_set_align(panel, LV_ALIGN_CENTER);
+    lv_obj_remove_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(panel, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
+    lv_obj_set_style_border_width(panel, 0, 0);
+    lv_obj_set_style_pad_all(panel, 0, 0);
+
+    if (layer)
+    {
+        ui_sprite_layer_create(&sprites, panel, 150, 240);
+        ui_sprite_layer_set_background(&sprites, &ui_img_road_png);
+        ui_sprite_layer_set_overflow(&sprites, 32);
+        playerSprite = ui_sprite_add(&sprites, &ui_img_car_png, carX, 160);
+        npcSprite = ui_sprite_add(&sprites, &ui_img_car_green_png, carX + 20, -1);
+    }
+    else
+    {
+        road = lv_image_create(panel);
+        lv_image_set_src(road, &ui_img_road_png);
+        lv_obj_set_size(road, 150, 540);
+        lv_obj_set_align(road, LV_ALIGN_BOTTOM_MID);
+        lv_image_set_inner_align(road, LV_IMAGE_ALIGN_TILE);
+        player = bench_car(screen, &ui_img_car_png, 0, 160);
+        npc = bench_car(screen, &ui_img_car_green_png, 20, -1);
+    }
+    lv_screen_load(screen);
+    lv_refr_now(display);
+
+    flushAreas = 0;
+    flushPixels = 0;
+    for (int i = 0; i < frames; i++)
+    {
+        int32_t x = (i % 60) < 30 ? (i % 60) : 60 - (i % 60); // steer back and forth
+        int32_t roadY = driving ? (i * BENCH_ROAD_STEP) % 270 : 0;
+        int32_t npcY = driving ? (i * 2) % 400 - 110 : -1;
+
+        uint64_t start = now_us();
+        if (layer)
+        {
+            ui_sprite_layer_scroll_to(&sprites, roadY);
+            ui_sprite_move(&sprites, playerSprite, carX + x, 160);
+            ui_sprite_move(&sprites, npcSprite, carX + 20, npcY);
+        }
+        else
+        {
+            lv_obj_set_y(road, roadY);
+            lv_obj_set_x(player, x);
+            lv_obj_set_y(npc, npcY);
+        }
+        lv_refr_now(display);
+        total += now_us() - start;
+    }
+
+    const char *name = driving ? "Racing driving" : "Racing steering";
+    fprintf(csv, "%dx%d,sprites,\"%s\",%s,%d,%.3f,%llu,%.1f,%zu\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display),
+            name, layer ? "layer" : "objects", frames,
+            total / 1000.0 / frames, (unsigned long long)(flushPixels / frames), (double)flushAreas / frames, heap_used());
+    printf("sprite %s %s: %.2fms per frame, %llu px\n", name, layer ? "layer" : "objects",
+           total / 1000.0 / frames, (unsigned long long)(flushPixels / frames));
+
+    lv_screen_load(ui_home);
+    lv_obj_delete(screen);
+}
+#endif
+
+static void bench_collect_app(const char *name, const lv_image_dsc_t *icon, void (*callback)(lv_event_t *e))
+{
+    (void)icon;
+    if (numApps >= BENCH_MAX_APPS)
+    {
+        return;
+    }
+    apps[numApps].name = name;
+    apps[numApps].launch = callback;
+    numApps++;
+}
+
+// face names contain spaces and symbols, keep file names portable
+static void snapshot_file_name(char *out, size_t size, const char *name)
+{
+    size_t j = 0;
+    for (size_t i = 0; name[i] != '\0' && j + 1 < size; i++)
+    {
+        char c = name[i];
+        out[j++] = isalnum((unsigned char)c) ? (char)tolower((unsigned char)c) : '_';
+    }
+    out[j] = '\0';
+}
+
+static bool snapshot_write(const char *path, int32_t w, int32_t h)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+    {
+        return false;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", (int)w, (int)h);
+    for (int32_t i = 0; i < w * h; i++)
+    {
+        uint16_t c = frame[i];
+        uint8_t rgb[3] = {
+            (uint8_t)(((c >> 11) & 0x1F) << 3 | ((c >> 13) & 0x07)),
+            (uint8_t)(((c >> 5) & 0x3F) << 2 | ((c >> 9) & 0x03)),
+            (uint8_t)((c & 0x1F) << 3 | ((c >> 2) & 0x07)),
+        };
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    return true;
+}
+
+// compare against a P6 reference, returns the number of differing pixels or -1 if unusable
+static long snapshot_diff(const char *outPath, const char *refPath, int tolerance, int *maxDelta)
+{
+    FILE *a = fopen(outPath, "rb");
+    FILE *b = fopen(refPath, "rb");
+    long diff = -1;
+    int wa, ha, wb, hb;
+
+    *maxDelta = 0;
+    if (a != NULL && b != NULL &&
+        fscanf(a, "P6 %d %d 255", &wa, &ha) == 2 && fscanf(b, "P6 %d %d 255", &wb, &hb) == 2 &&
+        wa == wb && ha == hb)
+    {
+        // single whitespace byte after the header
+        fgetc(a);
+        fgetc(b);
+        diff = 0;
+        for (long i = 0; i < (long)wa * ha; i++)
+        {
+            bool differs = false;
+            for (int ch = 0; ch < 3; ch++)
+            {
+                int d = abs(fgetc(a) - fgetc(b));
+                if (d > *maxDelta)
+                {
+                    *maxDelta = d;
+                }
+                if (d > tolerance)
+                {
+                    differs = true;
+                }
+            }
+            if (differs)
+            {
+                diff++;
+            }
+        }
+    }
+    if (a != NULL)
+    {
+        fclose(a);
+    }
+    if (b != NULL)
+    {
+        fclose(b);
+    }
+    return diff;
+}
+
+static int env_int(const char *name, int def)
+{
+    const char *value = getenv(name);
+    return (value != NULL && *value != '\0') ? atoi(value) : def;
+}
+
+/*
+ * Render every face at a fixed watch state and compare with the references in
+ * test/golden/<w>x<h>/. SNAPSHOT_UPDATE=1 writes all of them instead. Exits non-zero
+ * if any face differs or has no usable reference.
+ */
+static void snapshot_run(void)
+{
+    lv_display_t *display = lv_display_get_default();
+    int32_t w = lv_display_get_horizontal_resolution(display);
+    int32_t h = lv_display_get_vertical_resolution(display);
+    int tolerance = env_int("SNAPSHOT_TOLERANCE", SNAPSHOT_TOLERANCE);
+    long maxDiff = env_int("SNAPSHOT_MAX_DIFF", SNAPSHOT_MAX_DIFF);
+    bool update = env_int("SNAPSHOT_UPDATE", 0) != 0;
+    int failures = 0;
+    int missing = 0;
+
+    char outDir[64], refDir[64], path[160], ref[160], file[64];
+    snprintf(outDir, sizeof(outDir), "%s/%dx%d", SNAPSHOT_OUT_DIR, (int)w, (int)h);
+    snprintf(refDir, sizeof(refDir), "%s/%dx%d", SNAPSHOT_REF_DIR, (int)w, (int)h);
+    mkdir(SNAPSHOT_OUT_DIR, 0755);
+    mkdir(outDir, 0755);
+    mkdir(SNAPSHOT_REF_DIR, 0755);
+    mkdir(refDir, 0755);
+
+    snprintf(path, sizeof(path), "%s/report.csv", outDir);
+    FILE *report = fopen(path, "w");
+    if (report == NULL)
+    {
+        printf("Failed to open %s\n", path);
+        exit(1);
+    }
+    fprintf(report, "face,render_ms,diff_pixels,max_delta,status\n");
+
+    frame = (uint16_t *)calloc(w * h, sizeof(uint16_t));
+
+    for (int i = 0; i < numFaces; i++)
+    {
+        if (faces[i].watchface == NULL || *faces[i].watchface == NULL)
+        {
+            continue;
+        }
+        ui_home = *faces[i].watchface;
+        lv_screen_load(ui_home);
+        bench_settle(BENCH_SETTLE_MS);
+
+        // same watch state for every face and every run
+        sim_clock_set_time(SNAPSHOT_TIME);
+        ui_update_seconds(SNAPSHOT_TIME % 60);
+        update_home();
+
+        lv_obj_invalidate(ui_home);
+        uint64_t start = now_us();
+        lv_refr_now(display);
+        double renderMs = (now_us() - start) / 1000.0;
+
+        snapshot_file_name(file, sizeof(file), faces[i].name);
+        snprintf(path, sizeof(path), "%s/%s.ppm", outDir, file);
+        snprintf(ref, sizeof(ref), "%s/%s.ppm", refDir, file);
+        snapshot_write(path, w, h);
+
+        const char *status;
+        int maxDelta = 0;
+        long diff = update ? 0 : snapshot_diff(path, ref, tolerance, &maxDelta);
+        if (update)
+        {
+            snapshot_write(ref, w, h);
+            status = "new";
+        }
+        else if (diff < 0)
+        {
+            // a missing or unreadable reference is a failure, not a pass
+            status = "MISSING";
+            missing++;
+            failures++;
+        }
+        else if (diff > maxDiff)
+        {
+            status = "FAIL";
+            failures++;
+        }
+        else
+        {
+            status = "ok";
+        }
+        fprintf(report, "\"%s\",%.3f,%ld,%d,%s\n", faces[i].name, renderMs, diff, maxDelta, status);
+        printf("%-4s %s (%ld px, max delta %d, %.2fms)\n", status, faces[i].name, diff, maxDelta, renderMs);
+    }
+
+    free(frame);
+    frame = NULL;
+    fclose(report);
+
+    printf("%d face(s) differ from %s\n", failures, refDir);
+    if (missing > 0)
+    {
+        printf("%d reference(s) missing or unreadable, run with SNAPSHOT_UPDATE=1 to write them\n", missing);
+    }
+    exit(failures > 0 ? 1 : 0);
+}
+
+static int appsResident = 0;
+static int appsKept = 0;
+
+static void apps_count(const app_usage_t *usage)
+{
+    appsResident += usage->resident;
+    appsKept += usage->kept;
+}
+
+static void apps_report(const app_usage_t *usage)
+{
+    printf("app    %-12s %-8s %3u launches %3u evictions %7zu bytes %7zu peak\n", usage->name,
+           usage->kept ? "kept" : usage->resident ? "resident" : "evicted", usage->launches, usage->evictions,
+           usage->bytes, usage->peak);
+}
+
+static void apps_report_owner(const heap_tag_stats_t *stats)
+{
+    printf("owner  %-12s %7zu live %7zu peak %5u blocks %6u allocs\n", stats->name, stats->live, stats->peak,
+           stats->blocks, stats->allocs);
+}
+
+// opens and closes every app APP_ROUNDS times through the app manager, the kept screens
+// must stay within APP_CACHE_SCREENS plus the ones a suspend hook keeps, and the heap
+// after each pass must not grow once every app was created once
+static void apps_run(void)
+{
+    int rounds = env_int("APP_ROUNDS", APP_ROUNDS);
+    int errors = 0;
+    size_t steadyHeap = 0;
+
+    app_registry_iterate(bench_collect_app);
+    for (int round = 0; round < rounds; round++)
+    {
+        for (int i = 0; i < numApps; i++)
+        {
+            lv_screen_load(ui_gameListScreen);
+            bench_settle(BENCH_SETTLE_MS);
+            apps[i].launch(NULL);
+            bench_settle(BENCH_SETTLE_MS);
+            // straight back without the exit animation, the app screen gets its unload events now
+            lv_screen_load(ui_gameListScreen);
+            bench_settle(BENCH_SETTLE_MS);
+
+            appsResident = 0;
+            appsKept = 0;
+            app_manager_usage(apps_count);
+            if (appsResident > APP_CACHE_SCREENS + appsKept)
+            {
+                printf("apps   %d screens resident after %s, %d kept\n", appsResident, apps[i].name, appsKept);
+                errors++;
+            }
+        }
+
+        size_t heap = heap_used();
+        if (round == 1)
+        {
+            steadyHeap = heap;
+        }
+        else if (round > 1 && heap > steadyHeap + APP_HEAP_SLACK)
+        {
+            printf("apps   heap grew by %zu bytes in pass %d\n", heap - steadyHeap, round + 1);
+            errors++;
+        }
+        printf("apps   pass %d, %zu bytes in use\n", round + 1, heap);
+    }
+
+    app_manager_usage(apps_report);
+    heap_tags_iterate(apps_report_owner);
+    printf("apps   %d apps, %d passes, %d errors\n", numApps, rounds, errors);
+    exit(errors > 0 ? 1 : 0);
+}
+
+typedef struct
+{
+    const char *name;
+    uint16_t rate;
+    imu_stream_filter_t filter;
+    uint32_t samples;
+    uint32_t lastUs;
+} SensorCheck;
+
+static SensorCheck sensorChecks[] = {
+    {"raw", 1000, IMU_STREAM_DECIMATE, 0, 0},
+    {"decimate", 10, IMU_STREAM_DECIMATE, 0, 0},
+    {"average", 25, IMU_STREAM_AVERAGE, 0, 0},
+    {"low pass", 50, IMU_STREAM_LOW_PASS, 0, 0},
+};
+static uint32_t sensorErrors;
+static bool sensorFlat;
+
+static void sensor_check(const imu_sample_t *samples, uint16_t count, void *user)
+{
+    SensorCheck *check = (SensorCheck *)user;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (check->samples > 0 && (int32_t)(samples[i].time_us - check->lastUs) <= 0)
+        {
+            sensorErrors++;
+        }
+        // at rest every filter has to give 1g straight down
+        if (sensorFlat && (samples[i].az < 0.999f || samples[i].az > 1.001f))
+        {
+            sensorErrors++;
+        }
+        check->lastUs = samples[i].time_us;
+        check->samples++;
+    }
+}
+
+// the sensor service against the replay backend on the virtual clock: with irregular
+// loop times every stream must get its rate, in order, and nothing may be dropped
+static void sensors_run(void)
+{
+    const int numChecks = sizeof(sensorChecks) / sizeof(sensorChecks[0]);
+    int streams[numChecks];
+    uint32_t seed = 1;
+    sensorErrors = 0;
+    sensorFlat = getenv("SENSOR_CSV") == NULL;
+    // only the streams under test, the sensor has to stop once they close
+    activity_stop();
+    wrist_wake_stop();
+
+    for (int i = 0; i < numChecks; i++)
+    {
+        streams[i] = imu_stream_open(sensorChecks[i].rate, sensorChecks[i].filter, sensor_check, &sensorChecks[i]);
+    }
+
+    uint32_t start = sim_clock_ms();
+    uint32_t polls = 0;
+    while (sim_clock_ms() - start < SENSOR_CHECK_MS)
+    {
+        uint32_t wait = sensor_service_poll();
+        polls++;
+        // the loop wakes up late or early, as it does with other work due
+        seed = seed * 1103515245 + 12345;
+        sim_clock_advance(wait > 0 ? 1 + (seed >> 16) % (2 * wait) : 1);
+    }
+    sensor_service_poll();
+    uint32_t elapsed = sim_clock_ms() - start;
+
+    uint16_t odr = sensor_service_odr();
+    for (int i = 0; i < numChecks; i++)
+    {
+        SensorCheck *check = &sensorChecks[i];
+        uint32_t rate = check->rate < odr ? check->rate : odr;
+        uint32_t expected = (uint64_t)elapsed * rate / 1000;
+        // samples of the last burst may still sit in the sensor or wait for their latency
+        uint32_t slack = 1 + (SENSOR_LATENCY_MS * 2 * rate + 999) / 1000;
+        if (check->samples + slack < expected || check->samples > expected + 1)
+        {
+            sensorErrors++;
+        }
+        printf("sensor %-8s %4uHz %5u samples (expected %u)\n", check->name, (unsigned)rate, check->samples,
+               expected);
+        imu_stream_close(streams[i]);
+    }
+
+    imu_sample_t batch[SENSOR_HISTORY];
+    if (get_imu_batch(batch, SENSOR_HISTORY) != SENSOR_HISTORY || sensor_service_dropped() != 0 ||
+        sensor_service_poll() != UINT32_MAX)
+    {
+        sensorErrors++;
+    }
+
+    printf("sensor %u polls in %ums, %u dropped, %u errors\n", polls, elapsed, sensor_service_dropped(), sensorErrors);
+    exit(sensorErrors > 0 ? 1 : 0);
+}
+
+#ifdef ENABLE_LATENCY
+static lv_indev_data_t latencyTouch; // the virtual finger
+static bool latencyHost;             // add the host time spent since the last step
+static uint64_t latencyStepAt;
+static uint32_t latencyErrors;
+static lv_obj_t *latencyMover;
+
+static void latency_touch_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    LV_UNUSED(indev);
+    data->point = latencyTouch.point;
+    data->state = latencyTouch.state;
+}
+
+// virtual time between loop passes, plus the host time inside the current one
+static uint64_t latency_clock(void)
+{
+    uint64_t us = (uint64_t)sim_clock_ms() * 1000;
+    return latencyHost ? us + (now_us() - latencyStepAt) : us;
+}
+
+// the UI loop for ms of virtual time, sleeping until the next timer is due like hal_loop
+static void latency_loop(uint32_t ms)
+{
+    uint32_t end = sim_clock_ms() + ms;
+    while ((int32_t)(end - sim_clock_ms()) > 0)
+    {
+        uint32_t wait = lv_timer_handler();
+        uint32_t left = end - sim_clock_ms();
+        sim_clock_advance(wait == 0 ? 1 : wait < left ? wait : left);
+        latencyStepAt = now_us();
+    }
+}
+
+static void latency_tap(int32_t x, int32_t y)
+{
+    latencyTouch.point.x = x;
+    latencyTouch.point.y = y;
+    latencyTouch.state = LV_INDEV_STATE_PRESSED;
+    latency_loop(100);
+    latencyTouch.state = LV_INDEV_STATE_RELEASED;
+    latency_loop(BENCH_SETTLE_MS);
+}
+
+// a finger moving every LATENCY_MOVE_MS, faster than the touch is read
+static void latency_swipe(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    int steps = LATENCY_SWIPE_MS / LATENCY_MOVE_MS;
+    latencyTouch.state = LV_INDEV_STATE_PRESSED;
+    for (int i = 0; i <= steps; i++)
+    {
+        latencyTouch.point.x = x1 + (x2 - x1) * i / steps;
+        latencyTouch.point.y = y1 + (y2 - y1) * i / steps;
+        latency_loop(LATENCY_MOVE_MS);
+    }
+    latencyTouch.state = LV_INDEV_STATE_RELEASED;
+    latency_loop(BENCH_SETTLE_MS);
+}
+
+static latency_stats_t latencyLast;
+
+static void latency_last(const latency_stats_t *stats)
+{
+    latencyLast = *stats;
+}
+
+static void latency_expect(const char *name, bool ok)
+{
+    if (!ok)
+    {
+        printf("latency FAILED: %s (%u events, %u unchanged, max %uus)\n", name, latencyLast.count,
+               latencyLast.unchanged, latencyLast.max_us);
+        latencyErrors++;
+    }
+}
+
+// one check on a fresh histogram, the check screen is the only one touched
+static void latency_check(const char *name, void (*gesture)(void), uint32_t count, uint32_t unchanged,
+                          uint32_t min_us, uint32_t max_us)
+{
+    latency_reset();
+    gesture();
+    memset(&latencyLast, 0, sizeof(latencyLast));
+    latency_iterate(latency_last);
+    latency_expect(name, latencyLast.count == count && latencyLast.unchanged == unchanged &&
+                             (count == 0 || (latencyLast.p50_us >= min_us && latencyLast.max_us <= max_us)));
+}
+
+static void latency_tick(lv_timer_t *timer)
+{
+    lv_obj_t *label = (lv_obj_t *)lv_timer_get_user_data(timer);
+    lv_label_set_text_fmt(label, "%u", (unsigned)sim_clock_ms());
+}
+
+static void latency_move(void *obj, int32_t x)
+{
+    lv_obj_set_x((lv_obj_t *)obj, x);
+}
+
+static void latency_clicked(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, latencyMover);
+    lv_anim_set_exec_cb(&a, latency_move);
+    lv_anim_set_values(&a, lv_obj_get_x(latencyMover), lv_obj_get_x(latencyMover) + 40);
+    lv_anim_set_duration(&a, 200);
+    lv_anim_set_delay(&a, LATENCY_ANIM_DELAY_MS);
+    lv_anim_set_early_apply(&a, false);
+    lv_anim_start(&a);
+}
+
+static lv_obj_t *latency_box(lv_obj_t *parent, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    lv_obj_t *box = lv_obj_create(parent);
+    lv_obj_remove_style_all(box);
+    lv_obj_set_pos(box, x, y);
+    lv_obj_set_size(box, w, h);
+    lv_obj_set_style_bg_opa(box, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(box, lv_color_hex(0x202020), 0);
+    return box;
+}
+
+static void latency_press_box(void)
+{
+    latency_tap(SDL_HOR_RES / 4, SDL_VER_RES / 4);
+}
+
+static void latency_press_nothing(void)
+{
+    latency_tap(SDL_HOR_RES / 2, SDL_VER_RES * 7 / 8);
+}
+
+static void latency_press_animated(void)
+{
+    latency_tap(SDL_HOR_RES * 3 / 4, SDL_VER_RES / 8);
+}
+
+static void latency_scroll_list(void)
+{
+    latency_swipe(SDL_HOR_RES / 2, SDL_VER_RES * 3 / 4 - 4, SDL_HOR_RES / 2, SDL_VER_RES / 2 + 4);
+}
+
+// a screen with known answers on the virtual clock only: a restyled box shows on the
+// next refresh, a tap on nothing is not measured while a timer redraws elsewhere, an
+// animation started with a delay counts from the tap, a dragged list on every move
+static void latency_checks(void)
+{
+    const uint32_t frame = LV_DEF_REFR_PERIOD * 1000;
+    lv_obj_t *screen = lv_obj_create(NULL);
+    lv_obj_remove_style_all(screen);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(screen, lv_color_black(), 0);
+    heap_tag_bind_screen(screen, heap_tag_get("Latency check"));
+
+    lv_obj_t *pressBox = latency_box(screen, 0, 0, SDL_HOR_RES / 2, SDL_VER_RES / 2);
+    lv_obj_set_style_bg_color(pressBox, lv_color_white(), LV_STATE_PRESSED);
+
+    lv_obj_t *animBox = latency_box(screen, SDL_HOR_RES / 2, 0, SDL_HOR_RES / 2, SDL_VER_RES / 4);
+    lv_obj_add_event_cb(animBox, latency_clicked, LV_EVENT_CLICKED, NULL);
+    latencyMover = latency_box(screen, SDL_HOR_RES / 2, SDL_VER_RES / 4 + 4, 20, 20);
+
+    lv_obj_t *list = latency_box(screen, 0, SDL_VER_RES / 2, SDL_HOR_RES, SDL_VER_RES / 4);
+    lv_obj_set_scroll_dir(list, LV_DIR_VER);
+    lv_obj_add_flag(list, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_remove_flag(list, LV_OBJ_FLAG_SCROLL_ELASTIC);
+    lv_obj_remove_flag(list, LV_OBJ_FLAG_SCROLL_MOMENTUM);
+    for (int i = 0; i < 8; i++)
+    {
+        lv_obj_t *row = latency_box(list, 0, i * 30, SDL_HOR_RES, 26);
+        lv_obj_remove_flag(row, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_set_style_bg_color(row, lv_color_hex(0x404040 + i * 0x101010), 0);
+    }
+
+    lv_obj_t *ticker = lv_label_create(screen);
+    lv_obj_align(ticker, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_timer_t *tick = lv_timer_create(latency_tick, 10, ticker);
+
+    lv_screen_load(screen);
+    latencyHost = false;
+    latency_loop(BENCH_SETTLE_MS);
+
+    latency_check("restyle", latency_press_box, 2, 0, 0, frame);
+    latency_check("nothing", latency_press_nothing, 0, 2, 0, 0);
+    latency_check("animation", latency_press_animated, 1, 1, LATENCY_ANIM_DELAY_MS * 1000,
+                  LATENCY_ANIM_DELAY_MS * 1000 + 2 * frame);
+    latency_reset();
+    latency_scroll_list();
+    memset(&latencyLast, 0, sizeof(latencyLast));
+    latency_iterate(latency_last);
+    latency_expect("scroll", latencyLast.count > 0 && latencyLast.max_us <= frame);
+
+    lv_timer_delete(tick);
+    lv_screen_load(ui_home);
+    latency_loop(BENCH_SETTLE_MS);
+    lv_obj_delete(screen);
+}
+
+static void latency_print(const latency_stats_t *stats)
+{
+    if (stats->count == 0)
+    {
+        printf("latency %-14s %4u events, %3u unchanged\n", stats->screen, stats->count, stats->unchanged);
+        return;
+    }
+    printf("latency %-14s %4u events, %3u unchanged, p50 %6.2fms p90 %6.2fms p99 %6.2fms max %6.2fms mean %6.2fms\n",
+           stats->screen, stats->count, stats->unchanged, stats->p50_us / 1000.0, stats->p90_us / 1000.0,
+           stats->p99_us / 1000.0, stats->max_us / 1000.0, stats->total_us / 1000.0 / stats->count);
+}
+
+// taps and swipes on a screen, loaded again whenever one of them navigated away
+static void latency_screen(lv_obj_t *screen)
+{
+    const int32_t w = SDL_HOR_RES;
+    const int32_t h = SDL_VER_RES;
+    for (int i = 0; i < LATENCY_GESTURES; i++)
+    {
+        if (lv_screen_active() != screen)
+        {
+            lv_screen_load(screen);
+            latency_loop(BENCH_SETTLE_MS);
+        }
+        switch (i % 5)
+        {
+        case 0:
+            latency_tap(w / 2, h / 2);
+            break;
+        case 1:
+            latency_tap(w / 2, h / 4 + i % 3 * h / 8);
+            break;
+        case 2:
+            latency_swipe(w / 2, h * 3 / 4, w / 2, h / 4);
+            break;
+        case 3:
+            latency_swipe(w / 2, h / 4, w / 2, h * 3 / 4);
+            break;
+        default:
+            latency_swipe(w / 8, h / 2, w * 7 / 8, h / 2);
+            break;
+        }
+    }
+}
+
+// the checks on the virtual clock, then taps and swipes on the watchface and the
+// built-in screens with the host time spent in LVGL included
+static void latency_run(void)
+{
+    lv_indev_t *touch = lv_indev_create();
+    lv_indev_set_type(touch, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(touch, latency_touch_read);
+    latencyTouch.state = LV_INDEV_STATE_RELEASED;
+    latency_init(latency_clock);
+    latency_attach(lv_display_get_default(), touch);
+
+    latencyErrors = 0;
+    latency_checks();
+
+    static const char *targets[] = {"App List", "Game List", "Settings", "Notifications", "Control"};
+    if (heap_tag_screen_name(ui_home) == NULL)
+    {
+        heap_tag_bind_screen(ui_home, heap_tag_get("Home"));
+    }
+    latency_reset();
+    latencyHost = true;
+    latency_screen(ui_home);
+    for (size_t i = 0; i < sizeof(screens) / sizeof(screens[0]); i++)
+    {
+        for (size_t j = 0; j < sizeof(targets) / sizeof(targets[0]); j++)
+        {
+            lv_obj_t *screen = strcmp(screens[i].name, targets[j]) == 0 ? ui_screen_get(screens[i].screen) : NULL;
+            if (screen != NULL)
+            {
+                latency_screen(screen);
+            }
+        }
+    }
+    latency_iterate(latency_print);
+    printf("latency %u dropped, %u errors\n", latency_dropped(), latencyErrors);
+    exit(latencyErrors > 0 ? 1 : 0);
+}
+#else
+static void latency_run(void)
+{
+    printf("latency needs -D ENABLE_LATENCY=1 (env:linux_bench_latency)\n");
+    exit(1);
+}
+#endif
+
+// the UI loop of hal_loop on the virtual clock until the script ran out
+static void replay_run(void)
+{
+    if (!input_replay_active())
+    {
+        printf("replay needs INPUT_REPLAY=<script>, see test/replay\n");
+        exit(1);
+    }
+    while (!input_replay_done())
+    {
+        loop_sched_begin(sim_clock_ms());
+        loop_sched_add_delay(input_replay_poll());
+        loop_sched_add_delay(lv_timer_handler());
+        loop_sched_add_delay(sensor_service_poll());
+        ui_thread_drain();
+        update_home();
+        loop_sched_add_delay(ui_games_update());
+        loop_sched_add_delay(input_bus_dispatch());
+        input_replay_pass_end();
+        sim_clock_advance(loop_sched_end(sim_clock_ms()));
+    }
+    exit(input_replay_report() > 0 ? 1 : 0);
+}
+
+void bench_run(void)
+{
+    const char *mode = getenv("BENCH_MODE");
+    if (mode != NULL && strcmp(mode, "snapshot") == 0)
+    {
+        snapshot_run();
+        return;
+    }
+    if (mode != NULL && strcmp(mode, "apps") == 0)
+    {
+        apps_run();
+        return;
+    }
+    if (mode != NULL && strcmp(mode, "sensors") == 0)
+    {
+        sensors_run();
+        return;
+    }
+    if (mode != NULL && strcmp(mode, "latency") == 0)
+    {
+        latency_run();
+        return;
+    }
+    if (mode != NULL && strcmp(mode, "replay") == 0)
+    {
+        replay_run();
+        return;
+    }
+
+    char path[64];
+    const char *csvPath = getenv("BENCH_CSV");
+    const char *framesEnv = getenv("BENCH_FRAMES");
+
+    if (framesEnv != NULL && atoi(framesEnv) > 0)
+    {
+        frames = atoi(framesEnv);
+    }
+    if (csvPath == NULL)
+    {
+        snprintf(path, sizeof(path), "bench_%dx%d.csv", SDL_HOR_RES, SDL_VER_RES);
+        csvPath = path;
+    }
+
+    csv = fopen(csvPath, "w");
+    if (csv == NULL)
+    {
+        printf("Failed to open %s\n", csvPath);
+        return;
+    }
+    fprintf(csv, "resolution,kind,name,mode,frames,ms_per_frame,pixels_per_frame,areas_per_frame,heap_used\n");
+    bench_boot();
+
+    // watchfaces
+    for (int i = 0; i < numFaces; i++)
+    {
+        if (faces[i].watchface == NULL || *faces[i].watchface == NULL)
+        {
+            continue;
+        }
+        ui_home = *faces[i].watchface;
+        lv_screen_load(ui_home);
+        update_home();
+        bench_settle(BENCH_SETTLE_MS);
+        bench_target("face", faces[i].name, true);
+    }
+
+    // built-in screens
+    for (size_t i = 0; i < sizeof(screens) / sizeof(screens[0]); i++)
+    {
+        // builds screens that are created on first navigation
+        if (ui_screen_get(screens[i].screen) == NULL)
+        {
+            continue;
+        }
+        lv_screen_load(*screens[i].screen);
+        bench_settle(BENCH_SETTLE_MS);
+        bench_target("screen", screens[i].name, false);
+    }
+
+    bench_styles(false);
+    bench_styles(true);
+
+    static const int listItems[] = {10, 100, 1000};
+    for (size_t i = 0; i < sizeof(listItems) / sizeof(listItems[0]); i++)
+    {
+        bench_list(listItems[i], false);
+        bench_list(listItems[i], true);
+    }
+
+    static const int scrollItems[] = {10, 50, 200};
+    for (size_t i = 0; i < sizeof(scrollItems) / sizeof(scrollItems[0]); i++)
+    {
+        bench_scroll(scrollItems[i], true);
+        bench_scroll(scrollItems[i], false);
+    }
+
+    for (size_t i = 0; i < sizeof(transitions) / sizeof(transitions[0]); i++)
+    {
+        bench_transition(&transitions[i], false);
+        bench_transition(&transitions[i], true);
+    }
+
+#ifdef ENABLE_GAME_RACING
+    bench_sprites(true, false);
+    bench_sprites(true, true);
+    bench_sprites(false, false);
+    bench_sprites(false, true);
+#endif
+
+    // registered apps, ui_app_load only launches from the game list
+    app_registry_iterate(bench_collect_app);
+    for (int i = 0; i < numApps; i++)
+    {
+        lv_screen_load(ui_gameListScreen);
+        bench_settle(BENCH_SETTLE_MS);
+        apps[i].launch(NULL);
+        bench_settle(BENCH_SETTLE_MS);
+
+        if (lv_display_get_screen_active(lv_display_get_default()) == ui_gameListScreen)
+        {
+            continue;
+        }
+        bench_target("app", apps[i].name, false);
+    }
+    lv_screen_load(ui_gameListScreen);
+    bench_settle(BENCH_SETTLE_MS);
+
+    fclose(csv);
+    printf("Benchmark written to %s\n", csvPath);
+}
+
+#endif
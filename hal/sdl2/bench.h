@@ -0,0 +1,74 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Headless render benchmark, built with -D SIM_HEADLESS (env:linux_bench*).
+ *
+ * Renders every registered watchface, built-in screen and app on an offscreen
+ * display and writes one CSV row per target and redraw mode. The "list" rows time
+ * opening a notification list of 10, 100 and 1000 items up to the first frame,
+ * once with a row per item (create) and once recycled (virtual); their heap_used
+ * column is the heap the rows took. The "scroll" rows scroll lists of 10, 50 and
+ * 200 rows by BENCH_SCROLL_STEP pixels per frame, once with the pre-table onScroll
+ * that places every row (legacy) and once with onScroll (current). The
+ * "transition" rows time each screen load animation with live screens and with
+ * a snapshot of the outgoing one; heap_used is what the load allocated while it runs.
+ * The "sprites" rows draw the racing scene with a tiled road image and one lv_image
+ * per car (objects) and with a sprite layer (layer), scrolling the road (driving) and
+ * with only the player moving (steering).
+ * The "styles" rows build 50 notifications with local styles on every row (local) and
+ * with the shared ui_theme styles (shared); heap_used is the heap the rows took.
+ * The "boot" row covers ui_init up to the first rendered frame.
+ *   BENCH_CSV=<path>      output file (default bench_<w>x<h>.csv)
+ *   BENCH_FRAMES=<n>      frames per measurement (default 20)
+ *
+ * BENCH_MODE=snapshot renders every watchface at a fixed watch state instead and
+ * diffs it with the PPM references in test/golden/<w>x<h>/, a missing one fails.
+ *   SNAPSHOT_TOLERANCE=<n> per channel difference treated as equal (default 8)
+ *   SNAPSHOT_MAX_DIFF=<n>  differing pixels allowed per face (default 0)
+ *   SNAPSHOT_UPDATE=1      write the references
+ *
+ * BENCH_MODE=apps opens and closes every registered app in a loop through the app
+ * manager, checks that closed app screens are evicted down to APP_CACHE_SCREENS and
+ * that the heap stops growing after the first pass, prints the per-app heap report and
+ * the LVGL heap per owner (see heap_tags.h), and exits non-zero on errors.
+ *   APP_ROUNDS=<n>         passes over all apps (default 5)
+ *
+ * BENCH_MODE=sensors opens IMU streams at several rates and filters on the replay
+ * backend (sensor_replay.h) and polls the sensor service at irregular intervals on the
+ * virtual clock. It checks the sample counts and order, that the watch at rest reads
+ * 1g (without SENSOR_CSV) and that nothing was dropped, and exits non-zero on errors.
+ *
+ * BENCH_MODE=latency (built with -D ENABLE_LATENCY=1, env:linux_bench_latency) taps
+ * and drags a virtual pointer. On a check screen it expects a restyle on the next
+ * refresh, no result for a tap on nothing while a timer redraws, a delayed animation
+ * measured from the tap and a dragged list on every move, on the virtual clock. Then
+ * it taps and swipes on the watchface and the built-in screens and prints the
+ * latency.h percentiles per screen: virtual time between loop passes plus the host
+ * time spent in LVGL. Exits non-zero on errors.
+ *
+ * BENCH_MODE=replay runs the UI loop of the emulator on the virtual clock while
+ * INPUT_REPLAY plays a script (input_replay.h, scripts in test/replay), prints the frame
+ * times per mark and writes REPLAY_CSV. Exits non-zero on script errors.
+ */
+
+// offscreen display with a flush callback that only counts areas and pixels
+lv_display_t *bench_display_create(int32_t hor_res, int32_t ver_res);
+
+// mark the start of ui_init, bench_run reports the time and heap up to the first frame
+void bench_boot_start(void);
+
+// run all measurements and write the CSV
+void bench_run(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*BENCH_H*/
@@ -0,0 +1,879 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include SDL_INCLUDE_PATH
+
+#include "input_replay.h"
+#include "sim_clock.h"
+#include "indev/lv_indev_private.h"
+#include "common/input_bus/input_bus.h"
+#include "common/heap_tags/heap_tags.h"
+
+#define REPLAY_LINE 160
+#define REPLAY_FIELDS 8
+#define REPLAY_DEPTH 4     // nested repeat blocks
+#define REPLAY_SECTIONS 32 // marks with their own report line, later ones share the last
+#define REPLAY_INDEVS 4
+
+typedef enum
+{
+    CMD_WAIT,
+    CMD_TOUCH,
+    CMD_WHEEL,
+    CMD_KEY,
+    CMD_ENCODER,
+    CMD_BUTTON,
+    CMD_TAP,
+    CMD_HOLD,
+    CMD_SWIPE,
+    CMD_TAP_TEXT,
+    CMD_EXPECT,
+    CMD_MARK,
+} replay_op_t;
+
+typedef struct
+{
+    uint32_t delay_ms;
+    replay_op_t op;
+    int32_t args[5];
+    const char *text; // tap_text, expect and mark
+    bool optional;
+    int line;
+} replay_cmd_t;
+
+typedef struct
+{
+    uint32_t t_ms;
+    uint32_t us;
+    uint32_t pixels;
+    uint8_t section;
+    const char *screen;
+} replay_frame_t;
+
+typedef struct
+{
+    lv_indev_t *indev;
+    lv_indev_read_cb_t read;
+    lv_indev_data_t last;
+} recorded_indev_t;
+
+static const char *scriptPath = NULL;
+static replay_cmd_t *cmds = NULL;
+static int numCmds = 0;
+static int cmdCapacity = 0;
+static uint32_t errors = 0;
+
+// --- Recording ---
+static FILE *recordFile = NULL;
+static uint32_t recordedAt = 0;
+static recorded_indev_t recorded[REPLAY_INDEVS];
+
+static void record_line(const char *fmt, ...)
+{
+    uint32_t now = sim_clock_ms();
+    fprintf(recordFile, "%u,", (unsigned)(now - recordedAt));
+    recordedAt = now;
+
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(recordFile, fmt, args);
+    va_end(args);
+    fputc('\n', recordFile);
+}
+
+static recorded_indev_t *record_find(lv_indev_t *indev)
+{
+    for (int i = 0; i < REPLAY_INDEVS; i++)
+    {
+        if (recorded[i].indev == indev)
+        {
+            return &recorded[i];
+        }
+    }
+    return NULL;
+}
+
+// only what changes is written, a replayed device keeps its state between lines
+static void record_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    recorded_indev_t *r = record_find(indev);
+    if (r == NULL)
+    {
+        return;
+    }
+    r->read(indev, data);
+
+    bool changed = data->state != r->last.state;
+    switch (lv_indev_get_type(indev))
+    {
+    case LV_INDEV_TYPE_POINTER:
+        if (changed || (data->state == LV_INDEV_STATE_PRESSED &&
+                        (data->point.x != r->last.point.x || data->point.y != r->last.point.y)))
+        {
+            record_line("touch,%d,%d,%d", (int)data->point.x, (int)data->point.y, data->state == LV_INDEV_STATE_PRESSED);
+        }
+        break;
+    case LV_INDEV_TYPE_ENCODER:
+        if (changed || data->enc_diff != 0)
+        {
+            record_line("wheel,%d,%d", (int)data->enc_diff, data->state == LV_INDEV_STATE_PRESSED);
+        }
+        break;
+    case LV_INDEV_TYPE_KEYPAD:
+        if (changed || data->key != r->last.key)
+        {
+            record_line("key,%u,%d", (unsigned)data->key, data->state == LV_INDEV_STATE_PRESSED);
+        }
+        break;
+    default:
+        break;
+    }
+    r->last = *data;
+}
+
+static void record_encoder(long position, int32_t change)
+{
+    LV_UNUSED(change);
+    record_line("encoder,%ld", position);
+}
+
+static void record_button(bool pressed)
+{
+    record_line("button,%d", pressed);
+}
+
+static void record_close(void)
+{
+    if (recordFile != NULL)
+    {
+        fclose(recordFile);
+        recordFile = NULL;
+    }
+}
+
+static void record_start(const char *path, lv_display_t *display)
+{
+    recordFile = fopen(path, "w");
+    if (recordFile == NULL)
+    {
+        printf("input record: cannot open %s\n", path);
+        return;
+    }
+    fprintf(recordFile, "# recorded at %dx%d, replay with INPUT_REPLAY=%s\n",
+            (int)lv_display_get_horizontal_resolution(display), (int)lv_display_get_vertical_resolution(display), path);
+    recordedAt = sim_clock_ms();
+    input_bus_add_encoder_sub(record_encoder);
+    input_bus_add_button_sub(record_button);
+    atexit(record_close);
+    printf("input record: writing %s\n", path);
+}
+
+// --- Script ---
+static replay_cmd_t *script_add(void)
+{
+    if (numCmds == cmdCapacity)
+    {
+        cmdCapacity = cmdCapacity > 0 ? cmdCapacity * 2 : 256;
+        cmds = (replay_cmd_t *)realloc(cmds, cmdCapacity * sizeof(replay_cmd_t));
+    }
+    replay_cmd_t *cmd = &cmds[numCmds++];
+    memset(cmd, 0, sizeof(*cmd));
+    return cmd;
+}
+
+static void script_error(int line, const char *what, const char *field)
+{
+    printf("input replay: %s:%d: %s %s\n", scriptPath, line, what, field);
+    errors++;
+}
+
+typedef struct
+{
+    const char *name;
+    replay_op_t op;
+    int min_args;
+    int max_args;
+} replay_syntax_t;
+
+static const replay_syntax_t syntax[] = {
+    {"touch", CMD_TOUCH, 3, 3},
+    {"wheel", CMD_WHEEL, 2, 2},
+    {"key", CMD_KEY, 2, 2},
+    {"encoder", CMD_ENCODER, 1, 1},
+    {"button", CMD_BUTTON, 1, 1},
+    {"tap", CMD_TAP, 2, 2},
+    {"hold", CMD_HOLD, 3, 3},
+    {"swipe", CMD_SWIPE, 4, 5},
+    {"tap_text", CMD_TAP_TEXT, 1, 2},
+    {"expect", CMD_EXPECT, 1, 1},
+    {"mark", CMD_MARK, 1, 1},
+};
+
+static void script_parse(char **fields, int count, uint32_t delay, int line)
+{
+    const replay_syntax_t *s = NULL;
+    for (size_t i = 0; i < sizeof(syntax) / sizeof(syntax[0]); i++)
+    {
+        if (strcmp(fields[0], syntax[i].name) == 0)
+        {
+            s = &syntax[i];
+        }
+    }
+    if (s == NULL)
+    {
+        script_error(line, "unknown command", fields[0]);
+        return;
+    }
+    if (count - 1 < s->min_args || count - 1 > s->max_args)
+    {
+        script_error(line, "wrong number of arguments for", fields[0]);
+        return;
+    }
+
+    replay_cmd_t *cmd = script_add();
+    cmd->delay_ms = delay;
+    cmd->op = s->op;
+    cmd->line = line;
+    if (s->op == CMD_TAP_TEXT || s->op == CMD_EXPECT || s->op == CMD_MARK)
+    {
+        cmd->text = strdup(fields[1]);
+        cmd->optional = count > 2 && strcmp(fields[2], "optional") == 0;
+        return;
+    }
+    for (int i = 1; i < count; i++)
+    {
+        cmd->args[i - 1] = (int32_t)strtol(fields[i], NULL, 10);
+    }
+    if (s->op == CMD_SWIPE && count == 5)
+    {
+        cmd->args[4] = REPLAY_SWIPE_MS;
+    }
+}
+
+static void script_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        printf("input replay: cannot open %s\n", path);
+        errors++;
+        return;
+    }
+    scriptPath = path;
+
+    // start of each open repeat block and its count
+    int blockStart[REPLAY_DEPTH];
+    int blockCount[REPLAY_DEPTH];
+    int depth = 0;
+
+    char text[REPLAY_LINE];
+    int line = 0;
+    while (fgets(text, sizeof(text), f) != NULL)
+    {
+        line++;
+        text[strcspn(text, "\r\n")] = '\0';
+        char *p = text;
+        while (isspace((unsigned char)*p))
+        {
+            p++;
+        }
+        if (*p == '\0' || *p == '#')
+        {
+            continue;
+        }
+
+        char *fields[REPLAY_FIELDS];
+        int count = 0;
+        for (char *field = strtok(p, ","); field != NULL && count < REPLAY_FIELDS; field = strtok(NULL, ","))
+        {
+            fields[count++] = field;
+        }
+        uint32_t delay = 0;
+        if (isdigit((unsigned char)fields[0][0]))
+        {
+            delay = (uint32_t)strtoul(fields[0], NULL, 10);
+            for (int i = 1; i < count; i++)
+            {
+                fields[i - 1] = fields[i];
+            }
+            count--;
+        }
+        if (count == 0 || strcmp(fields[0], "repeat") == 0 || strcmp(fields[0], "end") == 0)
+        {
+            // a delay on its own, or on a block line, is a wait
+            if (delay > 0 || count == 0)
+            {
+                replay_cmd_t *wait = script_add();
+                wait->delay_ms = delay;
+                wait->op = CMD_WAIT;
+                wait->line = line;
+            }
+            if (count == 0)
+            {
+                continue;
+            }
+        }
+
+        if (strcmp(fields[0], "repeat") == 0)
+        {
+            if (depth == REPLAY_DEPTH || count != 2)
+            {
+                script_error(line, "bad or too deeply nested", "repeat");
+                continue;
+            }
+            blockStart[depth] = numCmds;
+            blockCount[depth] = atoi(fields[1]);
+            depth++;
+        }
+        else if (strcmp(fields[0], "end") == 0)
+        {
+            if (depth == 0)
+            {
+                script_error(line, "no repeat for", "end");
+                continue;
+            }
+            depth--;
+            int start = blockStart[depth];
+            int length = numCmds - start;
+            if (blockCount[depth] <= 0)
+            {
+                numCmds = start;
+            }
+            for (int n = 1; n < blockCount[depth]; n++)
+            {
+                for (int i = 0; i < length; i++)
+                {
+                    // script_add may move the array
+                    replay_cmd_t copy = cmds[start + i];
+                    *script_add() = copy;
+                }
+            }
+        }
+        else
+        {
+            script_parse(fields, count, delay, line);
+        }
+    }
+    fclose(f);
+    if (depth > 0)
+    {
+        script_error(line, "missing end for", "repeat");
+    }
+}
+
+// --- Replay devices ---
+static bool replaying = false;
+static lv_indev_t *replayTouch = NULL;
+static lv_indev_t *replayWheel = NULL;
+static lv_indev_t *replayKeys = NULL;
+
+static lv_point_t touchPoint;
+static bool touchPressed = false;
+static int32_t wheelDiff = 0;
+static bool wheelPressed = false;
+static uint32_t keyCode = 0;
+static bool keyPressed = false;
+
+static void replay_touch_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    LV_UNUSED(indev);
+    data->point = touchPoint;
+    data->state = touchPressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static void replay_wheel_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    LV_UNUSED(indev);
+    data->enc_diff = (int16_t)wheelDiff;
+    data->state = wheelPressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    wheelDiff = 0;
+}
+
+static void replay_keys_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    LV_UNUSED(indev);
+    data->key = keyCode;
+    data->state = keyPressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static lv_indev_t *replay_indev(lv_display_t *display, lv_indev_type_t type, lv_indev_read_cb_t read)
+{
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, type);
+    lv_indev_set_read_cb(indev, read);
+    lv_indev_set_display(indev, display);
+    return indev;
+}
+
+// --- Replay ---
+static int cmdIndex = 0;
+static uint32_t startedAt = 0;
+static uint32_t lastEnd = 0; // when the line before finished, delays count from here
+static uint32_t liftedAt = 0;
+static bool finished = false;
+
+// the finger of tap, hold, swipe and tap_text
+static bool gestureActive = false;
+static uint32_t gestureStart = 0;
+static uint32_t gestureMs = 0;     // pressed this long
+static uint32_t gestureTravel = 0; // moving this long, the end point is held for a move more
+static lv_point_t gestureFrom;
+static lv_point_t gestureTo;
+
+// tap_text scrolling its label into view
+static lv_obj_t *textTarget = NULL;
+static const replay_cmd_t *textCmd = NULL;
+static uint32_t textAt = 0;
+
+static const char *sections[REPLAY_SECTIONS] = {"start"};
+static uint8_t numSections = 1;
+static uint8_t section = 0;
+
+// a finger put down right after lifting would not be read as lifted
+static void replay_gesture(uint32_t start, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t ms)
+{
+    if ((int32_t)(liftedAt + REPLAY_TAP_MS - start) > 0)
+    {
+        start = liftedAt + REPLAY_TAP_MS;
+    }
+    bool moving = x1 != x2 || y1 != y2;
+    gestureActive = true;
+    gestureStart = start;
+    gestureTravel = ms > 0 ? ms : 1;
+    gestureMs = moving ? gestureTravel + REPLAY_MOVE_MS : gestureTravel;
+    gestureFrom.x = x1;
+    gestureFrom.y = y1;
+    gestureTo.x = x2;
+    gestureTo.y = y2;
+}
+
+// the finger at now, returns ms until it moves or lifts
+static uint32_t replay_gesture_step(uint32_t now)
+{
+    if ((int32_t)(now - gestureStart) < 0)
+    {
+        return gestureStart - now;
+    }
+    uint32_t t = now - gestureStart;
+    if (t >= gestureMs)
+    {
+        touchPressed = false;
+        gestureActive = false;
+        lastEnd = gestureStart + gestureMs;
+        liftedAt = lastEnd;
+        return 0;
+    }
+    uint32_t step = t - t % REPLAY_MOVE_MS;
+    uint32_t moved = step < gestureTravel ? step : gestureTravel;
+    touchPoint.x = gestureFrom.x + (int32_t)((int64_t)(gestureTo.x - gestureFrom.x) * moved / gestureTravel);
+    touchPoint.y = gestureFrom.y + (int32_t)((int64_t)(gestureTo.y - gestureFrom.y) * moved / gestureTravel);
+    touchPressed = true;
+
+    uint32_t next = gestureMs == gestureTravel ? gestureMs : step + REPLAY_MOVE_MS;
+    return (next < gestureMs ? next : gestureMs) - t;
+}
+
+static bool replay_hidden(lv_obj_t *obj)
+{
+    for (; obj != NULL; obj = lv_obj_get_parent(obj))
+    {
+        if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static lv_obj_t *replay_find_text(lv_obj_t *obj, const char *text)
+{
+    if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN))
+    {
+        return NULL;
+    }
+    if (lv_obj_check_type(obj, &lv_label_class) && strcmp(lv_label_get_text(obj), text) == 0)
+    {
+        return obj;
+    }
+    uint32_t count = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        lv_obj_t *found = replay_find_text(lv_obj_get_child(obj, i), text);
+        if (found != NULL)
+        {
+            return found;
+        }
+    }
+    return NULL;
+}
+
+// the lines up to the next mark belong to what was not there
+static void replay_skip(void)
+{
+    while (cmdIndex < numCmds && cmds[cmdIndex].op != CMD_MARK)
+    {
+        cmdIndex++;
+    }
+}
+
+static void replay_missing(const replay_cmd_t *cmd, const char *what)
+{
+    if (cmd->optional)
+    {
+        printf("input replay: line %d: %s \"%s\", skipped to the next mark\n", cmd->line, what, cmd->text);
+        replay_skip();
+        return;
+    }
+    script_error(cmd->line, what, cmd->text);
+}
+
+static void replay_tap_text(const replay_cmd_t *cmd, uint32_t due)
+{
+    lv_obj_t *label = replay_find_text(lv_screen_active(), cmd->text);
+    if (label == NULL)
+    {
+        replay_missing(cmd, "no label");
+        return;
+    }
+    lv_obj_scroll_to_view_recursive(label, LV_ANIM_ON);
+    textTarget = label;
+    textCmd = cmd;
+    textAt = due + REPLAY_SCROLL_MS;
+}
+
+// the label scrolled into view, or the screen changed under it
+static void replay_tap_label(void)
+{
+    lv_obj_t *label = textTarget;
+    textTarget = NULL;
+    lastEnd = textAt;
+    if (!lv_obj_is_valid(label) || lv_obj_get_screen(label) != lv_screen_active() || replay_hidden(label))
+    {
+        replay_missing(textCmd, "label went away");
+        return;
+    }
+
+    lv_area_t area;
+    lv_obj_update_layout(label);
+    lv_obj_get_coords(label, &area);
+    lv_display_t *display = lv_obj_get_display(label);
+    int32_t x = area.x1 + lv_area_get_width(&area) / 2;
+    int32_t y = area.y1 + lv_area_get_height(&area) / 2;
+    if (x < 0 || y < 0 || x >= lv_display_get_horizontal_resolution(display) ||
+        y >= lv_display_get_vertical_resolution(display))
+    {
+        replay_missing(textCmd, "label off screen");
+        return;
+    }
+    replay_gesture(textAt, x, y, x, y, REPLAY_TAP_MS);
+}
+
+static void replay_mark(const char *name)
+{
+    for (uint8_t i = 0; i < numSections; i++)
+    {
+        if (strcmp(sections[i], name) == 0)
+        {
+            section = i;
+            return;
+        }
+    }
+    if (numSections == REPLAY_SECTIONS)
+    {
+        section = REPLAY_SECTIONS - 1;
+        return;
+    }
+    sections[numSections] = name;
+    section = numSections++;
+}
+
+static void replay_run(const replay_cmd_t *cmd, uint32_t due)
+{
+    const int32_t *a = cmd->args;
+    switch (cmd->op)
+    {
+    case CMD_WAIT:
+        break;
+    case CMD_TOUCH:
+        touchPoint.x = a[0];
+        touchPoint.y = a[1];
+        touchPressed = a[2] != 0;
+        break;
+    case CMD_WHEEL:
+        wheelDiff += a[0];
+        wheelPressed = a[1] != 0;
+        break;
+    case CMD_KEY:
+        keyCode = (uint32_t)a[0];
+        keyPressed = a[1] != 0;
+        break;
+    case CMD_ENCODER:
+        input_bus_push_encoder(a[0]);
+        break;
+    case CMD_BUTTON:
+        input_bus_push_button(a[0] != 0);
+        break;
+    case CMD_TAP:
+        replay_gesture(due, a[0], a[1], a[0], a[1], REPLAY_TAP_MS);
+        break;
+    case CMD_HOLD:
+        replay_gesture(due, a[0], a[1], a[0], a[1], (uint32_t)a[2]);
+        break;
+    case CMD_SWIPE:
+        replay_gesture(due, a[0], a[1], a[2], a[3], (uint32_t)a[4]);
+        break;
+    case CMD_TAP_TEXT:
+        replay_tap_text(cmd, due);
+        break;
+    case CMD_EXPECT:
+    {
+        const char *name = heap_tag_screen_name(lv_screen_active());
+        if (strcmp(name != NULL ? name : "other", cmd->text) != 0)
+        {
+            printf("input replay: line %d: on \"%s\"\n", cmd->line, name != NULL ? name : "other");
+            script_error(cmd->line, "expected screen", cmd->text);
+        }
+        break;
+    }
+    case CMD_MARK:
+        replay_mark(cmd->text);
+        break;
+    }
+}
+
+// --- Frames ---
+static replay_frame_t *frames = NULL;
+static uint32_t numFrames = 0;
+static uint32_t frameCapacity = 0;
+static uint64_t passStart = 0;
+static bool rendered = false;
+static uint32_t flushedPixels = 0;
+
+static uint64_t host_us(void)
+{
+    return (uint64_t)((double)SDL_GetPerformanceCounter() * 1000000.0 / SDL_GetPerformanceFrequency());
+}
+
+static void replay_render_start(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    rendered = true;
+}
+
+static void replay_flushed(lv_event_t *e)
+{
+    const lv_area_t *area = (const lv_area_t *)lv_event_get_param(e);
+    if (area != NULL)
+    {
+        flushedPixels += lv_area_get_size(area);
+    }
+}
+
+// --- API ---
+void input_replay_init(lv_display_t *display)
+{
+    const char *record = getenv("INPUT_RECORD");
+    const char *replay = getenv("INPUT_REPLAY");
+    if (record != NULL && *record != '\0')
+    {
+        record_start(record, display);
+    }
+    if (replay == NULL || *replay == '\0')
+    {
+        return;
+    }
+
+    script_load(replay);
+    replaying = true;
+    startedAt = sim_clock_ms();
+    lastEnd = startedAt;
+    liftedAt = startedAt;
+    replayTouch = replay_indev(display, LV_INDEV_TYPE_POINTER, replay_touch_read);
+    replayWheel = replay_indev(display, LV_INDEV_TYPE_ENCODER, replay_wheel_read);
+    replayKeys = replay_indev(display, LV_INDEV_TYPE_KEYPAD, replay_keys_read);
+    lv_display_add_event_cb(display, replay_render_start, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(display, replay_flushed, LV_EVENT_FLUSH_FINISH, NULL);
+    printf("input replay: %d lines from %s\n", numCmds, replay);
+}
+
+void input_replay_attach(lv_indev_t *indev)
+{
+    if (replaying)
+    {
+        // the replay devices take over its group
+        lv_indev_enable(indev, false);
+        lv_indev_type_t type = lv_indev_get_type(indev);
+        lv_indev_t *replacement = type == LV_INDEV_TYPE_ENCODER ? replayWheel : type == LV_INDEV_TYPE_KEYPAD ? replayKeys : NULL;
+        if (replacement != NULL && lv_indev_get_group(indev) != NULL)
+        {
+            lv_indev_set_group(replacement, lv_indev_get_group(indev));
+        }
+        return;
+    }
+    if (recordFile == NULL || record_find(indev) != NULL)
+    {
+        return;
+    }
+    recorded_indev_t *r = record_find(NULL);
+    if (r == NULL)
+    {
+        return;
+    }
+    r->indev = indev;
+    r->read = indev->read_cb;
+    memset(&r->last, 0, sizeof(r->last));
+    indev->read_cb = record_read;
+}
+
+bool input_replay_active(void)
+{
+    return replaying;
+}
+
+uint32_t input_replay_poll(void)
+{
+    if (!replaying)
+    {
+        return UINT32_MAX;
+    }
+    passStart = host_us();
+    rendered = false;
+    flushedPixels = 0;
+
+    uint32_t now = sim_clock_ms();
+    while (true)
+    {
+        if (gestureActive)
+        {
+            uint32_t wait = replay_gesture_step(now);
+            if (wait > 0)
+            {
+                return wait;
+            }
+            continue;
+        }
+        if (textTarget != NULL)
+        {
+            if ((int32_t)(now - textAt) < 0)
+            {
+                return textAt - now;
+            }
+            replay_tap_label();
+            continue;
+        }
+        if (cmdIndex >= numCmds)
+        {
+            finished = true;
+            return UINT32_MAX;
+        }
+
+        const replay_cmd_t *cmd = &cmds[cmdIndex];
+        uint32_t due = lastEnd + cmd->delay_ms;
+        if ((int32_t)(now - due) < 0)
+        {
+            return due - now;
+        }
+        cmdIndex++;
+        lastEnd = due;
+        replay_run(cmd, due);
+    }
+}
+
+void input_replay_pass_end(void)
+{
+    if (!replaying || !rendered)
+    {
+        return;
+    }
+    if (numFrames == frameCapacity)
+    {
+        frameCapacity = frameCapacity > 0 ? frameCapacity * 2 : 1024;
+        frames = (replay_frame_t *)realloc(frames, frameCapacity * sizeof(replay_frame_t));
+    }
+    replay_frame_t *frame = &frames[numFrames++];
+    frame->t_ms = sim_clock_ms();
+    frame->us = (uint32_t)(host_us() - passStart);
+    frame->pixels = flushedPixels;
+    frame->section = section;
+    frame->screen = heap_tag_screen_name(lv_screen_active());
+}
+
+bool input_replay_done(void)
+{
+    return replaying && finished;
+}
+
+static int compare_us(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(const uint32_t *sorted, uint32_t count, uint32_t pct)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void report_section(uint8_t index, uint32_t *us)
+{
+    uint32_t count = 0;
+    uint32_t over = 0;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < numFrames; i++)
+    {
+        if (frames[i].section != index)
+        {
+            continue;
+        }
+        us[count++] = frames[i].us;
+        total += frames[i].us;
+        over += frames[i].us > LV_DEF_REFR_PERIOD * 1000;
+    }
+    if (count == 0)
+    {
+        return;
+    }
+    qsort(us, count, sizeof(uint32_t), compare_us);
+    printf("replay %-14s %5u frames, p50 %6.2fms p95 %6.2fms p99 %6.2fms max %6.2fms mean %6.2fms, %u over %dms\n",
+           sections[index], count, percentile(us, count, 50) / 1000.0, percentile(us, count, 95) / 1000.0,
+           percentile(us, count, 99) / 1000.0, us[count - 1] / 1000.0, total / 1000.0 / count, over, LV_DEF_REFR_PERIOD);
+}
+
+uint32_t input_replay_report(void)
+{
+    if (!replaying)
+    {
+        return 0;
+    }
+    uint32_t *us = (uint32_t *)malloc((numFrames > 0 ? numFrames : 1) * sizeof(uint32_t));
+    for (uint8_t i = 0; i < numSections; i++)
+    {
+        report_section(i, us);
+    }
+    free(us);
+
+    const char *path = getenv("REPLAY_CSV");
+    if (path == NULL)
+    {
+        path = "replay.csv";
+    }
+    FILE *csv = fopen(path, "w");
+    if (csv != NULL)
+    {
+        fprintf(csv, "frame,t_ms,mark,screen,us,pixels\n");
+        for (uint32_t i = 0; i < numFrames; i++)
+        {
+            const replay_frame_t *f = &frames[i];
+            fprintf(csv, "%u,%u,\"%s\",\"%s\",%u,%u\n", i, (unsigned)f->t_ms, sections[f->section],
+                    f->screen != NULL ? f->screen : "other", (unsigned)f->us, (unsigned)f->pixels);
+        }
+        fclose(csv);
+    }
+    printf("replay %s: %u frames in %.1fs virtual, %u errors, frames written to %s\n", scriptPath != NULL ? scriptPath : "",
+           numFrames, (sim_clock_ms() - startedAt) / 1000.0, errors, path);
+    return errors;
+}
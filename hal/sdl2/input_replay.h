@@ -0,0 +1,76 @@
+#ifndef INPUT_REPLAY_H
+#define INPUT_REPLAY_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Input recording and deterministic replay for the emulator.
+ *
+ *   INPUT_RECORD=<path>  write what the attached input devices read, and the encoder and
+ *                        button events delivered by input_bus.h, to a script until exit
+ *   INPUT_REPLAY=<path>  play a script instead of the attached devices (they are disabled)
+ *                        on the virtual clock, then print a frame time report and exit
+ *   REPLAY_CSV=<path>    one row per rendered frame of a replay (default replay.csv)
+ *
+ * A script line is [<delay_ms>,]<command>[,<args>], the delay counting from the end of
+ * the line before. Blank lines and # comments are skipped, a line with only a delay waits.
+ *   touch,<x>,<y>,<pressed>           pointer
+ *   wheel,<diff>,<pressed>            encoder device (the SDL mouse wheel)
+ *   key,<code>,<pressed>              keypad (the SDL keyboard)
+ *   encoder,<position>                knob, pushed to input_bus
+ *   button,<pressed>                  knob button, pushed to input_bus
+ *   tap,<x>,<y>                       pressed for REPLAY_TAP_MS
+ *   hold,<x>,<y>,<ms>
+ *   swipe,<x1>,<y1>,<x2>,<y2>[,<ms>]  moving every REPLAY_MOVE_MS for ms (REPLAY_SWIPE_MS)
+ *   tap_text,<text>[,optional]        tap the visible label showing text on the active
+ *                                     screen, scrolled into view first. Missing is an error,
+ *                                     with optional the lines up to the next mark are skipped
+ *   expect,<owner>                    the active screen is bound to this heap owner
+ *                                     (heap_tags.h), "other" for none
+ *   mark,<name>                       the frames from here on are reported under name
+ *   repeat,<n> ... end                the lines in between run n times
+ * A gesture starts at least REPLAY_TAP_MS after the one before lifted, so the touch read
+ * sees the finger up in between. Recordings only contain the first five lines, in the
+ * screen coordinates they were made at.
+ *
+ * A frame is a pass of the UI loop that rendered; its time is the host time of the whole
+ * pass, input handling, timers, games and rendering included.
+ */
+
+#define REPLAY_TAP_MS 100
+#define REPLAY_MOVE_MS 10
+#define REPLAY_SWIPE_MS 200
+#define REPLAY_SCROLL_MS 400 // tap_text waits this long for the scroll to the label
+
+// Call once the display is created, sets up recording or the replay devices
+void input_replay_init(lv_display_t *display);
+
+// an SDL input device, recorded with INPUT_RECORD and disabled with INPUT_REPLAY
+void input_replay_attach(lv_indev_t *indev);
+
+// INPUT_REPLAY is set and the script loaded
+bool input_replay_active(void);
+
+// start of a UI loop pass, feeds what is due at sim_clock_ms(). Returns ms until the
+// next change, UINT32_MAX when not replaying.
+uint32_t input_replay_poll(void);
+
+// end of the pass
+void input_replay_pass_end(void);
+
+// the last line ran
+bool input_replay_done(void);
+
+// prints the frame times per mark and writes REPLAY_CSV, returns the script errors
+// (lines that did not parse, a missing tap_text, a failed expect)
+uint32_t input_replay_report(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*INPUT_REPLAY_H*/
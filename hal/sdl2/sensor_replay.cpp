@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "sensor_replay.h"
+#include "sim_clock.h"
+
+#define REPLAY_FIFO 64
+#define REPLAY_LINE 160
+
+typedef struct
+{
+    uint32_t t_ms;
+    imu_sample_t sample;
+} replay_row_t;
+
+static replay_row_t *rows = NULL;
+static int numRows = 0;
+static bool loaded = false;
+static uint32_t durationMs = 0;
+
+static uint32_t periodUs = 0;
+static uint64_t startUs = 0;
+static uint64_t nextUs = 0;
+static int rowIndex = 0;
+
+static const imu_sample_t flat = {0, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 25.0f};
+
+static uint64_t replay_now_us(void)
+{
+    return (uint64_t)sim_clock_ms() * 1000;
+}
+
+static void replay_load(void)
+{
+    loaded = true;
+    const char *path = getenv("SENSOR_CSV");
+    if (path == NULL || *path == '\0')
+    {
+        return;
+    }
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        printf("sensor replay: cannot open %s\n", path);
+        return;
+    }
+
+    char line[REPLAY_LINE];
+    int capacity = 0;
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (!isdigit((unsigned char)line[0]))
+        {
+            continue;
+        }
+        replay_row_t row = {};
+        row.sample.temp = flat.temp;
+        unsigned long t;
+        int fields = sscanf(line, "%lu,%f,%f,%f,%f,%f,%f,%f", &t, &row.sample.ax, &row.sample.ay, &row.sample.az,
+                            &row.sample.gx, &row.sample.gy, &row.sample.gz, &row.sample.temp);
+        if (fields < 7)
+        {
+            continue;
+        }
+        row.t_ms = (uint32_t)t;
+        if (numRows == capacity)
+        {
+            capacity = capacity > 0 ? capacity * 2 : 256;
+            rows = (replay_row_t *)realloc(rows, capacity * sizeof(replay_row_t));
+        }
+        rows[numRows++] = row;
+    }
+    fclose(f);
+
+    if (numRows > 0)
+    {
+        // the last row lasts as long as the one before it
+        uint32_t last = numRows > 1 ? rows[numRows - 1].t_ms - rows[numRows - 2].t_ms : 10;
+        durationMs = rows[numRows - 1].t_ms + (last > 0 ? last : 1);
+    }
+    printf("sensor replay: %d rows, %ums from %s\n", numRows, (unsigned)durationMs, path);
+}
+
+// latest row at t_ms into the recording
+static const imu_sample_t *replay_sample(uint32_t t_ms)
+{
+    if (numRows == 0)
+    {
+        return &flat;
+    }
+    t_ms %= durationMs;
+    if (rowIndex >= numRows || rows[rowIndex].t_ms > t_ms)
+    {
+        rowIndex = 0; // looped
+    }
+    while (rowIndex + 1 < numRows && rows[rowIndex + 1].t_ms <= t_ms)
+    {
+        rowIndex++;
+    }
+    return &rows[rowIndex].sample;
+}
+
+static bool replay_start(uint16_t odr_hz)
+{
+    if (!loaded)
+    {
+        replay_load();
+    }
+    periodUs = 1000000 / odr_hz;
+    startUs = replay_now_us();
+    nextUs = startUs;
+    rowIndex = 0;
+    return true;
+}
+
+static void replay_stop(void)
+{
+}
+
+// the samples a sensor at the ODR would have taken since the last read, at most a FIFO full
+static uint16_t replay_read(imu_sample_t *out, uint16_t max)
+{
+    uint64_t now = replay_now_us();
+    if (now > nextUs + (uint64_t)REPLAY_FIFO * periodUs)
+    {
+        // an overflowing FIFO keeps the newest samples
+        nextUs = now - (uint64_t)(REPLAY_FIFO - 1) * periodUs;
+    }
+
+    uint16_t count = 0;
+    while (count < max && nextUs <= now)
+    {
+        out[count++] = *replay_sample((uint32_t)((nextUs - startUs) / 1000));
+        nextUs += periodUs;
+    }
+    return count;
+}
+
+static const sensor_backend_t replayBackend = {replay_start, replay_stop, replay_read, REPLAY_FIFO};
+
+const sensor_backend_t *sensor_replay_backend(void)
+{
+    return &replayBackend;
+}
+
+uint32_t sensor_replay_clock(void)
+{
+    return (uint32_t)replay_now_us();
+}
+
+uint32_t sensor_replay_duration_ms(void)
+{
+    if (!loaded)
+    {
+        replay_load();
+    }
+    return durationMs;
+}
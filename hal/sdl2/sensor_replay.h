@@ -0,0 +1,33 @@
+#ifndef SENSOR_REPLAY_H
+#define SENSOR_REPLAY_H
+
+#include "common/sensor_service/sensor_service.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * IMU for the emulator, drives the sensor service from a CSV recording.
+ *
+ *   SENSOR_CSV=<path>   rows of t_ms,ax,ay,az,gx,gy,gz[,temp], t_ms counting up from 0.
+ *                       Lines that do not start with a number (header, # comments) are
+ *                       skipped. Without it the watch lies flat and still.
+ *
+ * The recording is resampled to the ODR by holding the latest row and loops at its end.
+ * Time comes from sim_clock, so a replay follows the virtual clock and is reproducible.
+ */
+
+const sensor_backend_t *sensor_replay_backend(void);
+
+// sensor service timestamps, sim_clock in microseconds
+uint32_t sensor_replay_clock(void);
+
+// length of one pass over SENSOR_CSV, 0 without a recording
+uint32_t sensor_replay_duration_ms(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*SENSOR_REPLAY_H*/
@@ -0,0 +1,96 @@
+#include <stdlib.h>
+#include SDL_INCLUDE_PATH
+
+#include "sim_clock.h"
+
+#define SIM_DEFAULT_START_TIME 1704067200 // 2024-01-01 00:00:00 UTC
+
+static bool virtualMode = false;
+static uint64_t virtualMs = 0;
+static time_t startTime = SIM_DEFAULT_START_TIME;
+static uint32_t fastForward = 0;
+
+static unsigned long env_ulong(const char *name, unsigned long def)
+{
+    const char *value = getenv(name);
+    if (value == NULL || *value == '\0')
+    {
+        return def;
+    }
+    return strtoul(value, NULL, 10);
+}
+
+void sim_clock_init(void)
+{
+    virtualMode = env_ulong("SIM_VIRTUAL_CLOCK", 0) != 0;
+    fastForward = env_ulong("SIM_FAST_FORWARD", 0);
+#ifdef SIM_HEADLESS
+    // headless runs are always reproducible
+    virtualMode = true;
+#endif
+    if (fastForward > 0)
+    {
+        // fast-forward only makes sense if nothing waits for real time
+        virtualMode = true;
+    }
+    const char *replay = getenv("INPUT_REPLAY");
+    if (replay != NULL && *replay != '\0')
+    {
+        // a replayed script only gives the same frames on the same clock
+        virtualMode = true;
+    }
+    startTime = (time_t)env_ulong("SIM_START_TIME", SIM_DEFAULT_START_TIME);
+    virtualMs = 0;
+}
+
+bool sim_clock_is_virtual(void)
+{
+    return virtualMode;
+}
+
+uint32_t sim_clock_ms(void)
+{
+    if (virtualMode)
+    {
+        return (uint32_t)virtualMs;
+    }
+    return SDL_GetTicks();
+}
+
+time_t sim_clock_time(void)
+{
+    if (virtualMode)
+    {
+        return startTime + (time_t)(virtualMs / 1000);
+    }
+    return time(0);
+}
+
+struct tm *sim_clock_tm(void)
+{
+    time_t now = sim_clock_time();
+    return virtualMode ? gmtime(&now) : localtime(&now);
+}
+
+void sim_clock_advance(uint32_t ms)
+{
+    if (virtualMode)
+    {
+        virtualMs += ms;
+    }
+}
+
+void sim_clock_set_time(time_t wall)
+{
+    if (virtualMode)
+    {
+        // align to a whole second so the face shows exactly `wall`
+        virtualMs += 1000 - (virtualMs % 1000);
+        startTime = wall - (time_t)(virtualMs / 1000);
+    }
+}
+
+uint32_t sim_clock_fast_forward(void)
+{
+    return fastForward;
+}
@@ -0,0 +1,49 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Single time source for the emulator.
+ *
+ * Real mode: milliseconds come from SDL_GetTicks() and the wall clock from time().
+ * Virtual mode: time only moves when sim_clock_advance() is called, which makes
+ * animations, face updates and games deterministic and allows fast-forwarding.
+ *
+ * Configured from the environment in sim_clock_init():
+ *   SIM_VIRTUAL_CLOCK=1       enable virtual mode
+ *   SIM_START_TIME=<epoch>    wall clock at start (virtual mode, default 2024-01-01 00:00:00 UTC)
+ *   SIM_FAST_FORWARD=<sec>    run without sleeping until <sec> of virtual time passed, then exit
+ *   INPUT_REPLAY=<path>       replay input (input_replay.h), always in virtual mode
+ */
+
+void sim_clock_init(void);
+
+bool sim_clock_is_virtual(void);
+
+// monotonic milliseconds, used as the LVGL tick
+uint32_t sim_clock_ms(void);
+// wall clock, replaces time(0) in the emulator
+time_t sim_clock_time(void);
+// broken down wall clock, UTC in virtual mode so runs do not depend on the host timezone
+struct tm *sim_clock_tm(void);
+
+// move virtual time forward, ignored in real mode
+void sim_clock_advance(uint32_t ms);
+// jump the virtual wall clock to `wall`, the millisecond tick keeps counting up
+void sim_clock_set_time(time_t wall);
+
+// virtual seconds to fast-forward, 0 if not requested
+uint32_t sim_clock_fast_forward(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*SIM_CLOCK_H*/
@@ -44,7 +44,8 @@
 // #else
 // #define LV_USE_STDLIB_MALLOC    LV_STDLIB_CLIB
 // #endif
-#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CLIB
+// malloc with an owner tag per block, see src/common/heap_tags/heap_tags.h
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CUSTOM
 
 
 #if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
@@ -736,17 +737,21 @@
  *==================*/
 
 /*1: Enable API to take snapshot for object*/
-#define LV_USE_SNAPSHOT 0
+#define LV_USE_SNAPSHOT 1
 
 /*1: Enable system monitor component*/
-#define LV_USE_SYSMON   0
+#if defined(ENABLE_PROFILER) && defined(ENABLE_PROFILER_OVERLAY)
+    #define LV_USE_SYSMON   1
+#else
+    #define LV_USE_SYSMON   0
+#endif
 #if LV_USE_SYSMON
     /*Get the idle percentage. E.g. uint32_t my_get_idle(void);*/
     #define LV_SYSMON_GET_IDLE lv_timer_get_idle
 
     /*1: Show CPU usage and FPS count
      * Requires `LV_USE_SYSMON = 1`*/
-    #define LV_USE_PERF_MONITOR 0
+    #define LV_USE_PERF_MONITOR 1
     #if LV_USE_PERF_MONITOR
         #define LV_USE_PERF_MONITOR_POS LV_ALIGN_BOTTOM_RIGHT
 
@@ -764,30 +769,41 @@
 
 #endif /*LV_USE_SYSMON*/
 
-/*1: Enable the runtime performance profiler*/
-#define LV_USE_PROFILER 0
+/*1: Enable the runtime performance profiler
+ *Set by the native profiling envs, the trace is collected by src/common/profiler*/
+#ifdef ENABLE_PROFILER
+    #define LV_USE_PROFILER 1
+#else
+    #define LV_USE_PROFILER 0
+#endif
 #if LV_USE_PROFILER
     /*1: Enable the built-in profiler*/
-    #define LV_USE_PROFILER_BUILTIN 1
+    #define LV_USE_PROFILER_BUILTIN 0
     #if LV_USE_PROFILER_BUILTIN
         /*Default profiler trace buffer size*/
         #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /*[bytes]*/
     #endif
 
     /*Header to include for the profiler*/
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    #define LV_PROFILER_INCLUDE PROFILER_INCLUDE_PATH
 
     /*Profiler start point function*/
-    #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
+    #define LV_PROFILER_BEGIN    profiler_begin(__func__)
 
     /*Profiler end point function*/
-    #define LV_PROFILER_END      LV_PROFILER_BUILTIN_END
+    #define LV_PROFILER_END      profiler_end(__func__)
 
     /*Profiler start point function with custom tag*/
-    #define LV_PROFILER_BEGIN_TAG LV_PROFILER_BUILTIN_BEGIN_TAG
+    #define LV_PROFILER_BEGIN_TAG(tag) profiler_begin(tag)
 
     /*Profiler end point function with custom tag*/
-    #define LV_PROFILER_END_TAG   LV_PROFILER_BUILTIN_END_TAG
+    #define LV_PROFILER_END_TAG(tag)   profiler_end(tag)
+
+    /*One span around every event callback LVGL calls, named after the event code*/
+    #define LV_PROFILER_EVENT 1
+
+    /*Style lookups, too fine grained for the frame trace*/
+    #define LV_PROFILER_STYLE 0
 #endif
 
 /*1: Enable Monkey test*/
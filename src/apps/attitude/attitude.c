@@ -21,30 +21,31 @@ lv_obj_t *ui_img_pointer;
 lv_obj_t *ui_Label_roll;
 lv_obj_t *ui_Label_pitch;
 
-#define RAD2DEG 57.2958
+#define ATTITUDE_RATE_HZ SENSOR_ODR_MAX_HZ // every sample the sensor takes at its fastest
 
-imu_data_t d;
+int attiude_stream = -1;
 
-lv_timer_t *attiude_timer = NULL;
+fusion_t attiude_fusion;
 
-float pitch, roll;
-
-void attiude_timer_cb(lv_timer_t *timer)
+void attiude_stream_cb(const imu_sample_t *samples, uint16_t count, void *user)
 {
-    d = get_imu_data();
-
 #ifdef ENABLE_APP_ATTITUDE
 
-    // d.ax += 1.0;
-
-    pitch = atan2(-d.az, sqrt((d.ax *d.ax) + (d.ay * d.ay)));
-    roll = atan2(d.ay, sqrt((d.ax * d.ax) + (d.az * d.az)));
-
-    pitch *= RAD2DEG;
-    roll *= RAD2DEG;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const imu_sample_t *d = &samples[i];
+        // the watch is held upright like an instrument panel, x up: fusion.h axes are
+        // x' = z, y' = y, z' = x, a mirror, so the rates change sign
+        fusion_input_t in = {
+            Q16_FROM_FLOAT(d->az), Q16_FROM_FLOAT(d->ay), Q16_FROM_FLOAT(d->ax),
+            Q16_FROM_FLOAT(-d->gz), Q16_FROM_FLOAT(-d->gy), Q16_FROM_FLOAT(-d->gx)};
+        fusion_update(&attiude_fusion, &in, d->time_us);
+    }
 
-    update_pitch((int)pitch, (int)roll);
-    update_roll((int)roll);
+    int pitch = Q16_ROUND(attiude_fusion.pitch);
+    int roll = Q16_ROUND(attiude_fusion.roll);
+    update_pitch(pitch, roll);
+    update_roll(roll);
 
 #endif
 }
@@ -60,18 +61,15 @@ void ui_event_attiudeScreen(lv_event_t *e)
     {
         onGameOpened();
 
-        attiude_timer = lv_timer_create(attiude_timer_cb, 100, NULL);
-        lv_timer_set_repeat_count(attiude_timer, -1);
-        attiude_timer_cb(attiude_timer); // Trigger first run
+        // every sample for the filter, the dial follows once per batch
+        fusion_init(&attiude_fusion, 500);
+        attiude_stream = imu_stream_open(ATTITUDE_RATE_HZ, IMU_STREAM_DECIMATE, attiude_stream_cb, NULL);
     }
     if (event_code == LV_EVENT_SCREEN_UNLOAD_START)
     {
 
-        if (attiude_timer != NULL)
-        {
-            lv_timer_delete(attiude_timer);
-            attiude_timer = NULL;
-        }
+        imu_stream_close(attiude_stream);
+        attiude_stream = -1;
     }
     if (event_code == LV_EVENT_SCREEN_UNLOADED)
     {
@@ -17,7 +17,8 @@ extern "C"
 #include "lvgl.h"
 #include "app_hal.h"
 #include "../../common/api.h"
-#include "math.h"
+#include "../../common/fusion/fusion.h"
+#include "../../common/sensor_service/sensor_service.h"
 #include "../../common/app_manager.h"
 
 #ifdef ENABLE_APP_ATTITUDE
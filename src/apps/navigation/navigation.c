@@ -16,7 +16,9 @@
 #define CANVAS_WIDTH 48
 #define CANVAS_HEIGHT 48
 
-REGISTER_APP("Navigation", &ui_img_arrow_png, ui_navScreen, ui_navScreen_screen_init);
+static bool ui_navScreen_keep(void);
+
+REGISTER_APP_HOOKS("Navigation", &ui_img_arrow_png, ui_navScreen, ui_navScreen_screen_init, NULL, ui_navScreen_keep);
 
 lv_obj_t *ui_navPanel;
 lv_obj_t *ui_navDirection;
@@ -52,6 +54,12 @@ void ui_event_navScreen(lv_event_t *e)
     }
 }
 
+// directions from the phone are written into the screen and the HAL switches to it, so it is never evicted
+static bool ui_navScreen_keep(void)
+{
+    return true;
+}
+
 void ui_navScreen_screen_init()
 {
 
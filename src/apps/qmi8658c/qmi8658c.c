@@ -36,13 +36,13 @@ lv_obj_t *ui_rtwSwitch;
 bool qmi8658c_active;
 
 float ax, ay, az, gx, gy, gz, temp;
-imu_data_t qmi_d;
+imu_sample_t qmi_d;
 
-lv_timer_t *qmi8658c_timer = NULL;
+int qmi8658c_stream = -1;
 
-void qmi8658c_timer_cb(lv_timer_t *timer)
+void qmi8658c_stream_cb(const imu_sample_t *samples, uint16_t count, void *user)
 {
-    qmi_d = get_imu_data();
+    qmi_d = samples[count - 1];
 
     // counter++;
 
@@ -84,19 +84,15 @@ void ui_event_imuScreen(lv_event_t *e)
         qmi8658c_active = true;
         onGameOpened();
 
-        qmi8658c_timer = lv_timer_create(qmi8658c_timer_cb, 100, NULL);
-        lv_timer_set_repeat_count(qmi8658c_timer, -1);
-        qmi8658c_timer_cb(qmi8658c_timer); // Trigger first run
+        // raw values, every 10th sample at the default rate
+        qmi8658c_stream = imu_stream_open(10, IMU_STREAM_DECIMATE, qmi8658c_stream_cb, NULL);
     }
     if (event_code == LV_EVENT_SCREEN_UNLOAD_START)
     {
         qmi8658c_active = false;
 
-        if (qmi8658c_timer != NULL)
-        {
-            lv_timer_delete(qmi8658c_timer);
-            qmi8658c_timer = NULL;
-        }
+        imu_stream_close(qmi8658c_stream);
+        qmi8658c_stream = -1;
     }
     if (event_code == LV_EVENT_SCREEN_UNLOADED)
     {
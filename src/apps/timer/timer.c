@@ -8,7 +8,9 @@
 #ifdef ENABLE_APP_TIMER
 
 
-REGISTER_APP("Timer", &ui_img_timer_png, ui_timerScreen, timer_screen_init);
+static bool timer_running(void);
+
+REGISTER_APP_HOOKS("Timer", &ui_img_timer_png, ui_timerScreen, timer_screen_init, NULL, timer_running);
 
 static lv_obj_t *ui_timerScreen;
 static lv_obj_t *ui_customTimer;
@@ -69,6 +71,12 @@ void ui_event_timerScreen(lv_event_t *e)
     }
 }
 
+// the countdown updates the screen, it stays until the timer is stopped or ends
+static bool timer_running(void)
+{
+    return time_timer != NULL;
+}
+
 void time_timer_cb(lv_timer_t *t)
 {
 
@@ -0,0 +1,193 @@
+#include "activity.h"
+#include <string.h>
+#include "../fusion/fusion.h"
+
+#define MINUTE_US 60000000u
+// shifts of the band pass at ACTIVITY_RATE_HZ: 1/16 is about 0.25 Hz, 1/2 about 3 Hz
+#define BASE_SHIFT 4
+#define SMOOTH_SHIFT 1
+// stride in mm = height_cm * (STRIDE_BASE + STRIDE_PER_SPM * cadence) / 1000
+#define STRIDE_BASE 2500
+#define STRIDE_PER_SPM 17
+#define CADENCE_MIN 60
+#define CADENCE_MAX 220
+
+static activity_t shared;
+static bool sharedReady = false;
+static int stream = -1;
+static int today = -1;
+
+// --- Engine ---
+static void activity_minute(activity_t *a) {
+    a->minutes[a->minute_head] = a->minute_steps > 255 ? 255 : (uint8_t)a->minute_steps;
+    a->minute_head = (a->minute_head + 1) % ACTIVITY_MINUTES;
+    if (a->minute_count < ACTIVITY_MINUTES) a->minute_count++;
+    a->minute_steps = 0;
+}
+
+static void activity_clock(activity_t *a, uint32_t dt) {
+    a->since_step_us = dt < UINT32_MAX - a->since_step_us ? a->since_step_us + dt : UINT32_MAX;
+    if (a->since_step_us > ACTIVITY_MAX_STEP_MS * 1000u) {
+        // stopped walking, the next step starts a new run
+        a->run = 0;
+        a->cadence = 0;
+    }
+
+    uint32_t minutes = dt / MINUTE_US;
+    a->minute_us += dt % MINUTE_US;
+    if (a->minute_us >= MINUTE_US) {
+        a->minute_us -= MINUTE_US;
+        minutes++;
+    }
+    for (uint32_t i = 0; i < minutes && i < ACTIVITY_MINUTES; i++) activity_minute(a);
+}
+
+static void activity_count(activity_t *a, uint32_t steps) {
+    a->cadence = (uint16_t)(60000 / a->interval_ms);
+    uint32_t cadence = a->cadence < CADENCE_MIN ? CADENCE_MIN : a->cadence > CADENCE_MAX ? CADENCE_MAX : a->cadence;
+    uint32_t stride = a->height_cm * (STRIDE_BASE + STRIDE_PER_SPM * cadence) / 1000;
+
+    a->steps += steps;
+    a->minute_steps += steps;
+    a->distance_mm += stride * steps;
+    a->distance_m = a->distance_mm / 1000;
+    // 0.75 kcal per kg and km
+    a->cal += a->weight_kg * stride * 3 / 4000 * steps;
+    a->kcal = a->cal / 1000;
+}
+
+// a fall through the threshold, counted if it keeps the rhythm of the ones before
+static void activity_step(activity_t *a) {
+    uint32_t ms = a->since_step_us / 1000;
+    if (ms < ACTIVITY_MIN_STEP_MS) return; // the same step bouncing
+    a->since_step_us = 0;
+
+    // within 40% of the interval so far, the first interval sets it
+    bool regular = a->run < 2 || (ms * 5 >= a->interval_ms * 3u && ms * 5 <= a->interval_ms * 7u);
+    if (a->run == 0 || ms > ACTIVITY_MAX_STEP_MS || !regular) {
+        // starts a new run
+        a->run = 1;
+        a->cadence = 0;
+        return;
+    }
+
+    a->interval_ms = a->run == 1 ? (uint16_t)ms : (uint16_t)(a->interval_ms + ((int32_t)ms - a->interval_ms) / 4);
+    if (a->run >= ACTIVITY_CONFIRM_STEPS) {
+        activity_count(a, 1);
+    } else if (++a->run == ACTIVITY_CONFIRM_STEPS) {
+        activity_count(a, ACTIVITY_CONFIRM_STEPS);
+    }
+}
+
+void activity_init(activity_t *a) {
+    memset(a, 0, sizeof(*a));
+    a->height_cm = ACTIVITY_HEIGHT_CM;
+    a->weight_kg = ACTIVITY_WEIGHT_KG;
+    a->since_step_us = UINT32_MAX;
+}
+
+void activity_feed(activity_t *a, const imu_sample_t *s) {
+    q16_t ax = Q16_FROM_FLOAT(s->ax);
+    q16_t ay = Q16_FROM_FLOAT(s->ay);
+    q16_t az = Q16_FROM_FLOAT(s->az);
+    q16_t magnitude = q16_sqrt(q16_mul(ax, ax) + q16_mul(ay, ay) + q16_mul(az, az));
+    int32_t mg = (int32_t)(((int64_t)magnitude * 1000) >> 16);
+
+    if (!a->primed) {
+        a->base = mg * 256;
+        a->smooth = 0;
+        a->win_max = 0;
+        a->win_min = 0;
+        a->win_count = 0;
+        a->swing = 0;
+        a->above = false;
+        a->last_us = s->time_us;
+        a->primed = true;
+        return;
+    }
+    activity_clock(a, s->time_us - a->last_us);
+    a->last_us = s->time_us;
+
+    // band pass: gravity and turning the wrist out, the jitter above the step rate too
+    a->base += (mg * 256 - a->base) >> BASE_SHIFT;
+    int32_t high = mg - (a->base >> 8);
+    a->smooth += (high - a->smooth) >> SMOOTH_SHIFT;
+
+    // threshold and swing from the last full window
+    if (a->smooth > a->win_max) a->win_max = a->smooth;
+    if (a->smooth < a->win_min) a->win_min = a->smooth;
+    if (++a->win_count >= ACTIVITY_WINDOW) {
+        a->threshold = (a->win_max + a->win_min) / 2;
+        a->swing = a->win_max - a->win_min;
+        a->win_max = a->smooth;
+        a->win_min = a->smooth;
+        a->win_count = 0;
+    }
+
+    int32_t hysteresis = a->swing / 8;
+    if (a->swing < ACTIVITY_MIN_SWING) {
+        a->above = false;
+    } else if (a->smooth > a->threshold + hysteresis) {
+        a->above = true;
+    } else if (a->above && a->smooth < a->threshold - hysteresis) {
+        a->above = false;
+        activity_step(a);
+    }
+}
+
+void activity_reset(activity_t *a) {
+    a->steps = 0;
+    a->distance_m = 0;
+    a->distance_mm = 0;
+    a->kcal = 0;
+    a->cal = 0;
+}
+
+uint16_t activity_history(const activity_t *a, uint8_t *out, uint16_t max) {
+    uint16_t count = a->minute_count < max ? a->minute_count : max;
+    for (uint16_t i = 0; i < count; i++) {
+        out[i] = a->minutes[(a->minute_head + ACTIVITY_MINUTES - count + i) % ACTIVITY_MINUTES];
+    }
+    return count;
+}
+
+// --- Service ---
+static activity_t *activity_shared(void) {
+    if (!sharedReady) {
+        activity_init(&shared);
+        sharedReady = true;
+    }
+    return &shared;
+}
+
+static void activity_stream_cb(const imu_sample_t *samples, uint16_t count, void *user) {
+    (void)user;
+    for (uint16_t i = 0; i < count; i++) activity_feed(&shared, &samples[i]);
+}
+
+void activity_start(void) {
+    if (stream >= 0) return;
+    // the filters start over, the time the stream was closed is not known
+    activity_shared()->primed = false;
+    stream = imu_stream_open(ACTIVITY_RATE_HZ, IMU_STREAM_AVERAGE, activity_stream_cb, NULL);
+    imu_stream_set_latency(stream, ACTIVITY_LATENCY_MS);
+}
+
+void activity_stop(void) {
+    imu_stream_close(stream);
+    stream = -1;
+}
+
+const activity_t *activity_get(void) {
+    return activity_shared();
+}
+
+void activity_set_profile(uint16_t height_cm, uint16_t weight_kg) {
+    activity_shared()->height_cm = height_cm;
+    activity_shared()->weight_kg = weight_kg;
+}
+
+void activity_set_day(int day) {
+    if (today >= 0 && day != today) activity_reset(activity_shared());
+    today = day;
+}
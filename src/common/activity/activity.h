@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stream rate, averaged down from the sensor rate. The filter constants assume it.
+#define ACTIVITY_RATE_HZ 25
+// Steps can wait, the sensor service hands the samples over about once a second
+#define ACTIVITY_LATENCY_MS 1000
+// Samples per threshold window, about one second
+#define ACTIVITY_WINDOW 25
+// Peak to peak of the filtered magnitude below which nothing counts, mg
+#define ACTIVITY_MIN_SWING 60
+// Step intervals outside this range end a walk
+#define ACTIVITY_MIN_STEP_MS 250
+#define ACTIVITY_MAX_STEP_MS 2000
+// Regular steps in a row before any of them count
+#define ACTIVITY_CONFIRM_STEPS 6
+// Minute bins kept, one day
+#define ACTIVITY_MINUTES 1440
+// Until activity_set_profile()
+#define ACTIVITY_HEIGHT_CM 170
+#define ACTIVITY_WEIGHT_KG 70
+
+/*
+ * Pedometer over the accelerometer stream of the sensor service.
+ *
+ * Per sample: the magnitude of the acceleration (Q16, see fusion.h), a band pass of
+ * two shift-only first order filters (about 0.25 to 3 Hz at ACTIVITY_RATE_HZ), and a
+ * threshold halfway between the minimum and maximum of the last window. A step is a
+ * fall through the threshold with hysteresis, once the swing is large enough. Steps
+ * only count after ACTIVITY_CONFIRM_STEPS regular ones in a row, so waving the arm or
+ * typing does not add up. The cadence comes from the smoothed step interval and sets
+ * the stride from the height; the energy is 0.75 kcal per kg and km.
+ *
+ * The cost per sample is bounded: one square root, a few 32-bit divisions and a
+ * minute bin pushed once a minute. A gap in the stream pushes its empty minutes, at
+ * most ACTIVITY_MINUTES of them.
+ */
+
+typedef struct {
+    // published, read by the faces
+    uint32_t steps;      // today
+    uint32_t distance_m; // today
+    uint32_t kcal;       // today
+    uint16_t cadence;    // steps per minute, 0 while not walking
+
+    // profile
+    uint16_t height_cm;
+    uint16_t weight_kg;
+
+    // band pass
+    int32_t base;   // mg << 8, gravity and slow changes
+    int32_t smooth; // mg, base removed and low passed
+    bool primed;
+
+    // threshold
+    int32_t win_max;
+    int32_t win_min;
+    uint8_t win_count;
+    int32_t threshold;
+    int32_t swing;
+    bool above; // smooth went over the threshold since the last step
+
+    // steps
+    uint32_t last_us;      // time of the last sample
+    uint32_t since_step_us; // since the last step candidate
+    uint16_t interval_ms;  // smoothed step interval
+    uint8_t run;           // regular steps in a row, counted once it reaches ACTIVITY_CONFIRM_STEPS
+    uint32_t distance_mm;
+    uint32_t cal; // 1/1000 kcal
+
+    // steps per minute, ring of ACTIVITY_MINUTES
+    uint8_t minutes[ACTIVITY_MINUTES];
+    uint16_t minute_head; // next bin
+    uint16_t minute_count;
+    uint16_t minute_steps;
+    uint32_t minute_us;
+} activity_t;
+
+// --- Engine ---
+void activity_init(activity_t *a);
+// one sample at ACTIVITY_RATE_HZ, accelerometer in g
+void activity_feed(activity_t *a, const imu_sample_t *s);
+// today's totals back to 0, the minute bins stay
+void activity_reset(activity_t *a);
+// steps of the newest completed minutes, oldest first, returns how many were copied
+uint16_t activity_history(const activity_t *a, uint8_t *out, uint16_t max);
+
+// --- Service ---
+// Opens the stream into the shared engine, call after sensor_service_init()
+void activity_start(void);
+void activity_stop(void);
+const activity_t *activity_get(void);
+void activity_set_profile(uint16_t height_cm, uint16_t weight_kg);
+// Call with the day of the month, the totals restart when it changes
+void activity_set_day(int day);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,9 @@
 #ifndef _COMMON_API_H
 #define _COMMON_API_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -26,10 +29,42 @@ typedef struct imu_data {
 } imu_data_t;
 
 
+typedef struct imu_sample {
+    uint32_t time_us; // sensor service clock, wraps after about 71 minutes
+    float ax;
+    float ay;
+    float az;
+    float gx;
+    float gy;
+    float gz;
+    float temp;
+} imu_sample_t;
+
+typedef enum {
+    IMU_STREAM_DECIMATE, // every n-th sample
+    IMU_STREAM_AVERAGE,  // mean of the samples since the last one delivered
+    IMU_STREAM_LOW_PASS, // first order low pass at half the stream rate
+} imu_stream_filter_t;
+
+// samples oldest first, called on the UI thread
+typedef void (*imu_stream_cb_t)(const imu_sample_t *samples, uint16_t count, void *user);
+
+
 void imu_init();
 imu_data_t get_imu_data();
 void imu_close();
 
+// Streams from the sensor service (common/sensor_service), the IMU runs while one is open.
+// rate_hz above the sensor rate delivers every sample. Returns -1 when all streams are taken.
+int imu_stream_open(uint16_t rate_hz, imu_stream_filter_t filter, imu_stream_cb_t cb, void *user);
+void imu_stream_close(int stream);
+// Longest the samples of a stream may wait before its callback, longer lets the sensor
+// service hand them over less often. 0 restores the default (SENSOR_LATENCY_MS).
+void imu_stream_set_latency(int stream, uint16_t max_ms);
+
+// Newest samples seen by the UI thread, oldest first, returns how many were copied
+uint16_t get_imu_batch(imu_sample_t *out, uint16_t max);
+
 
 #ifdef __cplusplus
 } /*extern "C"*/
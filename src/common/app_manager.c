@@ -8,9 +8,8 @@
  *********************/
 
 #include "app_manager.h"
-
-#include <stdlib.h>
-#include <string.h>
+#include "generated_features.h"
+#include "heap_tags/heap_tags.h"
 
 /*********************
  *      DEFINES
@@ -20,105 +19,212 @@
  *      TYPEDEFS
  **********************/
 
-typedef struct app_node
+typedef struct
 {
-    const app_info_t *info;
-    struct app_node *next;
-} app_node_t;
+    uint32_t last_used; /* use_clock of the last launch */
+    uint32_t launches;
+    uint32_t evictions;
+    size_t bytes;       /* live bytes of the tag right after the last create */
+    size_t peak;
+    heap_tag_t tag;     /* owner of the app's allocations, see heap_tags.h */
+    bool hooked;        /* lifecycle events added to the current screen */
+} app_state_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 
-static int compare(const void *a, const void *b);
+static int app_index(const app_info_t *info);
+static void app_create(void);
+static void app_screen_event_cb(lv_event_t *e);
+static bool app_busy(const app_info_t *info);
+static void app_evict(int index);
+
+/* ui.c, loads the screen when the app list is active */
+void ui_app_load(lv_obj_t **screen, void (*screen_init)(void));
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 
-static app_node_t *head = NULL;
-static int app_count = 0;
+/* Records of the enabled apps, see REGISTER_APP */
+#define APP_ENTRY(_screen_var) extern const app_info_t app_info_##_screen_var;
+#include "generated_apps.h"
+#undef APP_ENTRY
+
+/* Sorted by title when generated, the trailing NULL keeps the table valid with no apps */
+#define APP_ENTRY(_screen_var) &app_info_##_screen_var,
+static const app_info_t *const app_table[] = {
+#include "generated_apps.h"
+    NULL};
+#undef APP_ENTRY
+
+#define APP_COUNT ((int)(sizeof(app_table) / sizeof(app_table[0])) - 1)
+
+static app_state_t app_state[APP_COUNT + 1];
+static uint32_t use_clock = 0;
+static const app_info_t *launching = NULL;
 
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
 
-void app_registry_register(const app_info_t *info)
+void app_registry_iterate(app_register_cb cb)
+{
+    for (const app_info_t *const *info = app_table; *info != NULL; info++)
+    {
+        cb((*info)->name, (*info)->icon, (*info)->callback);
+    }
+}
+
+int app_registry_get_count()
 {
-    app_node_t *node = malloc(sizeof(app_node_t));
-    if (node == NULL)
-        return; /* Handle malloc failure */
-    node->info = info;
-    node->next = head;
-    head = node;
+    return APP_COUNT;
 }
 
-void app_registry_iterate_unsorted(app_register_cb cb)
+void app_manager_launch(const app_info_t *info)
 {
-    app_node_t *current = head;
-    app_count = 0;
-    while (current != NULL)
+    int index = app_index(info);
+    if (index < 0)
+        return;
+
+    /* ui_app_load creates the screen through app_create only when it is missing */
+    launching = info;
+    ui_app_load(info->screen, app_create);
+    launching = NULL;
+
+    if (*info->screen != NULL && !app_state[index].hooked)
     {
-        const app_info_t *info = current->info;
-        cb(info->name, info->icon, info->callback);
-        current = current->next;
-        app_count++;
+        /* created outside the manager, e.g. the navigation screen opened by the HAL */
+        lv_obj_add_event_cb(*info->screen, app_screen_event_cb, LV_EVENT_ALL, (void *)info);
+        app_state[index].tag = heap_tag_get(info->name);
+        heap_tag_bind_screen(*info->screen, app_state[index].tag);
+        app_state[index].hooked = true;
     }
 }
 
-void app_registry_iterate(app_register_cb cb)
+void app_manager_trim(int keep)
 {
-    /* Count the apps */
-    int count = 0;
-    app_node_t *current = head;
-    while (current != NULL)
+    lv_obj_t *active = lv_screen_active();
+
+    for (;;)
     {
-        count++;
-        current = current->next;
+        int resident = 0;
+        size_t bytes = 0;
+        int oldest = -1;
+
+        for (int i = 0; i < APP_COUNT; i++)
+        {
+            lv_obj_t *screen = *app_table[i]->screen;
+            if (screen == NULL)
+                continue;
+            resident++;
+            /* what the screen holds now, including what it allocated while shown */
+            bytes += heap_tag_stats(app_state[i].tag)->live;
+            if (screen == active || app_busy(app_table[i]))
+                continue;
+            if (oldest < 0 || app_state[i].last_used < app_state[oldest].last_used)
+                oldest = i;
+        }
+
+        if (oldest < 0 || (resident <= keep && bytes <= APP_CACHE_BYTES))
+            return;
+        app_evict(oldest);
     }
+}
 
-    /* Copy pointers to array */
-    if (count == 0)
-        return;
-
-    const app_info_t **array = malloc(count * sizeof(app_info_t *));
-    if (!array)
-        return;
+void app_manager_usage(app_usage_cb cb)
+{
+    lv_obj_t *active = lv_screen_active();
 
-    current = head;
-    for (int i = 0; i < count; i++)
+    for (int i = 0; i < APP_COUNT; i++)
     {
-        array[i] = current->info;
-        current = current->next;
+        lv_obj_t *screen = *app_table[i]->screen;
+        app_usage_t usage = {
+            .name = app_table[i]->name,
+            .resident = screen != NULL,
+            .kept = screen != NULL && screen != active && app_busy(app_table[i]),
+            .launches = app_state[i].launches,
+            .evictions = app_state[i].evictions,
+            .bytes = app_state[i].bytes,
+            .peak = app_state[i].peak};
+        cb(&usage);
     }
+}
 
-    /* Sort the array by name */
-    qsort(array, count, sizeof(app_info_t *), compare);
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
 
-    app_count = 0;
-    /* Call callback in sorted order */
-    for (int i = 0; i < count; i++)
+static int app_index(const app_info_t *info)
+{
+    for (int i = 0; i < APP_COUNT; i++)
     {
-        cb(array[i]->name, array[i]->icon, array[i]->callback);
-        app_count++;
+        if (app_table[i] == info)
+            return i;
     }
+    return -1;
+}
+
+static void app_create(void)
+{
+    const app_info_t *info = launching;
+    int index = app_index(info);
+
+    /* room for the new screen first, the app list stays */
+    app_manager_trim(APP_CACHE_SCREENS - 1);
+
+    heap_tag_t tag = heap_tag_get(info->name);
+    heap_tag_t previous = heap_tag_enter(tag);
+    info->create();
+    heap_tag_leave(previous);
 
-    /* Cleanup */
-    free(array);
+    app_state[index].tag = tag;
+    app_state[index].bytes = heap_tag_stats(tag)->live;
+    if (app_state[index].bytes > app_state[index].peak)
+        app_state[index].peak = app_state[index].bytes;
+
+    lv_obj_add_event_cb(*info->screen, app_screen_event_cb, LV_EVENT_ALL, (void *)info);
+    heap_tag_bind_screen(*info->screen, tag);
+    app_state[index].hooked = true;
 }
 
-int app_registry_get_count()
+/* added after the app's own handler, so it sees the unload once the app is done with it */
+static void app_screen_event_cb(lv_event_t *e)
 {
-    return app_count;
+    const app_info_t *info = lv_event_get_user_data(e);
+    int index = app_index(info);
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_SCREEN_LOAD_START)
+    {
+        app_state[index].last_used = ++use_clock;
+        app_state[index].launches++;
+    }
+    else if (code == LV_EVENT_SCREEN_UNLOADED)
+    {
+        app_manager_trim(APP_CACHE_SCREENS);
+    }
+    else if (code == LV_EVENT_DELETE)
+    {
+        /* apps that delete their own screen on unload */
+        app_state[index].hooked = false;
+    }
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+static bool app_busy(const app_info_t *info)
+{
+    return info->suspend != NULL && info->suspend();
+}
 
-static int compare(const void *a, const void *b)
+static void app_evict(int index)
 {
-    const app_info_t *appA = *(const app_info_t **)a;
-    const app_info_t *appB = *(const app_info_t **)b;
-    return strcmp(appA->name, appB->name);
+    const app_info_t *info = app_table[index];
+    lv_obj_t *screen = *info->screen;
+
+    *info->screen = NULL;
+    lv_obj_delete(screen);
+    if (info->destroy)
+        info->destroy();
+    app_state[index].evictions++;
 }
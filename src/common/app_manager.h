@@ -20,6 +20,16 @@ extern "C"
  *      DEFINES
  *********************/
 
+/* App screens kept after their app was closed, least recently used go first */
+#ifndef APP_CACHE_SCREENS
+#define APP_CACHE_SCREENS 2
+#endif
+
+/* Heap the kept screens may take together, the live bytes of their heap tags */
+#ifndef APP_CACHE_BYTES
+#define APP_CACHE_BYTES (48 * 1024)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -28,19 +38,51 @@ typedef struct
     const char *name;
     const lv_image_dsc_t *icon;
     void (*callback)(lv_event_t *e);
+    lv_obj_t **screen;
+    void (*create)(void);  /* builds *screen */
+    void (*destroy)(void); /* optional, after *screen was evicted, resets what create set up besides the screen */
+    bool (*suspend)(void); /* optional, the app is in the background, return true to keep the screen */
 } app_info_t;
 
+typedef struct
+{
+    const char *name;
+    bool resident;      /* the screen exists */
+    bool kept;          /* resident and its suspend hook keeps it */
+    uint32_t launches;
+    uint32_t evictions;
+    size_t bytes;       /* heap the app held right after the last create */
+    size_t peak;        /* largest create so far */
+} app_usage_t;
+
 typedef void (*app_register_cb)(const char *name, const lv_image_dsc_t *icon, void (*callback)(lv_event_t *e));
+typedef void (*app_usage_cb)(const app_usage_t *usage);
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
-void app_registry_register(const app_info_t *info);
 void app_registry_iterate(app_register_cb cb);
-void app_registry_iterate_unsorted(app_register_cb cb);
 int app_registry_get_count();
 
+/**
+ * @brief Open an app from the app list, creating its screen when it is not resident
+ * @note The launch callback of REGISTER_APP calls this.
+ */
+void app_manager_launch(const app_info_t *info);
+
+/**
+ * @brief Evict background app screens until at most keep are left and they fit in APP_CACHE_BYTES
+ * @note Called when an app screen was left and before a screen is created. The active
+ *       screen and apps whose suspend hook returns true are never evicted.
+ */
+void app_manager_trim(int keep);
+
+/**
+ * @brief Report heap use and lifecycle counts of every registered app
+ */
+void app_manager_usage(app_usage_cb cb);
+
 /**********************
  *      MACROS
  **********************/
@@ -53,22 +95,39 @@ int app_registry_get_count();
  * @param _screen_init_fn The function to initialize the screen
  * @note This macro should be used in the source file where the app is implemented.
  *       It will automatically create a static variable for the screen and a callback function
- *       to launch the app. The callback function will be registered with the app manager.
+ *       to launch the app, and a constant app_info_ record named after the screen variable.
+ *       support/header_gen.py finds the macro at build time and lists the record in
+ *       generated_apps.h, sorted by title, so nothing is allocated or run at startup.
+ *       Keep the call on one line, with the title as a string literal, inside the
+ *       #ifdef ENABLE_ guard of the app.
+ *       The screen may be deleted after the app was closed, see REGISTER_APP_HOOKS.
+ */
+#define REGISTER_APP(_title, _icon, _screen_var, _screen_init_fn) \
+    REGISTER_APP_HOOKS(_title, _icon, _screen_var, _screen_init_fn, NULL, NULL)
+
+/**
+ * @brief Register an app with lifecycle hooks
+ * @param _destroy_fn Called after the manager deleted the screen (may be NULL), e.g. to
+ *        drop timers or pointers create left outside the screen
+ * @param _suspend_fn Called while the app is in the background (may be NULL, may be called
+ *        more than once), returns true while the screen has to stay, e.g. a running countdown
+ * @note Declare the hooks before the macro. Other parameters as REGISTER_APP.
  */
-#define REGISTER_APP(_title, _icon, _screen_var, _screen_init_fn)      \
-static lv_obj_t *_screen_var;                                          \
-static void _screen_var##_launch_cb(lv_event_t *e)                     \
-{                                                                      \
-    ui_app_load(&_screen_var, _screen_init_fn);                        \
-}                                                                      \
-static app_info_t _app_info_##_screen_var = {                          \
-    .name = _title,                                                    \
-    .icon = _icon,                                                     \
-    .callback = _screen_var##_launch_cb};                              \
-static void __attribute__((constructor)) _register_##_screen_var(void) \
-{                                                                      \
-    app_registry_register(&_app_info_##_screen_var);                   \
-}
+#define REGISTER_APP_HOOKS(_title, _icon, _screen_var, _screen_init_fn, _destroy_fn, _suspend_fn) \
+static lv_obj_t *_screen_var;                                                                    \
+extern const app_info_t app_info_##_screen_var;                                                  \
+static void _screen_var##_launch_cb(lv_event_t *e)                                               \
+{                                                                                                \
+    app_manager_launch(&app_info_##_screen_var);                                                 \
+}                                                                                                \
+const app_info_t app_info_##_screen_var = {                                                      \
+    .name = _title,                                                                              \
+    .icon = _icon,                                                                               \
+    .callback = _screen_var##_launch_cb,                                                         \
+    .screen = &_screen_var,                                                                      \
+    .create = _screen_init_fn,                                                                   \
+    .destroy = _destroy_fn,                                                                      \
+    .suspend = _suspend_fn}
 
 
 
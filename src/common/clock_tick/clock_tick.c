@@ -0,0 +1,70 @@
+#include "clock_tick.h"
+#include <stddef.h>
+
+typedef struct {
+    clock_tick_cb_t cb;
+    uint8_t units;
+} clock_tick_sub_t;
+
+static clock_tick_sub_t subs[CLOCK_TICK_MAX_SUBS];
+static clock_tick_time_t last;
+static bool invalid = true;
+
+bool clock_tick_subscribe(uint8_t units, clock_tick_cb_t cb) {
+    for (int i = 0; i < CLOCK_TICK_MAX_SUBS; i++) {
+        if (subs[i].cb == cb) {
+            subs[i].units = units;
+            return true;
+        }
+    }
+    for (int i = 0; i < CLOCK_TICK_MAX_SUBS; i++) {
+        if (subs[i].cb == NULL) {
+            subs[i].cb = cb;
+            subs[i].units = units;
+            // the new subscriber gets the current time on the next update
+            invalid = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void clock_tick_unsubscribe(clock_tick_cb_t cb) {
+    for (int i = 0; i < CLOCK_TICK_MAX_SUBS; i++) {
+        if (subs[i].cb == cb) {
+            subs[i].cb = NULL;
+            subs[i].units = 0;
+        }
+    }
+}
+
+void clock_tick_invalidate(void) {
+    invalid = true;
+}
+
+uint8_t clock_tick_update(const clock_tick_time_t *now) {
+    uint8_t changed = 0;
+
+    if (invalid) {
+        changed = CLOCK_TICK_ALL;
+        invalid = false;
+    } else if (now->day != last.day || now->month != last.month || now->year != last.year || now->weekday != last.weekday) {
+        changed = CLOCK_TICK_ALL;
+    } else if (now->hour != last.hour) {
+        changed = CLOCK_TICK_HOUR | CLOCK_TICK_MINUTE | CLOCK_TICK_SECOND;
+    } else if (now->minute != last.minute) {
+        changed = CLOCK_TICK_MINUTE | CLOCK_TICK_SECOND;
+    } else if (now->second != last.second) {
+        changed = CLOCK_TICK_SECOND;
+    } else {
+        return 0;
+    }
+    last = *now;
+
+    for (int i = 0; i < CLOCK_TICK_MAX_SUBS; i++) {
+        if (subs[i].cb != NULL && (subs[i].units & changed)) {
+            subs[i].cb(now, subs[i].units & changed);
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLOCK_TICK_MAX_SUBS 8
+
+// Units a subscriber is called for, a larger unit changing also counts as the smaller ones
+typedef enum {
+    CLOCK_TICK_SECOND = 1 << 0,
+    CLOCK_TICK_MINUTE = 1 << 1,
+    CLOCK_TICK_HOUR = 1 << 2,
+    CLOCK_TICK_DAY = 1 << 3, // day, month, year or weekday
+    CLOCK_TICK_ALL = 0x0F,
+} clock_tick_unit_t;
+
+typedef struct {
+    int second;
+    int minute;
+    int hour;    // 0-23
+    int day;     // 1-31
+    int month;   // 1-12
+    int year;
+    int weekday; // 0 = Sunday
+} clock_tick_time_t;
+
+// `changed` holds the units that changed since the last call, masked to the subscribed ones
+typedef void (*clock_tick_cb_t)(const clock_tick_time_t *now, uint8_t changed);
+
+// Returns false when all CLOCK_TICK_MAX_SUBS slots are taken
+bool clock_tick_subscribe(uint8_t units, clock_tick_cb_t cb);
+void clock_tick_unsubscribe(clock_tick_cb_t cb);
+
+// Feed the current time from the main loop. Only compares fields until a unit changes,
+// then calls the subscribers of the changed units. Returns the changed units.
+uint8_t clock_tick_update(const clock_tick_time_t *now);
+
+// Report every unit as changed on the next update (time synced, 12/24h mode or face changed)
+void clock_tick_invalidate(void);
+
+#ifdef __cplusplus
+}
+#endif
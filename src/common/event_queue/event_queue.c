@@ -0,0 +1,95 @@
+#include "event_queue.h"
+#include <string.h>
+
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_SIZE - 1)
+
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#if (EVENT_QUEUE_SIZE & EVENT_QUEUE_MASK) != 0
+#error "EVENT_QUEUE_SIZE must be a power of two"
+#endif
+
+void event_queue_init(event_queue_t *q, void (*wake)(void)) {
+    memset(q, 0, sizeof(*q));
+    q->wake = wake;
+}
+
+// --- Producer ---
+bool event_queue_push(event_queue_t *q, event_type_t type, uint32_t a, uint32_t b) {
+    uint32_t tail = LOAD(&q->tail);
+    if (tail - LOAD_ACQUIRE(&q->head) >= EVENT_QUEUE_SIZE) {
+        STORE(&q->dropped, LOAD(&q->dropped) + 1);
+        return false;
+    }
+
+    event_t *slot = &q->ring[tail & EVENT_QUEUE_MASK];
+    slot->type = type;
+    slot->a = a;
+    slot->b = b;
+    // publishes the slot contents together with the new tail
+    STORE_RELEASE(&q->tail, tail + 1);
+
+    if (q->wake) q->wake();
+    return true;
+}
+
+void event_queue_post(event_queue_t *q, event_type_t type, uint32_t a, uint32_t b) {
+    if (type <= EVENT_NONE || type >= EVENT_TYPE_COUNT) return;
+
+    uint32_t seq = LOAD(&q->latest[type].seq);
+    STORE(&q->latest[type].seq, seq + 1);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    STORE(&q->latest[type].a, a);
+    STORE(&q->latest[type].b, b);
+    STORE_RELEASE(&q->latest[type].seq, seq + 2);
+
+    if (q->wake) q->wake();
+}
+
+// --- Consumer ---
+// A slot caught mid write is left for the next drain, the producer wakes the
+// consumer again once it is done, so there is no spinning on a preempted producer.
+static bool event_queue_take_latest(event_queue_t *q, uint32_t type, event_t *event) {
+    uint32_t seq = LOAD_ACQUIRE(&q->latest[type].seq);
+    if (seq == q->seen[type] || (seq & 1)) return false;
+
+    event->type = type;
+    event->a = LOAD(&q->latest[type].a);
+    event->b = LOAD(&q->latest[type].b);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (LOAD(&q->latest[type].seq) != seq) return false;
+
+    q->seen[type] = seq;
+    return true;
+}
+
+uint32_t event_queue_drain(event_queue_t *q, event_handler_t handler) {
+    uint32_t handled = 0;
+    event_t event;
+
+    for (uint32_t type = EVENT_NONE + 1; type < EVENT_TYPE_COUNT; type++) {
+        if (event_queue_take_latest(q, type, &event)) {
+            handler(&event);
+            handled++;
+        }
+    }
+
+    // only what is queued now, a fast producer cannot keep the consumer here
+    uint32_t head = LOAD(&q->head);
+    uint32_t tail = LOAD_ACQUIRE(&q->tail);
+    while (head != tail) {
+        event = q->ring[head & EVENT_QUEUE_MASK];
+        head++;
+        STORE_RELEASE(&q->head, head);
+        handler(&event);
+        handled++;
+    }
+    return handled;
+}
+
+uint32_t event_queue_dropped(const event_queue_t *q) {
+    return LOAD(&q->dropped);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ring capacity, must be a power of two
+#define EVENT_QUEUE_SIZE 32
+
+// Events from the BLE/HAL callbacks to the UI loop
+typedef enum {
+    EVENT_NONE = 0,
+    EVENT_NOTIFICATIONS, // notification list changed
+    EVENT_WEATHER,       // current weather changed
+    EVENT_FORECAST,      // forecast and hourly weather changed
+    EVENT_NAV_DATA,      // navigation text changed
+    EVENT_NAV_ICON,      // navigation icon received, a = icon CRC
+    EVENT_TIME_SYNC,     // time synced from the phone
+    EVENT_APP_INFO,      // companion app connected, a = app code
+    EVENT_QR_LINKS,      // QR links received
+    EVENT_CONNECTION,    // phone connected or disconnected, a = state
+    EVENT_ALERT,         // notification received, show it as an alert
+    EVENT_CAMERA,        // camera remote opened or closed, a = state
+    EVENT_FONT_COLOR,    // face text color set from the app, a = color, b = style << 16 | position
+    EVENT_CONTACTS,      // a = 0 contacts are being received, 1 all received, b = SOS index << 8 | count
+    EVENT_TYPE_COUNT
+} event_type_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t a;
+    uint32_t b;
+} event_t;
+
+typedef void (*event_handler_t)(const event_t *event);
+
+/*
+ * Lock-free queue for exactly one producer context and one consumer context.
+ *
+ * event_queue_push() adds to a FIFO ring, events keep their order and are dropped
+ * (and counted) when the ring is full. event_queue_post() is coalesced: each type
+ * has one slot and only the newest payload is delivered, however often it was
+ * posted before the consumer got to it.
+ *
+ * Only aligned 32-bit loads and stores with acquire/release ordering are used,
+ * no read-modify-write, so it works on cores without atomic instructions (C3).
+ */
+typedef struct {
+    event_t ring[EVENT_QUEUE_SIZE];
+    uint32_t head; // next slot to read, written by the consumer
+    uint32_t tail; // next slot to write, written by the producer
+    uint32_t dropped;
+
+    // seqlock per type, odd while the producer writes the payload
+    struct {
+        uint32_t seq;
+        uint32_t a;
+        uint32_t b;
+    } latest[EVENT_TYPE_COUNT];
+    uint32_t seen[EVENT_TYPE_COUNT]; // consumer side copy of seq
+
+    void (*wake)(void);
+} event_queue_t;
+
+void event_queue_init(event_queue_t *q, void (*wake)(void));
+
+// Producer side, both call the wake callback afterwards
+bool event_queue_push(event_queue_t *q, event_type_t type, uint32_t a, uint32_t b);
+void event_queue_post(event_queue_t *q, event_type_t type, uint32_t a, uint32_t b);
+
+// Consumer side, handles the coalesced events and then the ring entries that were
+// queued when it was called. Returns the number of events handled.
+uint32_t event_queue_drain(event_queue_t *q, event_handler_t handler);
+
+// Ring entries lost because the queue was full
+uint32_t event_queue_dropped(const event_queue_t *q);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,104 @@
+#include "fusion.h"
+
+#define Q16_DEG(d) ((q16_t)(d) * Q16_ONE)
+// 65536 / 1e6 in Q16, turns microseconds into Q16 seconds
+#define US_TO_Q16 4295
+
+// --- Math ---
+q16_t q16_mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+static uint32_t isqrt32(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+q16_t q16_sqrt(q16_t v) {
+    if (v <= 0) return 0;
+
+    // the root of a Q16 value is Q8, scale up by powers of four first to keep 15+ bits
+    uint32_t u = (uint32_t)v;
+    int shift = 0;
+    while (u < (1u << 30) && shift < 8) {
+        u <<= 2;
+        shift++;
+    }
+    return (q16_t)(isqrt32(u) << (8 - shift));
+}
+
+// atan(z) in Q16 degrees for z in 0..1 (Q16), 45z + z(1-z)(14.02 + 3.80z)
+static q16_t atan_unit(uint32_t z) {
+    q16_t poly = 918835 + (q16_t)((248952 * (int64_t)z) >> 16);
+    q16_t curve = (q16_t)(((int64_t)z * (Q16_ONE - z)) >> 16);
+    return 45 * (q16_t)z + q16_mul(curve, poly);
+}
+
+q16_t q16_atan2_deg(q16_t y, q16_t x) {
+    uint32_t ux = x < 0 ? -(uint32_t)x : (uint32_t)x;
+    uint32_t uy = y < 0 ? -(uint32_t)y : (uint32_t)y;
+    if (ux == 0 && uy == 0) return 0;
+
+    // only the ratio matters, 15 bits keep the division in 32 bits
+    while (ux > 0x7FFF || uy > 0x7FFF) {
+        ux >>= 1;
+        uy >>= 1;
+    }
+
+    q16_t angle = uy <= ux ? atan_unit((uy << 16) / ux) : Q16_DEG(90) - atan_unit((ux << 16) / uy);
+    if (x < 0) angle = Q16_DEG(180) - angle;
+    return y < 0 ? -angle : angle;
+}
+
+// --- Filter ---
+static q16_t wrap180(q16_t angle) {
+    while (angle > Q16_DEG(180)) angle -= Q16_DEG(360);
+    while (angle < -Q16_DEG(180)) angle += Q16_DEG(360);
+    return angle;
+}
+
+// moves the integrated gyro angle the fraction beta towards the accelerometer angle
+static q16_t blend(q16_t gyro, q16_t acc, q16_t beta) {
+    return wrap180(gyro + q16_mul(wrap180(acc - gyro), beta));
+}
+
+void fusion_init(fusion_t *f, uint16_t tau_ms) {
+    f->pitch = 0;
+    f->roll = 0;
+    f->tau = (q16_t)((tau_ms * (int64_t)Q16_ONE) / 1000);
+    f->last_us = 0;
+    f->primed = false;
+}
+
+void fusion_update(fusion_t *f, const fusion_input_t *in, uint32_t time_us) {
+    q16_t horizontal = q16_sqrt(q16_mul(in->ay, in->ay) + q16_mul(in->az, in->az));
+    q16_t accPitch = q16_atan2_deg(-in->ax, horizontal);
+    q16_t accRoll = q16_atan2_deg(in->ay, in->az);
+
+    uint32_t dtUs = time_us - f->last_us;
+    f->last_us = time_us;
+    if (!f->primed || dtUs > FUSION_MAX_DT_US) {
+        f->pitch = accPitch;
+        f->roll = accRoll;
+        f->primed = true;
+        return;
+    }
+
+    q16_t dt = (q16_t)((dtUs * US_TO_Q16) >> 16);
+    // 1 - tau / (tau + dt), the share of the accelerometer in this step
+    q16_t beta = (q16_t)(((uint32_t)dt << 16) / (uint32_t)(f->tau + dt));
+
+    f->pitch = blend(f->pitch + q16_mul(in->gy, dt), accPitch, beta);
+    f->roll = blend(f->roll + q16_mul(in->gx, dt), accRoll, beta);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Pitch and roll from the IMU stream, complementary filter in Q16 fixed point.
+ *
+ * The C3 has no FPU, so everything past the input conversion is integer math: 32-bit
+ * divisions and 32x32->64 multiplies only. The gyro is integrated between samples and
+ * pulled towards the accelerometer angles with the time constant given to
+ * fusion_init(), which takes out the gyro drift and most of the accelerometer jitter.
+ *
+ * Axes: x forward, y left, z up, the watch lying flat reads 0/0. Pitch is about y
+ * (-90..90), roll about x (-180..180). Inputs in g and deg/s.
+ */
+
+typedef int32_t q16_t;
+
+#define Q16_ONE 65536
+#define Q16_FROM_FLOAT(x) ((q16_t)((x) * 65536.0f))
+#define Q16_TO_FLOAT(x) ((float)(x) / 65536.0f)
+// nearest integer, for labels and image rotations
+#define Q16_ROUND(x) (((x) + Q16_ONE / 2) >> 16)
+
+// Gaps longer than this restart from the accelerometer
+#define FUSION_MAX_DT_US 250000
+
+typedef struct {
+    q16_t ax, ay, az; // g
+    q16_t gx, gy, gz; // deg/s
+} fusion_input_t;
+
+typedef struct {
+    q16_t pitch; // degrees
+    q16_t roll;  // degrees
+    q16_t tau;   // seconds
+    uint32_t last_us;
+    bool primed;
+} fusion_t;
+
+// tau_ms: how long the gyro is trusted, 500 suits a watch
+void fusion_init(fusion_t *f, uint16_t tau_ms);
+// time_us from the sample, wraps like the sensor service clock
+void fusion_update(fusion_t *f, const fusion_input_t *in, uint32_t time_us);
+
+q16_t q16_mul(q16_t a, q16_t b);
+// square root of v >= 0
+q16_t q16_sqrt(q16_t v);
+// degrees, -180..180, error below 0.1 degree
+q16_t q16_atan2_deg(q16_t y, q16_t x);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+#include "game_loop.h"
+#include <stddef.h>
+#include <string.h>
+
+static const game_def_t *game = NULL;
+static uint32_t (*clock_ms)(void) = NULL;
+static uint32_t last = 0;
+static uint32_t step_us = 0;
+static uint32_t acc_us = 0; // time not yet simulated, in microseconds so 60 Hz does not drift
+static game_loop_stats_t stats;
+
+void game_loop_start(const game_def_t *def, uint32_t (*clock)(void)) {
+    if (def == NULL || def->update == NULL || def->hz == 0 || clock == NULL) return;
+
+    game = def;
+    clock_ms = clock;
+    step_us = 1000000UL / def->hz;
+    acc_us = 0;
+    last = clock();
+    memset(&stats, 0, sizeof(stats));
+}
+
+void game_loop_stop(void) {
+    game = NULL;
+}
+
+bool game_loop_running(void) {
+    return game != NULL;
+}
+
+uint32_t game_loop_tick(void) {
+    if (game == NULL) return GAME_LOOP_IDLE_MS;
+
+    const game_def_t *running = game;
+    uint32_t now = clock_ms();
+    acc_us += (now - last) * 1000;
+    last = now;
+
+    // --- Fixed updates ---
+    int steps = 0;
+    while (acc_us >= step_us) {
+        if (steps == GAME_LOOP_MAX_STEPS) {
+            // too far behind (stall, heavy frame), drop the backlog instead of catching up
+            stats.dropped_ms += (acc_us - acc_us % step_us) / 1000;
+            acc_us %= step_us;
+            break;
+        }
+        running->update(step_us);
+        acc_us -= step_us;
+        steps++;
+        stats.steps++;
+        // the update may have ended the game
+        if (game != running) return GAME_LOOP_IDLE_MS;
+    }
+
+    // --- Render ---
+    if (running->render != NULL) {
+        running->render((float)acc_us / step_us);
+    }
+
+    // --- Frame budget ---
+    uint32_t took = clock_ms() - now;
+    stats.ticks++;
+    if (took > step_us / 1000) stats.over_budget++;
+    if (took > stats.max_tick_ms) stats.max_tick_ms = took;
+
+    return (step_us - acc_us + 999) / 1000;
+}
+
+const game_loop_stats_t *game_loop_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed updates per tick before the rest of a late tick is dropped
+#define GAME_LOOP_MAX_STEPS 5
+// What game_loop_tick() returns while no game runs
+#define GAME_LOOP_IDLE_MS 1000
+
+// A game on the shared runtime, usually a static const next to its screen code
+typedef struct {
+    const char *name;
+    uint16_t hz;                     // fixed update rate
+    void (*update)(uint32_t dt_us);  // advance the game state by one step (1000000 / hz us)
+    void (*render)(float alpha);     // optional, draw the state `alpha` (0..1) of a step past the last update
+} game_def_t;
+
+typedef struct {
+    uint32_t ticks;       // game_loop_tick() calls while a game ran
+    uint32_t steps;       // fixed updates
+    uint32_t dropped_ms;  // time skipped when a tick came too late for GAME_LOOP_MAX_STEPS
+    uint32_t over_budget; // ticks whose updates and render took longer than one step
+    uint32_t max_tick_ms; // slowest tick
+} game_loop_stats_t;
+
+// Run `game` from now on, `clock` is the millisecond time base (lv_tick_get, the virtual
+// clock in the emulator). Replaces a running game and resets the stats.
+void game_loop_start(const game_def_t *game, uint32_t (*clock)(void));
+void game_loop_stop(void);
+bool game_loop_running(void);
+
+// Call from the loop that owns the game's objects. Runs the fixed updates that are due,
+// renders once and returns the time until the next update is due.
+uint32_t game_loop_tick(void);
+
+const game_loop_stats_t *game_loop_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,56 @@
+// Auto-generated app table, sorted by title
+// DO NOT EDIT this file
+// It will be overwritten
+
+// Attitude
+#ifdef ENABLE_APP_ATTITUDE
+APP_ENTRY(ui_attiudeScreen)
+#endif
+
+// Calendar
+#ifdef ENABLE_APP_CALENDAR
+APP_ENTRY(calendar_screen_main)
+#endif
+
+// Contacts
+#ifdef ENABLE_APP_CONTACTS
+APP_ENTRY(ui_contactScreen)
+#endif
+
+// Navigation
+#ifdef ENABLE_APP_NAVIGATION
+APP_ENTRY(ui_navScreen)
+#endif
+
+// PIO Bot
+APP_ENTRY(ui_pioScreen)
+
+// QMI8658C
+#ifdef ENABLE_APP_QMI8658C
+APP_ENTRY(ui_imuScreen)
+#endif
+
+// Racing
+#ifdef ENABLE_GAME_RACING
+APP_ENTRY(ui_raceScreen)
+#endif
+
+// Range
+#ifdef ENABLE_APP_RANGE
+APP_ENTRY(range_screen_main)
+#endif
+
+// Sample App
+#ifdef ENABLE_APP_SAMPLE
+APP_ENTRY(sample_screen_main)
+#endif
+
+// Simon Says
+#ifdef ENABLE_GAME_SIMON
+APP_ENTRY(ui_simonScreen)
+#endif
+
+// Timer
+#ifdef ENABLE_APP_TIMER
+APP_ENTRY(ui_timerScreen)
+#endif
@@ -0,0 +1,238 @@
+#include "heap_tags.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HEAP_TAG_INHERIT 0xFF // no tag entered, the active screen decides
+
+// one per block, in front of what LVGL gets
+typedef struct {
+    uint32_t size;
+    heap_tag_t tag;
+} heap_block_t;
+
+#define HEAP_HEADER ((sizeof(heap_block_t) + HEAP_TAGS_ALIGN - 1) & ~(size_t)(HEAP_TAGS_ALIGN - 1))
+
+typedef struct {
+    lv_obj_t *screen;
+    heap_tag_t tag;
+} heap_screen_t;
+
+static heap_tag_stats_t tags[HEAP_TAG_MAX] = {{"system", 0, 0, 0, 0}};
+static uint8_t numTags = 1;
+static heap_tag_t scopeTag = HEAP_TAG_INHERIT;
+
+static heap_screen_t screens[HEAP_TAG_SCREENS];
+static lv_obj_t *cachedScreen = NULL;
+static heap_tag_t cachedTag = HEAP_TAG_SYSTEM;
+
+static size_t totalLive = 0;
+static size_t totalPeak = 0;
+static uint32_t totalBlocks = 0;
+
+static size_t (*freeProbe)(void) = NULL;
+static size_t (*largestProbe)(void) = NULL;
+
+// --- Tags ---
+void heap_tags_init(size_t (*free_bytes)(void), size_t (*largest_free)(void)) {
+    freeProbe = free_bytes;
+    largestProbe = largest_free;
+}
+
+heap_tag_t heap_tag_get(const char *name) {
+    if (name == NULL) return HEAP_TAG_SYSTEM;
+    for (uint8_t i = 0; i < numTags; i++) {
+        if (strcmp(tags[i].name, name) == 0) return i;
+    }
+    if (numTags >= HEAP_TAG_MAX) return HEAP_TAG_SYSTEM;
+
+    memset(&tags[numTags], 0, sizeof(tags[numTags]));
+    tags[numTags].name = name;
+    return numTags++;
+}
+
+heap_tag_t heap_tag_enter(heap_tag_t tag) {
+    heap_tag_t previous = scopeTag;
+    scopeTag = tag;
+    return previous;
+}
+
+void heap_tag_leave(heap_tag_t previous) {
+    scopeTag = previous;
+}
+
+// called for every allocation, the screen lookup only runs when the active screen changed
+heap_tag_t heap_tag_current(void) {
+    if (scopeTag != HEAP_TAG_INHERIT) return scopeTag;
+
+    // lv_init allocates before there is a display
+    if (lv_display_get_default() == NULL) return HEAP_TAG_SYSTEM;
+
+    lv_obj_t *active = lv_screen_active();
+    if (active != cachedScreen) {
+        cachedScreen = active;
+        cachedTag = HEAP_TAG_SYSTEM;
+        for (int i = 0; i < HEAP_TAG_SCREENS; i++) {
+            if (screens[i].screen != NULL && screens[i].screen == active) {
+                cachedTag = screens[i].tag;
+                break;
+            }
+        }
+    }
+    return cachedTag;
+}
+
+// --- Screens ---
+static void heap_tag_screen_deleted(lv_event_t *e) {
+    lv_obj_t *screen = lv_event_get_target(e);
+    for (int i = 0; i < HEAP_TAG_SCREENS; i++) {
+        if (screens[i].screen == screen) screens[i].screen = NULL;
+    }
+    // a new screen may get the same address
+    if (cachedScreen == screen) cachedScreen = NULL;
+}
+
+void heap_tag_bind_screen(lv_obj_t *screen, heap_tag_t tag) {
+    if (screen == NULL) return;
+
+    heap_screen_t *slot = NULL;
+    for (int i = 0; i < HEAP_TAG_SCREENS; i++) {
+        if (screens[i].screen == screen) {
+            screens[i].tag = tag;
+            cachedScreen = NULL;
+            return;
+        }
+        if (slot == NULL && screens[i].screen == NULL) slot = &screens[i];
+    }
+    if (slot == NULL) return;
+
+    slot->screen = screen;
+    slot->tag = tag;
+    cachedScreen = NULL;
+    lv_obj_add_event_cb(screen, heap_tag_screen_deleted, LV_EVENT_DELETE, NULL);
+}
+
+const char *heap_tag_screen_name(lv_obj_t *screen) {
+    for (int i = 0; i < HEAP_TAG_SCREENS; i++) {
+        if (screens[i].screen != NULL && screens[i].screen == screen) return tags[screens[i].tag].name;
+    }
+    return NULL;
+}
+
+// --- Stats ---
+const heap_tag_stats_t *heap_tag_stats(heap_tag_t tag) {
+    return &tags[tag < numTags ? tag : HEAP_TAG_SYSTEM];
+}
+
+void heap_tags_iterate(heap_tag_cb_t cb) {
+    for (uint8_t i = 0; i < numTags; i++) {
+        cb(&tags[i]);
+    }
+}
+
+void heap_tags_totals(heap_totals_t *totals) {
+    memset(totals, 0, sizeof(*totals));
+    totals->live = totalLive;
+    totals->peak = totalPeak;
+    totals->blocks = totalBlocks;
+    totals->overhead = totalBlocks * HEAP_HEADER;
+    if (freeProbe) totals->free = freeProbe();
+    if (largestProbe) totals->largest_free = largestProbe();
+    if (totals->free > 0 && totals->largest_free > 0 && totals->largest_free <= totals->free) {
+        totals->frag_pct = (uint8_t)(100 - totals->largest_free * 100 / totals->free);
+    }
+}
+
+static void heap_account_add(heap_tag_t tag, size_t size, bool newBlock) {
+    heap_tag_stats_t *t = &tags[tag];
+    t->live += size;
+    if (t->live > t->peak) t->peak = t->live;
+    totalLive += size;
+    if (totalLive > totalPeak) totalPeak = totalLive;
+    if (newBlock) {
+        t->blocks++;
+        t->allocs++;
+        totalBlocks++;
+    }
+}
+
+static void heap_account_remove(heap_tag_t tag, size_t size, bool lastOfBlock) {
+    tags[tag].live -= size;
+    totalLive -= size;
+    if (lastOfBlock) {
+        tags[tag].blocks--;
+        totalBlocks--;
+    }
+}
+
+// --- LVGL stdlib ---
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+
+void lv_mem_init(void) {}
+
+void lv_mem_deinit(void) {}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes) {
+    LV_UNUSED(mem);
+    LV_UNUSED(bytes);
+    return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool) {
+    LV_UNUSED(pool);
+}
+
+void *lv_malloc_core(size_t size) {
+    heap_block_t *block = malloc(HEAP_HEADER + size);
+    if (block == NULL) return NULL;
+
+    block->size = (uint32_t)size;
+    block->tag = heap_tag_current();
+    heap_account_add(block->tag, size, true);
+    return (uint8_t *)block + HEAP_HEADER;
+}
+
+// the block keeps its owner, whoever resizes it
+void *lv_realloc_core(void *p, size_t new_size) {
+    if (p == NULL) return lv_malloc_core(new_size);
+
+    heap_block_t *block = (heap_block_t *)((uint8_t *)p - HEAP_HEADER);
+    size_t oldSize = block->size;
+    heap_tag_t tag = block->tag;
+
+    heap_block_t *moved = realloc(block, HEAP_HEADER + new_size);
+    if (moved == NULL) return NULL;
+
+    moved->size = (uint32_t)new_size;
+    heap_account_remove(tag, oldSize, false);
+    heap_account_add(tag, new_size, false);
+    return (uint8_t *)moved + HEAP_HEADER;
+}
+
+void lv_free_core(void *p) {
+    if (p == NULL) return;
+
+    heap_block_t *block = (heap_block_t *)((uint8_t *)p - HEAP_HEADER);
+    heap_account_remove(block->tag, block->size, true);
+    free(block);
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p) {
+    heap_totals_t totals;
+    heap_tags_totals(&totals);
+
+    mon_p->total_size = totals.live + totals.overhead + totals.free;
+    mon_p->free_size = totals.free;
+    mon_p->free_biggest_size = totals.largest_free;
+    mon_p->used_cnt = totals.blocks;
+    mon_p->max_used = totals.peak;
+    mon_p->frag_pct = totals.frag_pct;
+    if (mon_p->total_size > 0) {
+        mon_p->used_pct = (uint8_t)((mon_p->total_size - totals.free) * 100 / mon_p->total_size);
+    }
+}
+
+lv_result_t lv_mem_test_core(void) {
+    return LV_RESULT_OK;
+}
+
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HEAP_TAG_MAX 64      // owners, including HEAP_TAG_SYSTEM
+#define HEAP_TAG_SCREENS 64  // screens bound to an owner at a time
+#define HEAP_TAGS_ALIGN 8    // alignment of the blocks handed to LVGL
+
+#define HEAP_TAG_SYSTEM 0    // everything without an owner
+
+/*
+ * Owner tags for the LVGL heap. lv_conf.h selects LV_STDLIB_CUSTOM and this module
+ * implements lv_malloc_core and friends on top of malloc, with a small header per block
+ * that holds its size and owner.
+ *
+ * An allocation belongs to the tag entered with heap_tag_enter(), otherwise to the tag
+ * bound to the active screen, otherwise to HEAP_TAG_SYSTEM. The app manager, the built-in
+ * screen registry and the watchface list enter a tag while they create a screen and bind
+ * the screen to it, so its event handlers, timers and label updates count for it while it
+ * is shown. A block is freed from the owner that allocated it.
+ *
+ * UI thread only, like every other LVGL call.
+ */
+
+typedef uint8_t heap_tag_t;
+
+typedef struct {
+    const char *name;
+    size_t live;     // bytes currently allocated, headers not included
+    size_t peak;
+    uint32_t blocks; // live allocations
+    uint32_t allocs; // allocations since boot
+} heap_tag_stats_t;
+
+typedef struct {
+    size_t live;
+    size_t peak;
+    uint32_t blocks;
+    size_t overhead;     // bytes taken by the block headers
+    size_t free;         // free heap reported by the HAL, 0 when unknown
+    size_t largest_free; // largest free block reported by the HAL, 0 when unknown
+    uint8_t frag_pct;    // 100 - largest_free / free, 0 when unknown
+} heap_totals_t;
+
+typedef void (*heap_tag_cb_t)(const heap_tag_stats_t *stats);
+
+// HAL probes for the fragmentation figures, either may be NULL
+void heap_tags_init(size_t (*free_bytes)(void), size_t (*largest_free)(void));
+
+// Tag with this name, created on first use. name must stay valid. HEAP_TAG_SYSTEM when full.
+heap_tag_t heap_tag_get(const char *name);
+
+// Attribute allocations to tag until heap_tag_leave(previous), returns previous
+heap_tag_t heap_tag_enter(heap_tag_t tag);
+void heap_tag_leave(heap_tag_t previous);
+heap_tag_t heap_tag_current(void);
+
+// Attribute allocations made while screen is active to tag, until the screen is deleted
+void heap_tag_bind_screen(lv_obj_t *screen, heap_tag_t tag);
+// Name of the owner bound to screen, NULL if it has none
+const char *heap_tag_screen_name(lv_obj_t *screen);
+
+// Figures of one owner, valid until the next heap_tag_get()
+const heap_tag_stats_t *heap_tag_stats(heap_tag_t tag);
+void heap_tags_iterate(heap_tag_cb_t cb);
+void heap_tags_totals(heap_totals_t *totals);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,58 +1,279 @@
 #include "input_bus.h"
+#include <string.h>
 
+#define INPUT_BUS_MASK (INPUT_BUS_SIZE - 1)
 
-#define MAX_SUBS 8
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
 
-static encoder_event_cb_t encoder_subs[MAX_SUBS] = {0};
-static button_event_cb_t button_subs[MAX_SUBS] = {0};
+#if (INPUT_BUS_SIZE & INPUT_BUS_MASK) != 0
+#error "INPUT_BUS_SIZE must be a power of two"
+#endif
 
-// --- Encoder subscriptions ---
-void input_bus_add_encoder_sub(encoder_event_cb_t cb) {
-    for (int i = 0; i < MAX_SUBS; i++) {
-        if (encoder_subs[i] == NULL) {
-            encoder_subs[i] = cb;
-            break;
+enum {
+    INPUT_ENCODER,
+    INPUT_BUTTON,
+};
+
+typedef struct {
+    uint32_t time_ms;
+    uint32_t type;
+    int32_t value;  // encoder position, button pressed
+    int32_t change; // encoder steps since the previous push
+} input_event_t;
+
+// stored as one function pointer type, cast back to the real one for the call
+typedef void (*sub_fn_t)(void);
+
+typedef struct {
+    sub_fn_t *fns; // NULL entries are free
+    int count;
+    int capacity;
+} sub_list_t;
+
+static sub_list_t encoderSubs;
+static sub_list_t buttonSubs;
+static sub_list_t gestureSubs;
+
+static uint32_t (*clockMs)(void) = NULL;
+static void (*wakeCb)(void) = NULL;
+
+// single producer, single consumer (UI thread)
+static input_event_t ring[INPUT_BUS_SIZE];
+static uint32_t head = 0; // next event to read, written by the consumer
+static uint32_t tail = 0; // next slot to write, written by the producer
+static uint32_t dropped = 0;
+
+// producer side
+static uint32_t lastStamp = 0;
+static long lastPosition = 0;
+static bool positionKnown = false;
+
+// consumer side
+static long deliveredPosition = 0;
+static bool deliveredKnown = false;
+static bool held = false;
+static bool longSent = false;
+static uint32_t pressedAt = 0;
+static uint32_t releasedAt = 0;
+static uint8_t clicks = 0; // released once, waiting to see if a second click follows
+
+// --- Subscriptions ---
+static void sub_add(sub_list_t *list, sub_fn_t fn) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->fns[i] == NULL) {
+            list->fns[i] = fn;
+            return;
         }
     }
+    if (list->count == list->capacity) {
+        int capacity = list->capacity > 0 ? list->capacity * 2 : 4;
+        sub_fn_t *fns = realloc(list->fns, capacity * sizeof(sub_fn_t));
+        if (fns == NULL) return;
+        list->fns = fns;
+        list->capacity = capacity;
+    }
+    list->fns[list->count++] = fn;
 }
 
-void input_bus_remove_encoder_sub(encoder_event_cb_t cb) {
-    for (int i = 0; i < MAX_SUBS; i++) {
-        if (encoder_subs[i] == cb) {
-            encoder_subs[i] = NULL;
-            break;
+// the slot stays, a dispatch going over the list does not skip anyone
+static void sub_remove(sub_list_t *list, sub_fn_t fn) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->fns[i] == fn) {
+            list->fns[i] = NULL;
+            return;
         }
     }
 }
 
-// --- Button subscriptions ---
+void input_bus_add_encoder_sub(encoder_event_cb_t cb) {
+    sub_add(&encoderSubs, (sub_fn_t)cb);
+}
+
+void input_bus_remove_encoder_sub(encoder_event_cb_t cb) {
+    sub_remove(&encoderSubs, (sub_fn_t)cb);
+}
+
 void input_bus_add_button_sub(button_event_cb_t cb) {
-    for (int i = 0; i < MAX_SUBS; i++) {
-        if (button_subs[i] == NULL) {
-            button_subs[i] = cb;
-            break;
-        }
-    }
+    sub_add(&buttonSubs, (sub_fn_t)cb);
 }
 
 void input_bus_remove_button_sub(button_event_cb_t cb) {
-    for (int i = 0; i < MAX_SUBS; i++) {
-        if (button_subs[i] == cb) {
-            button_subs[i] = NULL;
-            break;
+    sub_remove(&buttonSubs, (sub_fn_t)cb);
+}
+
+void input_bus_add_gesture_sub(button_gesture_cb_t cb) {
+    sub_add(&gestureSubs, (sub_fn_t)cb);
+}
+
+void input_bus_remove_gesture_sub(button_gesture_cb_t cb) {
+    sub_remove(&gestureSubs, (sub_fn_t)cb);
+}
+
+// --- Producer ---
+void input_bus_init(uint32_t (*now_ms)(void), void (*wake)(void)) {
+    clockMs = now_ms;
+    wakeCb = wake;
+    memset(ring, 0, sizeof(ring));
+    head = 0;
+    tail = 0;
+    dropped = 0;
+    lastStamp = now_ms != NULL ? now_ms() : 0;
+    positionKnown = false;
+    deliveredKnown = false;
+    held = false;
+    longSent = false;
+    clicks = 0;
+}
+
+static bool input_push(uint32_t type, int32_t value, int32_t change) {
+    uint32_t now = clockMs != NULL ? clockMs() : 0;
+    if ((int32_t)(now - lastStamp) < 0) now = lastStamp;
+    lastStamp = now;
+
+    uint32_t slot = LOAD(&tail);
+    if (slot - LOAD_ACQUIRE(&head) >= INPUT_BUS_SIZE) {
+        STORE(&dropped, LOAD(&dropped) + 1);
+        return false;
+    }
+
+    input_event_t *event = &ring[slot & INPUT_BUS_MASK];
+    event->time_ms = now;
+    event->type = type;
+    event->value = value;
+    event->change = change;
+    // publishes the event together with the new tail
+    STORE_RELEASE(&tail, slot + 1);
+
+    if (wakeCb) wakeCb();
+    return true;
+}
+
+bool input_bus_push_encoder(long position) {
+    if (positionKnown && position == lastPosition) return true;
+    int32_t change = positionKnown ? (int32_t)(position - lastPosition) : 0;
+    // after a drop the next push carries the missed steps too
+    if (!input_push(INPUT_ENCODER, (int32_t)position, change)) return false;
+    lastPosition = position;
+    positionKnown = true;
+    return true;
+}
+
+bool input_bus_push_button(bool pressed) {
+    return input_push(INPUT_BUTTON, pressed, 0);
+}
+
+// --- Consumer ---
+static void encoder_deliver(long position) {
+    int32_t change = (int32_t)(position - deliveredPosition);
+    deliveredPosition = position;
+    if (change == 0) return;
+    // by index, the list may grow or lose entries from a callback
+    for (int i = 0; i < encoderSubs.count; i++) {
+        if (encoderSubs.fns[i]) ((encoder_event_cb_t)encoderSubs.fns[i])(position, change);
+    }
+}
+
+static void gesture_deliver(input_gesture_t gesture, uint32_t time_ms) {
+    for (int i = 0; i < gestureSubs.count; i++) {
+        if (gestureSubs.fns[i]) ((button_gesture_cb_t)gestureSubs.fns[i])(gesture, time_ms);
+    }
+}
+
+static void long_press(void) {
+    // a click waiting for its second one is done
+    if (clicks > 0) gesture_deliver(INPUT_CLICK, releasedAt);
+    clicks = 0;
+    longSent = true;
+    gesture_deliver(INPUT_LONG_PRESS, pressedAt + INPUT_LONG_PRESS_MS);
+}
+
+static void button_deliver(const input_event_t *event) {
+    bool pressed = event->value != 0;
+    if (pressed == held) return; // the other edge was dropped
+    held = pressed;
+    for (int i = 0; i < buttonSubs.count; i++) {
+        if (buttonSubs.fns[i]) ((button_event_cb_t)buttonSubs.fns[i])(pressed);
+    }
+
+    if (pressed) {
+        if (clicks > 0 && event->time_ms - releasedAt > INPUT_DOUBLE_CLICK_MS) {
+            gesture_deliver(INPUT_CLICK, releasedAt);
+            clicks = 0;
         }
+        pressedAt = event->time_ms;
+        longSent = false;
+        return;
+    }
+
+    // a dispatch that came late still sees how long it was held
+    if (!longSent && event->time_ms - pressedAt >= INPUT_LONG_PRESS_MS) long_press();
+    if (longSent) return;
+    if (++clicks == 2) {
+        gesture_deliver(INPUT_DOUBLE_CLICK, event->time_ms);
+        clicks = 0;
+    } else {
+        releasedAt = event->time_ms;
     }
 }
 
-// --- Emit events ---
-void input_bus_emit_encoder_event(long pos, int32_t change) {
-    for (int i = 0; i < MAX_SUBS; i++) {
-        if (encoder_subs[i]) encoder_subs[i](pos, change);
+// long presses and single clicks fire on time, not on an event
+static uint32_t button_timeouts(uint32_t now) {
+    uint32_t wait = UINT32_MAX;
+    if (held && !longSent) {
+        uint32_t heldMs = now - pressedAt;
+        if (heldMs >= INPUT_LONG_PRESS_MS) {
+            long_press();
+        } else {
+            wait = INPUT_LONG_PRESS_MS - heldMs;
+        }
+    }
+    if (!held && clicks > 0) {
+        uint32_t since = now - releasedAt;
+        if (since > INPUT_DOUBLE_CLICK_MS) {
+            gesture_deliver(INPUT_CLICK, releasedAt);
+            clicks = 0;
+        } else {
+            uint32_t due = INPUT_DOUBLE_CLICK_MS - since + 1;
+            wait = due < wait ? due : wait;
+        }
     }
+    return wait;
 }
 
-void input_bus_emit_button_event(bool pressed) {
-    for (int i = 0; i < MAX_SUBS; i++) {
-        if (button_subs[i]) button_subs[i](pressed);
+uint32_t input_bus_dispatch(void) {
+    bool moved = false;
+    long position = 0;
+
+    // only what is queued now, a fast producer cannot keep the consumer here
+    uint32_t next = LOAD(&head);
+    uint32_t end = LOAD_ACQUIRE(&tail);
+    while (next != end) {
+        input_event_t event = ring[next & INPUT_BUS_MASK];
+        next++;
+        STORE_RELEASE(&head, next);
+
+        if (event.type == INPUT_ENCODER) {
+            if (!deliveredKnown) {
+                deliveredPosition = event.value - event.change;
+                deliveredKnown = true;
+            }
+            position = event.value;
+            moved = true;
+        } else {
+            // steps before a press go out before it
+            if (moved) encoder_deliver(position);
+            moved = false;
+            button_deliver(&event);
+        }
     }
+    if (moved) encoder_deliver(position);
+
+    return button_timeouts(clockMs != NULL ? clockMs() : 0);
+}
+
+uint32_t input_bus_dropped(void) {
+    return LOAD(&dropped);
 }
@@ -1,14 +1,51 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Ring capacity, must be a power of two
+#define INPUT_BUS_SIZE 64
+// Held this long is a long press (no click follows)
+#define INPUT_LONG_PRESS_MS 600
+// A second click within this of the first release is a double click
+#define INPUT_DOUBLE_CLICK_MS 300
+
+/*
+ * Encoder and button events from the HAL to the UI thread.
+ *
+ * The HAL pushes raw events from one producer context, an ISR included: the ring is
+ * lock-free with aligned 32-bit loads and stores only, like event_queue.h. Each event
+ * is stamped with the clock given to input_bus_init(), never going backwards.
+ *
+ * input_bus_dispatch() runs once per frame on the UI thread. The encoder steps of the
+ * frame reach the subscribers as one call with the newest position and the summed
+ * change, so a fast spin updates a label once per frame. Button presses and releases
+ * are passed on as they are, and turned into clicks, double clicks and long presses
+ * from their timestamps.
+ *
+ * Subscribers are kept in arrays that grow as needed; a callback may add or remove
+ * subscribers, itself included.
+ */
+
+typedef enum {
+    INPUT_CLICK,
+    INPUT_DOUBLE_CLICK,
+    INPUT_LONG_PRESS,
+} input_gesture_t;
+
 typedef void (*encoder_event_cb_t)(long position, int32_t change);
 typedef void (*button_event_cb_t)(bool pressed);
+typedef void (*button_gesture_cb_t)(input_gesture_t gesture, uint32_t time_ms);
+
+// Call once before the first push. wake (may be NULL) is called after each push so a
+// sleeping UI loop returns early. Both are called from the producer context and must
+// be safe there (FromISR variants for an ISR).
+void input_bus_init(uint32_t (*now_ms)(void), void (*wake)(void));
 
 void input_bus_add_encoder_sub(encoder_event_cb_t cb);
 void input_bus_remove_encoder_sub(encoder_event_cb_t cb);
@@ -16,8 +53,20 @@ void input_bus_remove_encoder_sub(encoder_event_cb_t cb);
 void input_bus_add_button_sub(button_event_cb_t cb);
 void input_bus_remove_button_sub(button_event_cb_t cb);
 
-void input_bus_emit_encoder_event(long position, int32_t change);
-void input_bus_emit_button_event(bool pressed);
+void input_bus_add_gesture_sub(button_gesture_cb_t cb);
+void input_bus_remove_gesture_sub(button_gesture_cb_t cb);
+
+// Producer side, false when the ring is full. A dropped encoder event only delays
+// its steps, the next one carries the position.
+bool input_bus_push_encoder(long position);
+bool input_bus_push_button(bool pressed);
+
+// UI thread, delivers what was pushed before the call. Returns ms until a pending
+// click or long press is due, UINT32_MAX if none.
+uint32_t input_bus_dispatch(void);
+
+// Events lost because the ring was full
+uint32_t input_bus_dropped(void);
 
 #ifdef __cplusplus
 }
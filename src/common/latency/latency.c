@@ -0,0 +1,326 @@
+#ifdef ENABLE_LATENCY
+
+#include <string.h>
+#include "latency.h"
+#include "indev/lv_indev_private.h"
+#include "misc/lv_area_private.h"
+#include "misc/lv_timer_private.h"
+#include "../heap_tags/heap_tags.h"
+
+#define LATENCY_SUB (1u << LATENCY_SUB_BITS)
+#define LATENCY_TIMERS (LATENCY_INDEVS + 1) // the read timers and the animation timer
+
+typedef enum {
+    PENDING_FREE,
+    PENDING_DISPATCH, // stamped, LVGL is handling it
+    PENDING_FOLLOW,   // started an animation, waiting for its first frame
+    PENDING_DIRTY,    // invalidated, waiting for the flush
+} pending_state_t;
+
+typedef struct {
+    pending_state_t state;
+    uint64_t input_us;
+    uint8_t screen;
+    uint32_t pass;   // the dispatch or animation pass that invalidated it
+    lv_area_t area;  // bounding box of what it invalidated
+    uint32_t anims;  // running animations when it was read
+} latency_pending_t;
+
+typedef struct {
+    const char *name;
+    uint32_t count;
+    uint32_t unchanged;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t buckets[LATENCY_BUCKETS];
+} latency_screen_t;
+
+typedef struct {
+    lv_indev_t *indev;
+    lv_indev_read_cb_t read;
+    lv_indev_state_t state;
+    lv_point_t point;
+} latency_indev_t;
+
+typedef struct {
+    lv_timer_t *timer;
+    lv_timer_cb_t cb;
+    bool anim;
+} latency_timer_t;
+
+static uint64_t (*clockUs)(void) = NULL;
+
+static latency_screen_t screens[LATENCY_SCREENS];
+static uint8_t numScreens = 0;
+static latency_pending_t pending[LATENCY_PENDING];
+static uint32_t dropped = 0;
+
+static latency_indev_t indevs[LATENCY_INDEVS];
+static latency_timer_t timers[LATENCY_TIMERS];
+static lv_display_t *watched = NULL;
+
+// what LVGL is running, invalidations are attributed from it
+static bool dispatching = false;
+static bool animating = false;
+static int current = -1; // the event of the read being dispatched
+static uint32_t pass = 0;
+
+// --- Histogram ---
+static uint16_t latency_bucket(uint32_t us) {
+    if (us < (1u << LATENCY_MIN_SHIFT)) return 0;
+    uint32_t msb = 31 - __builtin_clz(us);
+    if (msb >= LATENCY_MAX_SHIFT) return LATENCY_BUCKETS - 1;
+    uint32_t sub = (us >> (msb - LATENCY_SUB_BITS)) & (LATENCY_SUB - 1);
+    return (uint16_t)(1 + (msb - LATENCY_MIN_SHIFT) * LATENCY_SUB + sub);
+}
+
+// largest value that falls into bucket i
+static uint32_t latency_bucket_top(uint16_t i) {
+    if (i == 0) return (1u << LATENCY_MIN_SHIFT) - 1;
+    if (i == LATENCY_BUCKETS - 1) return UINT32_MAX;
+    uint32_t octave = (i - 1) / LATENCY_SUB;
+    uint32_t sub = (i - 1) % LATENCY_SUB;
+    uint32_t shift = octave + LATENCY_MIN_SHIFT - LATENCY_SUB_BITS;
+    return ((LATENCY_SUB + sub + 1) << shift) - 1;
+}
+
+static uint32_t latency_percentile(const latency_screen_t *s, uint32_t pct) {
+    uint64_t rank = ((uint64_t)s->count * pct + 99) / 100;
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (uint16_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += s->buckets[i];
+        if (seen >= rank) {
+            uint32_t top = latency_bucket_top(i);
+            return top < s->max_us ? top : s->max_us;
+        }
+    }
+    return s->max_us;
+}
+
+static uint8_t latency_screen(lv_obj_t *screen) {
+    const char *name = heap_tag_screen_name(screen);
+    if (name == NULL) name = "other";
+    for (uint8_t i = 0; i < numScreens; i++) {
+        if (strcmp(screens[i].name, name) == 0) return i;
+    }
+    // full, the last one collects the rest
+    if (numScreens == LATENCY_SCREENS) {
+        screens[LATENCY_SCREENS - 1].name = "other";
+        return LATENCY_SCREENS - 1;
+    }
+    memset(&screens[numScreens], 0, sizeof(screens[numScreens]));
+    screens[numScreens].name = name;
+    return numScreens++;
+}
+
+static void latency_record(latency_pending_t *p, uint64_t now) {
+    latency_screen_t *s = &screens[p->screen];
+    uint64_t elapsed = now - p->input_us;
+    uint32_t us = elapsed < UINT32_MAX ? (uint32_t)elapsed : UINT32_MAX;
+    s->buckets[latency_bucket(us)]++;
+    s->count++;
+    s->total_us += us;
+    if (us > s->max_us) s->max_us = us;
+    p->state = PENDING_FREE;
+}
+
+static void latency_unchanged(latency_pending_t *p) {
+    screens[p->screen].unchanged++;
+    p->state = PENDING_FREE;
+}
+
+static void latency_expire(uint64_t now) {
+    for (int i = 0; i < LATENCY_PENDING; i++) {
+        if (pending[i].state != PENDING_FREE && pending[i].state != PENDING_DISPATCH &&
+            now - pending[i].input_us > LATENCY_TIMEOUT_MS * 1000ull) {
+            latency_unchanged(&pending[i]);
+        }
+    }
+}
+
+// --- Input ---
+static void latency_stamp(void) {
+    for (int i = 0; i < LATENCY_PENDING; i++) {
+        if (pending[i].state != PENDING_FREE) continue;
+        pending[i].state = PENDING_DISPATCH;
+        pending[i].input_us = clockUs();
+        pending[i].screen = latency_screen(lv_screen_active());
+        pending[i].anims = lv_anim_count_running();
+        current = i;
+        return;
+    }
+    dropped++;
+}
+
+// the read before was handled, it either invalidated, started an animation or did nothing
+static void latency_settle(void) {
+    if (current < 0) return;
+    latency_pending_t *p = &pending[current];
+    current = -1;
+    if (p->state != PENDING_DISPATCH) return;
+    if (lv_anim_count_running() > p->anims) {
+        p->state = PENDING_FOLLOW;
+    } else {
+        latency_unchanged(p);
+    }
+}
+
+static latency_indev_t *latency_find_indev(lv_indev_t *indev) {
+    for (int i = 0; i < LATENCY_INDEVS; i++) {
+        if (indevs[i].indev == indev) return &indevs[i];
+    }
+    return NULL;
+}
+
+static void latency_read(lv_indev_t *indev, lv_indev_data_t *data) {
+    latency_indev_t *in = latency_find_indev(indev);
+    if (in == NULL) return;
+    in->read(indev, data);
+
+    bool event = data->state != in->state || data->enc_diff != 0;
+    if (indev->type == LV_INDEV_TYPE_POINTER && data->state == LV_INDEV_STATE_PRESSED &&
+        (data->point.x != in->point.x || data->point.y != in->point.y)) {
+        event = true;
+    }
+    in->state = data->state;
+    in->point = data->point;
+    // only reads from the read timer, a direct lv_indev_read() is not followed
+    if (clockUs == NULL || !dispatching) return;
+
+    // LVGL handles each read before the next one, several per timer call included
+    latency_settle();
+    if (event) latency_stamp();
+}
+
+// --- LVGL ---
+static latency_timer_t *latency_find_timer(lv_timer_t *timer) {
+    for (int i = 0; i < LATENCY_TIMERS; i++) {
+        if (timers[i].timer == timer) return &timers[i];
+    }
+    return NULL;
+}
+
+static void latency_timer_cb(lv_timer_t *timer) {
+    latency_timer_t *t = latency_find_timer(timer);
+    if (t == NULL) return;
+    pass++;
+    if (t->anim) {
+        animating = true;
+        t->cb(timer);
+        animating = false;
+        return;
+    }
+    dispatching = true;
+    t->cb(timer);
+    latency_settle();
+    dispatching = false;
+}
+
+static void latency_wrap_timer(lv_timer_t *timer, bool anim) {
+    if (timer == NULL || latency_find_timer(timer) != NULL) return;
+    for (int i = 0; i < LATENCY_TIMERS; i++) {
+        if (timers[i].timer != NULL) continue;
+        timers[i].timer = timer;
+        timers[i].cb = timer->timer_cb;
+        timers[i].anim = anim;
+        timer->timer_cb = latency_timer_cb;
+        return;
+    }
+}
+
+static void latency_join(latency_pending_t *p, const lv_area_t *area) {
+    if (p->state == PENDING_DIRTY && p->pass == pass) {
+        lv_area_join(&p->area, &p->area, area);
+        return;
+    }
+    p->state = PENDING_DIRTY;
+    p->pass = pass;
+    p->area = *area;
+}
+
+static void latency_invalidated(lv_event_t *e) {
+    const lv_area_t *area = lv_event_get_param(e);
+    if (area == NULL) return;
+    if (dispatching && current >= 0) {
+        latency_join(&pending[current], area);
+    } else if (animating) {
+        for (int i = 0; i < LATENCY_PENDING; i++) {
+            latency_pending_t *p = &pending[i];
+            if (p->state == PENDING_FOLLOW || (p->state == PENDING_DIRTY && p->pass == pass)) {
+                latency_join(p, area);
+            }
+        }
+    }
+}
+
+static void latency_flushed(lv_event_t *e) {
+    const lv_area_t *area = lv_event_get_param(e);
+    if (area == NULL || clockUs == NULL) return;
+    uint64_t now = clockUs();
+    lv_area_t common;
+    for (int i = 0; i < LATENCY_PENDING; i++) {
+        if (pending[i].state == PENDING_DIRTY && lv_area_intersect(&common, &pending[i].area, area)) {
+            latency_record(&pending[i], now);
+        }
+    }
+    latency_expire(now);
+}
+
+void latency_init(uint64_t (*now_us)(void)) {
+    clockUs = now_us;
+    latency_reset();
+}
+
+void latency_attach(lv_display_t *display, lv_indev_t *indev) {
+    if (display != NULL && watched == NULL) {
+        watched = display;
+        lv_display_add_event_cb(display, latency_invalidated, LV_EVENT_INVALIDATE_AREA, NULL);
+        lv_display_add_event_cb(display, latency_flushed, LV_EVENT_FLUSH_FINISH, NULL);
+        latency_wrap_timer(lv_anim_get_timer(), true);
+    }
+    if (indev == NULL || latency_find_indev(indev) != NULL) return;
+
+    latency_indev_t *in = latency_find_indev(NULL);
+    if (in == NULL) return;
+    in->indev = indev;
+    in->read = indev->read_cb;
+    in->state = LV_INDEV_STATE_RELEASED;
+    in->point.x = 0;
+    in->point.y = 0;
+    indev->read_cb = latency_read;
+    latency_wrap_timer(lv_indev_get_read_timer(indev), false);
+}
+
+// --- Report ---
+void latency_iterate(latency_cb_t cb) {
+    for (uint8_t i = 0; i < numScreens; i++) {
+        const latency_screen_t *s = &screens[i];
+        latency_stats_t stats;
+        memset(&stats, 0, sizeof(stats));
+        stats.screen = s->name;
+        stats.count = s->count;
+        stats.unchanged = s->unchanged;
+        stats.max_us = s->max_us;
+        stats.total_us = s->total_us;
+        if (s->count > 0) {
+            stats.p50_us = latency_percentile(s, 50);
+            stats.p90_us = latency_percentile(s, 90);
+            stats.p99_us = latency_percentile(s, 99);
+        }
+        cb(&stats);
+    }
+}
+
+void latency_reset(void) {
+    memset(pending, 0, sizeof(pending));
+    numScreens = 0;
+    dropped = 0;
+    current = -1;
+}
+
+uint32_t latency_dropped(void) {
+    return dropped;
+}
+
+#endif
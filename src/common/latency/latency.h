@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Touch to photon latency, enabled with -D ENABLE_LATENCY=1 (emulator and device).
+ *
+ * latency_attach() wraps the read callback and read timer of an input device and
+ * watches the display. An input event (press, release, a pointer moving while pressed,
+ * encoder steps) is stamped when the read callback returns it. Areas invalidated while
+ * LVGL dispatches that read belong to it; a read that starts an animation and changes
+ * nothing yet is followed into the animation timer, and its first invalidation there
+ * counts. The event is done when the first flush that overlaps one of its areas
+ * finishes (flush_cb returned, so on a DMA panel the transfer has been queued).
+ *
+ * Results go into a histogram per screen, named after the heap owner bound to the
+ * screen (heap_tags.h): 8 buckets per power of two from 256us to 1s, percentiles are
+ * exact to 12.5%. Events that change no pixels within LATENCY_TIMEOUT_MS are counted
+ * apart. UI thread only.
+ */
+
+#ifdef ENABLE_LATENCY
+
+#include "lvgl.h"
+
+#define LATENCY_SCREENS 16  // screens with a histogram, later ones go to "other"
+#define LATENCY_PENDING 8   // input events waiting for their flush
+#define LATENCY_INDEVS 4
+#define LATENCY_TIMEOUT_MS 1000
+#define LATENCY_SUB_BITS 3  // buckets per power of two, as bits
+#define LATENCY_MIN_SHIFT 8 // below 256us is one bucket
+#define LATENCY_MAX_SHIFT 20 // from about 1s is one bucket
+#define LATENCY_BUCKETS (2 + (LATENCY_MAX_SHIFT - LATENCY_MIN_SHIFT) * (1 << LATENCY_SUB_BITS))
+
+typedef struct {
+    const char *screen;
+    uint32_t count;     // events that changed pixels
+    uint32_t unchanged; // events that did not
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+    uint64_t total_us;
+} latency_stats_t;
+
+typedef void (*latency_cb_t)(const latency_stats_t *stats);
+
+// microsecond clock, provided by the HAL
+void latency_init(uint64_t (*now_us)(void));
+
+// Call once per input device, after its read callback is set. The display events are
+// added on the first call.
+void latency_attach(lv_display_t *display, lv_indev_t *indev);
+
+// screens with at least one event, in the order they were first seen
+void latency_iterate(latency_cb_t cb);
+void latency_reset(void);
+
+// events lost because LATENCY_PENDING were still waiting
+uint32_t latency_dropped(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,81 @@
+#include "loop_scheduler.h"
+
+
+static uint32_t next_wait = LOOP_SCHED_MAX_SLEEP_MS;
+static uint32_t busy_start = 0;
+static volatile bool wake_pending = false;
+
+static uint32_t window_start = 0;
+static uint32_t window_busy = 0;
+static uint32_t window_sleep = 0;
+static uint32_t window_loops = 0;
+
+static uint8_t busy_pct = 0;
+static uint32_t avg_sleep = 0;
+static bool stats_ready = false;
+
+// --- Deadlines ---
+void loop_sched_begin(uint32_t now) {
+    busy_start = now;
+    next_wait = LOOP_SCHED_MAX_SLEEP_MS;
+}
+
+void loop_sched_add_delay(uint32_t ms) {
+    if (ms < next_wait) next_wait = ms;
+}
+
+void loop_sched_add_deadline(uint32_t now, uint32_t at) {
+    // signed difference handles the millis() wrap around
+    int32_t diff = (int32_t)(at - now);
+    loop_sched_add_delay(diff > 0 ? (uint32_t)diff : 0);
+}
+
+uint32_t loop_sched_end(uint32_t now) {
+    uint32_t busy = now - busy_start;
+    uint32_t wait = next_wait;
+
+    if (wake_pending) {
+        wake_pending = false;
+        wait = 0;
+    }
+    if (wait < LOOP_SCHED_MIN_SLEEP_MS) wait = LOOP_SCHED_MIN_SLEEP_MS;
+
+    // --- Busy statistics ---
+    window_busy += busy;
+    window_sleep += wait;
+    window_loops++;
+
+    uint32_t elapsed = now - window_start;
+    if (elapsed >= LOOP_SCHED_STATS_WINDOW_MS) {
+        uint32_t pct = (window_busy * 100) / elapsed;
+        busy_pct = pct > 100 ? 100 : (uint8_t)pct;
+        avg_sleep = window_sleep / window_loops;
+        stats_ready = true;
+
+        window_start = now;
+        window_busy = 0;
+        window_sleep = 0;
+        window_loops = 0;
+    }
+    return wait;
+}
+
+// --- Wake requests ---
+void loop_sched_wake(void) {
+    wake_pending = true;
+}
+
+// --- Stats ---
+uint8_t loop_sched_busy_pct(void) {
+    return busy_pct;
+}
+
+uint32_t loop_sched_avg_sleep(void) {
+    return avg_sleep;
+}
+
+bool loop_sched_stats_ready(void) {
+    bool r = stats_ready;
+    stats_ready = false;
+    return r;
+}
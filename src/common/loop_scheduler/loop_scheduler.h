@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest time the main loop may sleep, even if nothing is due.
+// Keeps BLE/label polling in the HALs responsive.
+#define LOOP_SCHED_MAX_SLEEP_MS 50
+// Shortest sleep, lets lower priority tasks (idle, BLE) run
+#define LOOP_SCHED_MIN_SLEEP_MS 1
+// Window over which the busy percentage is measured
+#define LOOP_SCHED_STATS_WINDOW_MS 1000
+
+// Start of a loop iteration, everything until loop_sched_end() counts as busy time
+void loop_sched_begin(uint32_t now);
+
+// Merge a deadline `ms` milliseconds from now (e.g. return value of lv_timer_handler())
+void loop_sched_add_delay(uint32_t ms);
+// Merge an absolute deadline `at`, in the same time base as `now`
+void loop_sched_add_deadline(uint32_t now, uint32_t at);
+
+// End of the loop iteration, returns how long the loop may sleep
+uint32_t loop_sched_end(uint32_t now);
+
+// Request that the next loop_sched_end() does not sleep, safe to call from callbacks on other tasks
+void loop_sched_wake(void);
+
+// Busy percentage of the last complete window (0-100)
+uint8_t loop_sched_busy_pct(void);
+// Average sleep of the last complete window in ms
+uint32_t loop_sched_avg_sleep(void);
+// Returns true once each time a new stats window has completed
+bool loop_sched_stats_ready(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,170 @@
+#ifdef ENABLE_PROFILER
+
+#if defined(__linux__) || defined(__APPLE__)
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#define PROFILER_HAS_DLADDR
+#endif
+
+#include <stdio.h>
+#include "lvgl.h"
+#include "misc/lv_timer_private.h"
+#include "profiler.h"
+#include "../heap_tags/heap_tags.h"
+
+typedef struct {
+    const char *name;
+    uint64_t ts;
+    char phase;
+} profiler_event_t;
+
+typedef struct {
+    lv_timer_t *timer;
+    lv_timer_cb_t cb;
+    const char *name;
+    char fallback[24];
+} profiler_timer_t;
+
+static profiler_event_t events[PROFILER_MAX_EVENTS];
+static uint32_t event_count = 0;
+static uint32_t dropped = 0;
+
+static profiler_timer_t timers[PROFILER_MAX_TIMERS];
+
+static uint64_t (*clock_us)(void) = NULL;
+
+// --- Recording ---
+void profiler_init(uint64_t (*now_us)(void)) {
+    clock_us = now_us;
+    event_count = 0;
+    dropped = 0;
+}
+
+static void profiler_add(const char *name, char phase) {
+    if (clock_us == NULL) return;
+    if (event_count >= PROFILER_MAX_EVENTS) {
+        dropped++;
+        return;
+    }
+    events[event_count].name = name;
+    events[event_count].ts = clock_us();
+    events[event_count].phase = phase;
+    event_count++;
+}
+
+void profiler_begin(const char *name) {
+    profiler_add(name, 'B');
+}
+
+void profiler_end(const char *name) {
+    profiler_add(name, 'E');
+}
+
+// --- Timers ---
+static profiler_timer_t *profiler_find_timer(lv_timer_t *timer) {
+    for (int i = 0; i < PROFILER_MAX_TIMERS; i++) {
+        if (timers[i].timer == timer) return &timers[i];
+    }
+    return NULL;
+}
+
+static void profiler_timer_cb(lv_timer_t *timer) {
+    profiler_timer_t *t = profiler_find_timer(timer);
+    if (t == NULL) return;
+
+    // the callback may delete its own timer, keep what is needed for the end event
+    lv_timer_cb_t cb = t->cb;
+    const char *name = t->name;
+
+    profiler_begin(name);
+    cb(timer);
+    profiler_end(name);
+}
+
+static void profiler_name_timer(profiler_timer_t *t) {
+#ifdef PROFILER_HAS_DLADDR
+    Dl_info info;
+    if (dladdr((void *)t->cb, &info) && info.dli_sname != NULL) {
+        t->name = info.dli_sname;
+        return;
+    }
+#endif
+    snprintf(t->fallback, sizeof(t->fallback), "timer %p", (void *)t->cb);
+    t->name = t->fallback;
+}
+
+static bool profiler_timer_alive(lv_timer_t *timer) {
+    for (lv_timer_t *t = lv_timer_get_next(NULL); t != NULL; t = lv_timer_get_next(t)) {
+        if (t == timer) return true;
+    }
+    return false;
+}
+
+void profiler_wrap_timers(void) {
+    // forget timers that were deleted since the last call
+    for (int i = 0; i < PROFILER_MAX_TIMERS; i++) {
+        if (timers[i].timer != NULL && !profiler_timer_alive(timers[i].timer)) {
+            timers[i].timer = NULL;
+        }
+    }
+
+    for (lv_timer_t *timer = lv_timer_get_next(NULL); timer != NULL; timer = lv_timer_get_next(timer)) {
+        if (timer->timer_cb == profiler_timer_cb || timer->timer_cb == NULL) continue;
+
+        // a new timer may reuse the address of a deleted one
+        profiler_timer_t *t = profiler_find_timer(timer);
+        if (t == NULL) t = profiler_find_timer(NULL);
+        if (t == NULL) return;
+
+        t->timer = timer;
+        t->cb = timer->timer_cb;
+        profiler_name_timer(t);
+        lv_timer_set_cb(timer, profiler_timer_cb);
+    }
+}
+
+// --- Export ---
+static FILE *heap_out = NULL;
+static bool heap_first = true;
+
+static void profiler_write_owner(const heap_tag_stats_t *stats) {
+    fprintf(heap_out, "%s\n{\"name\":\"%s\",\"live\":%lu,\"peak\":%lu,\"blocks\":%u,\"allocs\":%u}",
+            heap_first ? "" : ",", stats->name, (unsigned long)stats->live, (unsigned long)stats->peak,
+            (unsigned)stats->blocks, (unsigned)stats->allocs);
+    heap_first = false;
+}
+
+// LVGL heap per owner, free and largest_free are 0 when the HAL does not know them
+static void profiler_write_heap(FILE *f) {
+    heap_totals_t totals;
+    heap_tags_totals(&totals);
+
+    fprintf(f, "\"heap\":{\"live\":%lu,\"peak\":%lu,\"blocks\":%u,\"overhead\":%lu,"
+               "\"free\":%lu,\"largest_free\":%lu,\"frag_pct\":%u,\"owners\":[",
+            (unsigned long)totals.live, (unsigned long)totals.peak, (unsigned)totals.blocks,
+            (unsigned long)totals.overhead, (unsigned long)totals.free, (unsigned long)totals.largest_free,
+            (unsigned)totals.frag_pct);
+    heap_out = f;
+    heap_first = true;
+    heap_tags_iterate(profiler_write_owner);
+    fprintf(f, "]}");
+}
+
+bool profiler_write(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (f == NULL) return false;
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    for (uint32_t i = 0; i < event_count; i++) {
+        fprintf(f, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":1}%s\n",
+                events[i].name, events[i].phase, (unsigned long long)events[i].ts,
+                i + 1 < event_count ? "," : "");
+    }
+    fprintf(f, "],\"otherData\":{\"dropped\":%u,", (unsigned)dropped);
+    profiler_write_heap(f);
+    fprintf(f, "}}\n");
+    fclose(f);
+    return true;
+}
+
+#endif
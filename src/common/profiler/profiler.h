@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Frame profiler for the native builds, enabled with -D ENABLE_PROFILER=1.
+ * Records begin/end pairs and writes them as a Chrome trace (chrome://tracing, Perfetto).
+ * LVGL's own LV_PROFILER_* points (refresh, layout, render, flush) are routed here from lv_conf.h.
+ */
+
+#ifdef ENABLE_PROFILER
+
+#define PROFILER_MAX_EVENTS (128 * 1024)
+#define PROFILER_MAX_TIMERS 64
+
+// microsecond clock, provided by the HAL
+void profiler_init(uint64_t (*now_us)(void));
+
+void profiler_begin(const char *name);
+void profiler_end(const char *name);
+
+// route every lv_timer callback through the profiler, call after timers were created
+void profiler_wrap_timers(void);
+
+// write the Chrome trace JSON, returns false if the file could not be written
+bool profiler_write(const char *path);
+
+#define PROFILER_BEGIN profiler_begin(__func__)
+#define PROFILER_END profiler_end(__func__)
+#define PROFILER_BEGIN_TAG(tag) profiler_begin(tag)
+#define PROFILER_END_TAG(tag) profiler_end(tag)
+
+#else
+
+#define PROFILER_BEGIN
+#define PROFILER_END
+#define PROFILER_BEGIN_TAG(tag)
+#define PROFILER_END_TAG(tag)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,377 @@
+#include "sensor_service.h"
+#include <string.h>
+#include "../ui_thread/ui_thread.h"
+
+#if defined(ESP_PLATFORM)
+#define SENSOR_TASK_FREERTOS
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+#define SENSOR_RING_MASK (SENSOR_RING_SIZE - 1)
+#define SENSOR_PI 3.14159265f
+
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#if (SENSOR_RING_SIZE & SENSOR_RING_MASK) != 0
+#error "SENSOR_RING_SIZE must be a power of two"
+#endif
+
+typedef struct {
+    imu_stream_cb_t cb; // NULL when the slot is free
+    void *user;
+    imu_stream_filter_t filter;
+    uint16_t rate;
+    uint16_t latency_ms;
+    uint32_t interval_us;
+    uint32_t next_us; // when the next sample is due
+    bool primed;      // next_us is valid
+    imu_sample_t acc; // running sum or low pass state
+    uint16_t count;   // samples in acc
+    float alpha;      // low pass coefficient
+} sensor_stream_t;
+
+static const sensor_backend_t *backend = NULL;
+static uint32_t (*clockUs)(void) = NULL;
+
+// written by the UI thread, read by the reader
+static uint32_t streamsOpen = 0;
+static uint32_t odrHz = 0;      // highest open stream rate, capped at SENSOR_ODR_MAX_HZ
+static uint32_t latencyMs = SENSOR_LATENCY_MS; // shortest latency of the open streams
+static uint32_t generation = 0; // bumped on every change, a failed start is retried after the next one
+
+// single producer (reader), single consumer (UI thread)
+static imu_sample_t ring[SENSOR_RING_SIZE];
+static uint32_t head = 0; // next sample to deliver, written by the UI thread
+static uint32_t tail = 0; // next slot to fill, written by the reader
+static uint32_t dropped = 0;
+
+// reader side
+static bool started = false;
+static uint32_t startedOdr = 0;
+static uint32_t triedGeneration = 0;
+static uint32_t lastRead = 0;
+static uint32_t pending = 0;   // samples in the ring not handed to the UI thread yet
+static uint32_t pendingAt = 0; // when the oldest of them was read
+
+// UI thread side
+static sensor_stream_t streams[SENSOR_MAX_STREAMS];
+static imu_sample_t streamOut[SENSOR_RING_SIZE];
+static imu_sample_t history[SENSOR_HISTORY];
+static uint32_t historyCount = 0;
+
+static void sensor_dispatch(void *arg);
+
+// --- Reader ---
+// starts or stops the sensor to match the open streams, true while it runs
+static bool sensor_reconcile(void) {
+    bool want = LOAD_ACQUIRE(&streamsOpen) > 0;
+    uint32_t odr = LOAD(&odrHz);
+    uint32_t gen = LOAD(&generation);
+
+    if (started && (!want || odr != startedOdr)) {
+        backend->stop();
+        started = false;
+    }
+    if (!started && want && gen != triedGeneration) {
+        triedGeneration = gen;
+        started = backend->start((uint16_t)odr);
+        startedOdr = odr;
+        lastRead = clockUs();
+        pending = 0;
+    }
+    return started;
+}
+
+// one sample per ODR period without a FIFO, with one before it is half full and at
+// least once per latency
+static uint32_t sensor_interval_us(void) {
+    uint32_t period = 1000000 / startedOdr;
+    if (backend->fifo == 0) return period;
+    uint32_t us = (backend->fifo / 2 > 0 ? backend->fifo / 2 : 1) * period;
+    uint32_t latency = LOAD(&latencyMs) * 1000;
+    return us < latency ? us : latency;
+}
+
+// Empties the sensor into the ring. The last sample is stamped with the time of the
+// read and the ones before it one ODR period apart. Returns the samples queued.
+static uint32_t sensor_read(void) {
+    imu_sample_t burst[SENSOR_BURST_MAX];
+    uint32_t now = clockUs();
+    uint32_t period = 1000000 / startedOdr;
+    uint32_t start = LOAD(&tail);
+    uint32_t end = start;
+    uint32_t total = 0;
+    bool full = false;
+
+    lastRead = now;
+    for (uint32_t reads = 0; reads <= backend->fifo / SENSOR_BURST_MAX; reads++) {
+        uint16_t n = backend->read(burst, SENSOR_BURST_MAX);
+        for (uint16_t i = 0; i < n; i++) {
+            // once full, the newer samples are dropped so the stamps stay in order
+            full = full || end - LOAD_ACQUIRE(&head) >= SENSOR_RING_SIZE;
+            if (!full) ring[end++ & SENSOR_RING_MASK] = burst[i];
+        }
+        total += n;
+        if (n < SENSOR_BURST_MAX) break;
+    }
+
+    uint32_t kept = end - start;
+    for (uint32_t i = 0; i < kept; i++) {
+        ring[(start + i) & SENSOR_RING_MASK].time_us = now - (total - 1 - i) * period;
+    }
+    if (total > kept) STORE(&dropped, LOAD(&dropped) + total - kept);
+    // publishes the samples together with the new tail
+    STORE_RELEASE(&tail, end);
+    if (pending == 0) pendingAt = now;
+    pending += kept;
+    return kept;
+}
+
+// us until the samples waiting in the ring have to be handed over: when waiting for
+// the next read would take the oldest past the latency, or the ring is half full.
+// UINT32_MAX while the ring is empty.
+static uint32_t sensor_hand_over_in(void) {
+    if (pending == 0) return UINT32_MAX;
+    if (pending >= SENSOR_RING_SIZE / 2) return 0;
+    uint32_t waited = clockUs() - pendingAt + sensor_interval_us();
+    uint32_t latency = LOAD(&latencyMs) * 1000;
+    return waited >= latency ? 0 : latency - waited;
+}
+
+static bool sensor_hand_over_due(void) {
+    if (sensor_hand_over_in() > 0) return false;
+    pending = 0;
+    return true;
+}
+
+#if defined(SENSOR_TASK_FREERTOS)
+
+static TaskHandle_t sensorTask = NULL;
+
+static void sensor_task(void *param) {
+    for (;;) {
+        if (!sensor_reconcile()) {
+            // nothing to read until a stream opens or the ODR changes
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        // a full post queue is fine, the samples wait in the ring for the next one
+        sensor_read();
+        if (sensor_hand_over_due()) ui_post(sensor_dispatch, NULL);
+        uint32_t ms = sensor_interval_us() / 1000;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms > 0 ? ms : 1));
+    }
+}
+
+static void reader_start(void) {
+    xTaskCreate(sensor_task, "Sensors", SENSOR_TASK_STACK, NULL, 2, &sensorTask);
+}
+
+static void reader_wake(void) {
+    if (sensorTask != NULL) xTaskNotifyGive(sensorTask);
+}
+
+#else
+
+static void reader_start(void) {}
+static void reader_wake(void) {}
+
+#endif
+
+// --- UI thread ---
+// acc = acc * keep + s * take
+static void sample_mix(imu_sample_t *acc, const imu_sample_t *s, float keep, float take) {
+    acc->ax = acc->ax * keep + s->ax * take;
+    acc->ay = acc->ay * keep + s->ay * take;
+    acc->az = acc->az * keep + s->az * take;
+    acc->gx = acc->gx * keep + s->gx * take;
+    acc->gy = acc->gy * keep + s->gy * take;
+    acc->gz = acc->gz * keep + s->gz * take;
+    acc->temp = acc->temp * keep + s->temp * take;
+}
+
+static float stream_alpha(uint16_t rate) {
+    // cutoff at half the stream rate
+    float w = SENSOR_PI * rate / (float)LOAD(&odrHz);
+    return w >= 1.0f ? 1.0f : w / (1.0f + w);
+}
+
+// feeds one sample, true when the stream is due and *out holds its next sample
+static bool stream_feed(sensor_stream_t *st, const imu_sample_t *s, imu_sample_t *out) {
+    if (st->filter == IMU_STREAM_AVERAGE) {
+        sample_mix(&st->acc, s, st->count > 0 ? 1.0f : 0.0f, 1.0f);
+        st->count++;
+    } else if (st->filter == IMU_STREAM_LOW_PASS && st->count > 0) {
+        sample_mix(&st->acc, s, 1.0f - st->alpha, st->alpha);
+    } else {
+        st->acc = *s;
+        st->count = 1;
+    }
+
+    if (st->primed && (int32_t)(s->time_us - st->next_us) < 0) return false;
+
+    *out = st->acc;
+    if (st->filter == IMU_STREAM_AVERAGE) {
+        sample_mix(out, out, 1.0f / st->count, 0.0f);
+        st->count = 0;
+    }
+    out->time_us = s->time_us;
+
+    // after a gap the stream restarts from this sample instead of catching up
+    bool late = st->primed && s->time_us - st->next_us >= st->interval_us;
+    st->next_us = (st->primed && !late ? st->next_us : s->time_us) + st->interval_us;
+    st->primed = true;
+    return true;
+}
+
+static void sensor_dispatch(void *arg) {
+    (void)arg;
+    uint32_t first = LOAD(&head);
+    uint32_t end = LOAD_ACQUIRE(&tail);
+    if (first == end) return;
+
+    for (uint32_t i = first; i != end; i++) {
+        history[historyCount % SENSOR_HISTORY] = ring[i & SENSOR_RING_MASK];
+        historyCount++;
+    }
+
+    for (int s = 0; s < SENSOR_MAX_STREAMS; s++) {
+        uint16_t count = 0;
+        for (uint32_t i = first; i != end && streams[s].cb != NULL; i++) {
+            if (stream_feed(&streams[s], &ring[i & SENSOR_RING_MASK], &streamOut[count])) count++;
+        }
+        // the callback may close its stream
+        if (count > 0 && streams[s].cb != NULL) streams[s].cb(streamOut, count, streams[s].user);
+    }
+
+    // the slots belong to the reader again
+    STORE_RELEASE(&head, end);
+}
+
+// the sensor follows the fastest open stream, the filters are set up for its rate and
+// the hand-overs for the most impatient stream
+static void streams_changed(uint32_t open) {
+    uint32_t odr = 0;
+    uint32_t latency = UINT32_MAX;
+    for (int s = 0; s < SENSOR_MAX_STREAMS; s++) {
+        if (streams[s].cb == NULL) continue;
+        if (streams[s].rate > odr) odr = streams[s].rate;
+        if (streams[s].latency_ms < latency) latency = streams[s].latency_ms;
+    }
+    if (odr > SENSOR_ODR_MAX_HZ) odr = SENSOR_ODR_MAX_HZ;
+    if (odr > 0) STORE(&odrHz, odr);
+    if (latency != UINT32_MAX) STORE(&latencyMs, latency);
+    for (int s = 0; s < SENSOR_MAX_STREAMS; s++) {
+        if (streams[s].cb != NULL) streams[s].alpha = stream_alpha(streams[s].rate);
+    }
+
+    STORE(&generation, LOAD(&generation) + 1);
+    STORE_RELEASE(&streamsOpen, open);
+    reader_wake();
+}
+
+// --- API ---
+void sensor_service_init(const sensor_backend_t *sensor, uint32_t (*now_us)(void)) {
+    backend = sensor;
+    clockUs = now_us;
+    if (backend != NULL) reader_start();
+}
+
+uint16_t sensor_service_odr(void) {
+    return LOAD(&streamsOpen) > 0 ? (uint16_t)LOAD(&odrHz) : 0;
+}
+
+uint32_t sensor_service_poll(void) {
+#if defined(SENSOR_TASK_FREERTOS)
+    return UINT32_MAX;
+#else
+    if (sensor_service_read() == UINT32_MAX) return UINT32_MAX;
+    if (sensor_hand_over_due()) sensor_dispatch(NULL);
+
+    uint32_t interval = sensor_interval_us();
+    uint32_t elapsed = clockUs() - lastRead;
+    uint32_t untilRead = elapsed < interval ? interval - elapsed : 0;
+    uint32_t us = sensor_hand_over_in();
+    if (us == UINT32_MAX) {
+        // nothing waiting, the next read starts the wait
+        uint32_t latency = LOAD(&latencyMs) * 1000;
+        us = untilRead + (latency > interval ? latency - interval : 0);
+    }
+    // without a FIFO the reads until then are sensor_service_read()'s while the loop sleeps
+    if (backend->fifo > 0 && untilRead < us) us = untilRead;
+    return (us + 999) / 1000;
+#endif
+}
+
+uint32_t sensor_service_read(void) {
+#if defined(SENSOR_TASK_FREERTOS)
+    return UINT32_MAX;
+#else
+    if (backend == NULL || !sensor_reconcile()) return UINT32_MAX;
+
+    uint32_t interval = sensor_interval_us();
+    uint32_t elapsed = clockUs() - lastRead;
+    if (elapsed >= interval) {
+        sensor_read();
+        elapsed = 0;
+    }
+    if (sensor_hand_over_in() == 0) return 0;
+    return (interval - elapsed + 999) / 1000;
+#endif
+}
+
+uint32_t sensor_service_dropped(void) {
+    return LOAD(&dropped);
+}
+
+int imu_stream_open(uint16_t rate_hz, imu_stream_filter_t filter, imu_stream_cb_t cb, void *user) {
+    if (cb == NULL || rate_hz == 0) return -1;
+
+    for (int s = 0; s < SENSOR_MAX_STREAMS; s++) {
+        if (streams[s].cb != NULL) continue;
+
+        memset(&streams[s], 0, sizeof(streams[s]));
+        streams[s].cb = cb;
+        streams[s].user = user;
+        streams[s].filter = filter;
+        streams[s].rate = rate_hz;
+        streams[s].latency_ms = SENSOR_LATENCY_MS;
+        streams[s].interval_us = 1000000 / rate_hz;
+        streams_changed(LOAD(&streamsOpen) + 1);
+        return s;
+    }
+    return -1;
+}
+
+void imu_stream_close(int stream) {
+    if (stream < 0 || stream >= SENSOR_MAX_STREAMS || streams[stream].cb == NULL) return;
+
+    streams[stream].cb = NULL;
+    uint32_t open = LOAD(&streamsOpen) - 1;
+    // what the last stream did not get yet would reach the next one late
+    if (open == 0) STORE_RELEASE(&head, LOAD_ACQUIRE(&tail));
+    streams_changed(open);
+}
+
+void imu_stream_set_latency(int stream, uint16_t max_ms) {
+    if (stream < 0 || stream >= SENSOR_MAX_STREAMS || streams[stream].cb == NULL) return;
+
+    streams[stream].latency_ms = max_ms > 0 ? max_ms : SENSOR_LATENCY_MS;
+    streams_changed(LOAD(&streamsOpen));
+}
+
+uint16_t get_imu_batch(imu_sample_t *out, uint16_t max) {
+    // samples the sensor task queued since the last delivery
+    sensor_dispatch(NULL);
+
+    uint32_t kept = historyCount < SENSOR_HISTORY ? historyCount : SENSOR_HISTORY;
+    uint16_t count = kept < max ? (uint16_t)kept : max;
+    for (uint16_t i = 0; i < count; i++) {
+        out[i] = history[(historyCount - count + i) % SENSOR_HISTORY];
+    }
+    return count;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Samples between the sensor task and the UI thread, must be a power of two
+#define SENSOR_RING_SIZE 64
+// Newest samples kept for get_imu_batch()
+#define SENSOR_HISTORY 32
+#define SENSOR_MAX_STREAMS 4
+// Highest output data rate, faster streams get every sample
+#define SENSOR_ODR_MAX_HZ 100
+// Longest a sample waits before its stream gets it, unless the stream sets its own
+#define SENSOR_LATENCY_MS 40
+// Samples read in one go, larger FIFOs take more reads
+#define SENSOR_BURST_MAX 32
+#define SENSOR_TASK_STACK 4096
+
+/*
+ * One reader for the IMU, shared by every app through imu_stream_open() (api.h).
+ *
+ * The sensor is started when the first stream opens and stopped when the last one
+ * closes. It runs at the highest rate of the open streams (at most SENSOR_ODR_MAX_HZ)
+ * and is restarted when that changes. While it runs, it is read once per ODR period
+ * without a FIFO, or in bursts before its FIFO is half full. The samples are
+ * timestamped, spaced by the ODR back from the time of the read, and wait in a
+ * lock-free ring until the shortest latency of the open streams (imu_stream_set_latency,
+ * SENSOR_LATENCY_MS by default) is up or the ring is half full. Then they go to the UI
+ * thread in one hand-over, where each stream downsamples them to its own rate and gets
+ * them as one batch. Background streams such as the step counter can wait for seconds,
+ * so the UI loop is not woken for every read.
+ *
+ * Backends: on FreeRTOS (esp32) the reads run on their own task and the batches are
+ * handed over with ui_post(). Elsewhere the HAL calls sensor_service_poll() from its
+ * loop and everything runs on the UI thread; without a FIFO it also calls
+ * sensor_service_read() while the loop sleeps, so the reads between hand-overs do not
+ * need a loop pass.
+ */
+
+typedef struct {
+    // configure the sensor for at least odr_hz and start it, false if it did not respond
+    bool (*start)(uint16_t odr_hz);
+    // put the sensor in standby
+    void (*stop)(void);
+    // up to max samples waiting in the sensor, oldest first, time_us is set by the service
+    uint16_t (*read)(imu_sample_t *out, uint16_t max);
+    // samples the sensor buffers, 0 reads one sample per ODR period
+    uint16_t fifo;
+} sensor_backend_t;
+
+// Call once from the UI thread, after ui_thread_init(). backend may be NULL (no IMU).
+// now_us is the timestamp clock and is called from the sensor task.
+void sensor_service_init(const sensor_backend_t *backend, uint32_t (*now_us)(void));
+
+// The rate the sensor runs at for the open streams, 0 while none is open
+uint16_t sensor_service_odr(void);
+
+// Without a sensor task, from the UI loop: reads what is due and hands the samples over
+// once their latency is up. Returns ms until the next hand-over, or the next read with a
+// FIFO (UINT32_MAX while no stream is open). Does nothing with a sensor task.
+uint32_t sensor_service_poll(void);
+
+// Without a sensor task, while the UI loop sleeps: reads what is due, returns ms until
+// the next read, 0 when a hand-over is due and the loop should run (UINT32_MAX while no
+// stream is open). Does nothing with a sensor task.
+uint32_t sensor_service_read(void);
+
+// Samples lost because the UI thread did not keep up
+uint32_t sensor_service_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
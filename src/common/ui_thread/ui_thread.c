@@ -0,0 +1,212 @@
+#include "ui_thread.h"
+#include <stddef.h>
+
+#if defined(ESP_PLATFORM)
+#define UI_THREAD_FREERTOS
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#elif defined(__unix__) || defined(__APPLE__)
+#define UI_THREAD_PTHREAD
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if (UI_THREAD_POST_SIZE & (UI_THREAD_POST_SIZE - 1)) != 0 || (UI_THREAD_WORKER_JOBS & (UI_THREAD_WORKER_JOBS - 1)) != 0
+#error "UI_THREAD_POST_SIZE and UI_THREAD_WORKER_JOBS must be powers of two"
+#endif
+
+typedef struct {
+    ui_work_cb_t cb;
+    void *arg;
+} ui_closure_t;
+
+typedef struct {
+    ui_work_cb_t work;
+    ui_work_cb_t done;
+    void *arg;
+} ui_job_t;
+
+static ui_closure_t posts[UI_THREAD_POST_SIZE];
+static uint32_t postHead = 0;
+static uint32_t postTail = 0;
+static void (*wakeCb)(void) = NULL;
+
+// --- Backend ---
+#if defined(UI_THREAD_FREERTOS)
+
+static SemaphoreHandle_t uiMutex = NULL;
+static SemaphoreHandle_t postMutex = NULL;
+static TaskHandle_t uiTask = NULL;
+static QueueHandle_t jobQueue = NULL;
+
+static void os_init(void) {
+    uiMutex = xSemaphoreCreateRecursiveMutex();
+    postMutex = xSemaphoreCreateMutex();
+    uiTask = xTaskGetCurrentTaskHandle();
+}
+static bool os_is_ui(void) { return xTaskGetCurrentTaskHandle() == uiTask; }
+static void os_ui_lock(void) { xSemaphoreTakeRecursive(uiMutex, portMAX_DELAY); }
+static void os_ui_unlock(void) { xSemaphoreGiveRecursive(uiMutex); }
+static void os_post_lock(void) { xSemaphoreTake(postMutex, portMAX_DELAY); }
+static void os_post_unlock(void) { xSemaphoreGive(postMutex); }
+static void os_yield(void) { vTaskDelay(1); }
+
+static void worker_task(void *param) {
+    ui_job_t job;
+    for (;;) {
+        if (xQueueReceive(jobQueue, &job, portMAX_DELAY) == pdTRUE) {
+            job.work(job.arg);
+            while (job.done != NULL && !ui_post(job.done, job.arg)) os_yield();
+        }
+    }
+}
+
+static bool os_worker_push(const ui_job_t *job) {
+    if (jobQueue == NULL) {
+        jobQueue = xQueueCreate(UI_THREAD_WORKER_JOBS, sizeof(ui_job_t));
+        xTaskCreate(worker_task, "UI Worker", UI_THREAD_WORKER_STACK, NULL, 1, NULL);
+    }
+    return xQueueSend(jobQueue, job, 0) == pdTRUE;
+}
+
+#elif defined(UI_THREAD_PTHREAD)
+
+static pthread_mutex_t uiMutex;
+static pthread_mutex_t postMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t uiThread;
+static pthread_mutex_t jobMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobCond = PTHREAD_COND_INITIALIZER;
+static ui_job_t jobs[UI_THREAD_WORKER_JOBS];
+static uint32_t jobHead = 0;
+static uint32_t jobTail = 0;
+static bool workerStarted = false;
+
+static void os_init(void) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&uiMutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    uiThread = pthread_self();
+}
+static bool os_is_ui(void) { return pthread_equal(pthread_self(), uiThread); }
+static void os_ui_lock(void) { pthread_mutex_lock(&uiMutex); }
+static void os_ui_unlock(void) { pthread_mutex_unlock(&uiMutex); }
+static void os_post_lock(void) { pthread_mutex_lock(&postMutex); }
+static void os_post_unlock(void) { pthread_mutex_unlock(&postMutex); }
+static void os_yield(void) { sched_yield(); }
+
+static void *worker_thread(void *param) {
+    (void)param;
+    for (;;) {
+        pthread_mutex_lock(&jobMutex);
+        while (jobHead == jobTail) pthread_cond_wait(&jobCond, &jobMutex);
+        ui_job_t job = jobs[jobHead % UI_THREAD_WORKER_JOBS];
+        jobHead++;
+        pthread_mutex_unlock(&jobMutex);
+
+        job.work(job.arg);
+        while (job.done != NULL && !ui_post(job.done, job.arg)) os_yield();
+    }
+    return NULL;
+}
+
+static bool os_worker_push(const ui_job_t *job) {
+    pthread_mutex_lock(&jobMutex);
+    if (!workerStarted) {
+        pthread_t thread;
+        workerStarted = pthread_create(&thread, NULL, worker_thread, NULL) == 0;
+        if (workerStarted) pthread_detach(thread);
+    }
+    bool queued = workerStarted && jobTail - jobHead < UI_THREAD_WORKER_JOBS;
+    if (queued) {
+        jobs[jobTail % UI_THREAD_WORKER_JOBS] = *job;
+        jobTail++;
+        pthread_cond_signal(&jobCond);
+    }
+    pthread_mutex_unlock(&jobMutex);
+    return queued;
+}
+
+#else
+
+static void os_init(void) {}
+static bool os_is_ui(void) { return true; }
+static void os_ui_lock(void) {}
+static void os_ui_unlock(void) {}
+static void os_post_lock(void) {}
+static void os_post_unlock(void) {}
+
+// single thread, the job runs now and only its completion waits for the drain
+static bool os_worker_push(const ui_job_t *job) {
+    job->work(job->arg);
+    return job->done == NULL || ui_post(job->done, job->arg);
+}
+
+#endif
+
+// --- API ---
+void ui_thread_init(void (*wake)(void)) {
+    os_init();
+    wakeCb = wake;
+}
+
+bool ui_thread_is_current(void) {
+    return os_is_ui();
+}
+
+void ui_lock(void) {
+    os_ui_lock();
+}
+
+void ui_unlock(void) {
+    os_ui_unlock();
+}
+
+bool ui_post(ui_work_cb_t cb, void *arg) {
+    if (cb == NULL) return false;
+
+    os_post_lock();
+    bool queued = postTail - postHead < UI_THREAD_POST_SIZE;
+    if (queued) {
+        posts[postTail % UI_THREAD_POST_SIZE].cb = cb;
+        posts[postTail % UI_THREAD_POST_SIZE].arg = arg;
+        postTail++;
+    }
+    os_post_unlock();
+
+    if (queued && wakeCb) wakeCb();
+    return queued;
+}
+
+uint32_t ui_thread_drain(void) {
+    os_post_lock();
+    uint32_t end = postTail;
+    os_post_unlock();
+
+    // closures run without the post lock so they can post again
+    uint32_t ran = 0;
+    for (;;) {
+        os_post_lock();
+        if (postHead == end) {
+            os_post_unlock();
+            break;
+        }
+        ui_closure_t closure = posts[postHead % UI_THREAD_POST_SIZE];
+        postHead++;
+        os_post_unlock();
+
+        closure.cb(closure.arg);
+        ran++;
+    }
+    return ran;
+}
+
+bool ui_worker_run(ui_work_cb_t work, ui_work_cb_t done, void *arg) {
+    if (work == NULL) return false;
+
+    ui_job_t job = {work, done, arg};
+    return os_worker_push(&job);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Closures waiting for the UI thread
+#define UI_THREAD_POST_SIZE 16
+// Jobs waiting for the worker
+#define UI_THREAD_WORKER_JOBS 8
+#define UI_THREAD_WORKER_STACK 8192
+
+/*
+ * LVGL is built without an OS layer (LV_USE_OS LV_OS_NONE), so every LVGL call has to
+ * come from the UI loop or hold the UI lock.
+ *
+ * The UI loop takes ui_lock() for its whole iteration and releases it only while it
+ * sleeps. Another task (the ENABLE_GAME_TASK game loop) takes it around its LVGL
+ * calls. The lock is recursive.
+ *
+ * Tasks that must not wait for the UI post a closure instead. It runs on the UI
+ * thread at the next ui_thread_drain(). CPU heavy work goes to the worker with
+ * ui_worker_run(), and its completion runs on the UI thread the same way.
+ *
+ * Backends: FreeRTOS (esp32), pthreads (emulator). Without either everything runs
+ * on one thread: the lock does nothing and the worker runs jobs right away.
+ */
+
+// Call once from the UI thread. wake (may be NULL) is called after each post so a
+// sleeping UI loop can return early.
+void ui_thread_init(void (*wake)(void));
+bool ui_thread_is_current(void);
+
+void ui_lock(void);
+void ui_unlock(void);
+
+typedef void (*ui_work_cb_t)(void *arg);
+
+// Run cb(arg) on the UI thread, from any task but not from an ISR. False when the
+// queue is full.
+bool ui_post(ui_work_cb_t cb, void *arg);
+
+// UI thread, runs the closures posted before the call. Returns how many ran.
+uint32_t ui_thread_drain(void);
+
+// Run work(arg) on the worker task, then done(arg) on the UI thread (done may be
+// NULL). work must not call LVGL. False when the job queue is full.
+bool ui_worker_run(ui_work_cb_t work, ui_work_cb_t done, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,108 @@
+#include "wrist_wake.h"
+#include <stddef.h>
+#include "../fusion/fusion.h"
+
+#define MG(x) ((q16_t)((x) * (int64_t)Q16_ONE / 1000))
+#define MS(x) ((uint32_t)(x) * 1000u)
+
+static wrist_wake_t shared;
+static wrist_wake_cb_t wakeCb = NULL;
+static int stream = -1;
+
+// --- Engine ---
+static uint32_t add_us(uint32_t a, uint32_t b) {
+    return b < UINT32_MAX - a ? a + b : UINT32_MAX;
+}
+
+void wrist_wake_init(wrist_wake_t *w) {
+    w->state = WRIST_STATE_AWAY;
+    w->primed = false;
+    w->last_us = 0;
+    w->away_us = 0;
+    w->since_away_us = UINT32_MAX;
+    w->held_us = 0;
+    w->since_wake_us = UINT32_MAX;
+}
+
+wrist_wake_event_t wrist_wake_feed(wrist_wake_t *w, const imu_sample_t *s) {
+    q16_t ax = Q16_FROM_FLOAT(s->ax);
+    q16_t ay = Q16_FROM_FLOAT(s->ay);
+    q16_t az = Q16_FROM_FLOAT(s->az);
+    bool facing = az >= MG(WRIST_FACING_MG);
+    bool away = az <= MG(WRIST_AWAY_MG);
+    q16_t still = q16_mul(ax, ax) + q16_mul(ay, ay) + q16_mul(az, az) - Q16_ONE;
+    bool steady = still <= MG(WRIST_STEADY_MG) && still >= -MG(WRIST_STEADY_MG);
+
+    if (!w->primed) {
+        // already up when the stream starts is not a raise
+        w->state = facing ? WRIST_STATE_FACING : WRIST_STATE_AWAY;
+        w->last_us = s->time_us;
+        w->primed = true;
+        return WRIST_WAKE_NONE;
+    }
+    uint32_t dt = s->time_us - w->last_us;
+    w->last_us = s->time_us;
+    w->since_wake_us = add_us(w->since_wake_us, dt);
+
+    if (away) {
+        // a time away counts from the first away sample after being up
+        w->away_us = w->since_away_us == 0 ? add_us(w->away_us, dt) : dt;
+        w->since_away_us = 0;
+        w->state = WRIST_STATE_AWAY;
+        return WRIST_WAKE_NONE;
+    }
+    w->since_away_us = add_us(w->since_away_us, dt);
+    if (w->since_away_us > MS(WRIST_WINDOW_MS) + MS(WRIST_HOLD_MS)) {
+        // too slow for a gesture, the screen was turned up by hand
+        w->state = facing ? WRIST_STATE_FACING : WRIST_STATE_AWAY;
+        return WRIST_WAKE_NONE;
+    }
+
+    switch (w->state) {
+    case WRIST_STATE_AWAY:
+        if (facing && w->since_away_us <= MS(WRIST_WINDOW_MS)) {
+            w->state = WRIST_STATE_CANDIDATE;
+            w->held_us = 0;
+        }
+        break;
+
+    case WRIST_STATE_CANDIDATE:
+        if (!facing) {
+            w->state = WRIST_STATE_AWAY;
+            break;
+        }
+        w->held_us = steady ? w->held_us + dt : 0;
+        if (w->held_us < MS(WRIST_HOLD_MS)) break;
+
+        w->state = WRIST_STATE_FACING;
+        if (w->since_wake_us < MS(WRIST_REFRACTORY_MS)) break;
+        w->since_wake_us = 0;
+        return w->away_us >= MS(WRIST_RAISE_MS) ? WRIST_WAKE_RAISE : WRIST_WAKE_TILT;
+
+    case WRIST_STATE_FACING:
+        break;
+    }
+    return WRIST_WAKE_NONE;
+}
+
+// --- Service ---
+static void wrist_stream_cb(const imu_sample_t *samples, uint16_t count, void *user) {
+    (void)user;
+    for (uint16_t i = 0; i < count; i++) {
+        wrist_wake_event_t event = wrist_wake_feed(&shared, &samples[i]);
+        if (event != WRIST_WAKE_NONE && wakeCb != NULL) wakeCb(event);
+    }
+}
+
+void wrist_wake_start(wrist_wake_cb_t on_wake) {
+    wakeCb = on_wake;
+    if (stream >= 0) return;
+    wrist_wake_init(&shared);
+    stream = imu_stream_open(WRIST_WAKE_RATE_HZ, IMU_STREAM_AVERAGE, wrist_stream_cb, NULL);
+    imu_stream_set_latency(stream, WRIST_WAKE_LATENCY_MS);
+}
+
+void wrist_wake_stop(void) {
+    imu_stream_close(stream);
+    stream = -1;
+}
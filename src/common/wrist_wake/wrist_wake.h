@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stream rate, thresholds are in time so lower rates work too (tested down to 5 Hz)
+#define WRIST_WAKE_RATE_HZ 10
+// Added to the time to wake, the samples are handed over this often
+#define WRIST_WAKE_LATENCY_MS 200
+// Screen within about 45 degrees of up
+#define WRIST_FACING_MG 700
+// Screen more than about 70 degrees from up
+#define WRIST_AWAY_MG 300
+// |a|^2 within 1g +- this counts as held still, mg
+#define WRIST_STEADY_MG 300
+// Facing must follow the last away sample within this
+#define WRIST_WINDOW_MS 1000
+// Facing and steady this long before it wakes
+#define WRIST_HOLD_MS 150
+// Away at least this long is a raise, shorter a tilt
+#define WRIST_RAISE_MS 600
+// No second wake within this
+#define WRIST_REFRACTORY_MS 1500
+
+/*
+ * Wrist raise and tilt to wake, on the accelerometer stream of the sensor service.
+ *
+ * A state machine over the screen normal (z): it has to point away from up, then up
+ * again within WRIST_WINDOW_MS, and stay there without shaking for WRIST_HOLD_MS. A
+ * long time away (the arm hanging) is a raise, a short flick of the wrist while
+ * looking at it is a tilt. A watch turned over slowly, a swinging arm or typing does
+ * not get there. Thresholds are Q16 (fusion.h), no square root or division per sample.
+ */
+
+typedef enum {
+    WRIST_WAKE_NONE,
+    WRIST_WAKE_RAISE,
+    WRIST_WAKE_TILT,
+} wrist_wake_event_t;
+
+typedef enum {
+    WRIST_STATE_AWAY,      // waiting for the screen to come up
+    WRIST_STATE_CANDIDATE, // up, waiting for it to hold
+    WRIST_STATE_FACING,    // up and handled, waiting for it to turn away again
+} wrist_state_t;
+
+typedef struct {
+    wrist_state_t state;
+    bool primed;
+    uint32_t last_us;
+    uint32_t away_us;       // length of the last time away
+    uint32_t since_away_us; // since the last away sample
+    uint32_t held_us;
+    uint32_t since_wake_us;
+} wrist_wake_t;
+
+// --- Engine ---
+void wrist_wake_init(wrist_wake_t *w);
+// one sample, accelerometer in g
+wrist_wake_event_t wrist_wake_feed(wrist_wake_t *w, const imu_sample_t *s);
+
+// --- Service ---
+typedef void (*wrist_wake_cb_t)(wrist_wake_event_t event);
+
+// Opens the stream, on_wake runs on the UI thread. Call after sensor_service_init().
+void wrist_wake_start(wrist_wake_cb_t on_wake);
+void wrist_wake_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -13,15 +13,9 @@
 #ifdef ENABLE_GAME_RACING
 
 #ifndef LV_USE_SDL
-#warning "Racing game works best with SDL emulator" // hardware needs rewrite
-
-#if !defined(ENABLE_GAME_TASK)
-#error "Racing game needs separate task to run on hardware"
-#endif
-
+#warning "Racing game works best with SDL emulator" // steering still follows the touch read rate
 #endif
 
-#define ROAD_HEIGHT 270
 #define NPC_CAR_HEIGHT 400
 #define NPC_CAR_OFFSET_Y -110
 #define NPC_CAR_X_OFFSET -50
@@ -30,6 +24,10 @@
 #define MIN_SPEED 0.5
 #define INITIAL_SPEED 3.5
 #define SPEED_LIMIT_FACTOR 3.5
+#define RACE_HZ 100 // physics steps per second, the constants above are per step
+#define ROAD_WIDTH 150
+#define CAR_WIDTH 64
+#define RACE_CAR_X(x) ((ROAD_WIDTH - CAR_WIDTH) / 2 + (x)) // car offset from the road center to layer coordinates
 
 
 REGISTER_APP("Racing", &ui_img_car_png, ui_raceScreen, ui_raceScreen_screen_init);
@@ -37,19 +35,16 @@ REGISTER_APP("Racing", &ui_img_car_png, ui_raceScreen, ui_raceScreen_screen_init
 void ui_event_raceScreen(lv_event_t *e);
 void ui_event_roadPanel(lv_event_t *e);
 lv_obj_t *ui_roadPanel;
-lv_obj_t *ui_roadImage;
+ui_sprite_layer_t raceLayer; // road and cars
+int playerSprite, npcSprite;
 lv_obj_t *ui_distanceLabel;
 lv_obj_t *ui_speedLabel;
-lv_obj_t *ui_carPlayer;
 void ui_event_leftButton(lv_event_t *e);
 lv_obj_t *ui_leftButton;
 lv_obj_t *ui_leftButtonText;
 void ui_event_rightButton(lv_event_t *e);
 lv_obj_t *ui_rightButton;
 lv_obj_t *ui_rightButtonText;
-lv_obj_t *ui_carNPC1;
-lv_obj_t *ui_carNPC2;
-lv_obj_t *ui_carNPC3;
 lv_obj_t *ui_racePanel;
 lv_obj_t *ui_raceTitle;
 lv_obj_t *ui_raceInfo;
@@ -64,7 +59,10 @@ lv_obj_t *ui_exitRaceText;
 
 void ui_event_roadPanel(lv_event_t *e);
 
-bool active;
+static void race_update(uint32_t dt_us);
+static void race_render(float alpha);
+
+static const game_def_t raceGame = {"Racing", RACE_HZ, race_update, race_render};
 
 int highScore, currentScore;
 bool isRacing, gameOver;
@@ -73,6 +71,8 @@ float m = INITIAL_SPEED;
 float speedFactor;
 float roadProgress = 0.0f;
 float npcProgress = 0.0f;
+float prevRoadProgress, prevNpcProgress; // progress before the last step, for render
+int shownScore = -1, shownSpeed = -1;
 uint64_t counter;
 float npcSpeed = INITIAL_SPEED / 1.5;
 
@@ -93,8 +93,6 @@ const lv_image_dsc_t *carIcons[] = {
 
 CarP player;
 CarP npc1;
-CarP npcBuf;
-CarP plBuf;
 
 
 // Function to check if two cars have crashed into each other
@@ -124,7 +122,7 @@ void ui_event_raceScreen(lv_event_t *e)
     if (event_code == LV_EVENT_SCREEN_LOAD_START)
     {
         onGameOpened();
-        active = true;
+        game_loop_start(&raceGame, lv_tick_get);
         isRacing = false;
 
 
@@ -152,7 +150,7 @@ void ui_event_raceScreen(lv_event_t *e)
     }
     if (event_code == LV_EVENT_SCREEN_UNLOAD_START)
     {
-        active = false;
+        game_loop_stop();
         isRacing = false;
     }
     if (event_code == LV_EVENT_SCREEN_UNLOADED)
@@ -247,6 +245,10 @@ void ui_event_raceStart(lv_event_t *e)
             npcProgress = 0.0f;
             gen = true;
         }
+        prevRoadProgress = roadProgress;
+        prevNpcProgress = npcProgress;
+        shownScore = -1;
+        shownSpeed = -1;
         isRacing = true;
         lv_obj_add_flag(ui_racePanel, LV_OBJ_FLAG_HIDDEN); /// Flags
     }
@@ -281,14 +283,16 @@ void ui_raceScreen_screen_init()
     lv_obj_set_style_pad_top(ui_roadPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_pad_bottom(ui_roadPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
 
-    ui_roadImage = lv_image_create(ui_roadPanel);
-    lv_image_set_src(ui_roadImage, &ui_img_road_png);
-    lv_obj_set_width(ui_roadImage, 150);
-    lv_obj_set_height(ui_roadImage, 540);
-    lv_obj_set_align(ui_roadImage, LV_ALIGN_BOTTOM_MID);
-    lv_obj_add_flag(ui_roadImage, LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
-    lv_obj_remove_flag(ui_roadImage, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-    lv_image_set_inner_align(ui_roadImage, LV_IMAGE_ALIGN_TILE );
+    lv_obj_add_flag(ui_roadPanel, LV_OBJ_FLAG_OVERFLOW_VISIBLE); /// Flags, cars may leave the road
+
+    // one object for the road and all cars, redrawn by the layer itself
+    ui_sprite_layer_create(&raceLayer, ui_roadPanel, ROAD_WIDTH, 240);
+    ui_sprite_layer_set_background(&raceLayer, &ui_img_road_png);
+    ui_sprite_layer_set_overflow(&raceLayer, CAR_WIDTH / 2);
+    playerSprite = ui_sprite_add(&raceLayer, &ui_img_car_png, RACE_CAR_X(0), 160);
+    npcSprite = ui_sprite_add(&raceLayer, &ui_img_car_green_png, RACE_CAR_X(20), -1);
+    ui_sprite_add(&raceLayer, &ui_img_car_red_png, RACE_CAR_X(-21), -60);
+    ui_sprite_add(&raceLayer, &ui_img_car_yellow_png, RACE_CAR_X(-21), -60);
 
     ui_distanceLabel = lv_label_create(ui_raceScreen);
     lv_obj_set_width(ui_distanceLabel, LV_SIZE_CONTENT);  /// 1
@@ -320,16 +324,6 @@ void ui_raceScreen_screen_init()
     lv_obj_set_style_outline_width(ui_speedLabel, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_outline_pad(ui_speedLabel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
 
-    ui_carPlayer = lv_image_create(ui_raceScreen);
-    lv_image_set_src(ui_carPlayer, &ui_img_car_png);
-    lv_obj_set_width(ui_carPlayer, LV_SIZE_CONTENT);  /// 1
-    lv_obj_set_height(ui_carPlayer, LV_SIZE_CONTENT); /// 1
-    lv_obj_set_x(ui_carPlayer, 0);
-    lv_obj_set_y(ui_carPlayer, 160);
-    lv_obj_set_align(ui_carPlayer, LV_ALIGN_TOP_MID);
-    lv_obj_add_flag(ui_carPlayer, LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
-    lv_obj_remove_flag(ui_carPlayer, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-
     ui_leftButton = lv_button_create(ui_raceScreen);
     lv_obj_set_width(ui_leftButton, 50);
     lv_obj_set_height(ui_leftButton, 100);
@@ -374,36 +368,6 @@ void ui_raceScreen_screen_init()
     lv_label_set_text(ui_rightButtonText, ">");
     lv_obj_set_style_text_font(ui_rightButtonText, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
 
-    ui_carNPC1 = lv_image_create(ui_raceScreen);
-    lv_image_set_src(ui_carNPC1, &ui_img_car_green_png);
-    lv_obj_set_width(ui_carNPC1, LV_SIZE_CONTENT);  /// 1
-    lv_obj_set_height(ui_carNPC1, LV_SIZE_CONTENT); /// 1
-    lv_obj_set_x(ui_carNPC1, 20);
-    lv_obj_set_y(ui_carNPC1, -1);
-    lv_obj_set_align(ui_carNPC1, LV_ALIGN_TOP_MID);
-    lv_obj_add_flag(ui_carNPC1, LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
-    lv_obj_remove_flag(ui_carNPC1, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-
-    ui_carNPC2 = lv_image_create(ui_raceScreen);
-    lv_image_set_src(ui_carNPC2, &ui_img_car_red_png);
-    lv_obj_set_width(ui_carNPC2, LV_SIZE_CONTENT);  /// 1
-    lv_obj_set_height(ui_carNPC2, LV_SIZE_CONTENT); /// 1
-    lv_obj_set_x(ui_carNPC2, -21);
-    lv_obj_set_y(ui_carNPC2, -60);
-    lv_obj_set_align(ui_carNPC2, LV_ALIGN_TOP_MID);
-    lv_obj_add_flag(ui_carNPC2, LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
-    lv_obj_remove_flag(ui_carNPC2, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-
-    ui_carNPC3 = lv_image_create(ui_raceScreen);
-    lv_image_set_src(ui_carNPC3, &ui_img_car_yellow_png);
-    lv_obj_set_width(ui_carNPC3, LV_SIZE_CONTENT);  /// 1
-    lv_obj_set_height(ui_carNPC3, LV_SIZE_CONTENT); /// 1
-    lv_obj_set_x(ui_carNPC3, -21);
-    lv_obj_set_y(ui_carNPC3, -60);
-    lv_obj_set_align(ui_carNPC3, LV_ALIGN_TOP_MID);
-    lv_obj_add_flag(ui_carNPC3, LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
-    lv_obj_remove_flag(ui_carNPC3, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-
     ui_racePanel = lv_obj_create(ui_raceScreen);
     lv_obj_set_width(ui_racePanel, 240);
     lv_obj_set_height(ui_racePanel, 240);
@@ -497,122 +461,108 @@ void ui_raceScreen_screen_init()
     lv_obj_add_event_cb(ui_raceStart, ui_event_raceStart, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_exitRace, ui_event_exitRace, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_raceScreen, ui_event_raceScreen, LV_EVENT_ALL, NULL);
-
-
-    active = false;
-
-
 }
 
-#endif
-
-void ui_raceScreen_screen_loop()
+static void race_update(uint32_t dt_us)
 {
-#ifdef ENABLE_GAME_RACING
-    if (!active)
+    LV_UNUSED(dt_us);
+    if (!isRacing)
     {
         return;
     }
-    if (!ui_raceScreen)
+
+    // Calculate speed modifier
+    m = INITIAL_SPEED - (counter / SPEED_DIVISOR);
+    if (m < MIN_SPEED)
     {
-        return;
+        m = MIN_SPEED;
     }
 
-    if (isRacing)
+    // Calculate speed factor
+    speedFactor = INITIAL_SPEED / m;
+    if (speedFactor > SPEED_LIMIT_FACTOR)
     {
-        if (plBuf.x != player.x)
-        {
-            lv_obj_set_x(ui_carPlayer, player.x);
-            plBuf.x = player.x;
-        }
-        if (plBuf.y != player.y)
-        {
-            lv_obj_set_y(ui_carPlayer, player.y);
-            plBuf.y = player.y;
-        }
+        speedFactor = SPEED_LIMIT_FACTOR;
+    }
 
-        // Calculate speed modifier
-        m = INITIAL_SPEED - (counter / SPEED_DIVISOR);
-        if (m < MIN_SPEED)
-        {
-            m = MIN_SPEED;
-        }
+    // Update current score
+    currentScore = (counter / 100) + ((INITIAL_SPEED - m) * SCORE_MULTIPLIER);
 
-        // Calculate speed factor
-        speedFactor = INITIAL_SPEED / m;
-        if (speedFactor > SPEED_LIMIT_FACTOR)
-        {
-            speedFactor = SPEED_LIMIT_FACTOR;
-        }
+    // Update road movement progress
+    prevRoadProgress = roadProgress;
+    roadProgress += speedFactor;
 
-        // Update current score
-        currentScore = (counter / 100) + ((INITIAL_SPEED - m) * SCORE_MULTIPLIER);
-        lv_label_set_text_fmt(ui_distanceLabel, "%d", currentScore);
+    // NPC car logic
+    if (((int)npcProgress % NPC_CAR_HEIGHT) > (NPC_CAR_HEIGHT - 10))
+    {
+        gen = true; // Flag to generate new NPC car position
+    }
+    if (((int)npcProgress % NPC_CAR_HEIGHT) == 0 && gen)
+    {
+        npc1.x = (lv_rand(0, 99) % 100) + NPC_CAR_X_OFFSET;
+        ui_sprite_set_src(&raceLayer, npcSprite, carIcons[lv_rand(0, 2) % 3]);
+        gen = false;
+    }
 
-        // Update road movement progress
-        roadProgress += speedFactor;
+    // Update NPC car y-position
+    prevNpcProgress = npcProgress;
+    npcProgress += MIN_SPEED;
+    npc1.y = ((int)npcProgress % NPC_CAR_HEIGHT) + NPC_CAR_OFFSET_Y;
 
-        // Update speed label
-        lv_label_set_text_fmt(ui_speedLabel, "%d", (int)(speedFactor * 100));
+    if (haveCrashed(player, npc1))
+    {
+        isRacing = false;
+        gameOver = true;
 
-        // Move the road image vertically
-        lv_obj_set_y(ui_roadImage, ((int)roadProgress) % ROAD_HEIGHT);
+        lv_label_set_text(ui_distanceLabel, "0");
+        lv_label_set_text(ui_speedLabel, "0");
 
-        // NPC car logic
-        if (((int)npcProgress % NPC_CAR_HEIGHT) > (NPC_CAR_HEIGHT - 10))
-        {
-            gen = true; // Flag to generate new NPC car position
-        }
-        if (((int)npcProgress % NPC_CAR_HEIGHT) == 0 && gen)
-        {
-            npc1.x = (lv_rand(0, 99) % 100) + NPC_CAR_X_OFFSET;
-            lv_obj_set_x(ui_carNPC1, npc1.x);
-            lv_image_set_src(ui_carNPC1, carIcons[lv_rand(0, 2) % 3]);
-            gen = false;
-        }
+        lv_obj_remove_flag(ui_racePanel, LV_OBJ_FLAG_HIDDEN); /// Flags
+        lv_label_set_text(ui_raceButtonText, "Start");
+        lv_label_set_text(ui_raceLabel, "Your Score");
+        lv_label_set_text_fmt(ui_raceScore, "%dm", currentScore);
+        lv_obj_remove_flag(ui_raceInfo, LV_OBJ_FLAG_HIDDEN); /// Flags
 
-        // Update NPC car speed
-        // npcSpeed -= 0.001; // Decrease NPC speed gradually
-        // if (npcSpeed < MIN_SPEED)
-        // {
-        //     npcSpeed = MIN_SPEED;
-        // }
-
-        // Update NPC car y-position
-        npcProgress += MIN_SPEED;
-        npc1.y = ((int)npcProgress % NPC_CAR_HEIGHT) + NPC_CAR_OFFSET_Y;
-        if (npcBuf.y != npc1.y)
+        if (currentScore > highScore)
         {
-            npcBuf.y = npc1.y;
-            lv_obj_set_y(ui_carNPC1, npc1.y);
+            highScore = currentScore;
+            lv_label_set_text(ui_raceLabel, "New High Score");
+            savePrefInt("racing_high", highScore);
         }
+        currentScore = 0;
+    }
 
-        if (haveCrashed(player, npc1))
-        {
-            active = true;
-            isRacing = false;
-            gameOver = true;
+    counter++;
+}
 
-            lv_label_set_text(ui_distanceLabel, "0");
-            lv_label_set_text(ui_speedLabel, "0");
+// positions between the last two updates, labels only when their value changed
+static void race_render(float alpha)
+{
+    if (!isRacing)
+    {
+        return;
+    }
 
-            lv_obj_remove_flag(ui_racePanel, LV_OBJ_FLAG_HIDDEN); /// Flags
-            lv_label_set_text(ui_raceButtonText, "Start");
-            lv_label_set_text(ui_raceLabel, "Your Score");
-            lv_label_set_text_fmt(ui_raceScore, "%dm", currentScore);
-            lv_obj_remove_flag(ui_raceInfo, LV_OBJ_FLAG_HIDDEN); /// Flags
+    // the road first, a scrolled layer is redrawn whole and the car moves add nothing
+    float road = prevRoadProgress + (roadProgress - prevRoadProgress) * alpha;
+    ui_sprite_layer_scroll_to(&raceLayer, (int)road);
 
-            if (currentScore > highScore)
-            {
-                highScore = currentScore;
-                lv_label_set_text(ui_raceLabel, "New High Score");
-                savePrefInt("racing_high", highScore);
-            }
-            currentScore = 0;
-        }
+    ui_sprite_move(&raceLayer, playerSprite, RACE_CAR_X(player.x), player.y);
 
-        counter++;
+    float npc = prevNpcProgress + (npcProgress - prevNpcProgress) * alpha;
+    ui_sprite_move(&raceLayer, npcSprite, RACE_CAR_X(npc1.x), ((int)npc % NPC_CAR_HEIGHT) + NPC_CAR_OFFSET_Y);
+
+    if (shownScore != currentScore)
+    {
+        shownScore = currentScore;
+        lv_label_set_text_fmt(ui_distanceLabel, "%d", currentScore);
     }
+    int speedText = (int)(speedFactor * 100);
+    if (shownSpeed != speedText)
+    {
+        shownSpeed = speedText;
+        lv_label_set_text_fmt(ui_speedLabel, "%d", speedText);
+    }
+}
 
 #endif
-}
@@ -17,6 +17,8 @@ extern "C"
 #include "lvgl.h"
 #include "app_hal.h"
 #include "../../common/app_manager.h"
+#include "../../common/game_loop/game_loop.h"
+#include "../../ui/ui_sprite_layer.h"
 //#define ENABLE_GAME_RACING // (Racing) uncomment to enable or define it elsewhere
 
 #ifdef ENABLE_GAME_RACING
@@ -41,7 +43,6 @@ extern "C"
     int getPrefInt(const char* key, int def_value);
 
 #endif
-void ui_raceScreen_screen_loop(void);
 
 #ifdef __cplusplus
 } /*extern "C"*/
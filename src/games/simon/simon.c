@@ -15,6 +15,18 @@
 
 #define NUM_PANELS 4
 #define MAX_SEQUENCE_LENGTH 50 // Game max levels
+#define SIMON_HZ 20
+#define SIMON_SHOW_MS 500        // pause before and light time of each panel in the sequence
+#define SIMON_NEXT_ROUND_MS 1000 // wait after a completed round
+
+typedef enum
+{
+    SIMON_IDLE,
+    SIMON_SHOW_WAIT,  // next panel of the sequence is about to light up
+    SIMON_SHOW_ON,    // panel is lit
+    SIMON_PLAYER,     // waiting for the player
+    SIMON_NEXT_ROUND, // round done, next one starts soon
+} simon_phase_t;
 
 uint16_t tones[NUM_PANELS] = {220 * 2, 247 * 2, 277 * 2, 311 * 2};
 uint32_t panel_colors[NUM_PANELS] = {0x00801F, 0xD20000, 0xCDED07, 0x0A36E8}; // default colors
@@ -26,6 +38,13 @@ int sequence_index = 0;
 int current_sequence_length = 1; // Start with a sequence of 1
 bool is_player_turn = false;
 int highScoreSimon;
+simon_phase_t simon_phase = SIMON_IDLE;
+uint32_t simon_phase_us;
+lv_obj_t *simon_lit_panel;
+
+static void simon_update(uint32_t dt_us);
+
+static const game_def_t simonGame = {"Simon Says", SIMON_HZ, simon_update, NULL};
 
 
 REGISTER_APP("Simon Says", &ui_img_colors_png, ui_simonScreen, ui_simonScreen_screen_init);
@@ -48,12 +67,6 @@ void ui_event_exitSimon(lv_event_t *e);
 lv_obj_t *ui_exitSimon;
 lv_obj_t *ui_exitSimonText;
 
-typedef struct
-{
-    lv_obj_t *panel;
-    uint16_t tone;
-} panel_data_t;
-
 typedef struct
 {
     const char *title;
@@ -93,9 +106,12 @@ void ui_event_simonScreen(lv_event_t *e)
         lv_obj_remove_flag(ui_simonPanel, LV_OBJ_FLAG_HIDDEN); /// Flags
 
         simonTone(0, 0);
+        simon_phase = SIMON_IDLE;
+        game_loop_start(&simonGame, lv_tick_get);
     }
     if (event_code == LV_EVENT_SCREEN_UNLOAD_START)
     {
+        game_loop_stop();
     }
     if (event_code == LV_EVENT_SCREEN_UNLOADED)
     {
@@ -130,24 +146,41 @@ void ui_event_simonStart(lv_event_t *e)
     }
 }
 
-void remove_state_cb(lv_timer_t *timer)
+static void simon_set_phase(simon_phase_t phase)
 {
-    lv_obj_t *panel = (lv_obj_t *)timer->user_data;
-    lv_obj_remove_state(panel, LV_STATE_PRESSED);
-
-    play_sequence(NULL);
+    simon_phase = phase;
+    simon_phase_us = 0;
 }
 
-void add_state_cb(lv_timer_t *timer)
+// sequence playback and round pauses, counted in game loop steps
+static void simon_update(uint32_t dt_us)
 {
-    panel_data_t *data = (panel_data_t *)timer->user_data;
-    lv_obj_add_state(data->panel, LV_STATE_PRESSED);
-
-    lv_timer_t *remove_t = lv_timer_create(remove_state_cb, 500, data->panel);
-    lv_timer_set_repeat_count(remove_t, 1);
-    lv_timer_set_auto_delete(remove_t, true);
-
-    simonTone(2, data->tone);
+    simon_phase_us += dt_us;
+    switch (simon_phase)
+    {
+    case SIMON_SHOW_WAIT:
+        if (simon_phase_us >= SIMON_SHOW_MS * 1000)
+        {
+            flash_panel(sequence[sequence_index - 1]);
+            simon_set_phase(SIMON_SHOW_ON);
+        }
+        break;
+    case SIMON_SHOW_ON:
+        if (simon_phase_us >= SIMON_SHOW_MS * 1000)
+        {
+            lv_obj_remove_state(simon_lit_panel, LV_STATE_PRESSED);
+            play_sequence();
+        }
+        break;
+    case SIMON_NEXT_ROUND:
+        if (simon_phase_us >= SIMON_NEXT_ROUND_MS * 1000)
+        {
+            play_sequence();
+        }
+        break;
+    default:
+        break;
+    }
 }
 
 /* Event handler for when a panel is clicked */
@@ -175,6 +208,8 @@ void panel_event_handler(lv_event_t *e)
         lv_label_set_text(ui_simonInfo, levels[(int)((current_sequence_length - 1) / div)].message);
 
         lv_obj_remove_flag(ui_simonPanel, LV_OBJ_FLAG_HIDDEN);
+        is_player_turn = false;
+        simon_set_phase(SIMON_IDLE);
         if (current_sequence_length - 1 > highScoreSimon)
         {
             highScoreSimon = current_sequence_length - 1;
@@ -204,6 +239,8 @@ void panel_event_handler(lv_event_t *e)
             lv_label_set_text(ui_simonInfo, levels[10].message);
 
             lv_obj_remove_flag(ui_simonPanel, LV_OBJ_FLAG_HIDDEN);
+            is_player_turn = false;
+            simon_set_phase(SIMON_IDLE);
 
             savePrefInt("simon_high", highScoreSimon);
         }
@@ -215,9 +252,8 @@ void panel_event_handler(lv_event_t *e)
             lv_obj_remove_flag(ui_simonOverPanel, LV_OBJ_FLAG_HIDDEN);
             lv_arc_set_value(ui_simonArc, 360);
             lv_obj_set_style_arc_color(ui_simonArc, lv_color_hex(0x50FF00), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-            lv_timer_t *next_round_timer = lv_timer_create(play_sequence, 1000, NULL); // Wait 1 second before the next round
-            lv_timer_set_repeat_count(next_round_timer, 1);
-            lv_timer_set_auto_delete(next_round_timer, true);
+            is_player_turn = false;
+            simon_set_phase(SIMON_NEXT_ROUND); // Wait 1 second before the next round
         }
     }
 }
@@ -234,16 +270,14 @@ void generate_sequence()
 /* Function to highlight a panel */
 void flash_panel(int panel_idx)
 {
-    panel_data_t *data = lv_malloc(sizeof(panel_data_t));
-    data->panel = panels[panel_idx];
-    data->tone = tones[panel_idx];
-    lv_timer_t *timer = lv_timer_create(add_state_cb, 500, data);
-    lv_timer_set_repeat_count(timer, 1);
-    lv_timer_set_auto_delete(timer, true);
+    simon_lit_panel = panels[panel_idx];
+    lv_obj_add_state(simon_lit_panel, LV_STATE_PRESSED);
+
+    simonTone(2, tones[panel_idx]);
 }
 
 /* Function to play the sequence */
-void play_sequence(lv_timer_t *timer)
+void play_sequence(void)
 {
     lv_obj_remove_flag(ui_simonOverPanel, LV_OBJ_FLAG_HIDDEN);
     lv_arc_set_value(ui_simonArc, 360);
@@ -253,14 +287,15 @@ void play_sequence(lv_timer_t *timer)
     is_player_turn = false;
     if (sequence_index < current_sequence_length)
     {
-        flash_panel(sequence[sequence_index]);
         sequence_index++;
+        simon_set_phase(SIMON_SHOW_WAIT); // the panel lights up after SIMON_SHOW_MS
     }
     else
     {
         sequence_index = 0;
         is_player_turn = true;
         current_step = 0; // Reset player input step
+        simon_set_phase(SIMON_PLAYER);
         lv_obj_add_flag(ui_simonOverPanel, LV_OBJ_FLAG_HIDDEN);
         lv_arc_set_value(ui_simonArc, 0);
         lv_obj_set_style_arc_color(ui_simonArc, lv_color_hex(0x2A2A2A), LV_PART_INDICATOR | LV_STATE_DEFAULT);
@@ -274,7 +309,7 @@ void start_game()
     current_step = 0;
     sequence_index = 0;
     current_sequence_length = 1; // Start with sequence of length 1
-    play_sequence(NULL);
+    play_sequence();
 }
 
 
@@ -17,8 +17,8 @@ extern "C"
 #include "lvgl.h"
 #include "app_hal.h"
 
-#include "misc/lv_timer_private.h"
 #include "../../common/app_manager.h"
+#include "../../common/game_loop/game_loop.h"
 
 #ifdef ENABLE_GAME_SIMON
 
@@ -27,7 +27,7 @@ extern "C"
     void ui_simonScreen_screen_init();
 
     void start_game();
-    void play_sequence(lv_timer_t *timer);
+    void play_sequence(void);
     void flash_panel(int panel_idx);
     void generate_sequence();
     void panel_event_handler(lv_event_t *e);
@@ -11,6 +11,9 @@
 
 #include "ui.h"
 #include "ui_helpers.h"
+#include "ui_theme.h"
+#include "../common/profiler/profiler.h"
+#include "../common/heap_tags/heap_tags.h"
 
 #include "display/lv_display_private.h"
 #include "indev/lv_indev_private.h"
@@ -161,6 +164,7 @@ lv_obj_t *ui_appBatteryPanel;
 lv_obj_t *ui_appBatteryIcon;
 lv_obj_t *ui_appBatteryText;
 lv_obj_t *ui_appBatteryLevel;
+lv_obj_t *ui_appMemoryText;
 
 void ui_event_findPhone(lv_event_t *e);
 lv_obj_t *ui_findPhoneScreen;
@@ -207,6 +211,7 @@ lv_obj_t *ui_qrImage;
 lv_obj_t *ui_qrLabel;
 
 void ui_filesScreen_screen_init(void);
+void ui_event_filesScreen(lv_event_t *e);
 lv_obj_t *ui_filesScreen;
 lv_obj_t *ui_fileManagerPanel;
 lv_obj_t *ui_driveInfoPanel;
@@ -246,11 +251,35 @@ int currentIndex;
 bool screenOn;
 int32_t alert_states;
 
+// state shown on screens that are only created when opened, applied by their init
+static int32_t settingsBrightness = 100;
+static int32_t settingsTimeout = 0;
+static int32_t settingsRotation = 0;
+static bool settingsNavigation = false;
+static char settingsAbout[128] = "v4.0 (fbiego)\nESP32 C3 Mini\n11:22:33:44:55:66";
+static bool phoneConnected = false;
+static char appVersion[48] = "Chronos app\nv3.8.0 (52)";
+
+#define QR_LINKS 9
+static const char *qrDefaults[QR_LINKS] = {
+    "https://chronos.ke/",
+    "https://www.youtube.com/c/fbiego",
+    "https://play.google.com/store/apps/details?id=com.fbiego.chronos",
+    "https://github.com/fbiego/esp32-c3-mini",
+    "https://x.com/chronos_app",
+    "https://felix.fbiego.com",
+    "https://www.linkedin.com/in/fbiego/",
+    "https://ko-fi.com/fbiego",
+    "https://www.paypal.com/paypalme/biego",
+};
+static char *qrLinks[QR_LINKS]; // set by the companion app, NULL for the default
+
 void ui_event____initial_actions0(lv_event_t *e);
 lv_obj_t *ui____initial_actions0;
 
 Face faces[MAX_FACES];
 Face games[MAX_GAMES];
+static heap_tag_t faceOwner = HEAP_TAG_SYSTEM; // face being initialized, see ui_face_init
 
 Drag logoEv;
 
@@ -339,6 +368,7 @@ void pulseCall_Animation(lv_obj_t *TargetObject, int delay)
       PropertyAnimation_0_user_data->val = -1;
       lv_anim_t PropertyAnimation_0;
       lv_anim_init(&PropertyAnimation_0);
+      lv_anim_set_var(&PropertyAnimation_0, TargetObject); // removed with the object when its screen is deleted
       lv_anim_set_time(&PropertyAnimation_0, 1000);
       lv_anim_set_user_data(&PropertyAnimation_0, PropertyAnimation_0_user_data);
       lv_anim_set_custom_exec_cb(&PropertyAnimation_0, _ui_anim_callback_set_image_zoom);
@@ -358,6 +388,7 @@ void pulseCall_Animation(lv_obj_t *TargetObject, int delay)
       PropertyAnimation_1_user_data->val = -1;
       lv_anim_t PropertyAnimation_1;
       lv_anim_init(&PropertyAnimation_1);
+      lv_anim_set_var(&PropertyAnimation_1, TargetObject);
       lv_anim_set_time(&PropertyAnimation_1, 2000);
       lv_anim_set_user_data(&PropertyAnimation_1, PropertyAnimation_1_user_data);
       lv_anim_set_custom_exec_cb(&PropertyAnimation_1, _ui_anim_callback_set_y);
@@ -381,6 +412,7 @@ void findPhone_Animation(lv_obj_t *TargetObject, int delay)
       PropertyAnimation_0_user_data->val = -1;
       lv_anim_t PropertyAnimation_0;
       lv_anim_init(&PropertyAnimation_0);
+      lv_anim_set_var(&PropertyAnimation_0, TargetObject);
       lv_anim_set_time(&PropertyAnimation_0, 500);
       lv_anim_set_user_data(&PropertyAnimation_0, PropertyAnimation_0_user_data);
       lv_anim_set_custom_exec_cb(&PropertyAnimation_0, _ui_anim_callback_set_width);
@@ -399,6 +431,7 @@ void findPhone_Animation(lv_obj_t *TargetObject, int delay)
       PropertyAnimation_1_user_data->val = -1;
       lv_anim_t PropertyAnimation_1;
       lv_anim_init(&PropertyAnimation_1);
+      lv_anim_set_var(&PropertyAnimation_1, TargetObject);
       lv_anim_set_time(&PropertyAnimation_1, 500);
       lv_anim_set_user_data(&PropertyAnimation_1, PropertyAnimation_1_user_data);
       lv_anim_set_custom_exec_cb(&PropertyAnimation_1, _ui_anim_callback_set_height);
@@ -576,9 +609,7 @@ void ui_event____initial_actions0(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_SCREEN_LOAD_START)
       {
-            pulseCall_Animation(ui_callIcon, 0);
             // findPhone_Animation(ui_searchPanel, 0);
-            findPhone_Animation(ui_findPanel, 0);
 
             // analogSecond_Animation(face_radar_33_212563, 0);
       }
@@ -591,20 +622,20 @@ void ui_event_clockScreen(lv_event_t *e)
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
             toAppList = false; // flag was not open from app list
-            _ui_screen_change(ui_notificationScreen, LV_SCR_LOAD_ANIM_OVER_RIGHT, 500, 0);
+            _ui_screen_change(&ui_notificationScreen, LV_SCR_LOAD_ANIM_OVER_RIGHT, 500, 0);
       }
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_LEFT)
       {
-            _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
       }
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_BOTTOM)
       {
-            _ui_screen_change(ui_controlScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0);
+            _ui_screen_change(&ui_controlScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0);
       }
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_TOP)
       {
             toAppList = false; // flag was not open from app list
-            _ui_screen_change(ui_weatherScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
+            _ui_screen_change(&ui_weatherScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
       }
       if (event_code == LV_EVENT_SCREEN_LOAD_START)
       {
@@ -613,7 +644,7 @@ void ui_event_clockScreen(lv_event_t *e)
       if (event_code == LV_EVENT_LONG_PRESSED)
       {
             // ui_home = ui_pcbScreen;
-            // _ui_screen_change(ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
+            // _ui_screen_change(&ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
             onWatchfaceChange(e);
       }
 }
@@ -624,7 +655,7 @@ void ui_event_appListScreen(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_home, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+            _ui_screen_change(&ui_home, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
       }
 }
 
@@ -634,7 +665,7 @@ void ui_event_gameListScreen(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+            _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
       }
 }
 
@@ -673,7 +704,7 @@ void ui_event_weatherScreen(lv_event_t *e)
                   }
                   else
                   {
-                        _ui_screen_change(ui_home, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0); // load home
+                        _ui_screen_change(&ui_home, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0); // load home
                   }
             }
       }
@@ -690,7 +721,7 @@ void ui_event_weatherScreen(lv_event_t *e)
             {
                   if (toAppList)
                   {
-                        _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+                        _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
                         return;
                   }
             }
@@ -733,7 +764,7 @@ void ui_event_notificationScreen(lv_event_t *e)
                   }
                   else
                   {
-                        _ui_screen_change(ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
+                        _ui_screen_change(&ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
                   }
             }
       }
@@ -743,7 +774,7 @@ void ui_event_notificationScreen(lv_event_t *e)
             {
                   if (!lv_obj_has_flag(ui_messageList, LV_OBJ_FLAG_HIDDEN))
                   {
-                        _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+                        _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
                         return;
                   }
             }
@@ -764,27 +795,88 @@ void ui_event_settingsScreen(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+            _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+      }
+}
+
+// the app info screen's memory panel: totals and the largest owners of the LVGL heap
+#define HEAP_INFO_OWNERS 4
+
+static const heap_tag_stats_t *heapTop[HEAP_INFO_OWNERS];
+
+static void heapTop_cb(const heap_tag_stats_t *stats)
+{
+      // insertion into the largest owners by live bytes
+      for (int i = 0; i < HEAP_INFO_OWNERS; i++)
+      {
+            if (heapTop[i] == NULL || stats->live > heapTop[i]->live)
+            {
+                  for (int j = HEAP_INFO_OWNERS - 1; j > i; j--)
+                  {
+                        heapTop[j] = heapTop[j - 1];
+                  }
+                  heapTop[i] = stats;
+                  return;
+            }
+      }
+}
+
+void ui_update_heap_info(void)
+{
+      heap_totals_t totals;
+      heap_tags_totals(&totals);
+
+      memset(heapTop, 0, sizeof(heapTop));
+      heap_tags_iterate(heapTop_cb);
+
+      char text[320];
+      int len = lv_snprintf(text, sizeof(text), "Memory - %u KB, peak %u KB", (unsigned)(totals.live / 1024), (unsigned)(totals.peak / 1024));
+      if (totals.largest_free > 0 && len < (int)sizeof(text))
+      {
+            len += lv_snprintf(text + len, sizeof(text) - len, "\nLargest free %u KB, frag %u%%", (unsigned)(totals.largest_free / 1024), totals.frag_pct);
       }
+      for (int i = 0; i < HEAP_INFO_OWNERS && heapTop[i] != NULL && len < (int)sizeof(text); i++)
+      {
+            const heap_tag_stats_t *owner = heapTop[i];
+            len += lv_snprintf(text + len, sizeof(text) - len, "\n%s %u.%u KB, peak %u.%u KB, %u allocs", owner->name,
+                               (unsigned)(owner->live / 1024), (unsigned)(owner->live % 1024 * 10 / 1024),
+                               (unsigned)(owner->peak / 1024), (unsigned)(owner->peak % 1024 * 10 / 1024), (unsigned)owner->allocs);
+      }
+      lv_label_set_text(ui_appMemoryText, text);
 }
 
 void ui_event_appInfoScreen(lv_event_t *e)
 {
       lv_event_code_t event_code = lv_event_get_code(e);
       lv_obj_t *target = lv_event_get_target(e);
+      if (event_code == LV_EVENT_SCREEN_LOAD_START && target == ui_appInfoScreen)
+      {
+            ui_update_heap_info();
+      }
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+            _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
       }
 }
 
+void ui_event_filesScreen(lv_event_t *e)
+{
+      lv_event_code_t event_code = lv_event_get_code(e);
+      lv_obj_t *target = lv_event_get_target(e);
+      if (event_code == LV_EVENT_SCREEN_LOAD_START && target == ui_filesScreen)
+      {
+            onFilesLoad(e);
+      }
+      ui_event_appInfoScreen(e);
+}
+
 void ui_event_callScreen(lv_event_t *e)
 {
       lv_event_code_t event_code = lv_event_get_code(e);
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_home, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
+            _ui_screen_change(&ui_home, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
       }
 }
 
@@ -796,11 +888,11 @@ void ui_event_qrScreen(lv_event_t *e)
       {
             if (toAppList)
             {
-                  _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
+                  _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
             }
             else
             {
-                  _ui_screen_change(ui_controlScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
+                  _ui_screen_change(&ui_controlScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
             }
       }
 }
@@ -819,7 +911,7 @@ void ui_event_logoScreen(lv_event_t *e)
 
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_settingsScreen, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
+            _ui_screen_change(&ui_settingsScreen, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
             return;
       }
       if (event_code == LV_EVENT_SCREEN_LOADED)
@@ -869,7 +961,7 @@ void ui_event_connectScreen(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_settingsScreen, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
+            _ui_screen_change(&ui_settingsScreen, LV_SCR_LOAD_ANIM_FADE_OUT, 500, 0);
       }
 }
 
@@ -885,10 +977,32 @@ void ui_event_brightnessSlider(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_VALUE_CHANGED)
       {
+            settingsBrightness = lv_slider_get_value(target);
             onBrightnessChange(e);
       }
 }
 
+// scroll the lists by a pixel so onScroll lays them out for the scroll mode, lists of
+// screens that have not been created yet are laid out once they are
+static void ui_nudge_list(lv_obj_t *list, lv_anim_enable_t anim)
+{
+      if (list != NULL)
+      {
+            lv_obj_scroll_by(list, 0, circular ? 1 : -1, anim);
+      }
+}
+
+static void ui_nudge_lists(void)
+{
+      ui_nudge_list(ui_settingsList, LV_ANIM_ON);
+      ui_nudge_list(ui_appList, LV_ANIM_OFF);
+      ui_nudge_list(ui_messageList, LV_ANIM_OFF);
+      ui_nudge_list(ui_forecastList, LV_ANIM_OFF);
+      ui_nudge_list(ui_appInfoPanel, LV_ANIM_OFF);
+      ui_nudge_list(ui_gameList, LV_ANIM_OFF);
+      ui_nudge_list(ui_fileManagerPanel, LV_ANIM_OFF);
+}
+
 void ui_event_scrollMode(lv_event_t *e)
 {
       lv_disp_t *display = lv_display_get_default();
@@ -903,13 +1017,7 @@ void ui_event_scrollMode(lv_event_t *e)
       {
 
             circular = lv_obj_has_state(target, LV_STATE_CHECKED);
-            lv_obj_scroll_by(ui_settingsList, 0, circular ? 1 : -1, LV_ANIM_ON);
-            lv_obj_scroll_by(ui_appList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-            lv_obj_scroll_by(ui_messageList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-            lv_obj_scroll_by(ui_forecastList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-            lv_obj_scroll_by(ui_appInfoPanel, 0, circular ? 1 : -1, LV_ANIM_OFF);
-            lv_obj_scroll_by(ui_gameList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-            lv_obj_scroll_by(ui_fileManagerPanel, 0, circular ? 1 : -1, LV_ANIM_OFF);
+            ui_nudge_lists();
             onScrollMode(e);
       }
 }
@@ -957,7 +1065,7 @@ void ui_event_alertStatePanel(lv_event_t *e)
       lv_event_code_t event_code = lv_event_get_code(e);
       if (event_code == LV_EVENT_CLICKED)
       {
-            _ui_screen_change(ui_alertScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_alertScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
       }
 }
 
@@ -974,7 +1082,7 @@ void ui_event_alertScreen(lv_event_t *e)
 
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_settingsScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+            _ui_screen_change(&ui_settingsScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
             return;
       }
 }
@@ -991,6 +1099,7 @@ void ui_event_navStateSwitch(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_VALUE_CHANGED)
       {
+            settingsNavigation = lv_obj_has_state(target, LV_STATE_CHECKED);
             onNavState(e);
       }
 }
@@ -1007,6 +1116,7 @@ void ui_event_timeoutSelect(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_VALUE_CHANGED)
       {
+            settingsTimeout = lv_dropdown_get_selected(target);
             onTimeoutChange(e);
       }
 }
@@ -1023,6 +1133,7 @@ void ui_event_rotateSelect(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_VALUE_CHANGED)
       {
+            settingsRotation = lv_dropdown_get_selected(target);
             onRotateChange(e);
       }
 }
@@ -1076,7 +1187,7 @@ void ui_event_kenyaPanel(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_CLICKED)
       {
-            _ui_screen_change(ui_logoScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
+            _ui_screen_change(&ui_logoScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
       }
 }
 
@@ -1093,7 +1204,7 @@ void ui_event_aboutPanel(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_CLICKED)
       {
-            _ui_screen_change(ui_connectScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
+            _ui_screen_change(&ui_connectScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
       }
 }
 
@@ -1104,14 +1215,17 @@ void ui_event_controlScreen(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_TOP)
       {
-            _ui_screen_change(ui_home, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
+            _ui_screen_change(&ui_home, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
             _ui_state_modify(ui_phoneSearchButton, LV_STATE_CHECKED, _UI_MODIFY_STATE_ADD);
 
             onEndSearch(e);
       }
       if (event_code == LV_EVENT_SCREEN_UNLOAD_START)
       {
-            _ui_state_modify(ui_findButtonText, LV_STATE_CHECKED, _UI_MODIFY_STATE_REMOVE);
+            if (ui_findButtonText != NULL)
+            {
+                  _ui_state_modify(ui_findButtonText, LV_STATE_CHECKED, _UI_MODIFY_STATE_REMOVE);
+            }
             _ui_flag_modify(ui_searchPanel, LV_OBJ_FLAG_HIDDEN, _UI_MODIFY_FLAG_ADD);
       }
 }
@@ -1210,7 +1324,7 @@ void ui_event_findPhone(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
-            _ui_screen_change(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
+            _ui_screen_change(&ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
       }
 
       if (event_code == LV_EVENT_SCREEN_UNLOAD_START)
@@ -1268,7 +1382,7 @@ void ui_event_qrCodeButton(lv_event_t *e)
             toAppList = false;
             _ui_state_modify(ui_phoneSearchButton, LV_STATE_CHECKED, _UI_MODIFY_STATE_ADD);
             onEndSearch(e);
-            lv_screen_load_anim(ui_qrScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0, false);
+            _ui_screen_change(&ui_qrScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0);
       }
 }
 
@@ -1284,7 +1398,7 @@ void ui_event_closeControlButton(lv_event_t *e)
       lv_obj_t *target = lv_event_get_target(e);
       if (event_code == LV_EVENT_CLICKED)
       {
-            _ui_screen_change(ui_home, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
+            _ui_screen_change(&ui_home, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
             _ui_state_modify(ui_phoneSearchButton, LV_STATE_CHECKED, _UI_MODIFY_STATE_ADD);
 
             onEndSearch(e);
@@ -1327,7 +1441,7 @@ void ui_event_faceSelected(lv_event_t *e)
                   }
             }
 
-            lv_screen_load_anim(ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, false);
+            ui_transition_load(ui_home, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
 
             onFaceSelected(e);
       }
@@ -1373,26 +1487,27 @@ void onAppListClicked(lv_event_t *e)
       {
       case 0:
             toAppList = true; // flag was open from app list
-            _ui_screen_change(ui_notificationScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_notificationScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
             break;
       case 1:
             toAppList = true; // flag was open from app list
-            _ui_screen_change(ui_weatherScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_weatherScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
             break;
       case 2:
-            _ui_screen_change(ui_settingsScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_settingsScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
             break;
       case 3:
-            _ui_screen_change(ui_appInfoScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_appInfoScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
             break;
       case 4:
             toAppList = true; // flag was open from app list
-            _ui_screen_change(ui_qrScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0);
+            _ui_screen_change(&ui_qrScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0);
             break;
       case 5:
 #ifdef USE_SDL
-            _ui_screen_change(ui_faceSelect, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
+            _ui_screen_change(&ui_faceSelect, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
 #else
+            ui_screen_get(&ui_filesScreen);
             lv_obj_clean(ui_fileManagerPanel);
 
             addSelectItem(ui_fileManagerPanel);
@@ -1404,66 +1519,131 @@ void onAppListClicked(lv_event_t *e)
 
             lv_obj_scroll_by(ui_fileManagerPanel, 0, -1, LV_ANIM_ON);
 
-            _ui_screen_change(ui_filesScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_filesScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
 #endif
             break;
       case 6:
-            _ui_screen_change(ui_findPhoneScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_findPhoneScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
             break;
       case 7:
-            _ui_screen_change(ui_gameListScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_gameListScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
             break;
       case 8:
-            _ui_screen_change(ui_filesScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
+            _ui_screen_change(&ui_filesScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
             break;
       }
 }
 
+#define SCROLL_LUT_SLOTS 4 // list heights with a cached circle table
+
+// offset of a row from the list edge by its distance to the list center, per list height
+static int16_t *scrollOffsets(lv_coord_t height, lv_coord_t r)
+{
+      static struct
+      {
+            lv_coord_t height;
+            int16_t *offsets;
+      } tables[SCROLL_LUT_SLOTS];
+      static uint32_t next;
+
+      for (uint32_t i = 0; i < SCROLL_LUT_SLOTS; i++)
+      {
+            if (tables[i].offsets != NULL && tables[i].height == height)
+            {
+                  return tables[i].offsets;
+            }
+      }
+
+      int16_t *offsets = lv_malloc((r + 1) * sizeof(int16_t));
+      if (offsets == NULL)
+      {
+            return NULL;
+      }
+      for (lv_coord_t y = 0; y <= r; y++)
+      {
+            /*Use Pythagoras theorem to get x from radius and y*/
+            lv_sqrt_res_t res;
+            lv_sqrt((uint32_t)(r * r - y * y), &res, 0x8000); /*Use lvgl's built in sqrt root function*/
+            offsets[y] = r - res.i;
+      }
+
+      uint32_t slot = next++ % SCROLL_LUT_SLOTS;
+      lv_free(tables[slot].offsets);
+      tables[slot].height = height;
+      tables[slot].offsets = offsets;
+      return offsets;
+}
+
 void onScroll(lv_event_t *e)
 {
+      PROFILER_BEGIN;
       lv_obj_t *list = lv_event_get_target(e);
 
       lv_area_t list_a;
       lv_obj_get_coords(list, &list_a);
       lv_coord_t list_y_center = list_a.y1 + lv_area_get_height(&list_a) / 2;
 
-      lv_coord_t r = lv_obj_get_height(list) * 7 / 10;
+      lv_coord_t height = lv_obj_get_height(list);
+      lv_coord_t r = height * 7 / 10;
+      int16_t *offsets = circular ? scrollOffsets(height, r) : NULL;
       uint32_t i;
       uint32_t child_cnt = lv_obj_get_child_count(list);
       for (i = 0; i < child_cnt; i++)
       {
             lv_obj_t *child = lv_obj_get_child(list, i);
+            if (lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN))
+            {
+                  continue;
+            }
             lv_area_t child_a;
             lv_obj_get_coords(child, &child_a);
 
-            lv_coord_t child_y_center = child_a.y1 + lv_area_get_height(&child_a) / 2;
-
-            lv_coord_t diff_y = child_y_center - list_y_center;
-            diff_y = LV_ABS(diff_y);
-
-            /*Get the x of diff_y on a circle.*/
-            lv_coord_t x;
-            /*If diff_y is out of the circle use the last point of the circle (the radius)*/
-            if (diff_y >= r)
+            /*Rows outside the list are not drawn, they are placed once they scroll in*/
+            if (child_a.y2 < list_a.y1)
             {
-                  x = r;
+                  continue;
             }
-            else
+            if (child_a.y1 > list_a.y2)
+            {
+                  break;
+            }
+
+            lv_coord_t x = 0;
+            if (circular)
             {
-                  /*Use Pythagoras theorem to get x from radius and y*/
-                  uint32_t x_sqr = r * r - diff_y * diff_y;
-                  lv_sqrt_res_t res;
-                  lv_sqrt(x_sqr, &res, 0x8000); /*Use lvgl's built in sqrt root function*/
-                  x = r - res.i;
+                  lv_coord_t child_y_center = child_a.y1 + lv_area_get_height(&child_a) / 2;
+
+                  lv_coord_t diff_y = child_y_center - list_y_center;
+                  diff_y = LV_ABS(diff_y);
+
+                  /*If diff_y is out of the circle use the last point of the circle (the radius)*/
+                  if (diff_y >= r)
+                  {
+                        x = r;
+                  }
+                  else if (offsets != NULL)
+                  {
+                        x = offsets[diff_y];
+                  }
+                  else
+                  {
+                        lv_sqrt_res_t res;
+                        lv_sqrt((uint32_t)(r * r - diff_y * diff_y), &res, 0x8000);
+                        x = r - res.i;
+                  }
             }
 
-            /*Translate the item by the calculated X coordinate*/
-            lv_obj_set_style_translate_x(child, circular ? x : 0, 0);
+            /*Translate the item by the calculated X coordinate, unchanged values would only invalidate the row*/
+            if (lv_obj_get_style_translate_x(child, LV_PART_MAIN) != x)
+            {
+                  lv_obj_set_style_translate_x(child, x, 0);
+            }
 
             /*Use some opacity with larger translations*/
             // lv_opa_t opa = lv_map(x, 0, r, LV_OPA_TRANSP, LV_OPA_COVER);
             // lv_obj_set_style_opa(child, LV_OPA_COVER - opa, 0);
       }
+      PROFILER_END;
 }
 
 void watchfaceEvents(lv_event_t *e)
@@ -1473,20 +1653,20 @@ void watchfaceEvents(lv_event_t *e)
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_RIGHT)
       {
             toAppList = false; // flag was not open from app list
-            lv_screen_load_anim(ui_notificationScreen, LV_SCR_LOAD_ANIM_OVER_RIGHT, 500, 0, false);
+            ui_transition_load(ui_notificationScreen, LV_SCR_LOAD_ANIM_OVER_RIGHT, 500, 0);
       }
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_LEFT)
       {
-            lv_screen_load_anim(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0, false);
+            ui_transition_load(ui_appListScreen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
       }
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_BOTTOM)
       {
-            lv_screen_load_anim(ui_controlScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0, false);
+            _ui_screen_change(&ui_controlScreen, LV_SCR_LOAD_ANIM_MOVE_BOTTOM, 500, 0);
       }
       if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_active()) == LV_DIR_TOP)
       {
             toAppList = false; // flag was not open from app list
-            lv_screen_load_anim(ui_weatherScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0, false);
+            _ui_screen_change(&ui_weatherScreen, LV_SCR_LOAD_ANIM_MOVE_TOP, 500, 0);
       }
       if (event_code == LV_EVENT_LONG_PRESSED_REPEAT)
       {
@@ -1497,7 +1677,7 @@ void watchfaceEvents(lv_event_t *e)
                   return;
             }
             // ui_home = ui_clockScreen;
-            lv_screen_load_anim(ui_faceSelect, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, false);
+            ui_transition_load(ui_faceSelect, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
             on_watchface_list_open();
       }
 }
@@ -1564,19 +1744,19 @@ void ui_event_gameSelected(lv_event_t *e)
                   showError("Game Error", "Game root object not initialized");
                   return;
             }
-            lv_screen_load_anim(*games[index].watchface, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0, false);
+            ui_transition_load(*games[index].watchface, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
       }
 }
 
 void ui_gameExit()
 {
-      lv_screen_load_anim(ui_gameListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0, false);
+      ui_transition_load(ui_gameListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
 }
 
 void ui_app_exit()
 {
 
-      lv_screen_load_anim(ui_gameListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0, false);
+      ui_transition_load(ui_gameListScreen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 500, 0);
 }
 
 void ui_app_load(lv_obj_t **screen, void (*screen_init)(void))
@@ -1591,7 +1771,7 @@ void ui_app_load(lv_obj_t **screen, void (*screen_init)(void))
       if (*screen == NULL)
             screen_init();
 
-      lv_screen_load_anim(*screen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0, false);
+      ui_transition_load(*screen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0);
 }
 
 void ui_event_errorClose(lv_event_t *e)
@@ -1612,7 +1792,7 @@ void ui_event_face_select(lv_event_t *e)
       {
             return;
       }
-      lv_screen_load_anim(ui_faceSelect, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, false);
+      ui_transition_load(ui_faceSelect, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0);
 }
 
 void set_alert_states(int32_t states)
@@ -1625,6 +1805,110 @@ void set_alert_states(int32_t states)
       _ui_state_modify(ui_vibrateAlert, LV_STATE_CHECKED, check_bit(states, 0x08) ? _UI_MODIFY_FLAG_ADD : _UI_MODIFY_FLAG_REMOVE);
 }
 
+void ui_settings_set_brightness(int32_t level)
+{
+      settingsBrightness = level;
+      if (ui_brightnessSlider != NULL)
+      {
+            lv_slider_set_value(ui_brightnessSlider, level, LV_ANIM_OFF);
+      }
+}
+
+int32_t ui_settings_get_brightness(void)
+{
+      return settingsBrightness;
+}
+
+void ui_settings_set_timeout(int32_t index)
+{
+      settingsTimeout = index;
+      if (ui_timeoutSelect != NULL)
+      {
+            lv_dropdown_set_selected(ui_timeoutSelect, index, LV_ANIM_OFF);
+      }
+}
+
+void ui_settings_set_rotation(int32_t index)
+{
+      settingsRotation = index;
+      if (ui_rotateSelect != NULL)
+      {
+            lv_dropdown_set_selected(ui_rotateSelect, index, LV_ANIM_OFF);
+      }
+}
+
+void ui_settings_set_navigation(bool on)
+{
+      settingsNavigation = on;
+#ifdef ENABLE_APP_NAVIGATION
+      if (ui_navStateSwitch != NULL)
+      {
+            _ui_state_modify(ui_navStateSwitch, LV_STATE_CHECKED, on ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+      }
+#endif
+}
+
+void ui_settings_set_about(const char *text)
+{
+      lv_snprintf(settingsAbout, sizeof(settingsAbout), "%s", text);
+      if (ui_aboutText != NULL)
+      {
+            lv_label_set_text(ui_aboutText, settingsAbout);
+      }
+}
+
+void ui_set_connected(bool state)
+{
+      phoneConnected = state;
+      if (ui_btStateButton != NULL)
+      {
+            _ui_state_modify(ui_btStateButton, LV_STATE_CHECKED, state ? _UI_MODIFY_STATE_REMOVE : _UI_MODIFY_STATE_ADD);
+      }
+      if (ui_appConnectionText != NULL)
+      {
+            lv_label_set_text_fmt(ui_appConnectionText, "Status\n%s", state ? "Connected" : "Disconnected");
+      }
+}
+
+void ui_set_app_version(const char *version, int code)
+{
+      lv_snprintf(appVersion, sizeof(appVersion), "Chronos app\nv%s (%d)", version, code);
+      if (ui_appDetailsText != NULL)
+      {
+            lv_label_set_text(ui_appDetailsText, appVersion);
+      }
+}
+
+void ui_set_qr_link(uint8_t id, const char *link)
+{
+      if (id >= QR_LINKS)
+      {
+            return;
+      }
+      lv_free(qrLinks[id]);
+      qrLinks[id] = lv_strdup(link);
+}
+
+static void ui_add_qr_links(void)
+{
+      for (int i = 0; i < QR_LINKS; i++)
+      {
+            addQrList(i, qrLinks[i] != NULL ? qrLinks[i] : qrDefaults[i]);
+      }
+}
+
+void ui_update_qr_links(void)
+{
+#if LV_USE_QRCODE == 1
+      // otherwise the links are shown when the screen is next created
+      if (ui_qrScreen != NULL)
+      {
+            lv_obj_clean(ui_qrPanel);
+            ui_add_qr_links();
+      }
+#endif
+}
+
 ///////////////////// HELPERS ////////////////////
 
 const char *get_alert_state_text(int32_t states)
@@ -1764,22 +2048,8 @@ void setNotificationIcon(lv_obj_t *obj, int appId)
 
 void add_appList(const char *appName, int index, const void *img)
 {
-      lv_obj_t *ui_appListPanel = lv_obj_create(ui_appList);
-      lv_obj_set_width(ui_appListPanel, 200);
-      lv_obj_set_height(ui_appListPanel, 64);
-      lv_obj_set_align(ui_appListPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_appListPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_appListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_appListPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_appListPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_appListPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_appListPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_appListPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_appListPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_left(ui_appListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_right(ui_appListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_top(ui_appListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_bottom(ui_appListPanel, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_t *ui_appListPanel = ui_theme_row_create(ui_appList, 200, 64, true);
+      lv_obj_add_style(ui_appListPanel, &ui_style_pad_menu, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *ui_appListIcon = lv_image_create(ui_appListPanel);
       lv_image_set_src(ui_appListIcon, img);
@@ -1800,29 +2070,15 @@ void add_appList(const char *appName, int index, const void *img)
       lv_obj_set_align(ui_appListLabel, LV_ALIGN_LEFT_MID);
       lv_label_set_text(ui_appListLabel, appName);
       lv_label_set_long_mode(ui_appListLabel, LV_LABEL_LONG_CLIP);
-      lv_obj_set_style_text_font(ui_appListLabel, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_appListLabel, &ui_style_title, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_appListPanel, onAppListClicked, LV_EVENT_CLICKED, (void *)index);
 }
 
 void add_gameList(const char *appName, int index, const void *img)
 {
-      lv_obj_t *ui_gameListPanel = lv_obj_create(ui_gameList);
-      lv_obj_set_width(ui_gameListPanel, 200);
-      lv_obj_set_height(ui_gameListPanel, 64);
-      lv_obj_set_align(ui_gameListPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_gameListPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_gameListPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_gameListPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_gameListPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_gameListPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_gameListPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_gameListPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_left(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_right(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_top(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_bottom(ui_gameListPanel, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_t *ui_gameListPanel = ui_theme_row_create(ui_gameList, 200, 64, true);
+      lv_obj_add_style(ui_gameListPanel, &ui_style_pad_menu, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *ui_gameListIcon = lv_image_create(ui_gameListPanel);
       lv_image_set_src(ui_gameListIcon, img);
@@ -1843,29 +2099,15 @@ void add_gameList(const char *appName, int index, const void *img)
       lv_obj_set_align(ui_gameListLabel, LV_ALIGN_LEFT_MID);
       lv_label_set_text(ui_gameListLabel, appName);
       lv_label_set_long_mode(ui_gameListLabel, LV_LABEL_LONG_CLIP);
-      lv_obj_set_style_text_font(ui_gameListLabel, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_gameListLabel, &ui_style_title, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_gameListPanel, ui_event_gameSelected, LV_EVENT_CLICKED, (void *)index);
 }
 
 void add_app_list(const char *appName, const void *icon, void (*callback)(lv_event_t *e))
 {
-      lv_obj_t *ui_gameListPanel = lv_obj_create(ui_gameList);
-      lv_obj_set_width(ui_gameListPanel, 200);
-      lv_obj_set_height(ui_gameListPanel, 64);
-      lv_obj_set_align(ui_gameListPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_gameListPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_gameListPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_gameListPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_gameListPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_gameListPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_gameListPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_gameListPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_left(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_right(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_top(ui_gameListPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_bottom(ui_gameListPanel, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_t *ui_gameListPanel = ui_theme_row_create(ui_gameList, 200, 64, true);
+      lv_obj_add_style(ui_gameListPanel, &ui_style_pad_menu, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *ui_gameListIcon = lv_image_create(ui_gameListPanel);
       lv_image_set_src(ui_gameListIcon, icon);
@@ -1886,7 +2128,7 @@ void add_app_list(const char *appName, const void *icon, void (*callback)(lv_eve
       lv_obj_set_align(ui_gameListLabel, LV_ALIGN_LEFT_MID);
       lv_label_set_text(ui_gameListLabel, appName);
       lv_label_set_long_mode(ui_gameListLabel, LV_LABEL_LONG_CLIP);
-      lv_obj_set_style_text_font(ui_gameListLabel, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_gameListLabel, &ui_style_title, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_gameListPanel, callback, LV_EVENT_CLICKED, NULL);
 }
@@ -1947,25 +2189,14 @@ void addWatchface(const char *name, const lv_image_dsc_t *src, int index)
       lv_label_set_long_mode(ui_faceLabel, LV_LABEL_LONG_DOT);
       lv_label_set_text(ui_faceLabel, name);
       lv_obj_set_style_text_align(ui_faceLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_text_font(ui_faceLabel, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_faceLabel, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_faceItem, ui_event_faceSelected, LV_EVENT_ALL, (void *)index);
 }
 
 void addSelectItem(lv_obj_t *parent)
 {
-      lv_obj_t *ui_faceSelectItem = lv_obj_create(parent);
-      lv_obj_set_width(ui_faceSelectItem, 240);
-      lv_obj_set_height(ui_faceSelectItem, 50);
-      lv_obj_set_align(ui_faceSelectItem, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_faceSelectItem, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_faceSelectItem, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_faceSelectItem, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_faceSelectItem, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_faceSelectItem, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_faceSelectItem, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_faceSelectItem, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_faceSelectItem, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_t *ui_faceSelectItem = ui_theme_row_create(parent, 240, 50, false);
 
       lv_obj_t *ui_faceItemIcon = lv_image_create(ui_faceSelectItem);
       lv_image_set_src(ui_faceItemIcon, &ui_img_clock_png);
@@ -1988,29 +2219,15 @@ void addSelectItem(lv_obj_t *parent)
       lv_label_set_long_mode(ui_faceItemName, LV_LABEL_LONG_CLIP);
       lv_label_set_text(ui_faceItemName, "Change Current");
 
-      lv_obj_set_style_text_font(ui_faceItemName, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_faceItemName, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_faceSelectItem, ui_event_face_select, LV_EVENT_CLICKED, NULL);
 }
 
 void addForecast(int day, int temp, int icon)
 {
-      lv_obj_t *forecastItem = lv_obj_create(ui_forecastList);
-      lv_obj_set_width(forecastItem, 200);
-      lv_obj_set_height(forecastItem, 40);
-      lv_obj_set_align(forecastItem, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(forecastItem, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(forecastItem, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(forecastItem, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(forecastItem, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(forecastItem, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(forecastItem, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(forecastItem, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(forecastItem, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_left(forecastItem, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_right(forecastItem, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_top(forecastItem, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_bottom(forecastItem, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_t *forecastItem = ui_theme_row_create(ui_forecastList, 200, 40, false);
+      lv_obj_add_style(forecastItem, &ui_style_pad_forecast, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *forecastIcon = lv_image_create(forecastItem);
       lv_obj_set_width(forecastIcon, LV_SIZE_CONTENT);  /// 40
@@ -2029,7 +2246,7 @@ void addForecast(int day, int temp, int icon)
       lv_obj_set_align(forecastTemp, LV_ALIGN_CENTER);
       lv_label_set_long_mode(forecastTemp, LV_LABEL_LONG_CLIP);
       lv_label_set_text_fmt(forecastTemp, "%d°C", temp);
-      lv_obj_set_style_text_font(forecastTemp, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(forecastTemp, &ui_style_title, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *forecastDay = lv_label_create(forecastItem);
       lv_obj_set_width(forecastDay, 68);
@@ -2039,7 +2256,7 @@ void addForecast(int day, int temp, int icon)
       lv_obj_set_align(forecastDay, LV_ALIGN_CENTER);
       lv_label_set_long_mode(forecastDay, LV_LABEL_LONG_CLIP);
       lv_label_set_text(forecastDay, days[day % 7]);
-      lv_obj_set_style_text_font(forecastDay, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(forecastDay, &ui_style_title, LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
 void addHourlyWeather(int hour, int icon, int temp, int humidity, int wind, int uv, bool info)
@@ -2063,7 +2280,7 @@ void addHourlyWeather(int hour, int icon, int temp, int humidity, int wind, int
       lv_obj_set_align(ui_hourlyTime, LV_ALIGN_CENTER);
       lv_label_set_text_fmt(ui_hourlyTime, info ? "Hour" : "%02d:00", hour);
       lv_obj_set_style_text_align(ui_hourlyTime, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_text_font(ui_hourlyTime, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_hourlyTime, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
       lv_obj_set_style_border_color(ui_hourlyTime, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
       lv_obj_set_style_border_opa(ui_hourlyTime, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
       lv_obj_set_style_border_width(ui_hourlyTime, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -2083,50 +2300,42 @@ void addHourlyWeather(int hour, int icon, int temp, int humidity, int wind, int
       lv_obj_set_height(ui_hourlyTemp, LV_SIZE_CONTENT); /// 1
       lv_obj_set_align(ui_hourlyTemp, LV_ALIGN_CENTER);
       lv_label_set_text_fmt(ui_hourlyTemp, info ? "Temperature" : "%d°C", temp);
-      lv_obj_set_style_text_font(ui_hourlyTemp, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_hourlyTemp, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *ui_hourlyHumidity = lv_label_create(ui_hourlyPanel);
       lv_obj_set_width(ui_hourlyHumidity, LV_SIZE_CONTENT);  /// 1
       lv_obj_set_height(ui_hourlyHumidity, LV_SIZE_CONTENT); /// 1
       lv_obj_set_align(ui_hourlyHumidity, LV_ALIGN_CENTER);
       lv_label_set_text_fmt(ui_hourlyHumidity, info ? "Humidity" : "%d%%", humidity);
-      lv_obj_set_style_text_font(ui_hourlyHumidity, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_hourlyHumidity, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *ui_hourlyWind = lv_label_create(ui_hourlyPanel);
       lv_obj_set_width(ui_hourlyWind, LV_SIZE_CONTENT);  /// 1
       lv_obj_set_height(ui_hourlyWind, LV_SIZE_CONTENT); /// 1
       lv_obj_set_align(ui_hourlyWind, LV_ALIGN_CENTER);
       lv_label_set_text_fmt(ui_hourlyWind, info ? "Wind Speed" : "%d km/h", wind);
-      lv_obj_set_style_text_font(ui_hourlyWind, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_hourlyWind, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *ui_hourlyUV = lv_label_create(ui_hourlyPanel);
       lv_obj_set_width(ui_hourlyUV, LV_SIZE_CONTENT);  /// 1
       lv_obj_set_height(ui_hourlyUV, LV_SIZE_CONTENT); /// 1
       lv_obj_set_align(ui_hourlyUV, LV_ALIGN_CENTER);
       lv_label_set_text_fmt(ui_hourlyUV, info ? "UV" : "%d", uv);
-      lv_obj_set_style_text_font(ui_hourlyUV, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_hourlyUV, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
-void addNotificationList(int appId, const char *message, int index)
+#define NOTIFICATION_ROW_HEIGHT 60
+#define FILE_ROW_HEIGHT 50
+
+static ui_vlist_t notificationVList;
+static ui_vlist_t fileVList;
+
+static lv_obj_t *createNotificationRow(lv_obj_t *parent)
 {
-      lv_obj_t *notificationItem = lv_obj_create(ui_messageList);
-      lv_obj_set_width(notificationItem, 200);
-      lv_obj_set_height(notificationItem, LV_SIZE_CONTENT); /// 50
-      lv_obj_set_align(notificationItem, LV_ALIGN_CENTER);
+      lv_obj_t *notificationItem = ui_theme_row_create(parent, 200, LV_SIZE_CONTENT, true); /// 50
       lv_obj_set_flex_flow(notificationItem, LV_FLEX_FLOW_ROW);
       lv_obj_set_flex_align(notificationItem, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_START);
-      lv_obj_remove_flag(notificationItem, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(notificationItem, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(notificationItem, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(notificationItem, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(notificationItem, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(notificationItem, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(notificationItem, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(notificationItem, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_left(notificationItem, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_right(notificationItem, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_top(notificationItem, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_bottom(notificationItem, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(notificationItem, &ui_style_pad_item, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *notificationIcon = lv_image_create(notificationItem);
 
@@ -2135,16 +2344,54 @@ void addNotificationList(int appId, const char *message, int index)
       lv_obj_set_align(notificationIcon, LV_ALIGN_CENTER);
       lv_obj_add_flag(notificationIcon, LV_OBJ_FLAG_ADV_HITTEST);   /// Flags
       lv_obj_remove_flag(notificationIcon, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      setNotificationIcon(notificationIcon, appId);
 
       lv_obj_t *notificationText = lv_label_create(notificationItem);
       lv_obj_set_width(notificationText, 140);
       lv_obj_set_height(notificationText, LV_SIZE_CONTENT); /// 1
       lv_obj_set_align(notificationText, LV_ALIGN_CENTER);
       lv_label_set_long_mode(notificationText, LV_LABEL_LONG_DOT);
-      lv_label_set_text(notificationText, message);
 
-      lv_obj_add_event_cb(notificationItem, ui_event_messageClick, LV_EVENT_CLICKED, (void *)index);
+      lv_obj_add_event_cb(notificationItem, ui_event_messageClick, LV_EVENT_CLICKED, NULL);
+      return notificationItem;
+}
+
+// rows from the virtual lists are rebound, so their click index lives in the event user data
+static void setEventUserData(lv_obj_t *obj, lv_event_cb_t cb, void *user_data)
+{
+      uint32_t count = lv_obj_get_event_count(obj);
+      for (uint32_t i = 0; i < count; i++)
+      {
+            lv_event_dsc_t *dsc = lv_obj_get_event_dsc(obj, i);
+            if (lv_event_dsc_get_cb(dsc) == cb)
+            {
+                  dsc->user_data = user_data;
+            }
+      }
+}
+
+void bindNotificationList(lv_obj_t *row, int appId, const char *message, int index)
+{
+      setNotificationIcon(lv_obj_get_child(row, 0), appId);
+      lv_label_set_text(lv_obj_get_child(row, 1), message);
+      setEventUserData(row, ui_event_messageClick, (void *)index);
+}
+
+void addNotificationList(int appId, const char *message, int index)
+{
+      bindNotificationList(createNotificationRow(ui_messageList), appId, message, index);
+}
+
+static lv_obj_t *createNotificationListRow(lv_obj_t *parent)
+{
+      lv_obj_t *row = createNotificationRow(parent);
+      // fixed height rows, long messages end with dots
+      lv_obj_set_height(lv_obj_get_child(row, 1), NOTIFICATION_ROW_HEIGHT - 10);
+      return row;
+}
+
+void setNotificationList(int32_t count, ui_vlist_bind_cb_t bind)
+{
+      ui_vlist_set(&notificationVList, count, bind);
 }
 
 void addQrList(uint8_t id, const char *link)
@@ -2189,28 +2436,14 @@ void addQrList(uint8_t id, const char *link)
       lv_obj_set_height(ui_qrLabel, LV_SIZE_CONTENT); /// 1
       lv_obj_set_align(ui_qrLabel, LV_ALIGN_CENTER);
       lv_label_set_text(ui_qrLabel, qrNames[getQRIndex(id)]);
-      lv_obj_set_style_text_font(ui_qrLabel, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_qrLabel, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
 #endif
 }
 
 void addAppInfo(const void *src, const char *txt)
 {
-      lv_obj_t *ui_appDetailsPanel = lv_obj_create(ui_appInfoPanel);
-      lv_obj_set_width(ui_appDetailsPanel, 190);
-      lv_obj_set_height(ui_appDetailsPanel, 50);
-      lv_obj_set_align(ui_appDetailsPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_appDetailsPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_appDetailsPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_appDetailsPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_appDetailsPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_appDetailsPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_appDetailsPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_appDetailsPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_appDetailsPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_left(ui_appDetailsPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_right(ui_appDetailsPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_top(ui_appDetailsPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_pad_bottom(ui_appDetailsPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_t *ui_appDetailsPanel = ui_theme_row_create(ui_appInfoPanel, 190, 50, false);
+      lv_obj_add_style(ui_appDetailsPanel, &ui_style_pad_none, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_t *ui_appDetailsIcon = lv_image_create(ui_appDetailsPanel);
       lv_image_set_src(ui_appDetailsIcon, src);
@@ -2227,23 +2460,12 @@ void addAppInfo(const void *src, const char *txt)
       lv_obj_set_y(ui_appDetailsText, 8);
       lv_label_set_text(ui_appDetailsText, txt);
       // lv_label_set_recolor(ui_appDetailsText, true);
-      lv_obj_set_style_text_font(ui_appDetailsText, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_appDetailsText, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
 void addListDrive(const char *name, int total, int used, lv_event_cb_t event_cb)
 {
-      ui_driveInfoPanel = lv_obj_create(ui_fileManagerPanel);
-      lv_obj_set_width(ui_driveInfoPanel, 240);
-      lv_obj_set_height(ui_driveInfoPanel, 60);
-      lv_obj_set_align(ui_driveInfoPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_driveInfoPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_driveInfoPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_driveInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_driveInfoPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_driveInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_driveInfoPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_driveInfoPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_driveInfoPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
+      ui_driveInfoPanel = ui_theme_row_create(ui_fileManagerPanel, 240, 60, false);
       // lv_obj_set_style_bg_color(ui_driveInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_PRESSED);
       // lv_obj_set_style_bg_opa(ui_driveInfoPanel, 100, LV_PART_MAIN | LV_STATE_PRESSED);
 
@@ -2280,7 +2502,7 @@ void addListDrive(const char *name, int total, int used, lv_event_cb_t event_cb)
       {
             lv_label_set_text_fmt(ui_driveInfoLabel, "%s - %dB", name, total);
       }
-      lv_obj_set_style_text_font(ui_driveInfoLabel, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_driveInfoLabel, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       ui_driveInfoBar = lv_bar_create(ui_driveInfoPanel);
       if (total == 0)
@@ -2305,18 +2527,7 @@ void addListDrive(const char *name, int total, int used, lv_event_cb_t event_cb)
 void addListDir(const char *name)
 {
 
-      ui_folderInfoPanel = lv_obj_create(ui_fileManagerPanel);
-      lv_obj_set_width(ui_folderInfoPanel, 240);
-      lv_obj_set_height(ui_folderInfoPanel, 50);
-      lv_obj_set_align(ui_folderInfoPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_folderInfoPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_folderInfoPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_folderInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_folderInfoPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_folderInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_folderInfoPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_folderInfoPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_folderInfoPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
+      ui_folderInfoPanel = ui_theme_row_create(ui_fileManagerPanel, 240, 50, false);
       // lv_obj_set_style_bg_color(ui_folderInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_PRESSED);
       // lv_obj_set_style_bg_opa(ui_folderInfoPanel, 100, LV_PART_MAIN | LV_STATE_PRESSED);
 
@@ -2337,25 +2548,30 @@ void addListDir(const char *name)
       lv_obj_set_y(ui_folderInfoName, 0);
       lv_obj_set_align(ui_folderInfoName, LV_ALIGN_LEFT_MID);
       lv_label_set_text(ui_folderInfoName, name);
-      lv_obj_set_style_text_font(ui_folderInfoName, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_folderInfoName, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       // click to open
 }
 
+static void setFileSize(lv_obj_t *label, int size)
+{
+      if (size >= 1048576)
+      {
+            lv_label_set_text_fmt(label, "%dmb", (size / 1048576));
+      }
+      else if (size >= 1024)
+      {
+            lv_label_set_text_fmt(label, "%dkb", (size / 1024));
+      }
+      else
+      {
+            lv_label_set_text_fmt(label, "%db", size);
+      }
+}
+
 void addListFile(const char *name, int size)
 {
-      ui_fileInfoPanel = lv_obj_create(ui_fileManagerPanel);
-      lv_obj_set_width(ui_fileInfoPanel, 240);
-      lv_obj_set_height(ui_fileInfoPanel, 50);
-      lv_obj_set_align(ui_fileInfoPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_fileInfoPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_fileInfoPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_fileInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_fileInfoPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_fileInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_fileInfoPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_fileInfoPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_fileInfoPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
+      ui_fileInfoPanel = ui_theme_row_create(ui_fileManagerPanel, 240, 50, false);
       // lv_obj_set_style_bg_color(ui_fileInfoPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_PRESSED);
       // lv_obj_set_style_bg_opa(ui_fileInfoPanel, 100, LV_PART_MAIN | LV_STATE_PRESSED);
 
@@ -2376,7 +2592,7 @@ void addListFile(const char *name, int size)
       lv_obj_set_y(ui_fileInfoName, -7);
       lv_obj_set_align(ui_fileInfoName, LV_ALIGN_LEFT_MID);
       lv_label_set_text(ui_fileInfoName, name);
-      lv_obj_set_style_text_font(ui_fileInfoName, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_fileInfoName, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       ui_fileInfoSize = lv_label_create(ui_fileInfoPanel);
       lv_obj_set_width(ui_fileInfoSize, 150);
@@ -2384,37 +2600,15 @@ void addListFile(const char *name, int size)
       lv_obj_set_x(ui_fileInfoSize, 50);
       lv_obj_set_y(ui_fileInfoSize, 11);
       lv_obj_set_align(ui_fileInfoSize, LV_ALIGN_LEFT_MID);
-      if (size >= 1048576)
-      {
-            lv_label_set_text_fmt(ui_fileInfoSize, "%dmb", (size / 1048576));
-      }
-      else if (size >= 1024)
-      {
-            lv_label_set_text_fmt(ui_fileInfoSize, "%dkb", (size / 1024));
-      }
-      else
-      {
-            lv_label_set_text_fmt(ui_fileInfoSize, "%db", size);
-      }
+      setFileSize(ui_fileInfoSize, size);
       lv_obj_set_style_text_align(ui_fileInfoSize, LV_TEXT_ALIGN_RIGHT, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_text_font(ui_fileInfoSize, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_fileInfoSize, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
 }
 
 void addListBack(lv_event_cb_t event_cb)
 {
 
-      ui_driveBackPanel = lv_obj_create(ui_fileManagerPanel);
-      lv_obj_set_width(ui_driveBackPanel, 240);
-      lv_obj_set_height(ui_driveBackPanel, 50);
-      lv_obj_set_align(ui_driveBackPanel, LV_ALIGN_CENTER);
-      lv_obj_remove_flag(ui_driveBackPanel, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-      lv_obj_set_style_radius(ui_driveBackPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_color(ui_driveBackPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_bg_opa(ui_driveBackPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_color(ui_driveBackPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_opa(ui_driveBackPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_width(ui_driveBackPanel, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
-      lv_obj_set_style_border_side(ui_driveBackPanel, LV_BORDER_SIDE_BOTTOM, LV_PART_MAIN | LV_STATE_DEFAULT);
+      ui_driveBackPanel = ui_theme_row_create(ui_fileManagerPanel, 240, 50, false);
       // lv_obj_set_style_bg_color(ui_driveBackPanel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_PRESSED);
       // lv_obj_set_style_bg_opa(ui_driveBackPanel, 100, LV_PART_MAIN | LV_STATE_PRESSED);
 
@@ -2435,11 +2629,90 @@ void addListBack(lv_event_cb_t event_cb)
       lv_obj_set_y(ui_driveBackLabel, 0);
       lv_obj_set_align(ui_driveBackLabel, LV_ALIGN_LEFT_MID);
       lv_label_set_text(ui_driveBackLabel, "Back");
-      lv_obj_set_style_text_font(ui_driveBackLabel, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(ui_driveBackLabel, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_driveBackPanel, event_cb, LV_EVENT_CLICKED, NULL);
 }
 
+static void ui_event_fileRow(lv_event_t *e)
+{
+      lv_event_cb_t event_cb = (lv_event_cb_t)lv_event_get_user_data(e);
+      if (event_cb != NULL)
+      {
+            event_cb(e);
+      }
+}
+
+// one row layout for back, folder and file entries of the virtual file list
+static lv_obj_t *createFileRow(lv_obj_t *parent)
+{
+      lv_obj_t *row = ui_theme_row_create(parent, 240, FILE_ROW_HEIGHT, false);
+
+      lv_obj_t *icon = lv_image_create(row);
+      lv_obj_set_width(icon, LV_SIZE_CONTENT);  /// 1
+      lv_obj_set_height(icon, LV_SIZE_CONTENT); /// 1
+      lv_obj_set_x(icon, 10);
+      lv_obj_set_align(icon, LV_ALIGN_LEFT_MID);
+      lv_obj_add_flag(icon, LV_OBJ_FLAG_ADV_HITTEST);   /// Flags
+      lv_obj_remove_flag(icon, LV_OBJ_FLAG_SCROLLABLE); /// Flags
+
+      lv_obj_t *name = lv_label_create(row);
+      lv_obj_set_width(name, 150);
+      lv_obj_set_height(name, LV_SIZE_CONTENT); /// 1
+      lv_obj_set_x(name, 50);
+      lv_obj_set_align(name, LV_ALIGN_LEFT_MID);
+      lv_obj_add_style(name, &ui_style_text, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+      lv_obj_t *size = lv_label_create(row);
+      lv_obj_set_width(size, 150);
+      lv_obj_set_height(size, LV_SIZE_CONTENT); /// 1
+      lv_obj_set_x(size, 50);
+      lv_obj_set_y(size, 11);
+      lv_obj_set_align(size, LV_ALIGN_LEFT_MID);
+      lv_obj_set_style_text_align(size, LV_TEXT_ALIGN_RIGHT, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(size, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+      lv_obj_add_event_cb(row, ui_event_fileRow, LV_EVENT_CLICKED, NULL);
+      return row;
+}
+
+static void bindFileRow(lv_obj_t *row, const void *icon, const char *name, int size, lv_event_cb_t event_cb)
+{
+      lv_image_set_src(lv_obj_get_child(row, 0), icon);
+      lv_label_set_text(lv_obj_get_child(row, 1), name);
+      lv_obj_set_y(lv_obj_get_child(row, 1), size < 0 ? 0 : -7);
+      if (size < 0)
+      {
+            lv_obj_add_flag(lv_obj_get_child(row, 2), LV_OBJ_FLAG_HIDDEN);
+      }
+      else
+      {
+            setFileSize(lv_obj_get_child(row, 2), size);
+            lv_obj_remove_flag(lv_obj_get_child(row, 2), LV_OBJ_FLAG_HIDDEN);
+      }
+      setEventUserData(row, ui_event_fileRow, (void *)event_cb);
+}
+
+void bindListDir(lv_obj_t *row, const char *name)
+{
+      bindFileRow(row, &ui_img_directory_png, name, -1, NULL);
+}
+
+void bindListFile(lv_obj_t *row, const char *name, int size)
+{
+      bindFileRow(row, &ui_img_file_png, name, size, NULL);
+}
+
+void bindListBack(lv_obj_t *row, lv_event_cb_t event_cb)
+{
+      bindFileRow(row, &ui_img_back_file_png, "Back", -1, event_cb);
+}
+
+void setFileList(int32_t count, ui_vlist_bind_cb_t bind)
+{
+      ui_vlist_set(&fileVList, count, bind);
+}
+
 void registerWatchface_cb(const char *name, const lv_image_dsc_t *preview, lv_obj_t **watchface, lv_obj_t **seconds)
 {
       if (numFaces >= MAX_FACES)
@@ -2450,6 +2723,10 @@ void registerWatchface_cb(const char *name, const lv_image_dsc_t *preview, lv_ob
       faces[numFaces].preview = preview;
       faces[numFaces].watchface = watchface;
       faces[numFaces].seconds = seconds;
+      if (faceOwner != HEAP_TAG_SYSTEM)
+      {
+            heap_tag_bind_screen(*watchface, faceOwner);
+      }
       addWatchface(faces[numFaces].name, faces[numFaces].preview, numFaces);
       numFaces++;
 }
@@ -2743,6 +3020,17 @@ void ui_weatherScreen_screen_init(void)
       lv_obj_add_event_cb(ui_weatherScreen, ui_event_weatherScreen, LV_EVENT_ALL, NULL);
 }
 
+void ui_weatherScreen_screen_destroy(void)
+{
+      ui_weatherPanel = NULL;
+      ui_weatherCity = NULL;
+      ui_weatherCurrentIcon = NULL;
+      ui_weatherCurrentTemp = NULL;
+      ui_weatherUpdateTime = NULL;
+      ui_forecastList = NULL;
+      ui_hourlyList = NULL;
+}
+
 void ui_appListScreen_screen_init(void)
 {
       ui_appListScreen = lv_obj_create(NULL);
@@ -2874,6 +3162,7 @@ void ui_notificationScreen_screen_init(void)
       lv_obj_set_style_pad_bottom(ui_messageList, 70, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_messageList, onScroll, LV_EVENT_SCROLL, NULL);
+      ui_vlist_init(&notificationVList, ui_messageList, NOTIFICATION_ROW_HEIGHT, createNotificationListRow);
 
       lv_obj_add_event_cb(ui_notificationScreen, ui_event_notificationScreen, LV_EVENT_ALL, NULL);
 }
@@ -2938,7 +3227,7 @@ void ui_settingsScreen_screen_init(void)
 
       ui_brightnessSlider = lv_slider_create(ui_brightnessPanel);
       lv_slider_set_range(ui_brightnessSlider, 1, 255);
-      lv_slider_set_value(ui_brightnessSlider, 100, LV_ANIM_OFF);
+      lv_slider_set_value(ui_brightnessSlider, settingsBrightness, LV_ANIM_OFF);
       if (lv_slider_get_mode(ui_brightnessSlider) == LV_SLIDER_MODE_RANGE)
             lv_slider_set_left_value(ui_brightnessSlider, 0, LV_ANIM_OFF);
       lv_obj_set_width(ui_brightnessSlider, 123);
@@ -3335,7 +3624,7 @@ void ui_settingsScreen_screen_init(void)
       lv_obj_set_height(ui_aboutText, LV_SIZE_CONTENT); /// 1
       lv_obj_set_x(ui_aboutText, 60);
       lv_obj_set_y(ui_aboutText, 7);
-      lv_label_set_text(ui_aboutText, "v4.0 (fbiego)\nESP32 C3 Mini\n11:22:33:44:55:66");
+      lv_label_set_text(ui_aboutText, settingsAbout);
 
       ui_kenyaPanel = lv_obj_create(ui_settingsList);
       lv_obj_set_width(ui_kenyaPanel, 200);
@@ -3387,6 +3676,21 @@ void ui_settingsScreen_screen_init(void)
       // lv_obj_add_event_cb(ui_languageSelect, ui_event_languageSelect, LV_EVENT_ALL, NULL);
       lv_obj_add_event_cb(ui_batterySlider, ui_event_batterySlider, LV_EVENT_ALL, NULL);
       lv_obj_add_event_cb(ui_settingsScreen, ui_event_settingsScreen, LV_EVENT_ALL, NULL);
+
+      lv_dropdown_set_selected(ui_timeoutSelect, settingsTimeout, LV_ANIM_OFF);
+      lv_dropdown_set_selected(ui_rotateSelect, settingsRotation, LV_ANIM_OFF);
+      _ui_state_modify(ui_Switch2, LV_STATE_CHECKED, circular ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+#ifdef ENABLE_APP_NAVIGATION
+      _ui_state_modify(ui_navStateSwitch, LV_STATE_CHECKED, settingsNavigation ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+#endif
+
+      lv_disp_t *display = lv_display_get_default();
+      if (lv_display_get_horizontal_resolution(display) != lv_display_get_vertical_resolution(display))
+      {
+            lv_obj_add_flag(ui_rotatePanel, LV_OBJ_FLAG_HIDDEN); /// Flags
+      }
+
+      lv_obj_scroll_to_y(ui_settingsList, 1, LV_ANIM_OFF);
 }
 
 void ui_alertScreen_screen_init(void)
@@ -3555,7 +3859,10 @@ void ui_controlScreen_screen_init(void)
       lv_obj_set_x(ui_btStateButton, 0);
       lv_obj_set_y(ui_btStateButton, -100);
       lv_obj_set_align(ui_btStateButton, LV_ALIGN_CENTER);
-      lv_obj_add_state(ui_btStateButton, LV_STATE_CHECKED);         /// States
+      if (!phoneConnected)
+      {
+            lv_obj_add_state(ui_btStateButton, LV_STATE_CHECKED); /// States
+      }
       lv_obj_add_flag(ui_btStateButton, LV_OBJ_FLAG_CHECKABLE);     /// Flags
       lv_obj_remove_flag(ui_btStateButton, LV_OBJ_FLAG_SCROLLABLE); /// Flags
       lv_image_set_scale(ui_btStateButton, 200);
@@ -3660,6 +3967,20 @@ void ui_controlScreen_screen_init(void)
       lv_obj_add_event_cb(ui_controlScreen, ui_event_controlScreen, LV_EVENT_ALL, NULL);
 }
 
+void ui_controlScreen_screen_destroy(void)
+{
+      ui_musicPlayButton = NULL;
+      ui_musicPrevButton = NULL;
+      ui_musicNextButton = NULL;
+      ui_btStateButton = NULL;
+      ui_searchPanel = NULL;
+      ui_phoneSearchButton = NULL;
+      ui_volumeUpButton = NULL;
+      ui_volumeDownButton = NULL;
+      ui_qrCodeButton = NULL;
+      ui_closeControlButton = NULL;
+}
+
 void ui_appInfoScreen_screen_init(void)
 {
       ui_appInfoScreen = lv_obj_create(NULL);
@@ -3733,7 +4054,7 @@ void ui_appInfoScreen_screen_init(void)
       lv_obj_set_height(ui_appDetailsText, LV_SIZE_CONTENT); /// 1
       lv_obj_set_x(ui_appDetailsText, 43);
       lv_obj_set_y(ui_appDetailsText, 8);
-      lv_label_set_text(ui_appDetailsText, "Chronos app\nv3.8.0 (52)");
+      lv_label_set_text(ui_appDetailsText, appVersion);
       lv_obj_set_style_text_font(ui_appDetailsText, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       ui_appConnectionPanel = lv_obj_create(ui_appInfoPanel);
@@ -3766,7 +4087,7 @@ void ui_appInfoScreen_screen_init(void)
       lv_obj_set_height(ui_appConnectionText, LV_SIZE_CONTENT); /// 1
       lv_obj_set_x(ui_appConnectionText, 43);
       lv_obj_set_y(ui_appConnectionText, 8);
-      lv_label_set_text(ui_appConnectionText, "Status\nDisconnected");
+      lv_label_set_text_fmt(ui_appConnectionText, "Status\n%s", phoneConnected ? "Connected" : "Disconnected");
       // lv_label_set_recolor(ui_appConnectionText, true);
       lv_obj_set_style_text_font(ui_appConnectionText, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
 
@@ -3810,11 +4131,23 @@ void ui_appInfoScreen_screen_init(void)
       lv_obj_set_x(ui_appBatteryLevel, 44);
       lv_obj_set_y(ui_appBatteryLevel, 28);
 
+      lv_obj_t *ui_appMemoryPanel = ui_theme_row_create(ui_appInfoPanel, 190, LV_SIZE_CONTENT, false);
+      lv_obj_add_style(ui_appMemoryPanel, &ui_style_pad_none, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+      ui_appMemoryText = lv_label_create(ui_appMemoryPanel);
+      lv_obj_set_width(ui_appMemoryText, 182);
+      lv_obj_set_height(ui_appMemoryText, LV_SIZE_CONTENT); /// 1
+      lv_obj_set_x(ui_appMemoryText, 4);
+      lv_label_set_text(ui_appMemoryText, "Memory");
+      lv_obj_add_style(ui_appMemoryText, &ui_style_text_small, LV_PART_MAIN | LV_STATE_DEFAULT);
+
       addAppInfo(&ui_img_twitter_x_png, "X (Twitter)\n@chronos_app");
       addAppInfo(&ui_img_web_png, "Website\nchronos.ke");
 
       lv_obj_add_event_cb(ui_appInfoPanel, onScroll, LV_EVENT_SCROLL, NULL);
       lv_obj_add_event_cb(ui_appInfoScreen, ui_event_appInfoScreen, LV_EVENT_ALL, NULL);
+
+      lv_obj_scroll_to_y(ui_appInfoPanel, 1, LV_ANIM_OFF);
 }
 
 void ui_callScreen_screen_init(void)
@@ -3854,6 +4187,15 @@ void ui_callScreen_screen_init(void)
       lv_obj_set_style_text_font(ui_callName, &lv_font_montserrat_18, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_callScreen, ui_event_callScreen, LV_EVENT_ALL, NULL);
+
+      pulseCall_Animation(ui_callIcon, 0);
+}
+
+void ui_callScreen_screen_destroy(void)
+{
+      ui_callIcon = NULL;
+      ui_callLabel = NULL;
+      ui_callName = NULL;
 }
 
 void ui_cameraScreen_screen_init()
@@ -3931,6 +4273,16 @@ void ui_cameraScreen_screen_init()
       lv_label_set_text(ui_cameraButtonLabel, "Capture");
 }
 
+void ui_cameraScreen_screen_destroy(void)
+{
+      ui_cameraPanel = NULL;
+      ui_cameraTitle = NULL;
+      ui_cameraIcon = NULL;
+      ui_cameraLabel = NULL;
+      ui_cameraButton = NULL;
+      ui_cameraButtonLabel = NULL;
+}
+
 void ui_qrScreen_screen_init(void)
 {
       ui_qrScreen = lv_obj_create(NULL);
@@ -3957,15 +4309,7 @@ void ui_qrScreen_screen_init(void)
 
 #if LV_USE_QRCODE == 1
 
-      addQrList(0, "https://chronos.ke/");
-      addQrList(1, "https://www.youtube.com/c/fbiego");
-      addQrList(2, "https://play.google.com/store/apps/details?id=com.fbiego.chronos");
-      addQrList(3, "https://github.com/fbiego/esp32-c3-mini");
-      addQrList(4, "https://x.com/chronos_app");
-      addQrList(5, "https://felix.fbiego.com");
-      addQrList(6, "https://www.linkedin.com/in/fbiego/");
-      addQrList(7, "https://ko-fi.com/fbiego");
-      addQrList(8, "https://www.paypal.com/paypalme/biego");
+      ui_add_qr_links();
 
 #else
       lv_obj_t *info = lv_label_create(ui_qrPanel);
@@ -3979,6 +4323,15 @@ void ui_qrScreen_screen_init(void)
       lv_obj_add_event_cb(ui_qrScreen, ui_event_qrScreen, LV_EVENT_ALL, NULL);
 }
 
+void ui_qrScreen_screen_destroy(void)
+{
+      ui_qrPanel = NULL;
+      ui_qrItem = NULL;
+      ui_qrIcon = NULL;
+      ui_qrImage = NULL;
+      ui_qrLabel = NULL;
+}
+
 void ui_findPhone_screen_init(void)
 {
       ui_findPhoneScreen = lv_obj_create(NULL);
@@ -4042,6 +4395,17 @@ void ui_findPhone_screen_init(void)
 
       lv_obj_add_event_cb(ui_findButton, ui_event_findButton, LV_EVENT_ALL, NULL);
       lv_obj_add_event_cb(ui_findPhoneScreen, ui_event_findPhone, LV_EVENT_ALL, NULL);
+
+      findPhone_Animation(ui_findPanel, 0);
+}
+
+void ui_findPhone_screen_destroy(void)
+{
+      ui_findTitle = NULL;
+      ui_findButton = NULL;
+      ui_findButtonText = NULL;
+      ui_findPanel = NULL;
+      ui_findIcon = NULL;
 }
 
 void ui_logoScreen_screen_init(void)
@@ -4082,6 +4446,16 @@ void ui_logoScreen_screen_init(void)
       lv_obj_add_event_cb(ui_logoScreen, ui_event_logoScreen, LV_EVENT_ALL, NULL);
 }
 
+void ui_logoScreen_screen_destroy(void)
+{
+      // the drift timers point at the logos
+      stop_drift_animation();
+      ui_lvglLogoBlack = NULL;
+      ui_lvglLogoBlue = NULL;
+      ui_lvglLogoRed = NULL;
+      ui_lvglLogoGreen = NULL;
+}
+
 void ui_filesScreen_screen_init(void)
 {
       ui_filesScreen = lv_obj_create(NULL);
@@ -4107,7 +4481,8 @@ void ui_filesScreen_screen_init(void)
       lv_obj_set_style_pad_column(ui_fileManagerPanel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
 
       lv_obj_add_event_cb(ui_fileManagerPanel, onScroll, LV_EVENT_SCROLL, NULL);
-      lv_obj_add_event_cb(ui_filesScreen, ui_event_appInfoScreen, LV_EVENT_ALL, NULL);
+      ui_vlist_init(&fileVList, ui_fileManagerPanel, FILE_ROW_HEIGHT, createFileRow);
+      lv_obj_add_event_cb(ui_filesScreen, ui_event_filesScreen, LV_EVENT_ALL, NULL);
 }
 
 void ui_connectScreen_screen_init(void)
@@ -4186,6 +4561,7 @@ void ui_watchfaces_init(void)
 void ui_update_watchfaces(int second, int minute, int hour, bool mode, bool am, int day, int month, int year, int weekday,
                           int temp, int icon, int battery, bool connection, int steps, int distance, int kcal, int bpm, int oxygen)
 {
+      PROFILER_BEGIN;
 
       update_check_elecrow(ui_home, second, minute, hour, mode, am, day, month, year, weekday, temp, icon, battery, connection, steps, distance, kcal, bpm, oxygen);
       update_check_34_2(ui_home, second, minute, hour, mode, am, day, month, year, weekday, temp, icon, battery, connection, steps, distance, kcal, bpm, oxygen);
@@ -4212,8 +4588,8 @@ void ui_update_watchfaces(int second, int minute, int hour, bool mode, bool am,
 
       update_check_756_2_466(ui_home, second, minute, hour, mode, am, day, month, year, weekday, temp, icon, battery, connection, steps, distance, kcal, bpm, oxygen);
       update_check_radar_466(ui_home, second, minute, hour, mode, am, day, month, year, weekday, temp, icon, battery, connection, steps, distance, kcal, bpm, oxygen);
-      
 
+      PROFILER_END;
 }
 
 void ui_update_seconds(int second)
@@ -4245,9 +4621,9 @@ void ui_apps_init(void)
       }
 }
 
-void ui_games_update(void)
+uint32_t ui_games_update(void)
 {
-      ui_raceScreen_screen_loop();
+      return game_loop_tick();
 }
 
 void ui_errorWindow_init(void)
@@ -4349,27 +4725,33 @@ void ui_init(void)
       lv_disp_t *dispp = lv_display_get_default();
       lv_theme_t *theme = lv_theme_default_init(dispp, lv_palette_main(LV_PALETTE_BLUE), lv_palette_main(LV_PALETTE_RED), true, LV_FONT_DEFAULT);
       lv_display_set_theme(dispp, theme);
+      ui_theme_init();
+
+      // screens the HAL updates in the background stay resident, the rest is built on first use
+      // from state kept outside the widgets (the ui_settings_set_* and ui_set_* calls)
+      ui_screen_register("Clock", &ui_clockScreen, ui_clockScreen_screen_init, NULL, UI_SCREEN_RESIDENT);
+      ui_screen_register("Notifications", &ui_notificationScreen, ui_notificationScreen_screen_init, NULL, UI_SCREEN_RESIDENT);
+      ui_screen_register("App list", &ui_appListScreen, ui_appListScreen_screen_init, NULL, UI_SCREEN_RESIDENT);
+      ui_screen_register("Game list", &ui_gameListScreen, ui_gameListScreen_screen_init, NULL, UI_SCREEN_RESIDENT);
+      ui_screen_register("Alerts", &ui_alertScreen, ui_alertScreen_screen_init, NULL, UI_SCREEN_RESIDENT);
+      ui_screen_register("Connect", &ui_connectScreen, ui_connectScreen_screen_init, NULL, UI_SCREEN_RESIDENT);
 
-      ui_clockScreen_screen_init();
-      ui_weatherScreen_screen_init();
-      ui_notificationScreen_screen_init();
-      ui_appListScreen_screen_init();
-      ui_gameListScreen_screen_init();
-      ui_settingsScreen_screen_init();
-      ui_alertScreen_screen_init();
-      ui_controlScreen_screen_init();
-      ui_appInfoScreen_screen_init();
-      ui_callScreen_screen_init();
-      ui_qrScreen_screen_init();
-      ui_connectScreen_screen_init();
+      ui_screen_register("Settings", &ui_settingsScreen, ui_settingsScreen_screen_init, NULL, UI_SCREEN_LAZY);
+      ui_screen_register("App info", &ui_appInfoScreen, ui_appInfoScreen_screen_init, NULL, UI_SCREEN_LAZY);
+      ui_screen_register("Files", &ui_filesScreen, ui_filesScreen_screen_init, NULL, UI_SCREEN_LAZY);
 
-      ui_findPhone_screen_init();
-      ui_logoScreen_screen_init();
+      ui_screen_register("Weather", &ui_weatherScreen, ui_weatherScreen_screen_init, ui_weatherScreen_screen_destroy, UI_SCREEN_TRANSIENT);
+      ui_screen_register("Controls", &ui_controlScreen, ui_controlScreen_screen_init, ui_controlScreen_screen_destroy, UI_SCREEN_TRANSIENT);
+      ui_screen_register("QR codes", &ui_qrScreen, ui_qrScreen_screen_init, ui_qrScreen_screen_destroy, UI_SCREEN_TRANSIENT);
 
-      ui_cameraScreen_screen_init();
+      ui_screen_register("Call", &ui_callScreen, ui_callScreen_screen_init, ui_callScreen_screen_destroy, UI_SCREEN_OVERLAY);
+      ui_screen_register("Camera", &ui_cameraScreen, ui_cameraScreen_screen_init, ui_cameraScreen_screen_destroy, UI_SCREEN_OVERLAY);
+      ui_screen_register("Find phone", &ui_findPhoneScreen, ui_findPhone_screen_init, ui_findPhone_screen_destroy, UI_SCREEN_TRANSIENT);
+      ui_screen_register("Logo", &ui_logoScreen, ui_logoScreen_screen_init, ui_logoScreen_screen_destroy, UI_SCREEN_TRANSIENT);
+
+      ui_screen_init_resident();
 
       ui_errorWindow_init();
-      ui_filesScreen_screen_init();
 
       init_face_select();
       ui_watchfaces_init();
@@ -4384,21 +4766,9 @@ void ui_init(void)
 
       lv_screen_load(ui____initial_actions0);
       lv_screen_load(ui_home);
-
-      if (dispp->hor_res != dispp->ver_res)
-      {
-            lv_obj_add_flag(ui_rotatePanel, LV_OBJ_FLAG_HIDDEN); /// Flags
-      }
 }
 
 void ui_setup(void)
 {
-
-      lv_obj_scroll_by(ui_settingsList, 0, circular ? 1 : -1, LV_ANIM_ON);
-      lv_obj_scroll_by(ui_appList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-      lv_obj_scroll_by(ui_messageList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-      lv_obj_scroll_by(ui_forecastList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-      lv_obj_scroll_by(ui_appInfoPanel, 0, circular ? 1 : -1, LV_ANIM_OFF);
-      lv_obj_scroll_by(ui_gameList, 0, circular ? 1 : -1, LV_ANIM_OFF);
-      lv_obj_scroll_by(ui_fileManagerPanel, 0, circular ? 1 : -1, LV_ANIM_OFF);
+      ui_nudge_lists();
 }
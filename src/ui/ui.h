@@ -27,6 +27,10 @@ extern "C"
 #include "../common/app_manager.h"
 #include "../common/generated_features.h"
 #include "../common/input_bus/input_bus.h"
+#include "../common/game_loop/game_loop.h"
+#include "ui_screens.h"
+#include "ui_vlist.h"
+#include "ui_transition.h"
 
 
     extern const char *ui_info_text;
@@ -166,6 +170,7 @@ extern "C"
     extern lv_obj_t *ui_appBatteryIcon;
     extern lv_obj_t *ui_appBatteryText;
     extern lv_obj_t *ui_appBatteryLevel;
+    extern lv_obj_t *ui_appMemoryText;
 
     void ui_event_findPhone(lv_event_t *e);
     extern lv_obj_t *ui_findPhoneScreen;
@@ -288,14 +293,29 @@ extern "C"
     void ui_update_watchfaces(int second, int minute, int hour, bool mode, bool am, int day, int month, int year, int weekday,
                               int temp, int icon, int battery, bool connection, int steps, int distance, int kcal, int bpm, int oxygen);
     void ui_update_seconds(int second);
+    void ui_update_heap_info(void);
+
+    // state of screens that are created on demand, kept here and applied when they are
+    void ui_settings_set_brightness(int32_t level);
+    int32_t ui_settings_get_brightness(void);
+    void ui_settings_set_timeout(int32_t index);
+    void ui_settings_set_rotation(int32_t index);
+    void ui_settings_set_navigation(bool on);
+    void ui_settings_set_about(const char *text);
+    void ui_set_connected(bool state);
+    void ui_set_app_version(const char *version, int code);
+    void ui_set_qr_link(uint8_t id, const char *link);
+    void ui_update_qr_links(void); // rebuild the QR screen after ui_set_qr_link, when it exists
 
     void addNotificationList(int appId, const char *message, int index);
+    void setNotificationList(int32_t count, ui_vlist_bind_cb_t bind);
+    void bindNotificationList(lv_obj_t *row, int appId, const char *message, int index);
     void addForecast(int day, int temp, int icon);
     void addHourlyWeather(int hour, int icon, int temp, int humidity, int wind, int uv, bool info);
     void addQrList(uint8_t id, const char *link);
     void setWeatherIcon(lv_obj_t *obj, int id, bool day);
     void setNotificationIcon(lv_obj_t *obj, int appId);
-    void ui_games_update(void);
+    uint32_t ui_games_update(void); // runs the active game, returns ms until it is due again
     void showError(const char *title, const char *message);
     void addWatchface(const char *name, const lv_image_dsc_t *src, int index);
 
@@ -303,6 +323,10 @@ extern "C"
     void addListDir(const char *name);
     void addListFile(const char *name, int size);
     void addListBack(lv_event_cb_t event_cb);
+    void setFileList(int32_t count, ui_vlist_bind_cb_t bind);
+    void bindListDir(lv_obj_t *row, const char *name);
+    void bindListFile(lv_obj_t *row, const char *name, int size);
+    void bindListBack(lv_obj_t *row, lv_event_cb_t event_cb);
 
     void addFaceList(lv_obj_t *parent, Face face);
 
@@ -14,6 +14,7 @@ void onLoadHome(lv_event_t * e);
 void onClickAlert(lv_event_t * e);
 void onForecastOpen(lv_event_t * e);
 void onWeatherLoad(lv_event_t * e);
+void onFilesLoad(lv_event_t * e);
 void onNotificationsOpen(lv_event_t * e);
 void onBrightnessChange(lv_event_t * e);
 void onScrollMode(lv_event_t * e);
@@ -49,9 +49,9 @@ void _ui_slider_set_property( lv_obj_t *target, int id, int val)
 }
 
 
-void _ui_screen_change( lv_obj_t *target, lv_scr_load_anim_t fademode, int spd, int delay) 
+void _ui_screen_change( lv_obj_t **target, lv_scr_load_anim_t fademode, int spd, int delay) 
 {
-   lv_screen_load_anim(target, fademode, spd, delay, false);
+   ui_screen_load(target, fademode, spd, delay);
 }
 
 void _ui_arc_increment( lv_obj_t *target, int val) 
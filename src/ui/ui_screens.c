@@ -0,0 +1,154 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#include "ui.h"
+#include "ui_screens.h"
+#include "display/lv_display_private.h"
+#include "../common/heap_tags/heap_tags.h"
+
+typedef struct
+{
+      const char *name;
+      lv_obj_t **screen;
+      void (*init)(void);
+      void (*destroy)(void);
+      ui_screen_policy_t policy;
+} ui_screen_entry_t;
+
+static ui_screen_entry_t entries[UI_SCREEN_MAX];
+static int numEntries = 0;
+
+static ui_screen_entry_t *ui_screen_find(lv_obj_t **screen)
+{
+      for (int i = 0; i < numEntries; i++)
+      {
+            if (entries[i].screen == screen)
+            {
+                  return &entries[i];
+            }
+      }
+      return NULL;
+}
+
+static ui_screen_entry_t *ui_screen_find_obj(lv_obj_t *obj)
+{
+      for (int i = 0; i < numEntries; i++)
+      {
+            if (obj != NULL && *entries[i].screen == obj)
+            {
+                  return &entries[i];
+            }
+      }
+      return NULL;
+}
+
+// runs after the unload has finished, the screen may have been loaded again meanwhile
+static void ui_screen_release(void *data)
+{
+      ui_screen_entry_t *entry = (ui_screen_entry_t *)data;
+      lv_display_t *display = lv_display_get_default();
+      lv_obj_t *actScr = lv_display_get_screen_active(display);
+      lv_obj_t *obj = *entry->screen;
+
+      if (obj == NULL || obj == actScr || obj == display->scr_to_load)
+      {
+            return;
+      }
+
+      // overlays, apps and the HAL's own screens (navigation) return to the screen they
+      // covered, keep that one until it is left again
+      ui_screen_entry_t *active = ui_screen_find_obj(actScr);
+      bool covered = active == NULL ? actScr != ui_home : active->policy == UI_SCREEN_OVERLAY;
+      if (covered)
+      {
+            return;
+      }
+
+      *entry->screen = NULL;
+      if (entry->destroy != NULL)
+      {
+            entry->destroy();
+      }
+      lv_obj_delete(obj);
+}
+
+static void ui_screen_unloaded(lv_event_t *e)
+{
+      lv_async_call(ui_screen_release, lv_event_get_user_data(e));
+}
+
+void ui_screen_register(const char *name, lv_obj_t **screen, void (*init)(void), void (*destroy)(void), ui_screen_policy_t policy)
+{
+      if (numEntries >= UI_SCREEN_MAX || ui_screen_find(screen) != NULL)
+      {
+            return;
+      }
+      entries[numEntries].name = name;
+      entries[numEntries].screen = screen;
+      entries[numEntries].init = init;
+      entries[numEntries].destroy = destroy;
+      entries[numEntries].policy = policy;
+      numEntries++;
+}
+
+void ui_screen_init_resident(void)
+{
+      for (int i = 0; i < numEntries; i++)
+      {
+            if (entries[i].policy == UI_SCREEN_RESIDENT)
+            {
+                  ui_screen_get(entries[i].screen);
+            }
+      }
+}
+
+lv_obj_t *ui_screen_get(lv_obj_t **screen)
+{
+      if (*screen != NULL)
+      {
+            return *screen;
+      }
+
+      ui_screen_entry_t *entry = ui_screen_find(screen);
+      if (entry == NULL)
+      {
+            return NULL;
+      }
+
+      heap_tag_t tag = heap_tag_get(entry->name);
+      heap_tag_t previous = heap_tag_enter(tag);
+      entry->init();
+      heap_tag_leave(previous);
+      heap_tag_bind_screen(*screen, tag);
+
+      if (*screen != NULL && (entry->policy == UI_SCREEN_TRANSIENT || entry->policy == UI_SCREEN_OVERLAY))
+      {
+            lv_obj_add_event_cb(*screen, ui_screen_unloaded, LV_EVENT_SCREEN_UNLOADED, entry);
+      }
+      return *screen;
+}
+
+void ui_screen_load(lv_obj_t **screen, lv_screen_load_anim_t anim, uint32_t time, uint32_t delay)
+{
+      lv_obj_t *obj = ui_screen_get(screen);
+      if (obj != NULL)
+      {
+            ui_transition_load(obj, anim, time, delay);
+      }
+}
+
+int ui_screen_count_created(void)
+{
+      int count = 0;
+      for (int i = 0; i < numEntries; i++)
+      {
+            if (*entries[i].screen != NULL)
+            {
+                  count++;
+            }
+      }
+      return count;
+}
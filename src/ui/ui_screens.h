@@ -0,0 +1,49 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#ifndef _C3_WATCH_UI_SCREENS_H
+#define _C3_WATCH_UI_SCREENS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+#define UI_SCREEN_MAX 24
+
+typedef enum
+{
+      UI_SCREEN_RESIDENT,  // created in ui_init and kept (home, lists the HAL fills in the background)
+      UI_SCREEN_LAZY,      // created on first navigation and kept
+      UI_SCREEN_TRANSIENT, // created on navigation and deleted once left
+      UI_SCREEN_OVERLAY,   // transient, shown over another screen that the HAL returns to (call, camera)
+} ui_screen_policy_t;
+
+/*
+ * Register a built-in screen. init must assign *screen, destroy (optional) clears the
+ * child object pointers once a transient screen has been deleted. name is the heap owner
+ * the screen is counted for.
+ */
+void ui_screen_register(const char *name, lv_obj_t **screen, void (*init)(void), void (*destroy)(void), ui_screen_policy_t policy);
+
+// create all resident screens, in registration order
+void ui_screen_init_resident(void);
+
+// return the screen, creating it first if it is registered and not created yet
+lv_obj_t *ui_screen_get(lv_obj_t **screen);
+
+// ui_screen_get followed by ui_transition_load
+void ui_screen_load(lv_obj_t **screen, lv_screen_load_anim_t anim, uint32_t time, uint32_t delay);
+
+// number of registered screens currently created
+int ui_screen_count_created(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
@@ -0,0 +1,222 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#include "ui_sprite_layer.h"
+
+// absolute coordinates of a sprite
+static bool ui_sprite_area(ui_sprite_layer_t *layer, const ui_sprite_t *sprite, lv_area_t *area)
+{
+      if (sprite->src == NULL || !sprite->visible)
+      {
+            return false;
+      }
+      lv_area_t coords;
+      lv_obj_get_coords(layer->obj, &coords);
+      area->x1 = coords.x1 + sprite->x;
+      area->y1 = coords.y1 + sprite->y;
+      area->x2 = area->x1 + sprite->src->header.w - 1;
+      area->y2 = area->y1 + sprite->src->header.h - 1;
+      return true;
+}
+
+static void ui_sprite_layer_invalidate_all(ui_sprite_layer_t *layer)
+{
+      if (!layer->dirty)
+      {
+            lv_obj_invalidate(layer->obj);
+            layer->dirty = true;
+      }
+}
+
+// old and new rectangle of a sprite that changed, joined when they overlap
+static void ui_sprite_invalidate(ui_sprite_layer_t *layer, const lv_area_t *before, bool hadBefore, const ui_sprite_t *sprite)
+{
+      if (layer->dirty)
+      {
+            return;
+      }
+
+      lv_area_t after;
+      bool hasAfter = ui_sprite_area(layer, sprite, &after);
+      if (hadBefore && hasAfter && lv_area_is_on(before, &after))
+      {
+            lv_area_t joined;
+            lv_area_join(&joined, before, &after);
+            lv_obj_invalidate_area(layer->obj, &joined);
+            return;
+      }
+      if (hadBefore)
+      {
+            lv_obj_invalidate_area(layer->obj, before);
+      }
+      if (hasAfter)
+      {
+            lv_obj_invalidate_area(layer->obj, &after);
+      }
+}
+
+static void ui_sprite_layer_draw(lv_event_t *e)
+{
+      ui_sprite_layer_t *layer = (ui_sprite_layer_t *)lv_event_get_user_data(e);
+      lv_layer_t *drawLayer = lv_event_get_layer(e);
+      lv_area_t coords;
+      lv_area_t area;
+      lv_obj_get_coords(layer->obj, &coords);
+
+      lv_draw_image_dsc_t dsc;
+      lv_draw_image_dsc_init(&dsc);
+
+      if (layer->background != NULL)
+      {
+            int32_t tileH = layer->background->header.h;
+            int32_t y = layer->scroll % tileH;
+            if (y > 0)
+            {
+                  y -= tileH;
+            }
+            dsc.src = layer->background;
+            for (; y < lv_area_get_height(&coords); y += tileH)
+            {
+                  area.x1 = coords.x1;
+                  area.y1 = coords.y1 + y;
+                  area.x2 = area.x1 + layer->background->header.w - 1;
+                  area.y2 = area.y1 + tileH - 1;
+                  lv_draw_image(drawLayer, &dsc, &area);
+            }
+      }
+
+      for (uint8_t i = 0; i < layer->count; i++)
+      {
+            if (ui_sprite_area(layer, &layer->sprites[i], &area))
+            {
+                  dsc.src = layer->sprites[i].src;
+                  lv_draw_image(drawLayer, &dsc, &area);
+            }
+      }
+      layer->dirty = false;
+}
+
+static void ui_sprite_layer_cover_check(lv_event_t *e)
+{
+      ui_sprite_layer_t *layer = (ui_sprite_layer_t *)lv_event_get_user_data(e);
+      const lv_image_dsc_t *tile = layer->background;
+      if (tile == NULL || lv_color_format_has_alpha(tile->header.cf) || (int32_t)tile->header.w < lv_obj_get_width(layer->obj))
+      {
+            return;
+      }
+
+      lv_area_t coords;
+      lv_obj_get_coords(layer->obj, &coords);
+      if (lv_area_is_in(lv_event_get_cover_area(e), &coords, 0))
+      {
+            lv_event_set_cover_res(e, LV_COVER_RES_COVER);
+      }
+}
+
+static void ui_sprite_layer_ext_draw_size(lv_event_t *e)
+{
+      ui_sprite_layer_t *layer = (ui_sprite_layer_t *)lv_event_get_user_data(e);
+      lv_event_set_ext_draw_size(e, layer->overflow);
+}
+
+lv_obj_t *ui_sprite_layer_create(ui_sprite_layer_t *layer, lv_obj_t *parent, int32_t w, int32_t h)
+{
+      lv_memzero(layer, sizeof(*layer));
+      layer->obj = lv_obj_create(parent);
+      lv_obj_remove_style_all(layer->obj);
+      lv_obj_set_size(layer->obj, w, h);
+      lv_obj_remove_flag(layer->obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE); /// Flags
+      lv_obj_add_event_cb(layer->obj, ui_sprite_layer_draw, LV_EVENT_DRAW_MAIN, layer);
+      lv_obj_add_event_cb(layer->obj, ui_sprite_layer_cover_check, LV_EVENT_COVER_CHECK, layer);
+      lv_obj_add_event_cb(layer->obj, ui_sprite_layer_ext_draw_size, LV_EVENT_REFR_EXT_DRAW_SIZE, layer);
+      return layer->obj;
+}
+
+void ui_sprite_layer_set_background(ui_sprite_layer_t *layer, const lv_image_dsc_t *tile)
+{
+      layer->background = tile;
+      ui_sprite_layer_invalidate_all(layer);
+}
+
+void ui_sprite_layer_scroll_to(ui_sprite_layer_t *layer, int32_t y)
+{
+      if (layer->background != NULL)
+      {
+            y %= (int32_t)layer->background->header.h;
+      }
+      if (y == layer->scroll)
+      {
+            return;
+      }
+      layer->scroll = y;
+      ui_sprite_layer_invalidate_all(layer);
+}
+
+void ui_sprite_layer_set_overflow(ui_sprite_layer_t *layer, int32_t overflow)
+{
+      layer->overflow = overflow;
+      lv_obj_refresh_ext_draw_size(layer->obj);
+      lv_obj_invalidate(layer->obj);
+}
+
+int ui_sprite_add(ui_sprite_layer_t *layer, const lv_image_dsc_t *src, int32_t x, int32_t y)
+{
+      if (layer->count >= UI_SPRITE_LAYER_MAX)
+      {
+            return -1;
+      }
+      ui_sprite_t *sprite = &layer->sprites[layer->count];
+      sprite->src = src;
+      sprite->x = x;
+      sprite->y = y;
+      sprite->visible = true;
+      ui_sprite_invalidate(layer, NULL, false, sprite);
+      return layer->count++;
+}
+
+void ui_sprite_move(ui_sprite_layer_t *layer, int id, int32_t x, int32_t y)
+{
+      if (id < 0 || id >= layer->count)
+      {
+            return;
+      }
+      ui_sprite_t *sprite = &layer->sprites[id];
+      if (sprite->x == x && sprite->y == y)
+      {
+            return;
+      }
+      lv_area_t before;
+      bool hadBefore = ui_sprite_area(layer, sprite, &before);
+      sprite->x = x;
+      sprite->y = y;
+      ui_sprite_invalidate(layer, &before, hadBefore, sprite);
+}
+
+void ui_sprite_set_src(ui_sprite_layer_t *layer, int id, const lv_image_dsc_t *src)
+{
+      if (id < 0 || id >= layer->count || layer->sprites[id].src == src)
+      {
+            return;
+      }
+      ui_sprite_t *sprite = &layer->sprites[id];
+      lv_area_t before;
+      bool hadBefore = ui_sprite_area(layer, sprite, &before);
+      sprite->src = src;
+      ui_sprite_invalidate(layer, &before, hadBefore, sprite);
+}
+
+void ui_sprite_set_visible(ui_sprite_layer_t *layer, int id, bool visible)
+{
+      if (id < 0 || id >= layer->count || layer->sprites[id].visible == visible)
+      {
+            return;
+      }
+      ui_sprite_t *sprite = &layer->sprites[id];
+      lv_area_t before;
+      bool hadBefore = ui_sprite_area(layer, sprite, &before);
+      sprite->visible = visible;
+      ui_sprite_invalidate(layer, &before, hadBefore, sprite);
+}
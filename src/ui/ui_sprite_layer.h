@@ -0,0 +1,68 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#ifndef _C3_WATCH_UI_SPRITE_LAYER_H
+#define _C3_WATCH_UI_SPRITE_LAYER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+#define UI_SPRITE_LAYER_MAX 8 // sprites per layer
+
+typedef struct
+{
+      const lv_image_dsc_t *src;
+      int32_t x; // top left, relative to the layer
+      int32_t y;
+      bool visible;
+} ui_sprite_t;
+
+/*
+ * One plain object that draws a vertically tiled, scrolling background and a few image
+ * sprites itself in LV_EVENT_DRAW_MAIN, for games that move things every frame.
+ * Sprites have no styles, layout or events. Moving one invalidates its old and new
+ * rectangle (one area when they overlap), scrolling the background invalidates the layer
+ * once and sprite moves in the same frame add nothing. An opaque background as wide as
+ * the layer covers it, so LVGL skips drawing whatever is behind.
+ * Sprites are drawn in the order they were added and may stick out of the layer by the
+ * overflow set (the parent needs LV_OBJ_FLAG_OVERFLOW_VISIBLE for that). The object is
+ * not clickable, presses go to the parent.
+ */
+typedef struct
+{
+      lv_obj_t *obj;
+      const lv_image_dsc_t *background;
+      int32_t scroll;
+      int32_t overflow;
+      bool dirty; // whole layer invalidated since the last draw
+      ui_sprite_t sprites[UI_SPRITE_LAYER_MAX];
+      uint8_t count;
+} ui_sprite_layer_t;
+
+lv_obj_t *ui_sprite_layer_create(ui_sprite_layer_t *layer, lv_obj_t *parent, int32_t w, int32_t h);
+
+// tile repeated from the top, NULL for none
+void ui_sprite_layer_set_background(ui_sprite_layer_t *layer, const lv_image_dsc_t *tile);
+// move the background down by y pixels, wraps at the tile height
+void ui_sprite_layer_scroll_to(ui_sprite_layer_t *layer, int32_t y);
+
+// how far sprites may be drawn outside the layer
+void ui_sprite_layer_set_overflow(ui_sprite_layer_t *layer, int32_t overflow);
+
+// returns the sprite id or -1 when the layer is full
+int ui_sprite_add(ui_sprite_layer_t *layer, const lv_image_dsc_t *src, int32_t x, int32_t y);
+void ui_sprite_move(ui_sprite_layer_t *layer, int id, int32_t x, int32_t y);
+void ui_sprite_set_src(ui_sprite_layer_t *layer, int id, const lv_image_dsc_t *src);
+void ui_sprite_set_visible(ui_sprite_layer_t *layer, int id, bool visible);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#include "ui_theme.h"
+
+lv_style_t ui_style_row;
+lv_style_t ui_style_row_solid;
+lv_style_t ui_style_row_clear;
+lv_style_t ui_style_pad_menu;
+lv_style_t ui_style_pad_item;
+lv_style_t ui_style_pad_forecast;
+lv_style_t ui_style_pad_none;
+lv_style_t ui_style_title;
+lv_style_t ui_style_text;
+lv_style_t ui_style_text_small;
+
+static bool initialized = false;
+
+static void ui_theme_pad(lv_style_t *style, int32_t left, int32_t right, int32_t top, int32_t bottom)
+{
+      lv_style_init(style);
+      lv_style_set_pad_left(style, left);
+      lv_style_set_pad_right(style, right);
+      lv_style_set_pad_top(style, top);
+      lv_style_set_pad_bottom(style, bottom);
+}
+
+void ui_theme_init(void)
+{
+      if (initialized)
+      {
+            return;
+      }
+      initialized = true;
+
+      lv_style_init(&ui_style_row);
+      lv_style_set_radius(&ui_style_row, 0);
+      lv_style_set_border_color(&ui_style_row, lv_color_hex(0xFFFFFF));
+      lv_style_set_border_opa(&ui_style_row, 255);
+      lv_style_set_border_width(&ui_style_row, 1);
+      lv_style_set_border_side(&ui_style_row, LV_BORDER_SIDE_BOTTOM);
+
+      lv_style_init(&ui_style_row_solid);
+      lv_style_set_bg_color(&ui_style_row_solid, lv_color_hex(0x000000));
+      lv_style_set_bg_opa(&ui_style_row_solid, 255);
+
+      lv_style_init(&ui_style_row_clear);
+      lv_style_set_bg_opa(&ui_style_row_clear, 0);
+
+      ui_theme_pad(&ui_style_pad_menu, 0, 0, 0, 5);
+      ui_theme_pad(&ui_style_pad_item, 5, 5, 5, 5);
+      ui_theme_pad(&ui_style_pad_forecast, 5, 5, 0, 10);
+      ui_theme_pad(&ui_style_pad_none, 0, 0, 0, 0);
+
+      lv_style_init(&ui_style_title);
+      lv_style_set_text_font(&ui_style_title, &lv_font_montserrat_20);
+
+      lv_style_init(&ui_style_text);
+      lv_style_set_text_font(&ui_style_text, &lv_font_montserrat_16);
+
+      lv_style_init(&ui_style_text_small);
+      lv_style_set_text_font(&ui_style_text_small, &lv_font_montserrat_14);
+}
+
+lv_obj_t *ui_theme_row_create(lv_obj_t *parent, int32_t w, int32_t h, bool solid)
+{
+      lv_obj_t *row = lv_obj_create(parent);
+      lv_obj_set_width(row, w);
+      lv_obj_set_height(row, h);
+      lv_obj_set_align(row, LV_ALIGN_CENTER);
+      lv_obj_remove_flag(row, LV_OBJ_FLAG_SCROLLABLE); /// Flags
+      lv_obj_add_style(row, &ui_style_row, LV_PART_MAIN | LV_STATE_DEFAULT);
+      lv_obj_add_style(row, solid ? &ui_style_row_solid : &ui_style_row_clear, LV_PART_MAIN | LV_STATE_DEFAULT);
+      return row;
+}
@@ -0,0 +1,39 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#ifndef _C3_WATCH_UI_THEME_H
+#define _C3_WATCH_UI_THEME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+// Shared styles for the list rows built at runtime (apps, notifications, weather, files...)
+// One static lv_style_t is referenced by every row instead of each row carrying its own local styles.
+
+extern lv_style_t ui_style_row;       // square row with a white bottom separator
+extern lv_style_t ui_style_row_solid; // opaque black background
+extern lv_style_t ui_style_row_clear; // transparent background
+extern lv_style_t ui_style_pad_menu;  // app/game list rows
+extern lv_style_t ui_style_pad_item;  // notification rows
+extern lv_style_t ui_style_pad_forecast;
+extern lv_style_t ui_style_pad_none;
+extern lv_style_t ui_style_title;     // montserrat 20
+extern lv_style_t ui_style_text;      // montserrat 16
+extern lv_style_t ui_style_text_small; // montserrat 14
+
+void ui_theme_init(void);
+
+// row panel with the shared row styles, not scrollable
+lv_obj_t *ui_theme_row_create(lv_obj_t *parent, int32_t w, int32_t h, bool solid);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
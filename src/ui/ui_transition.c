@@ -0,0 +1,229 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#include "ui_transition.h"
+#include "display/lv_display_private.h"
+
+typedef struct
+{
+      lv_obj_t *from;
+      lv_obj_t *to;
+      lv_obj_t *fromImage;
+      lv_draw_buf_t *fromBuf;
+      lv_screen_load_anim_t anim;
+      int32_t w;
+      int32_t h;
+      bool running;
+} ui_transition_t;
+
+static ui_transition_t transition;
+static bool snapshotEnabled = true;
+
+static void ui_transition_free(void)
+{
+      if (transition.fromImage != NULL)
+      {
+            lv_obj_delete(transition.fromImage);
+            transition.fromImage = NULL;
+      }
+      if (transition.fromBuf != NULL)
+      {
+            lv_draw_buf_destroy(transition.fromBuf);
+            transition.fromBuf = NULL;
+      }
+}
+
+// the buffer plus the reserve, so the load itself does not starve the rest of the ui
+static bool ui_transition_alloc(int32_t w, int32_t h)
+{
+      transition.fromBuf = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_NATIVE, 0);
+      void *reserve = lv_malloc(UI_TRANSITION_RESERVE);
+      if (transition.fromBuf == NULL || reserve == NULL)
+      {
+            lv_free(reserve);
+            ui_transition_free();
+            return false;
+      }
+      lv_free(reserve);
+      return true;
+}
+
+static void ui_transition_exec(void *var, int32_t v)
+{
+      LV_UNUSED(var);
+      int32_t w = transition.w;
+      int32_t h = transition.h;
+      int32_t dx = w * v / UI_TRANSITION_STEPS;
+      int32_t dy = h * v / UI_TRANSITION_STEPS;
+
+      switch (transition.anim)
+      {
+      case LV_SCR_LOAD_ANIM_OVER_LEFT:
+            lv_obj_set_x(transition.to, w - dx);
+            break;
+      case LV_SCR_LOAD_ANIM_OVER_RIGHT:
+            lv_obj_set_x(transition.to, dx - w);
+            break;
+      case LV_SCR_LOAD_ANIM_OVER_TOP:
+            lv_obj_set_y(transition.to, h - dy);
+            break;
+      case LV_SCR_LOAD_ANIM_OVER_BOTTOM:
+            lv_obj_set_y(transition.to, dy - h);
+            break;
+      case LV_SCR_LOAD_ANIM_MOVE_LEFT:
+            lv_obj_set_x(transition.to, w - dx);
+            lv_obj_set_x(transition.fromImage, -dx);
+            break;
+      case LV_SCR_LOAD_ANIM_MOVE_RIGHT:
+            lv_obj_set_x(transition.to, dx - w);
+            lv_obj_set_x(transition.fromImage, dx);
+            break;
+      case LV_SCR_LOAD_ANIM_MOVE_TOP:
+            lv_obj_set_y(transition.to, h - dy);
+            lv_obj_set_y(transition.fromImage, -dy);
+            break;
+      case LV_SCR_LOAD_ANIM_MOVE_BOTTOM:
+            lv_obj_set_y(transition.to, dy - h);
+            lv_obj_set_y(transition.fromImage, dy);
+            break;
+      case LV_SCR_LOAD_ANIM_OUT_LEFT:
+            lv_obj_set_x(transition.fromImage, -dx);
+            break;
+      case LV_SCR_LOAD_ANIM_OUT_RIGHT:
+            lv_obj_set_x(transition.fromImage, dx);
+            break;
+      case LV_SCR_LOAD_ANIM_OUT_TOP:
+            lv_obj_set_y(transition.fromImage, -dy);
+            break;
+      case LV_SCR_LOAD_ANIM_OUT_BOTTOM:
+            lv_obj_set_y(transition.fromImage, dy);
+            break;
+      case LV_SCR_LOAD_ANIM_FADE_IN:
+            lv_obj_set_style_opa(transition.to, LV_OPA_COVER * v / UI_TRANSITION_STEPS, 0);
+            break;
+      case LV_SCR_LOAD_ANIM_FADE_OUT:
+            lv_obj_set_style_image_opa(transition.fromImage, LV_OPA_COVER - LV_OPA_COVER * v / UI_TRANSITION_STEPS, 0);
+            break;
+      default:
+            break;
+      }
+}
+
+// another load replaces the incoming screen before the animation ended, e.g. a plain
+// lv_screen_load: finish first so the screen is shown and the buffers are released
+static void ui_transition_unload(lv_event_t *e)
+{
+      LV_UNUSED(e);
+      ui_transition_finish();
+}
+
+static void ui_transition_ready(lv_anim_t *a)
+{
+      LV_UNUSED(a);
+      ui_transition_finish();
+}
+
+static void ui_transition_live(lv_obj_t *screen, lv_screen_load_anim_t anim, uint32_t time, uint32_t delay)
+{
+      lv_screen_load_anim(screen, anim, time, delay, false);
+}
+
+void ui_transition_load(lv_obj_t *screen, lv_screen_load_anim_t anim, uint32_t time, uint32_t delay)
+{
+      if (transition.running)
+      {
+            ui_transition_finish();
+      }
+
+      lv_display_t *display = lv_display_get_default();
+      lv_obj_t *actScr = lv_display_get_screen_active(display);
+
+      if (!LV_USE_SNAPSHOT || !snapshotEnabled || anim == LV_SCR_LOAD_ANIM_NONE || time == 0 || delay != 0 ||
+          actScr == NULL || actScr == screen || display->scr_to_load != NULL)
+      {
+            ui_transition_live(screen, anim, time, delay);
+            return;
+      }
+
+#if LV_USE_SNAPSHOT
+      transition.w = lv_display_get_horizontal_resolution(display);
+      transition.h = lv_display_get_vertical_resolution(display);
+      if (!ui_transition_alloc(transition.w, transition.h))
+      {
+            LV_LOG_WARN("transition: no heap for the snapshot, animating live");
+            ui_transition_live(screen, anim, time, delay);
+            return;
+      }
+      // the outgoing screen as it is shown, before any of the load events
+      if (lv_snapshot_take_to_draw_buf(actScr, LV_COLOR_FORMAT_NATIVE, transition.fromBuf) != LV_RESULT_OK)
+      {
+            LV_LOG_WARN("transition: snapshot failed, animating live");
+            ui_transition_free();
+            ui_transition_live(screen, anim, time, delay);
+            return;
+      }
+
+      lv_obj_send_event(actScr, LV_EVENT_SCREEN_UNLOAD_START, NULL);
+      lv_obj_send_event(screen, LV_EVENT_SCREEN_LOAD_START, NULL);
+
+      transition.from = actScr;
+      transition.to = screen;
+      transition.anim = anim;
+      transition.running = true;
+
+      // the new screen is active right away like with lv_screen_load_anim and animated
+      // live, the old one is only its bitmap: on the top layer when it moves or fades
+      // over the new screen, on the bottom layer where the new one does not cover it
+      display->act_scr = screen;
+      display->prev_scr = NULL;
+      lv_obj_add_event_cb(screen, ui_transition_unload, LV_EVENT_SCREEN_UNLOAD_START, NULL);
+
+      bool fromOnTop = anim == LV_SCR_LOAD_ANIM_FADE_OUT || (anim >= LV_SCR_LOAD_ANIM_OUT_LEFT && anim <= LV_SCR_LOAD_ANIM_OUT_BOTTOM);
+      transition.fromImage = lv_image_create(fromOnTop ? lv_layer_top() : lv_layer_bottom());
+      lv_image_set_src(transition.fromImage, transition.fromBuf);
+      lv_obj_remove_flag(transition.fromImage, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE); /// Flags
+      ui_transition_exec(NULL, 0);
+
+      lv_anim_t a;
+      lv_anim_init(&a);
+      lv_anim_set_var(&a, &transition);
+      lv_anim_set_exec_cb(&a, ui_transition_exec);
+      lv_anim_set_values(&a, 0, UI_TRANSITION_STEPS);
+      lv_anim_set_duration(&a, time);
+      lv_anim_set_completed_cb(&a, ui_transition_ready);
+      lv_anim_start(&a);
+#endif
+}
+
+void ui_transition_finish(void)
+{
+      if (!transition.running)
+      {
+            return;
+      }
+      transition.running = false;
+      lv_anim_delete(&transition, ui_transition_exec);
+      ui_transition_free();
+      lv_obj_remove_event_cb(transition.to, ui_transition_unload);
+
+      lv_obj_set_pos(transition.to, 0, 0);
+      lv_obj_remove_local_style_prop(transition.to, LV_STYLE_OPA, 0);
+      lv_obj_invalidate(transition.to);
+      lv_obj_send_event(transition.to, LV_EVENT_SCREEN_LOADED, NULL);
+      lv_obj_send_event(transition.from, LV_EVENT_SCREEN_UNLOADED, NULL);
+      transition.from = NULL;
+      transition.to = NULL;
+}
+
+void ui_transition_set_snapshot(bool enable)
+{
+      snapshotEnabled = enable;
+}
+
+bool ui_transition_running(void)
+{
+      return transition.running;
+}
@@ -0,0 +1,45 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#ifndef _C3_WATCH_UI_TRANSITION_H
+#define _C3_WATCH_UI_TRANSITION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+#define UI_TRANSITION_STEPS 256           // animation resolution
+#define UI_TRANSITION_RESERVE (16 * 1024) // heap that must stay free next to the snapshot
+
+/*
+ * Screen loads with the same animations as lv_screen_load_anim. The outgoing screen is
+ * rendered once into a draw buffer and only its bitmap is moved and faded, its tree is
+ * not drawn again; the incoming screen is animated live as lv_screen_load_anim does.
+ * The snapshot takes one full-screen buffer plus UI_TRANSITION_RESERVE of heap, about
+ * 128 KB at 240x240 in RGB565. The screen events are sent as usual: *_START after the
+ * snapshot, LOADED/UNLOADED when the animation ends. Loading another screen while it
+ * runs, with this or with lv_screen_load*, finishes it first.
+ *
+ * Falls back to lv_screen_load_anim when snapshots are disabled, the buffer does not fit
+ * in the heap, the snapshot fails, a delay is given or a live load is still running.
+ */
+void ui_transition_load(lv_obj_t *screen, lv_screen_load_anim_t anim, uint32_t time, uint32_t delay);
+
+// end a running snapshot transition right away
+void ui_transition_finish(void);
+
+// use snapshots when possible (default) or always animate the live screens
+void ui_transition_set_snapshot(bool enable);
+
+bool ui_transition_running(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
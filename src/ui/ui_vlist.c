@@ -0,0 +1,170 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#include "ui_vlist.h"
+
+static int32_t ui_vlist_stride(ui_vlist_t *vlist)
+{
+      return vlist->rowHeight + lv_obj_get_style_pad_row(vlist->list, LV_PART_MAIN);
+}
+
+static lv_obj_t *ui_vlist_spacer(lv_obj_t *parent)
+{
+      lv_obj_t *spacer = lv_obj_create(parent);
+      lv_obj_remove_style_all(spacer);
+      lv_obj_set_width(spacer, 1);
+      lv_obj_remove_flag(spacer, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE); /// Flags
+      lv_obj_add_flag(spacer, LV_OBJ_FLAG_HIDDEN);
+      return spacer;
+}
+
+// a spacer stands in for hidden rows, including the gaps between them
+static void ui_vlist_spacer_set(ui_vlist_t *vlist, lv_obj_t *spacer, int32_t rows)
+{
+      if (rows <= 0)
+      {
+            lv_obj_add_flag(spacer, LV_OBJ_FLAG_HIDDEN);
+            return;
+      }
+      lv_obj_set_height(spacer, rows * ui_vlist_stride(vlist) - lv_obj_get_style_pad_row(vlist->list, LV_PART_MAIN));
+      lv_obj_remove_flag(spacer, LV_OBJ_FLAG_HIDDEN);
+}
+
+// the list may have been cleaned and filled directly (addListDrive...) since ui_vlist_set
+static bool ui_vlist_attached(ui_vlist_t *vlist)
+{
+      return vlist->rows > 0 && lv_obj_get_child_count(vlist->list) == (uint32_t)vlist->rows + 2 &&
+             lv_obj_get_child(vlist->list, 0) == vlist->top;
+}
+
+static int32_t ui_vlist_first(ui_vlist_t *vlist)
+{
+      int32_t offset = lv_obj_get_scroll_y(vlist->list) - lv_obj_get_style_pad_top(vlist->list, LV_PART_MAIN);
+      int32_t first = (offset > 0 ? offset / ui_vlist_stride(vlist) : 0) - UI_VLIST_MARGIN;
+      if (first > vlist->count - vlist->rows)
+      {
+            first = vlist->count - vlist->rows;
+      }
+      return first < 0 ? 0 : first;
+}
+
+static void ui_vlist_place(ui_vlist_t *vlist, int32_t first)
+{
+      int32_t shift = first - vlist->first;
+
+      if (shift > 0 && shift < vlist->rows)
+      {
+            // rows scrolled out at the top are reused at the bottom, the rest keep their binding
+            for (int32_t i = 0; i < shift; i++)
+            {
+                  lv_obj_t *row = lv_obj_get_child(vlist->list, 1);
+                  lv_obj_move_to_index(row, vlist->rows);
+                  vlist->bind(row, vlist->first + vlist->rows + i);
+            }
+      }
+      else if (shift < 0 && -shift < vlist->rows)
+      {
+            for (int32_t i = 0; i < -shift; i++)
+            {
+                  lv_obj_t *row = lv_obj_get_child(vlist->list, vlist->rows);
+                  lv_obj_move_to_index(row, 1);
+                  vlist->bind(row, vlist->first - 1 - i);
+            }
+      }
+      else
+      {
+            for (int32_t i = 0; i < vlist->rows; i++)
+            {
+                  vlist->bind(lv_obj_get_child(vlist->list, 1 + i), first + i);
+            }
+      }
+
+      vlist->first = first;
+      ui_vlist_spacer_set(vlist, vlist->top, first);
+      ui_vlist_spacer_set(vlist, vlist->bottom, vlist->count - first - vlist->rows);
+}
+
+static void ui_vlist_scroll(lv_event_t *e)
+{
+      ui_vlist_t *vlist = (ui_vlist_t *)lv_event_get_user_data(e);
+      if (vlist->updating || !ui_vlist_attached(vlist))
+      {
+            return;
+      }
+
+      int32_t first = ui_vlist_first(vlist);
+      if (first == vlist->first)
+      {
+            return;
+      }
+
+      vlist->updating = true;
+      ui_vlist_place(vlist, first);
+      // the rows moved, let onScroll place them on the circle again
+      lv_obj_update_layout(vlist->list);
+      lv_obj_send_event(vlist->list, LV_EVENT_SCROLL, NULL);
+      vlist->updating = false;
+}
+
+void ui_vlist_init(ui_vlist_t *vlist, lv_obj_t *list, int32_t rowHeight, ui_vlist_create_cb_t create)
+{
+      vlist->list = list;
+      vlist->top = NULL;
+      vlist->bottom = NULL;
+      vlist->create = create;
+      vlist->bind = NULL;
+      vlist->rowHeight = rowHeight;
+      vlist->count = 0;
+      vlist->first = 0;
+      vlist->rows = 0;
+      vlist->updating = false;
+      lv_obj_add_event_cb(list, ui_vlist_scroll, LV_EVENT_SCROLL, vlist);
+}
+
+void ui_vlist_set(ui_vlist_t *vlist, int32_t count, ui_vlist_bind_cb_t bind)
+{
+      lv_obj_clean(vlist->list);
+      vlist->top = ui_vlist_spacer(vlist->list);
+      vlist->bind = bind;
+      vlist->count = count;
+      vlist->first = 0;
+
+      int32_t height = lv_obj_get_height(vlist->list);
+      if (height <= 0)
+      {
+            height = lv_display_get_vertical_resolution(lv_obj_get_display(vlist->list));
+      }
+      vlist->rows = height / ui_vlist_stride(vlist) + 1 + 2 * UI_VLIST_MARGIN;
+      if (vlist->rows > UI_VLIST_MAX_ROWS)
+      {
+            vlist->rows = UI_VLIST_MAX_ROWS;
+      }
+      if (vlist->rows > count)
+      {
+            vlist->rows = count;
+      }
+
+      for (int32_t i = 0; i < vlist->rows; i++)
+      {
+            lv_obj_t *row = vlist->create(vlist->list);
+            lv_obj_set_height(row, vlist->rowHeight);
+      }
+      vlist->bottom = ui_vlist_spacer(vlist->list);
+
+      ui_vlist_place(vlist, 0);
+}
+
+void ui_vlist_refresh(ui_vlist_t *vlist)
+{
+      if (!ui_vlist_attached(vlist))
+      {
+            return;
+      }
+      for (int32_t i = 0; i < vlist->rows; i++)
+      {
+            vlist->bind(lv_obj_get_child(vlist->list, 1 + i), vlist->first + i);
+      }
+}
@@ -0,0 +1,54 @@
+/*
+    Copyright (c) 2024 Felix Biego. All rights reserved.
+    This work is licensed under the terms of the MIT license.  
+    For a copy, see <https://opensource.org/licenses/MIT>.
+*/
+
+#ifndef _C3_WATCH_UI_VLIST_H
+#define _C3_WATCH_UI_VLIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+#define UI_VLIST_MAX_ROWS 16 // pooled row objects per list
+#define UI_VLIST_MARGIN 2    // rows kept bound above and below the viewport
+
+typedef lv_obj_t *(*ui_vlist_create_cb_t)(lv_obj_t *parent);
+typedef void (*ui_vlist_bind_cb_t)(lv_obj_t *row, int32_t index);
+
+/*
+ * Virtual list on top of an existing flex column list (ui_messageList, ui_fileManagerPanel).
+ * Only the rows around the viewport exist, they are created once with create and rebound
+ * to data indices with bind while scrolling. Two spacers keep the scroll range of the
+ * full list so onScroll and the circular look keep working. Rows must have a fixed height.
+ */
+typedef struct
+{
+      lv_obj_t *list;
+      lv_obj_t *top;
+      lv_obj_t *bottom;
+      ui_vlist_create_cb_t create;
+      ui_vlist_bind_cb_t bind;
+      int32_t rowHeight;
+      int32_t count;
+      int32_t first;
+      int32_t rows;
+      bool updating;
+} ui_vlist_t;
+
+void ui_vlist_init(ui_vlist_t *vlist, lv_obj_t *list, int32_t rowHeight, ui_vlist_create_cb_t create);
+
+// clear the list and show count items, bind is called for the rows that become visible
+void ui_vlist_set(ui_vlist_t *vlist, int32_t count, ui_vlist_bind_cb_t bind);
+
+// rebind the visible rows, e.g. after the data behind them changed
+void ui_vlist_refresh(ui_vlist_t *vlist);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
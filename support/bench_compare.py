@@ -0,0 +1,42 @@
+import csv
+import sys
+
+# Side by side view of a bench_<w>x<h>.csv from the linux_bench envs:
+# one line per row name, the first mode of each kind is the baseline the others are compared to
+#   python support/bench_compare.py bench_240x240.csv [kind ...]
+# e.g. `styles`, `list`, `scroll` or `sprites`, every kind when none is given
+
+if len(sys.argv) < 2:
+    print("usage: bench_compare.py <bench.csv> [kind ...]")
+    sys.exit(1)
+
+kinds = sys.argv[2:]
+rows = {}
+order = []
+with open(sys.argv[1], newline="") as f:
+    for row in csv.DictReader(f):
+        if kinds and row["kind"] not in kinds:
+            continue
+        key = (row["resolution"], row["kind"], row["name"])
+        if key not in rows:
+            rows[key] = []
+            order.append(key)
+        rows[key].append(row)
+
+
+def ratio(value, base):
+    return f"{value / base:.2f}x" if base > 0 else "-"
+
+
+print(f"{'kind':<10} {'name':<28} {'mode':<12} {'ms':>9} {'pixels':>9} {'areas':>7} {'heap':>10}  vs first")
+for key in order:
+    resolution, kind, name = key
+    base = rows[key][0]
+    for row in rows[key]:
+        ms = float(row["ms_per_frame"])
+        heap = int(row["heap_used"])
+        versus = ""
+        if row is not base:
+            versus = f"ms {ratio(ms, float(base['ms_per_frame']))}, heap {ratio(heap, int(base['heap_used']))}"
+        print(f"{kind:<10} {name:<28} {row['mode']:<12} {ms:>9.3f} {row['pixels_per_frame']:>9} "
+              f"{row['areas_per_frame']:>7} {heap:>10}  {versus}")
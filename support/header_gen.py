@@ -1,4 +1,6 @@
 import os
+import re
+import sys
 
 # Folders to scan
 include_dirs = [
@@ -7,8 +9,15 @@ include_dirs = [
     "src/faces"
 ]
 
-# Output header file
+# Folders with REGISTER_APP sources
+app_dirs = [
+    "src/apps",
+    "src/games"
+]
+
+# Output header files
 output_file = "src/common/generated_features.h"
+apps_file = "src/common/generated_apps.h"
 
 with open(output_file, "w") as f:
     f.write("// Auto-generated header includes\n// DO NOT EDIT this file\n// It will be overwritten\n")
@@ -23,3 +32,106 @@ with open(output_file, "w") as f:
                     f.write(f'#include "{rel_path}"\n')
 
 print(f"🔄 Generated: {output_file}")
+
+# REGISTER_APP("Title", icon, screen_var, ...) or REGISTER_APP_HOOKS and the #if blocks around it
+register_re = re.compile(r'^\s*REGISTER_APP(?:_HOOKS)?\(\s*"((?:[^"\\]|\\.)*)"\s*,[^,]*,\s*(\w+)\s*,')
+directive_re = re.compile(r'^\s*#\s*(\w+)\s*(.*)$')
+comment_re = re.compile(r'/\*.*?\*/|//.*$')
+identifier_re = re.compile(r'\b[A-Za-z_]\w*\b')
+
+
+def fail(path, lineno, message):
+    sys.exit(f"❌ {path}:{lineno}: {message}")
+
+
+# A guard is the condition for the current branch of one #if block, as a C expression.
+# `#ifdef X` stays X so the table can use #ifdef for it.
+class Guard:
+    def __init__(self, condition, lineno, plain=None):
+        self.taken = [condition]  # conditions of the branches so far
+        self.condition = condition
+        self.lineno = lineno
+        self.plain = plain
+
+    def branch(self, condition):
+        earlier = " || ".join(self.taken)
+        self.condition = f"!({earlier})" if condition is None else f"!({earlier}) && ({condition})"
+        if condition is not None:
+            self.taken.append(f"({condition})")
+        self.plain = None
+
+
+def check_guard(path, lineno, guard):
+    # the table is compiled in app_manager.c, which only sees the build flags
+    for name in identifier_re.findall(guard.condition):
+        if name != "defined" and not name.startswith("ENABLE_"):
+            fail(path, lineno, f"REGISTER_APP under a guard on {name} (line {guard.lineno}), "
+                               "only ENABLE_ build flags can guard an app")
+
+
+def scan_apps(path):
+    found = []
+    guards = []
+    with open(path, encoding="utf-8", errors="ignore") as src:
+        lines = src.read().split("\n")
+    lineno = 0
+    while lineno < len(lines):
+        line = lines[lineno]
+        lineno += 1
+        start = lineno
+        while line.endswith("\\") and lineno < len(lines):
+            line = line[:-1] + " " + lines[lineno]
+            lineno += 1
+
+        directive = directive_re.match(line)
+        if directive is None:
+            match = register_re.match(line)
+            if match:
+                for guard in guards:
+                    check_guard(path, start, guard)
+                found.append((match.group(1), match.group(2), [(g.plain, g.condition) for g in guards]))
+            continue
+
+        keyword = directive.group(1)
+        argument = comment_re.sub("", directive.group(2)).strip()
+        if keyword in ("ifdef", "ifndef", "if", "elif") and not argument:
+            fail(path, start, f"#{keyword} without a condition")
+        if keyword == "ifdef":
+            guards.append(Guard(f"defined({argument})", start, argument))
+        elif keyword == "ifndef":
+            guards.append(Guard(f"!defined({argument})", start))
+        elif keyword == "if":
+            guards.append(Guard(f"({argument})", start))
+        elif keyword in ("elif", "else", "endif"):
+            if not guards:
+                fail(path, start, f"#{keyword} without #if")
+            if keyword == "endif":
+                guards.pop()
+            else:
+                guards[-1].branch(argument if keyword == "elif" else None)
+    if guards:
+        fail(path, guards[-1].lineno, "#if without #endif")
+    return found
+
+
+apps = []
+for directory in app_dirs:
+    for root, dirs, files in os.walk(directory):
+        for file in files:
+            if file.endswith(".c"):
+                apps.extend(scan_apps(os.path.join(root, file).replace("\\", "/")))
+
+# the registry walks this list as is, so it is sorted here the way strcmp would
+apps.sort(key=lambda app: app[0].encode("utf-8"))
+
+with open(apps_file, "w") as f:
+    f.write("// Auto-generated app table, sorted by title\n// DO NOT EDIT this file\n// It will be overwritten\n")
+    for title, screen_var, guards in apps:
+        f.write(f"\n// {title}\n")
+        for plain, condition in guards:
+            f.write(f"#ifdef {plain}\n" if plain else f"#if {condition}\n")
+        f.write(f"APP_ENTRY({screen_var})\n")
+        for guard in guards:
+            f.write("#endif\n")
+
+print(f"🔄 Generated: {apps_file}")
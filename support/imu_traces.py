@@ -0,0 +1,171 @@
+import math
+import sys
+
+# Writes the IMU traces the unit tests replay, in the SENSOR_CSV format
+# (t_ms,ax,ay,az,gx,gy,gz in g and deg/s):
+#   test_activity/walk.csv    a wrist on a walk with a stop, the true step count in its header
+#   test_activity/wrist.csv   desk work, typing, arm gestures and slow wrist turns, no steps
+#   test_wrist_wake/wake.csv  walks, desk work and turns with raises and tilts to look at
+#                             the watch, the true counts in its header
+# They are synthetic and the output is the same on every run:
+#   python support/imu_traces.py [test dir]
+
+SOURCE_HZ = 100  # the motion is sampled at this rate
+RATE_HZ = 25  # and averaged down to the activity stream rate, as the sensor service does
+test_dir = sys.argv[1] if len(sys.argv) > 1 else "test"
+
+seed = 7
+
+
+def noise(amplitude):
+    # same generator as the C tests, so a change here is easy to follow there
+    global seed
+    seed = (seed * 1103515245 + 12345) & 0xFFFFFFFF
+    return (((seed >> 16) & 0x7FFF) - 0x4000) * amplitude / 0x4000
+
+
+def write(name, comment, rows):
+    ratio = SOURCE_HZ // RATE_HZ
+    with open(f"{test_dir}/{name}", "w", newline="\n") as f:
+        for line in comment:
+            f.write(f"# {line}\n")
+        f.write("t_ms,ax,ay,az,gx,gy,gz\n")
+        for i in range(0, len(rows) - ratio + 1, ratio):
+            # stamped with the last sample of the average
+            group = rows[i:i + ratio]
+            row = [group[-1][0]] + [sum(r[c] for r in group) / ratio for c in range(1, 7)]
+            f.write(f"{row[0]},{row[1]:.3f},{row[2]:.3f},{row[3]:.3f},{row[4]:.1f},{row[5]:.1f},{row[6]:.1f}\n")
+
+
+def sample(t, pitch, roll, g, turn):
+    # accelerometer of a wrist at pitch and roll (radians) with g along the screen normal,
+    # the gyro from how fast the pose turns
+    dt = 1.0 / SOURCE_HZ
+    ax = -math.sin(pitch) * g + noise(0.03)
+    ay = math.cos(pitch) * math.sin(roll) * g + noise(0.03)
+    az = math.cos(pitch) * math.cos(roll) * g + noise(0.03)
+    gx = math.degrees(turn[1]) / dt + noise(1.0)
+    gy = math.degrees(turn[0]) / dt + noise(1.0)
+    gz = noise(1.0)
+    return (round(t * 1000), ax, ay, az, gx, gy, gz)
+
+
+# 120 s at about 105 steps per minute with +-5% timing jitter, standing still from 50 s
+# to 65 s. A step counts once it is done, if it was walked.
+def walk():
+    spm, amplitude, seconds = 105, 0.25, 120
+    stop_from, stop_to = 50.0, 65.0
+    step_start, step_length = 0.0, 60.0 / spm
+    index, steps = 0, 0
+    rows = []
+    last = (0.6, 0.0)
+    for i in range(seconds * SOURCE_HZ):
+        t = i / SOURCE_HZ
+        if t >= step_start + step_length:
+            middle = step_start + step_length / 2
+            steps += 0 if stop_from <= middle < stop_to else 1
+            step_start += step_length
+            step_length = 60.0 / spm * (1.0 + noise(0.05))
+            index += 1
+        phase = (t - step_start) / step_length
+        impact = 0.0
+        if not stop_from <= t < stop_to:
+            # the impact once per step, the arm swing at half the step rate
+            impact = amplitude * math.sin(2 * math.pi * phase) + 0.3 * amplitude * math.sin(math.pi * (index + phase))
+        pitch, roll = 0.6 + 0.3 * math.sin(0.05 * t), 0.4 * math.sin(0.031 * t)
+        rows.append(sample(t, pitch, roll, 1.0 + impact, (pitch - last[0], roll - last[1])))
+        last = (pitch, roll)
+    return rows, steps
+
+
+# 120 s in four parts: resting on the desk, typing, gestures (one to three jerks, then
+# a rest of 1 to 5 s) and the wrist slowly turned over and back
+def wrist():
+    seconds = 120
+    gesture_start, gesture_end = 60.0, 0.0
+    rows = []
+    last = (0.35, 0.0)
+    for i in range(seconds * SOURCE_HZ):
+        t = i / SOURCE_HZ
+        pitch, roll, shake = 0.35, 0.0, 0.0
+        if 30 <= t < 60:
+            # keystrokes at 4 to 8 per second
+            shake = 0.08 * abs(math.sin(2 * math.pi * (3.0 + math.sin(0.7 * t)) * t)) + noise(0.02)
+        elif 60 <= t < 90:
+            if t >= gesture_start:
+                gesture_end = t + 0.4 + abs(noise(0.8))
+                gesture_start = gesture_end + 1.0 + abs(noise(4.0))
+            if t < gesture_end:
+                shake = 0.4 * math.sin(2 * math.pi * 2.7 * t)
+        elif t >= 90:
+            roll = math.pi * (1 - math.cos(2 * math.pi * (t - 90) / 30)) / 2
+        rows.append(sample(t, pitch, roll, 1.0 + shake, (pitch - last[0], roll - last[1])))
+        last = (pitch, roll)
+    return rows
+
+
+# About two minutes of a day: typing at a desk with three flicks of the wrist to look
+# at the watch, the watch slowly turned over and back, the arm lowered, then walking
+# with the arm hanging and a raise to look twice, standing still and a last raise.
+# Every part starts where the one before ends. Angles in degrees.
+def wake():
+    hang, up = -80.0, 20.0
+    swing = 10 / 0.9  # ten arm swings, back where they started
+
+    def typing(t):
+        return up + 5 * math.sin(0.7 * t), 10 * math.sin(0.3 * t), noise(0.15)
+
+    def flick(t):
+        # turned away in 0.25 s, 0.2 s there, back in 0.25 s
+        k = min(t / 0.25, 1.0) if t < 0.45 else max(1.0 - (t - 0.45) / 0.25, 0.0)
+        return up, -90 * k, 0.0
+
+    def turn_over(t):
+        return up, 180 * (1 - math.cos(2 * math.pi * t / 30)) / 2, 0.0
+
+    def lower(t):
+        k = min(t / 0.5, 1.0)
+        return up * (1 - k), hang * k, 0.0
+
+    def walking(t):
+        return 10 * math.sin(2 * math.pi * 0.9 * t), hang + 25 * math.sin(2 * math.pi * 0.9 * t), \
+            0.3 * math.sin(2 * math.pi * 1.8 * t)
+
+    def raise_and_look(t):
+        # raised in 0.5 s, looked at for 3 s, lowered in 0.5 s
+        k = min(t / 0.5, 1.0) if t < 3.5 else max(1.0 - (t - 3.5) / 0.5, 0.0)
+        return up * k, hang * (1 - k), 0.0
+
+    def still(t):
+        return 0.0, hang, 0.0
+
+    segments = [(8, typing), (0.7, flick)] * 3 + [(8, typing), (30, turn_over), (1, lower)]
+    segments += [(swing, walking), (4, raise_and_look)] * 2 + [(6, still), (4, raise_and_look), (swing, walking)]
+    raises = sum(1 for _, pose in segments if pose is raise_and_look)
+    tilts = sum(1 for _, pose in segments if pose is flick)
+
+    rows = []
+    start = 0
+    last = None
+    for length, pose in segments:
+        count = round(length * SOURCE_HZ)
+        for i in range(count):
+            pitch, roll, shake = pose(i / SOURCE_HZ)
+            pitch, roll = math.radians(pitch), math.radians(roll)
+            last = last or (pitch, roll)
+            rows.append(sample((start + i) / SOURCE_HZ, pitch, roll, 1.0 + shake, (pitch - last[0], roll - last[1])))
+            last = (pitch, roll)
+        start += count
+    return rows, raises, tilts
+
+
+rows, steps = walk()
+write("test_activity/walk.csv", [f"synthetic wrist on a walk, {RATE_HZ} Hz, written by support/imu_traces.py",
+                                 f"steps: {steps}"], rows)
+write("test_activity/wrist.csv",
+      [f"synthetic wrist that does not walk, {RATE_HZ} Hz, written by support/imu_traces.py", "steps: 0"], wrist())
+rows, raises, tilts = wake()
+write("test_wrist_wake/wake.csv",
+      [f"synthetic wrist raised and tilted to look at the watch, {RATE_HZ} Hz, written by support/imu_traces.py",
+       f"raises: {raises}", f"tilts: {tilts}"], rows)
+print(f"walk.csv {steps} steps, wrist.csv 0 steps, wake.csv {raises} raises and {tilts} tilts")
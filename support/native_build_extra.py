@@ -0,0 +1,7 @@
+Import("env", "projenv")
+
+for e in [ env, projenv ]:
+    # Sanitizers need their runtime at link time as well
+    for flag in e['CCFLAGS']:
+        if isinstance(flag, str) and flag.startswith("-fsanitize=") and flag not in e['LINKFLAGS']:
+            e.Append(LINKFLAGS = [flag])
@@ -11,6 +11,10 @@ for e in [ env, projenv ]:
     # Add via script, because `-Wl,-m32` does not work.
     if "-m32" in e['CCFLAGS']:
         e.Append(LINKFLAGS = ["-m32"])
+    # Sanitizers need their runtime at link time as well
+    for flag in e['CCFLAGS']:
+        if isinstance(flag, str) and flag.startswith("-fsanitize=") and flag not in e['LINKFLAGS']:
+            e.Append(LINKFLAGS = [flag])
     # e.Append(LINKFLAGS = ["-mwindows"])
 
 exec_name = "${BUILD_DIR}/${PROGNAME}${PROGSUFFIX}"
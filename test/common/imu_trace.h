@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "common/api.h"
+
+#define IMU_TRACE_LINE 160
+
+/*
+ * The committed IMU traces next to the suites, in the SENSOR_CSV format of the emulator
+ * replay. Header only, the suites include it as "../common/imu_trace.h".
+ */
+
+// name in the directory of source (the suite's __FILE__), or name as it is
+static inline FILE *imu_trace_open(const char *source, const char *name) {
+    char path[256];
+    const char *slash = strrchr(source, '/');
+    if (slash != NULL) {
+        snprintf(path, sizeof(path), "%.*s/%s", (int)(slash - source), source, name);
+        FILE *f = fopen(path, "r");
+        if (f != NULL) return f;
+    }
+    return fopen(name, "r");
+}
+
+// same parsing as the emulator's SENSOR_CSV replay, lines not starting with a digit
+// are skipped. Returns the sample count, fails the test if the trace is missing
+static inline int imu_trace_load(const char *source, const char *name, imu_sample_t *out, int max) {
+    FILE *f = imu_trace_open(source, name);
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, name);
+
+    char line[IMU_TRACE_LINE];
+    int count = 0;
+    while (count < max && fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] < '0' || line[0] > '9') continue;
+        imu_sample_t *s = &out[count];
+        unsigned long t;
+        memset(s, 0, sizeof(*s));
+        if (sscanf(line, "%lu,%f,%f,%f,%f,%f,%f", &t, &s->ax, &s->ay, &s->az, &s->gx, &s->gy, &s->gz) < 7) continue;
+        s->time_us = (uint32_t)(t * 1000);
+        s->temp = 25.0f;
+        count++;
+    }
+    fclose(f);
+    return count;
+}
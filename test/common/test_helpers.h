@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unity.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TEST_HAS_TSC 1
+#endif
+
+/*
+ * Shared by the native suites: the noise of the synthetic IMU traces and the clocks
+ * of the timing passes. Header only, the suites include it as "../common/test_helpers.h".
+ */
+
+// +-amplitude from a small LCG, the same on every host and in support/imu_traces.py
+static inline float noise(uint32_t *seed, float amplitude) {
+    *seed = *seed * 1103515245 + 12345;
+    return ((int32_t)(*seed >> 16 & 0x7FFF) - 0x4000) * amplitude / 0x4000;
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// time stamp counter on x86, 0 elsewhere
+static inline uint64_t now_cycles(void) {
+#ifdef TEST_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+typedef struct {
+    uint64_t ns;
+    uint64_t cycles;
+} timing_t;
+
+static inline timing_t timing_start(void) {
+    timing_t t = {now_ns(), now_cycles()};
+    return t;
+}
+
+// prints the cost of each of count runs since start and the runs per second. Only
+// informative: the figures are those of the host, not of the watch
+static inline void timing_report(const char *what, timing_t start, uint32_t count) {
+    char message[128];
+    double ns = (double)(now_ns() - start.ns) / count;
+    double cycles = (double)(now_cycles() - start.cycles) / count;
+    snprintf(message, sizeof(message), "%s: %.1f ns (%.0f cycles) each, %.2f million per second on this host", what,
+             ns, cycles, 1000.0 / ns);
+    TEST_MESSAGE(message);
+}
@@ -0,0 +1,222 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "common/activity/activity.h"
+#include "../common/test_helpers.h"
+#include "../common/imu_trace.h"
+
+#define SOURCE_HZ 100   // synthetic traces, averaged down to ACTIVITY_RATE_HZ
+#define MAX_ERROR 0.05  // of the true steps on walking traces
+#define MAX_SECONDS 240 // longest trace
+#define TIMING_SAMPLES 2000000 // samples fed in the cost pass
+
+// Traces next to this file in the SENSOR_CSV format at ACTIVITY_RATE_HZ, so the emulator
+// can replay them too. They are synthetic, written by support/imu_traces.py with
+// the true steps in their header; a recording with a counted step total fits the same.
+#define WALK_CSV "walk.csv"
+#define WALK_STEPS 184
+#define WRIST_CSV "wrist.csv"
+
+typedef struct {
+    const char *name;
+    float spm;       // 0 for no walking
+    float amplitude; // g of the step impact
+    int seconds;
+    int pauseEvery;  // a stop every n seconds, 0 for none
+    bool gestures;   // irregular arm movements instead of steps
+} trace_t;
+
+static const trace_t traces[] = {
+    {"slow walk", 80, 0.15f, 180, 0, false},
+    {"walk", 105, 0.25f, 180, 0, false},
+    {"brisk walk", 125, 0.35f, 180, 0, false},
+    {"run", 170, 0.8f, 180, 0, false},
+    {"stop and go", 110, 0.25f, 240, 40, false},
+    {"desk", 0, 0.0f, 240, 0, false},
+    {"gestures", 0, 0.4f, 240, 0, true},
+};
+
+static activity_t engine;
+static imu_sample_t samples[MAX_SECONDS * ACTIVITY_RATE_HZ];
+
+static bool paused(const trace_t *trace, float t) {
+    return trace->pauseEvery > 0 && fmodf(t, (float)trace->pauseEvery) >= trace->pauseEvery * 0.75f;
+}
+
+// A wrist on a walk: one impact cycle per step with +-5% timing jitter, the arm swing
+// at half the step rate and a slowly turning wrist. Writes the stream as the sensor
+// service averages it, returns the sample count and the true steps.
+static int synthesize(const trace_t *trace, imu_sample_t *out, int *steps) {
+    const int ratio = SOURCE_HZ / ACTIVITY_RATE_HZ;
+    const int total = trace->seconds * SOURCE_HZ;
+    const float pi = 3.14159265f;
+    uint32_t seed = 7;
+    float stepStart = 0, stepLength = trace->spm > 0 ? 60.0f / trace->spm : 1.0f;
+    float gestureStart = 1.0f, gestureEnd = 0;
+    int count = 0, index = 0;
+    imu_sample_t sum;
+    memset(&sum, 0, sizeof(sum));
+    *steps = 0;
+
+    for (int i = 0; i < total; i++) {
+        float t = (float)i / SOURCE_HZ;
+        float impact = 0;
+
+        if (trace->spm > 0) {
+            if (t >= stepStart + stepLength) {
+                // a step counts once it is done, if it was walked
+                *steps += paused(trace, stepStart + stepLength / 2) ? 0 : 1;
+                stepStart += stepLength;
+                stepLength = 60.0f / trace->spm * (1.0f + noise(&seed, 0.05f));
+                index++;
+            }
+            float phase = (t - stepStart) / stepLength;
+            if (!paused(trace, t)) {
+                impact = trace->amplitude * sinf(2.0f * pi * phase) +
+                         0.3f * trace->amplitude * sinf(pi * (index + phase));
+            }
+        } else if (trace->gestures) {
+            // one to three jerks, then a rest of 1 to 5 s
+            if (t >= gestureStart) {
+                gestureEnd = t + 0.4f + fabsf(noise(&seed, 0.8f));
+                gestureStart = gestureEnd + 1.0f + fabsf(noise(&seed, 4.0f));
+            }
+            if (t < gestureEnd) {
+                impact = trace->amplitude * sinf(2.0f * pi * 2.7f * t);
+            }
+        }
+
+        float pitch = 0.6f + 0.3f * sinf(0.05f * t), roll = 0.4f * sinf(0.031f * t);
+        float g = 1.0f + impact;
+        sum.ax += -sinf(pitch) * g + noise(&seed, 0.03f);
+        sum.ay += cosf(pitch) * sinf(roll) * g + noise(&seed, 0.03f);
+        sum.az += cosf(pitch) * cosf(roll) * g + noise(&seed, 0.03f);
+        if ((i + 1) % ratio == 0) {
+            imu_sample_t *s = &out[count++];
+            *s = sum;
+            s->ax /= ratio;
+            s->ay /= ratio;
+            s->az /= ratio;
+            s->time_us = (uint32_t)((uint64_t)(i + 1) * 1000000 / SOURCE_HZ);
+            s->temp = 25.0f;
+            memset(&sum, 0, sizeof(sum));
+        }
+    }
+    return count;
+}
+
+static void feed(const imu_sample_t *in, int count) {
+    for (int i = 0; i < count; i++) {
+        activity_feed(&engine, &in[i]);
+    }
+}
+
+// walking within MAX_ERROR of the truth, anything else a stray confirmed run at most
+static void check_steps(const char *name, uint32_t truth) {
+    char message[64];
+    snprintf(message, sizeof(message), "%s: %u steps, true %u", name, (unsigned)engine.steps, (unsigned)truth);
+    if (truth > 0) {
+        TEST_ASSERT_TRUE_MESSAGE(fabs((double)engine.steps - truth) <= truth * MAX_ERROR, message);
+    } else {
+        TEST_ASSERT_TRUE_MESSAGE(engine.steps <= ACTIVITY_CONFIRM_STEPS, message);
+    }
+}
+
+void setUp(void) {
+    activity_init(&engine);
+}
+
+void tearDown(void) {
+}
+
+static void test_synthetic_traces(void) {
+    for (size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        int truth;
+        int count = synthesize(&traces[t], samples, &truth);
+
+        activity_init(&engine);
+        feed(samples, count);
+        check_steps(traces[t].name, (uint32_t)truth);
+    }
+}
+
+static void test_walk_trace(void) {
+    int count = imu_trace_load(__FILE__, WALK_CSV, samples, sizeof(samples) / sizeof(samples[0]));
+    TEST_ASSERT_GREATER_THAN(0, count);
+
+    feed(samples, count);
+    check_steps(WALK_CSV, WALK_STEPS);
+    TEST_ASSERT_GREATER_THAN(0, engine.distance_m);
+    TEST_ASSERT_GREATER_THAN(0, engine.kcal);
+}
+
+static void test_wrist_trace_does_not_walk(void) {
+    int count = imu_trace_load(__FILE__, WRIST_CSV, samples, sizeof(samples) / sizeof(samples[0]));
+    TEST_ASSERT_GREATER_THAN(0, count);
+
+    feed(samples, count);
+    check_steps(WRIST_CSV, 0);
+}
+
+// every completed minute is binned, and the bins add up to the total
+static void test_minute_bins_add_up(void) {
+    int truth;
+    int count = synthesize(&traces[4], samples, &truth);
+    feed(samples, count);
+
+    uint8_t minutes[ACTIVITY_MINUTES];
+    uint16_t numMinutes = activity_history(&engine, minutes, ACTIVITY_MINUTES);
+    uint32_t binned = engine.minute_steps;
+    for (uint16_t m = 0; m < numMinutes; m++) {
+        binned += minutes[m];
+    }
+    // the clock starts at the first sample
+    uint32_t elapsedUs = samples[count - 1].time_us - samples[0].time_us;
+    TEST_ASSERT_EQUAL_UINT32(elapsedUs / 60000000, numMinutes);
+    TEST_ASSERT_EQUAL_UINT32(engine.steps, binned);
+}
+
+static void test_reset_keeps_the_minutes(void) {
+    int truth;
+    int count = synthesize(&traces[1], samples, &truth);
+    feed(samples, count);
+    uint8_t minutes[ACTIVITY_MINUTES];
+    uint16_t before = activity_history(&engine, minutes, ACTIVITY_MINUTES);
+
+    activity_reset(&engine);
+    TEST_ASSERT_EQUAL_UINT32(0, engine.steps);
+    TEST_ASSERT_EQUAL_UINT32(0, engine.distance_m);
+    TEST_ASSERT_EQUAL_UINT32(0, engine.kcal);
+    TEST_ASSERT_EQUAL_UINT16(before, activity_history(&engine, minutes, ACTIVITY_MINUTES));
+}
+
+// the cost of one sample on the brisk walk, printed and not asserted
+static void test_cost_per_sample(void) {
+    int truth;
+    int count = synthesize(&traces[2], samples, &truth);
+    volatile uint32_t sink = 0;
+
+    timing_t start = timing_start();
+    for (uint32_t n = 0; n < TIMING_SAMPLES; n++) {
+        imu_sample_t s = samples[n % count];
+        s.time_us = (uint32_t)((uint64_t)n * 1000000 / ACTIVITY_RATE_HZ);
+        activity_feed(&engine, &s);
+        sink = engine.steps;
+    }
+    timing_report("activity_feed", start, TIMING_SAMPLES);
+    (void)sink;
+    TEST_ASSERT_GREATER_THAN(0, engine.steps);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_synthetic_traces);
+    RUN_TEST(test_walk_trace);
+    RUN_TEST(test_wrist_trace_does_not_walk);
+    RUN_TEST(test_minute_bins_add_up);
+    RUN_TEST(test_reset_keeps_the_minutes);
+    RUN_TEST(test_cost_per_sample);
+    return UNITY_END();
+}
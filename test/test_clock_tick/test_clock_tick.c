@@ -0,0 +1,193 @@
+#include <unity.h>
+#include <stddef.h>
+#include "common/clock_tick/clock_tick.h"
+
+static clock_tick_time_t now;
+static uint32_t secondCalls;
+static uint8_t secondChanged;
+static uint32_t minuteCalls;
+static uint8_t minuteChanged;
+static uint32_t dayCalls;
+
+static void on_second(const clock_tick_time_t *time, uint8_t changed) {
+    (void)time;
+    secondCalls++;
+    secondChanged = changed;
+}
+
+static void on_minute(const clock_tick_time_t *time, uint8_t changed) {
+    (void)time;
+    minuteCalls++;
+    minuteChanged = changed;
+}
+
+static void on_day(const clock_tick_time_t *time, uint8_t changed) {
+    (void)time;
+    (void)changed;
+    dayCalls++;
+}
+
+#define FILLER(n)                                                        \
+    static void filler##n(const clock_tick_time_t *time, uint8_t changed) { \
+        (void)time;                                                          \
+        (void)changed;                                                       \
+    }
+FILLER(0)
+FILLER(1)
+FILLER(2)
+FILLER(3)
+FILLER(4)
+FILLER(5)
+FILLER(6)
+FILLER(7)
+
+// distinct callbacks, subscribing the same one again only updates its units
+static const clock_tick_cb_t fillers[] = {filler0, filler1, filler2, filler3, filler4, filler5, filler6, filler7};
+
+static void reset_counts(void) {
+    secondCalls = 0;
+    secondChanged = 0;
+    minuteCalls = 0;
+    minuteChanged = 0;
+    dayCalls = 0;
+}
+
+void setUp(void) {
+    // Sat 11 May 2024 10:08:36, reported to nobody so the tests start from a known time
+    clock_tick_time_t start = {36, 8, 10, 11, 5, 2024, 6};
+    now = start;
+    clock_tick_invalidate();
+    clock_tick_update(&now);
+    reset_counts();
+}
+
+void tearDown(void) {
+    clock_tick_unsubscribe(on_second);
+    clock_tick_unsubscribe(on_minute);
+    clock_tick_unsubscribe(on_day);
+    for (size_t i = 0; i < sizeof(fillers) / sizeof(fillers[0]); i++) {
+        clock_tick_unsubscribe(fillers[i]);
+    }
+}
+
+static void test_unchanged_time_calls_nobody(void) {
+    clock_tick_subscribe(CLOCK_TICK_SECOND, on_second);
+    clock_tick_update(&now);
+    reset_counts();
+
+    TEST_ASSERT_EQUAL_UINT8(0, clock_tick_update(&now));
+    TEST_ASSERT_EQUAL_UINT32(0, secondCalls);
+}
+
+static void test_new_subscriber_gets_the_current_time(void) {
+    clock_tick_subscribe(CLOCK_TICK_MINUTE, on_minute);
+
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_ALL, clock_tick_update(&now));
+    TEST_ASSERT_EQUAL_UINT32(1, minuteCalls);
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_MINUTE, minuteChanged);
+}
+
+static void test_units_cascade(void) {
+    clock_tick_subscribe(CLOCK_TICK_SECOND, on_second);
+    clock_tick_subscribe(CLOCK_TICK_MINUTE, on_minute);
+    clock_tick_subscribe(CLOCK_TICK_DAY, on_day);
+    clock_tick_update(&now);
+    reset_counts();
+
+    now.second = 37;
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_SECOND, clock_tick_update(&now));
+    TEST_ASSERT_EQUAL_UINT32(1, secondCalls);
+    TEST_ASSERT_EQUAL_UINT32(0, minuteCalls);
+
+    // a new minute also counts as a new second
+    now.second = 0;
+    now.minute = 9;
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_MINUTE | CLOCK_TICK_SECOND, clock_tick_update(&now));
+    TEST_ASSERT_EQUAL_UINT32(2, secondCalls);
+    TEST_ASSERT_EQUAL_UINT32(1, minuteCalls);
+    TEST_ASSERT_EQUAL_UINT32(0, dayCalls);
+
+    now.hour = 11;
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_HOUR | CLOCK_TICK_MINUTE | CLOCK_TICK_SECOND, clock_tick_update(&now));
+    TEST_ASSERT_EQUAL_UINT32(2, minuteCalls);
+    TEST_ASSERT_EQUAL_UINT32(0, dayCalls);
+
+    // only the weekday changing (a time zone or sync fix) is a new day
+    now.weekday = 0;
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_ALL, clock_tick_update(&now));
+    TEST_ASSERT_EQUAL_UINT32(1, dayCalls);
+    TEST_ASSERT_EQUAL_UINT32(3, minuteCalls);
+}
+
+static void test_changed_is_masked_to_the_subscription(void) {
+    clock_tick_subscribe(CLOCK_TICK_MINUTE | CLOCK_TICK_HOUR, on_minute);
+    clock_tick_update(&now);
+    reset_counts();
+
+    now.second = 0;
+    now.minute = 9;
+    clock_tick_update(&now);
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_MINUTE, minuteChanged);
+
+    now.hour = 11;
+    clock_tick_update(&now);
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_MINUTE | CLOCK_TICK_HOUR, minuteChanged);
+}
+
+static void test_invalidate_reports_every_unit(void) {
+    clock_tick_subscribe(CLOCK_TICK_SECOND, on_second);
+    clock_tick_subscribe(CLOCK_TICK_DAY, on_day);
+    clock_tick_update(&now);
+    reset_counts();
+
+    clock_tick_invalidate();
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_TICK_ALL, clock_tick_update(&now));
+    TEST_ASSERT_EQUAL_UINT32(1, secondCalls);
+    TEST_ASSERT_EQUAL_UINT32(1, dayCalls);
+}
+
+static void test_subscribe_again_changes_the_units(void) {
+    clock_tick_subscribe(CLOCK_TICK_SECOND, on_second);
+    clock_tick_subscribe(CLOCK_TICK_DAY, on_second);
+    clock_tick_update(&now);
+    reset_counts();
+
+    now.second = 37;
+    clock_tick_update(&now);
+    TEST_ASSERT_EQUAL_UINT32(0, secondCalls);
+}
+
+static void test_unsubscribed_is_not_called(void) {
+    clock_tick_subscribe(CLOCK_TICK_SECOND, on_second);
+    clock_tick_update(&now);
+    clock_tick_unsubscribe(on_second);
+    reset_counts();
+
+    now.second = 37;
+    clock_tick_update(&now);
+    TEST_ASSERT_EQUAL_UINT32(0, secondCalls);
+}
+
+static void test_slots_run_out(void) {
+    TEST_ASSERT_TRUE(CLOCK_TICK_MAX_SUBS <= sizeof(fillers) / sizeof(fillers[0]));
+    for (size_t i = 0; i < CLOCK_TICK_MAX_SUBS; i++) {
+        TEST_ASSERT_TRUE(clock_tick_subscribe(CLOCK_TICK_SECOND, fillers[i]));
+    }
+    TEST_ASSERT_FALSE(clock_tick_subscribe(CLOCK_TICK_SECOND, on_second));
+
+    // a taken slot still changes its units
+    TEST_ASSERT_TRUE(clock_tick_subscribe(CLOCK_TICK_MINUTE, fillers[0]));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unchanged_time_calls_nobody);
+    RUN_TEST(test_new_subscriber_gets_the_current_time);
+    RUN_TEST(test_units_cascade);
+    RUN_TEST(test_changed_is_masked_to_the_subscription);
+    RUN_TEST(test_invalidate_reports_every_unit);
+    RUN_TEST(test_subscribe_again_changes_the_units);
+    RUN_TEST(test_unsubscribed_is_not_called);
+    RUN_TEST(test_slots_run_out);
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+#include <unity.h>
+#include <pthread.h>
+#include <sched.h>
+#include "common/event_queue/event_queue.h"
+#include "../common/test_helpers.h"
+
+#define STRESS_EVENTS 1000000 // pushed from a second thread in the stress test
+
+static event_queue_t queue;
+static event_t handled[EVENT_QUEUE_SIZE * 2];
+static uint32_t handledCount;
+static uint32_t wakes;
+
+static void record(const event_t *event) {
+    if (handledCount < sizeof(handled) / sizeof(handled[0])) {
+        handled[handledCount] = *event;
+    }
+    handledCount++;
+}
+
+static void wake(void) {
+    wakes++;
+}
+
+void setUp(void) {
+    event_queue_init(&queue, wake);
+    handledCount = 0;
+    wakes = 0;
+}
+
+void tearDown(void) {
+}
+
+static void test_push_keeps_order(void) {
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(event_queue_push(&queue, EVENT_NAV_ICON, i, i * 2));
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, wakes);
+
+    TEST_ASSERT_EQUAL_UINT32(10, event_queue_drain(&queue, record));
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL_UINT32(EVENT_NAV_ICON, handled[i].type);
+        TEST_ASSERT_EQUAL_UINT32(i, handled[i].a);
+        TEST_ASSERT_EQUAL_UINT32(i * 2, handled[i].b);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, event_queue_drain(&queue, record));
+}
+
+static void test_full_ring_drops(void) {
+    for (uint32_t i = 0; i < EVENT_QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(event_queue_push(&queue, EVENT_NAV_ICON, i, 0));
+    }
+    TEST_ASSERT_FALSE(event_queue_push(&queue, EVENT_NAV_ICON, EVENT_QUEUE_SIZE, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, event_queue_dropped(&queue));
+
+    // the oldest events are kept, the one that did not fit is lost
+    TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_SIZE, event_queue_drain(&queue, record));
+    TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_SIZE - 1, handled[EVENT_QUEUE_SIZE - 1].a);
+
+    // and there is room again once drained
+    TEST_ASSERT_TRUE(event_queue_push(&queue, EVENT_NAV_ICON, 0, 0));
+}
+
+static void test_post_delivers_only_the_newest(void) {
+    event_queue_post(&queue, EVENT_WEATHER, 1, 10);
+    event_queue_post(&queue, EVENT_WEATHER, 2, 20);
+    event_queue_post(&queue, EVENT_WEATHER, 3, 30);
+    event_queue_post(&queue, EVENT_TIME_SYNC, 7, 0);
+    TEST_ASSERT_EQUAL_UINT32(4, wakes);
+
+    TEST_ASSERT_EQUAL_UINT32(2, event_queue_drain(&queue, record));
+    TEST_ASSERT_EQUAL_UINT32(EVENT_WEATHER, handled[0].type);
+    TEST_ASSERT_EQUAL_UINT32(3, handled[0].a);
+    TEST_ASSERT_EQUAL_UINT32(30, handled[0].b);
+    TEST_ASSERT_EQUAL_UINT32(EVENT_TIME_SYNC, handled[1].type);
+
+    // delivered once
+    TEST_ASSERT_EQUAL_UINT32(0, event_queue_drain(&queue, record));
+
+    // the same payload posted again is a new event
+    event_queue_post(&queue, EVENT_WEATHER, 3, 30);
+    TEST_ASSERT_EQUAL_UINT32(1, event_queue_drain(&queue, record));
+}
+
+static void test_post_ignores_invalid_types(void) {
+    event_queue_post(&queue, EVENT_NONE, 1, 1);
+    event_queue_post(&queue, EVENT_TYPE_COUNT, 1, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, wakes);
+    TEST_ASSERT_EQUAL_UINT32(0, event_queue_drain(&queue, record));
+}
+
+static void test_posted_before_queued(void) {
+    event_queue_push(&queue, EVENT_NAV_ICON, 1, 0);
+    event_queue_post(&queue, EVENT_NOTIFICATIONS, 0, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(2, event_queue_drain(&queue, record));
+    TEST_ASSERT_EQUAL_UINT32(EVENT_NOTIFICATIONS, handled[0].type);
+    TEST_ASSERT_EQUAL_UINT32(EVENT_NAV_ICON, handled[1].type);
+}
+
+static uint32_t stressExpected;
+static uint32_t stressLatest;
+static uint32_t stressErrors;
+
+static void stress_check(const event_t *event) {
+    if (event->type == EVENT_WEATHER) {
+        // coalesced: a torn payload or an older value after a newer one is an error
+        if (event->b != ~event->a || event->a < stressLatest) {
+            stressErrors++;
+        }
+        stressLatest = event->a;
+        return;
+    }
+    if (event->a != stressExpected || event->b != ~event->a) {
+        stressErrors++;
+    }
+    stressExpected = event->a + 1;
+}
+
+static void *stress_producer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < STRESS_EVENTS; i++) {
+        while (!event_queue_push(&queue, EVENT_NOTIFICATIONS, i, ~i)) {
+            sched_yield();
+        }
+        if ((i & 7) == 0) {
+            event_queue_post(&queue, EVENT_WEATHER, i, ~i);
+        }
+    }
+    return NULL;
+}
+
+// one producer and one consumer thread: order and payloads hold, nothing is lost when
+// the producer retries on a full ring. The time from the start of the producer to the
+// last event drained is printed as the throughput
+static void test_two_threads(void) {
+    pthread_t producer;
+    event_queue_init(&queue, NULL);
+    stressExpected = 0;
+    stressLatest = 0;
+    stressErrors = 0;
+
+    timing_t start = timing_start();
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, stress_producer, NULL));
+    while (stressExpected < STRESS_EVENTS) {
+        if (event_queue_drain(&queue, stress_check) == 0) {
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+    event_queue_drain(&queue, stress_check);
+    timing_report("event through the queue", start, STRESS_EVENTS);
+
+    TEST_ASSERT_EQUAL_UINT32(0, stressErrors);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_EVENTS, stressExpected);
+    TEST_ASSERT_EQUAL_UINT32((STRESS_EVENTS - 1) & ~7u, stressLatest);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_push_keeps_order);
+    RUN_TEST(test_full_ring_drops);
+    RUN_TEST(test_post_delivers_only_the_newest);
+    RUN_TEST(test_post_ignores_invalid_types);
+    RUN_TEST(test_posted_before_queued);
+    RUN_TEST(test_two_threads);
+    return UNITY_END();
+}
@@ -0,0 +1,239 @@
+#include <unity.h>
+#include <math.h>
+#include <stdlib.h>
+#include "common/fusion/fusion.h"
+#include "../common/test_helpers.h"
+
+#define MOTION_SECONDS 120 // synthetic wrist motion in the filter tests
+#define MOTION_RATE 100
+#define MOTION_TAU_MS 500
+#define MAX_DIFF 0.5 // degrees between the fixed point filter and the float one
+#define MAX_RMS 2.0  // degrees from the true attitude
+#define TIMING_SAMPLES 2000000 // updates in each cost pass
+
+#define DEG 57.29577951
+#define RAD 0.0174532925f
+#define PI_F 3.14159265f
+
+typedef struct {
+    float ax, ay, az; // g
+    float gx, gy, gz; // deg/s
+} motion_t;
+
+// float version of fusion.c, the reference for the fixed point one
+typedef struct {
+    float pitch;
+    float roll;
+    bool primed;
+} fusion_ref_t;
+
+static float wrap(float angle) {
+    while (angle > 180.0f) angle -= 360.0f;
+    while (angle < -180.0f) angle += 360.0f;
+    return angle;
+}
+
+static void ref_update(fusion_ref_t *f, const motion_t *s, float dt) {
+    const float deg = 57.2957795f;
+    float accPitch = atan2f(-s->ax, sqrtf(s->ay * s->ay + s->az * s->az)) * deg;
+    float accRoll = atan2f(s->ay, s->az) * deg;
+    if (!f->primed) {
+        f->pitch = accPitch;
+        f->roll = accRoll;
+        f->primed = true;
+        return;
+    }
+    float beta = dt / (MOTION_TAU_MS / 1000.0f + dt);
+    float pitch = f->pitch + s->gy * dt;
+    float roll = f->roll + s->gx * dt;
+    f->pitch = wrap(pitch + wrap(accPitch - pitch) * beta);
+    f->roll = wrap(roll + wrap(accRoll - roll) * beta);
+}
+
+static fusion_input_t input(const motion_t *s) {
+    fusion_input_t in = {Q16_FROM_FLOAT(s->ax), Q16_FROM_FLOAT(s->ay), Q16_FROM_FLOAT(s->az),
+                         Q16_FROM_FLOAT(s->gx), Q16_FROM_FLOAT(s->gy), Q16_FROM_FLOAT(s->gz)};
+    return in;
+}
+
+// the watch held still at pitch and roll, in g
+static motion_t still(float pitch, float roll) {
+    motion_t s = {-sinf(pitch * RAD), cosf(pitch * RAD) * sinf(roll * RAD), cosf(pitch * RAD) * cosf(roll * RAD),
+                  0.0f, 0.0f, 0.0f};
+    return s;
+}
+
+// wrist motion: slow swings in pitch and roll, gyro bias and noise, accelerometer noise
+static motion_t motion(int i, uint32_t *seed, float *pitch, float *roll) {
+    float t = (float)i / MOTION_RATE;
+    *pitch = 40.0f * sinf(2.0f * PI_F * 0.2f * t);
+    *roll = 60.0f * sinf(2.0f * PI_F * 0.13f * t + 1.0f);
+    float pitchRate = 40.0f * 2.0f * PI_F * 0.2f * cosf(2.0f * PI_F * 0.2f * t);
+    float rollRate = 60.0f * 2.0f * PI_F * 0.13f * cosf(2.0f * PI_F * 0.13f * t + 1.0f);
+
+    motion_t s = still(*pitch, *roll);
+    s.ax += noise(seed, 0.02f);
+    s.ay += noise(seed, 0.02f);
+    s.az += noise(seed, 0.02f);
+    s.gx = rollRate + 0.5f + noise(seed, 1.0f);
+    s.gy = pitchRate - 0.3f + noise(seed, 1.0f);
+    s.gz = noise(seed, 1.0f);
+    return s;
+}
+
+static fusion_t fusion;
+
+void setUp(void) {
+    fusion_init(&fusion, MOTION_TAU_MS);
+}
+
+void tearDown(void) {
+}
+
+// against the inputs as they are in Q16, on short, unit and long vectors
+static void test_atan2_within_a_tenth_of_a_degree(void) {
+    static const float radii[] = {0.004f, 1.0f, 8.0f};
+    double worst = 0;
+    for (int deg = -1800; deg < 1800; deg++) {
+        for (size_t r = 0; r < sizeof(radii) / sizeof(radii[0]); r++) {
+            float a = deg * 0.1f * RAD;
+            q16_t y = Q16_FROM_FLOAT(radii[r] * sinf(a));
+            q16_t x = Q16_FROM_FLOAT(radii[r] * cosf(a));
+            double got = Q16_TO_FLOAT(q16_atan2_deg(y, x));
+            double err = fabs(wrap((float)(got - atan2(y, x) * DEG)));
+            worst = err > worst ? err : worst;
+        }
+    }
+    TEST_ASSERT_TRUE(worst < 0.1);
+}
+
+static void test_sqrt_within_a_thousandth(void) {
+    double worst = 0;
+    for (double v = 0.001; v < 16.0; v *= 1.01) {
+        q16_t q = Q16_FROM_FLOAT(v);
+        double exact = sqrt(Q16_TO_FLOAT(q));
+        double err = fabs(Q16_TO_FLOAT(q16_sqrt(q)) - exact) / exact;
+        worst = err > worst ? err : worst;
+    }
+    TEST_ASSERT_TRUE(worst < 0.001);
+    TEST_ASSERT_EQUAL_INT32(0, q16_sqrt(0));
+    TEST_ASSERT_EQUAL_INT32(2 * Q16_ONE, q16_sqrt(4 * Q16_ONE));
+}
+
+static void test_first_sample_takes_the_accelerometer_angles(void) {
+    motion_t flat = still(0.0f, 0.0f);
+    fusion_input_t in = input(&flat);
+    fusion_update(&fusion, &in, 1000);
+    TEST_ASSERT_EQUAL_INT32(0, Q16_ROUND(fusion.pitch));
+    TEST_ASSERT_EQUAL_INT32(0, Q16_ROUND(fusion.roll));
+
+    fusion_init(&fusion, MOTION_TAU_MS);
+    motion_t tilted = still(30.0f, -120.0f);
+    in = input(&tilted);
+    fusion_update(&fusion, &in, 1000);
+    TEST_ASSERT_EQUAL_INT32(30, Q16_ROUND(fusion.pitch));
+    TEST_ASSERT_EQUAL_INT32(-120, Q16_ROUND(fusion.roll));
+}
+
+// a gyro reading alone moves the angle by rate * dt, the accelerometer pulls it back
+static void test_gyro_is_integrated_between_samples(void) {
+    motion_t s = still(0.0f, 0.0f);
+    fusion_input_t in = input(&s);
+    fusion_update(&fusion, &in, 0);
+
+    s.gy = 100.0f;
+    in = input(&s);
+    fusion_update(&fusion, &in, 10000);
+    // 1 degree from the gyro, less the accelerometer share 0.01 / 0.51
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.98f, Q16_TO_FLOAT(fusion.pitch));
+}
+
+static void test_gap_restarts_from_the_accelerometer(void) {
+    motion_t s = still(0.0f, 0.0f);
+    s.gx = 500.0f;
+    fusion_input_t in = input(&s);
+    fusion_update(&fusion, &in, 0xFFFFF000u);
+    // the clock wraps between these two, still a short step
+    fusion_update(&fusion, &in, 0x00001000u);
+    TEST_ASSERT_TRUE(Q16_TO_FLOAT(fusion.roll) > 1.0f);
+
+    fusion_update(&fusion, &in, 0x00001000u + FUSION_MAX_DT_US + 1);
+    TEST_ASSERT_EQUAL_INT32(0, Q16_ROUND(fusion.roll));
+}
+
+// the Q16 filter tracks the float one and both stay close to the true attitude
+// despite the gyro bias and the accelerometer noise
+static void test_matches_the_float_filter_on_synthetic_motion(void) {
+    fusion_ref_t ref = {0.0f, 0.0f, false};
+    double maxDiff = 0, fixedSq = 0, refSq = 0;
+    int settled = 0;
+    uint32_t seed = 1;
+
+    for (int i = 0; i < MOTION_SECONDS * MOTION_RATE; i++) {
+        float pitch, roll;
+        motion_t s = motion(i, &seed, &pitch, &roll);
+        fusion_input_t in = input(&s);
+        fusion_update(&fusion, &in, (uint32_t)((uint64_t)i * 1000000 / MOTION_RATE));
+        ref_update(&ref, &s, 1.0f / MOTION_RATE);
+        if (i < MOTION_RATE * 2) {
+            continue; // both start from the noisy accelerometer
+        }
+        double fixedPitch = Q16_TO_FLOAT(fusion.pitch), fixedRoll = Q16_TO_FLOAT(fusion.roll);
+        double diff = fmax(fabs(fixedPitch - ref.pitch), fabs(wrap((float)(fixedRoll - ref.roll))));
+        maxDiff = diff > maxDiff ? diff : maxDiff;
+        fixedSq += pow(fixedPitch - pitch, 2) + pow(wrap((float)(fixedRoll - roll)), 2);
+        refSq += pow(ref.pitch - pitch, 2) + pow(wrap(ref.roll - roll), 2);
+        settled++;
+    }
+
+    TEST_ASSERT_TRUE(maxDiff <= MAX_DIFF);
+    TEST_ASSERT_TRUE(sqrt(fixedSq / (2 * settled)) <= MAX_RMS);
+    TEST_ASSERT_TRUE(sqrt(refSq / (2 * settled)) <= MAX_RMS);
+}
+
+// the cost of one update of each filter on the same motion, printed and not asserted;
+// the float one includes its atan2f and sqrtf on top of the filter
+static void test_cost_per_sample(void) {
+    static motion_t samples[MOTION_SECONDS * MOTION_RATE];
+    static fusion_input_t inputs[MOTION_SECONDS * MOTION_RATE];
+    const int count = MOTION_SECONDS * MOTION_RATE;
+    fusion_ref_t ref = {0.0f, 0.0f, false};
+    volatile q16_t sinkFixed = 0;
+    volatile float sinkRef = 0;
+    uint32_t seed = 1;
+
+    for (int i = 0; i < count; i++) {
+        float pitch, roll;
+        samples[i] = motion(i, &seed, &pitch, &roll);
+        inputs[i] = input(&samples[i]);
+    }
+
+    timing_t start = timing_start();
+    for (uint32_t n = 0; n < TIMING_SAMPLES; n++) {
+        fusion_update(&fusion, &inputs[n % count], (uint32_t)((uint64_t)n * 1000000 / MOTION_RATE));
+        sinkFixed = fusion.pitch;
+    }
+    timing_report("fusion_update q16", start, TIMING_SAMPLES);
+
+    start = timing_start();
+    for (uint32_t n = 0; n < TIMING_SAMPLES; n++) {
+        ref_update(&ref, &samples[n % count], 1.0f / MOTION_RATE);
+        sinkRef = ref.pitch;
+    }
+    timing_report("float reference", start, TIMING_SAMPLES);
+    (void)sinkFixed;
+    (void)sinkRef;
+    TEST_ASSERT_TRUE(fusion.primed && ref.primed);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_atan2_within_a_tenth_of_a_degree);
+    RUN_TEST(test_sqrt_within_a_thousandth);
+    RUN_TEST(test_first_sample_takes_the_accelerometer_angles);
+    RUN_TEST(test_gyro_is_integrated_between_samples);
+    RUN_TEST(test_gap_restarts_from_the_accelerometer);
+    RUN_TEST(test_matches_the_float_filter_on_synthetic_motion);
+    RUN_TEST(test_cost_per_sample);
+    return UNITY_END();
+}
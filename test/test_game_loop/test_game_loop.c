@@ -0,0 +1,156 @@
+#include <unity.h>
+#include <stddef.h>
+#include "common/game_loop/game_loop.h"
+
+#define CHECK_MS 60000 // clock time per update rate in the irregular frame test
+
+static uint32_t clockMs;
+static uint32_t steps;
+static uint64_t simulatedUs; // sum of the dt_us passed to update
+static uint32_t stepUs;
+static uint32_t badDt;
+static uint32_t badAlpha;
+static uint32_t renders;
+
+static uint32_t fake_clock(void) {
+    return clockMs;
+}
+
+static void check_update(uint32_t dt_us) {
+    steps++;
+    simulatedUs += dt_us;
+    if (dt_us != stepUs) {
+        badDt++;
+    }
+}
+
+static void check_render(float alpha) {
+    renders++;
+    if (alpha < 0.0f || alpha >= 1.0f) {
+        badAlpha++;
+    }
+}
+
+static void stop_update(uint32_t dt_us) {
+    (void)dt_us;
+    steps++;
+    game_loop_stop();
+}
+
+static void reset(void) {
+    clockMs = 1000;
+    steps = 0;
+    simulatedUs = 0;
+    badDt = 0;
+    badAlpha = 0;
+    renders = 0;
+}
+
+void setUp(void) {
+    reset();
+}
+
+void tearDown(void) {
+    game_loop_stop();
+}
+
+static void test_idle_without_a_game(void) {
+    TEST_ASSERT_FALSE(game_loop_running());
+    TEST_ASSERT_EQUAL_UINT32(GAME_LOOP_IDLE_MS, game_loop_tick());
+}
+
+static void test_invalid_games_do_not_start(void) {
+    game_def_t noUpdate = {"none", 60, NULL, NULL};
+    game_def_t noRate = {"zero", 0, check_update, NULL};
+    game_loop_start(&noUpdate, fake_clock);
+    game_loop_start(&noRate, fake_clock);
+    game_loop_start(NULL, fake_clock);
+    TEST_ASSERT_FALSE(game_loop_running());
+}
+
+// irregular frames on the fake clock add up to exactly elapsed * hz updates of
+// 1000000 / hz us each, at rates that do and do not divide a millisecond evenly
+static void test_irregular_frames_at_each_rate(void) {
+    static const uint16_t rates[] = {20, 60, 100};
+    uint32_t seed = 1;
+
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        game_def_t def = {"check", rates[i], check_update, check_render};
+        stepUs = 1000000 / rates[i];
+        // longest frame that never needs more than GAME_LOOP_MAX_STEPS updates
+        uint32_t maxFrame = GAME_LOOP_MAX_STEPS * stepUs / 1000;
+
+        reset();
+        uint32_t start = clockMs;
+        game_loop_start(&def, fake_clock);
+        while (clockMs - start < CHECK_MS) {
+            seed = seed * 1103515245 + 12345;
+            clockMs += 1 + (seed >> 16) % maxFrame;
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(stepUs / 1000 + 1, game_loop_tick());
+        }
+        uint32_t elapsed = clockMs - start;
+
+        TEST_ASSERT_EQUAL_UINT32((uint64_t)elapsed * 1000 / stepUs, steps);
+        TEST_ASSERT_EQUAL_UINT32(0, badDt);
+        TEST_ASSERT_EQUAL_UINT32(0, badAlpha);
+        TEST_ASSERT_EQUAL_UINT32(0, game_loop_stats()->dropped_ms);
+        // the game time stays within one step of the clock
+        TEST_ASSERT_UINT32_WITHIN(stepUs, (uint64_t)elapsed * 1000, simulatedUs);
+        game_loop_stop();
+    }
+}
+
+static void test_stall_is_cut_to_max_steps(void) {
+    game_def_t def = {"check", 60, check_update, check_render};
+    stepUs = 1000000 / 60;
+    game_loop_start(&def, fake_clock);
+
+    clockMs += 1000;
+    game_loop_tick();
+    TEST_ASSERT_EQUAL_UINT32(GAME_LOOP_MAX_STEPS, steps);
+    TEST_ASSERT_GREATER_THAN(0, game_loop_stats()->dropped_ms);
+    TEST_ASSERT_EQUAL_UINT32(1, renders);
+
+    // back to normal on the next frame
+    clockMs += 17;
+    game_loop_tick();
+    TEST_ASSERT_EQUAL_UINT32(GAME_LOOP_MAX_STEPS + 1, steps);
+}
+
+static void test_render_once_per_tick(void) {
+    game_def_t def = {"check", 100, check_update, check_render};
+    stepUs = 10000;
+    game_loop_start(&def, fake_clock);
+
+    clockMs += 5;
+    TEST_ASSERT_EQUAL_UINT32(5, game_loop_tick());
+    TEST_ASSERT_EQUAL_UINT32(0, steps);
+    TEST_ASSERT_EQUAL_UINT32(1, renders);
+
+    clockMs += 30;
+    game_loop_tick();
+    TEST_ASSERT_EQUAL_UINT32(3, steps);
+    TEST_ASSERT_EQUAL_UINT32(2, renders);
+}
+
+static void test_update_may_stop_the_game(void) {
+    game_def_t def = {"stop", 100, stop_update, check_render};
+    game_loop_start(&def, fake_clock);
+
+    clockMs += 40;
+    TEST_ASSERT_EQUAL_UINT32(GAME_LOOP_IDLE_MS, game_loop_tick());
+    TEST_ASSERT_EQUAL_UINT32(1, steps);
+    TEST_ASSERT_EQUAL_UINT32(0, renders);
+    TEST_ASSERT_FALSE(game_loop_running());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_without_a_game);
+    RUN_TEST(test_invalid_games_do_not_start);
+    RUN_TEST(test_irregular_frames_at_each_rate);
+    RUN_TEST(test_stall_is_cut_to_max_steps);
+    RUN_TEST(test_render_once_per_tick);
+    RUN_TEST(test_update_may_stop_the_game);
+    return UNITY_END();
+}
@@ -0,0 +1,277 @@
+#include <unity.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "common/input_bus/input_bus.h"
+#include "../common/test_helpers.h"
+
+#define STRESS_STEPS 1000000 // encoder steps pushed from a second thread in the stress test
+
+static uint32_t now;
+static uint32_t errors;
+static int encoderCalls;
+static long position;
+static long changes;
+static int buttonCalls;
+static bool pressed;
+static int gestures[INPUT_LONG_PRESS + 1];
+static uint32_t gestureTime;
+static int extraCalls;
+
+static uint32_t fake_clock(void) {
+    return now;
+}
+
+static void on_encoder(long pos, int32_t change) {
+    // one call per dispatch, the change adds up to the position
+    if (pos != position + change) errors++;
+    encoderCalls++;
+    position = pos;
+    changes += change;
+}
+
+static void on_button(bool down) {
+    if (down == pressed) errors++;
+    buttonCalls++;
+    pressed = down;
+}
+
+static void on_gesture(input_gesture_t gesture, uint32_t time_ms) {
+    gestures[gesture]++;
+    gestureTime = time_ms;
+}
+
+static void extra(long pos, int32_t change) {
+    (void)pos;
+    (void)change;
+    extraCalls++;
+}
+
+// removes itself on its first call and adds another subscriber
+static void once(long pos, int32_t change) {
+    (void)pos;
+    (void)change;
+    extraCalls++;
+    input_bus_remove_encoder_sub(once);
+    input_bus_add_encoder_sub(extra);
+}
+
+static void press(uint32_t at, bool down) {
+    now = at;
+    input_bus_push_button(down);
+}
+
+void setUp(void) {
+    now = 1000;
+    input_bus_init(fake_clock, NULL);
+    errors = 0;
+    encoderCalls = 0;
+    position = 0;
+    changes = 0;
+    buttonCalls = 0;
+    pressed = false;
+    memset(gestures, 0, sizeof(gestures));
+    gestureTime = 0;
+    extraCalls = 0;
+    input_bus_add_encoder_sub(on_encoder);
+    input_bus_add_button_sub(on_button);
+    input_bus_add_gesture_sub(on_gesture);
+}
+
+void tearDown(void) {
+    input_bus_remove_encoder_sub(on_encoder);
+    input_bus_remove_button_sub(on_button);
+    input_bus_remove_gesture_sub(on_gesture);
+}
+
+static void test_spin_is_coalesced(void) {
+    for (long p = 0; p <= 50; p++) {
+        input_bus_push_encoder(p);
+    }
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(1, encoderCalls);
+    TEST_ASSERT_EQUAL_INT32(50, position);
+    TEST_ASSERT_EQUAL_INT32(50, changes);
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+}
+
+static void test_order_around_a_press(void) {
+    for (long p = 0; p <= 3; p++) {
+        input_bus_push_encoder(p);
+    }
+    press(1000, true);
+    for (long p = 4; p <= 6; p++) {
+        input_bus_push_encoder(p);
+    }
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(2, encoderCalls);
+    TEST_ASSERT_EQUAL_INT(1, buttonCalls);
+    TEST_ASSERT_EQUAL_INT32(6, position);
+}
+
+static void test_click_waits_for_the_double_click_time(void) {
+    press(1000, true);
+    press(1100, false);
+    TEST_ASSERT_EQUAL_UINT32(INPUT_DOUBLE_CLICK_MS + 1, input_bus_dispatch());
+    TEST_ASSERT_EQUAL_INT(0, gestures[INPUT_CLICK]);
+
+    now = 1100 + INPUT_DOUBLE_CLICK_MS + 1;
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, input_bus_dispatch());
+    TEST_ASSERT_EQUAL_INT(1, gestures[INPUT_CLICK]);
+    TEST_ASSERT_EQUAL_UINT32(1100, gestureTime);
+}
+
+static void test_double_click(void) {
+    press(1000, true);
+    press(1080, false);
+    press(1200, true);
+    press(1280, false);
+    now = 2000;
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(1, gestures[INPUT_DOUBLE_CLICK]);
+    TEST_ASSERT_EQUAL_INT(0, gestures[INPUT_CLICK]);
+}
+
+static void test_long_press(void) {
+    press(1000, true);
+    now = 1000 + INPUT_LONG_PRESS_MS - 1;
+    TEST_ASSERT_EQUAL_UINT32(1, input_bus_dispatch());
+    TEST_ASSERT_EQUAL_INT(0, gestures[INPUT_LONG_PRESS]);
+
+    now = 1000 + INPUT_LONG_PRESS_MS;
+    input_bus_dispatch();
+    press(1900, false);
+    now = 3000;
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(1, gestures[INPUT_LONG_PRESS]);
+    TEST_ASSERT_EQUAL_INT(0, gestures[INPUT_CLICK]);
+}
+
+// the loop was busy, both edges come in one dispatch
+static void test_late_long_press(void) {
+    press(1000, true);
+    press(1000 + INPUT_LONG_PRESS_MS + 100, false);
+    now = 3000;
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(1, gestures[INPUT_LONG_PRESS]);
+    TEST_ASSERT_EQUAL_INT(0, gestures[INPUT_CLICK]);
+    TEST_ASSERT_EQUAL_UINT32(1000 + INPUT_LONG_PRESS_MS, gestureTime);
+}
+
+static void test_two_slow_clicks(void) {
+    press(1000, true);
+    press(1100, false);
+    press(1100 + INPUT_DOUBLE_CLICK_MS + 100, true);
+    press(1100 + INPUT_DOUBLE_CLICK_MS + 200, false);
+    now = 3000;
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(2, gestures[INPUT_CLICK]);
+    TEST_ASSERT_EQUAL_INT(0, gestures[INPUT_DOUBLE_CLICK]);
+}
+
+// a clock going back does not reorder the stamps
+static void test_stamps_never_go_back(void) {
+    press(1500, true);
+    press(1400, false);
+    now = 3000;
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(1, gestures[INPUT_CLICK]);
+    TEST_ASSERT_EQUAL_UINT32(1500, gestureTime);
+}
+
+static void test_full_ring_delays_steps(void) {
+    for (long p = 0; p <= 100; p++) {
+        input_bus_push_encoder(p);
+    }
+    TEST_ASSERT_EQUAL_UINT32(101 - INPUT_BUS_SIZE, input_bus_dropped());
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT32(INPUT_BUS_SIZE - 1, position);
+
+    // the next push carries the position
+    input_bus_push_encoder(101);
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT32(101, position);
+    TEST_ASSERT_EQUAL_INT32(101, changes);
+}
+
+static void test_subscribers_change_during_dispatch(void) {
+    input_bus_add_encoder_sub(once);
+    for (int i = 0; i < 20; i++) {
+        input_bus_add_encoder_sub(extra);
+    }
+    input_bus_push_encoder(0);
+    input_bus_push_encoder(1);
+    input_bus_dispatch();
+    // once and the 20 extras, the one it added takes its slot and waits for the next
+    TEST_ASSERT_EQUAL_INT(21, extraCalls);
+
+    extraCalls = 0;
+    input_bus_push_encoder(2);
+    input_bus_dispatch();
+    TEST_ASSERT_EQUAL_INT(21, extraCalls);
+    TEST_ASSERT_EQUAL_INT(2, encoderCalls);
+    for (int i = 0; i < 21; i++) {
+        input_bus_remove_encoder_sub(extra);
+    }
+}
+
+static uint32_t real_clock(void) {
+    return (uint32_t)(now_ns() / 1000000);
+}
+
+static void *stress_producer(void *arg) {
+    (void)arg;
+    for (long p = 0; p <= STRESS_STEPS; p++) {
+        while (!input_bus_push_encoder(p)) {
+            sched_yield();
+        }
+        if ((p & 1023) == 0) {
+            while (!input_bus_push_button((p >> 10 & 1) == 0)) {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+// one producer thread spinning the encoder as fast as it can against a consumer
+// dispatching in a loop: nothing is lost when the producer retries on a full ring,
+// every step and every press arrives in order. The time from the start of the producer
+// to the last step dispatched is printed as the throughput
+static void test_two_threads(void) {
+    pthread_t producer;
+    input_bus_init(real_clock, NULL);
+
+    timing_t start = timing_start();
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, stress_producer, NULL));
+    while (position < STRESS_STEPS) {
+        long before = position;
+        input_bus_dispatch();
+        if (position == before) {
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+    input_bus_dispatch();
+    timing_report("encoder step through the bus", start, STRESS_STEPS);
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_EQUAL_INT32(STRESS_STEPS, changes);
+    TEST_ASSERT_EQUAL_INT(STRESS_STEPS / 1024 + 1, buttonCalls);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_spin_is_coalesced);
+    RUN_TEST(test_order_around_a_press);
+    RUN_TEST(test_click_waits_for_the_double_click_time);
+    RUN_TEST(test_double_click);
+    RUN_TEST(test_long_press);
+    RUN_TEST(test_late_long_press);
+    RUN_TEST(test_two_slow_clicks);
+    RUN_TEST(test_stamps_never_go_back);
+    RUN_TEST(test_full_ring_delays_steps);
+    RUN_TEST(test_subscribers_change_during_dispatch);
+    RUN_TEST(test_two_threads);
+    return UNITY_END();
+}
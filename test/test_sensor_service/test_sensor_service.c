@@ -0,0 +1,204 @@
+#include <unity.h>
+#include <string.h>
+#include "common/sensor_service/sensor_service.h"
+
+#define FAKE_FIFO 64 // samples the FIFO backend buffers
+
+static uint32_t nowUs = 1000; // runs on across the tests like a real clock
+static uint16_t fifo;     // of the fake sensor, 0 for none
+static uint16_t odr;      // 0 while stopped
+static uint32_t startUs;  // when the fake sensor started
+static uint32_t consumed; // samples read since the start
+static uint32_t loops;    // passes of the fake UI loop
+static uint32_t handOvers;
+static uint32_t delivered;
+static uint32_t latest;   // longest a delivered sample waited, us
+static uint32_t latencyMs;
+
+static uint32_t fake_clock(void) {
+    return nowUs;
+}
+
+static bool fake_start(uint16_t odr_hz) {
+    odr = odr_hz;
+    startUs = nowUs;
+    consumed = 0;
+    return true;
+}
+
+static void fake_stop(void) {
+    odr = 0;
+}
+
+// the samples measured since the last read, only the newest without a FIFO
+static uint16_t fake_read(imu_sample_t *out, uint16_t max) {
+    uint32_t produced = (uint32_t)((uint64_t)(nowUs - startUs) * odr / 1000000);
+    uint32_t waiting = produced - consumed;
+    uint32_t keep = fifo > 0 ? fifo : 1;
+    if (waiting > keep) {
+        consumed += waiting - keep;
+        waiting = keep;
+    }
+    uint16_t n = waiting < max ? (uint16_t)waiting : max;
+    for (uint16_t i = 0; i < n; i++) {
+        memset(&out[i], 0, sizeof(out[i]));
+        out[i].az = 1.0f;
+    }
+    consumed += n;
+    return n;
+}
+
+static const sensor_backend_t backends[] = {
+    {fake_start, fake_stop, fake_read, 0},
+    {fake_start, fake_stop, fake_read, FAKE_FIFO},
+};
+
+static void on_samples(const imu_sample_t *samples, uint16_t count, void *user) {
+    (void)user;
+    handOvers++;
+    delivered += count;
+    uint32_t waited = nowUs - samples[0].time_us;
+    latest = waited > latest ? waited : latest;
+}
+
+static void other_samples(const imu_sample_t *samples, uint16_t count, void *user) {
+    (void)samples;
+    (void)count;
+    (void)user;
+}
+
+// the UI loop of a HAL without a sensor task for ms: poll, then sleep until the
+// returned deadline, reading in between like the pico HAL
+static void run(uint32_t ms) {
+    uint32_t end = nowUs + ms * 1000;
+    while ((int32_t)(end - nowUs) > 0) {
+        loops++;
+        uint32_t wait = sensor_service_poll();
+        uint32_t until = wait == UINT32_MAX || wait * 1000 > end - nowUs ? end : nowUs + wait * 1000;
+        if (wait == 0) until = nowUs + 1000;
+        while ((int32_t)(until - nowUs) > 0) {
+            uint32_t next = sensor_service_read();
+            if (next == 0) break;
+            uint32_t step = next == UINT32_MAX || next * 1000 > until - nowUs ? until - nowUs : next * 1000;
+            nowUs += step;
+        }
+    }
+}
+
+static void use(int backend) {
+    fifo = backends[backend].fifo;
+    sensor_service_init(&backends[backend], fake_clock);
+}
+
+void setUp(void) {
+    loops = 0;
+    handOvers = 0;
+    delivered = 0;
+    latest = 0;
+    latencyMs = 0;
+    use(0);
+}
+
+// also after a failed assert, which skips the closes of the test
+void tearDown(void) {
+    for (int s = 0; s < SENSOR_MAX_STREAMS; s++) {
+        imu_stream_close(s);
+    }
+    // stops the sensor
+    sensor_service_poll();
+}
+
+static int open_stream(uint16_t rate, uint16_t latency) {
+    int stream = imu_stream_open(rate, IMU_STREAM_AVERAGE, on_samples, NULL);
+    TEST_ASSERT_TRUE(stream >= 0);
+    if (latency > 0) imu_stream_set_latency(stream, latency);
+    latencyMs = latency > 0 ? latency : SENSOR_LATENCY_MS;
+    return stream;
+}
+
+// samples by the stream rate, handed over once per latency at most and never later
+static void check(uint16_t rate, uint32_t seconds) {
+    uint32_t expected = rate * seconds;
+    TEST_ASSERT_UINT32_WITHIN(rate * latencyMs / 1000 + 2, expected, delivered);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(latencyMs * 1000, latest);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(seconds * 1000 / latencyMs + 1, handOvers);
+}
+
+static void test_default_latency_without_fifo(void) {
+    int stream = open_stream(25, 0);
+    run(10000);
+    check(25, 10);
+    imu_stream_close(stream);
+}
+
+// the step counter: one loop pass a second instead of one per read
+static void test_long_latency_without_fifo(void) {
+    int stream = open_stream(25, 1000);
+    run(10000);
+    check(25, 10);
+    TEST_ASSERT_GREATER_OR_EQUAL(9, handOvers);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(11, loops);
+    imu_stream_close(stream);
+}
+
+static void test_long_latency_with_fifo(void) {
+    use(1);
+    int stream = open_stream(25, 1000);
+    run(10000);
+    check(25, 10);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(11, loops);
+    imu_stream_close(stream);
+}
+
+// the shortest latency of the open streams sets the pace
+static void test_shortest_latency_wins(void) {
+    int slow = open_stream(25, 1000);
+    int fast = imu_stream_open(10, IMU_STREAM_AVERAGE, other_samples, NULL);
+    imu_stream_set_latency(fast, 200);
+    latencyMs = 200;
+    run(10000);
+    check(25, 10);
+    TEST_ASSERT_GREATER_OR_EQUAL(45, handOvers);
+
+    // and the longer one again once it closes
+    imu_stream_close(fast);
+    handOvers = 0;
+    loops = 0;
+    delivered = 0;
+    latest = 0;
+    latencyMs = 1000;
+    run(10000);
+    check(25, 10);
+    imu_stream_close(slow);
+}
+
+// a latency longer than the ring holds hands over when it is half full
+static void test_half_full_ring_hands_over(void) {
+    int stream = open_stream(100, 5000);
+    run(10000);
+    TEST_ASSERT_UINT32_WITHIN(SENSOR_RING_SIZE / 2 + 2, 1000, delivered);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SENSOR_RING_SIZE / 2 * 10000, latest);
+    TEST_ASSERT_EQUAL_UINT32(0, sensor_service_dropped());
+    imu_stream_close(stream);
+}
+
+static void test_sensor_stops_with_the_last_stream(void) {
+    int stream = open_stream(25, 0);
+    run(100);
+    TEST_ASSERT_EQUAL_UINT16(25, odr);
+    imu_stream_close(stream);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, sensor_service_poll());
+    TEST_ASSERT_EQUAL_UINT16(0, odr);
+    TEST_ASSERT_EQUAL_UINT16(0, sensor_service_odr());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_latency_without_fifo);
+    RUN_TEST(test_long_latency_without_fifo);
+    RUN_TEST(test_long_latency_with_fifo);
+    RUN_TEST(test_shortest_latency_wins);
+    RUN_TEST(test_half_full_ring_hands_over);
+    RUN_TEST(test_sensor_stops_with_the_last_stream);
+    return UNITY_END();
+}
@@ -0,0 +1,242 @@
+#include <unity.h>
+#include <pthread.h>
+#include <sched.h>
+#include "common/ui_thread/ui_thread.h"
+#include "../common/test_helpers.h"
+
+#define STRESS_POSTS 100000 // closures per poster thread in the stress test
+#define STRESS_POSTERS 3
+#define STRESS_JOBS 2000
+
+static uint32_t wakes; // also counted from the poster and worker threads
+static uint32_t ran[UI_THREAD_POST_SIZE * 2];
+static uint32_t ranCount;
+static uint32_t errors;
+
+static void wake(void) {
+    __atomic_add_fetch(&wakes, 1, __ATOMIC_RELAXED);
+}
+
+static void record(void *arg) {
+    if (!ui_thread_is_current()) errors++;
+    if (ranCount < sizeof(ran) / sizeof(ran[0])) {
+        ran[ranCount] = (uint32_t)(uintptr_t)arg;
+    }
+    ranCount++;
+}
+
+// posts another closure from inside the drain
+static void repost(void *arg) {
+    record(arg);
+    ui_post(record, (void *)((uintptr_t)arg + 1));
+}
+
+static void drain_all(void) {
+    while (ui_thread_drain() > 0) {
+    }
+}
+
+void setUp(void) {
+    __atomic_store_n(&wakes, 0, __ATOMIC_RELAXED);
+    ranCount = 0;
+    errors = 0;
+}
+
+void tearDown(void) {
+    drain_all();
+}
+
+static void test_posts_run_in_order_on_drain(void) {
+    for (uintptr_t i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(ui_post(record, (void *)i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, __atomic_load_n(&wakes, __ATOMIC_RELAXED));
+    TEST_ASSERT_EQUAL_UINT32(0, ranCount);
+
+    TEST_ASSERT_EQUAL_UINT32(5, ui_thread_drain());
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, ran[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ui_thread_drain());
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+}
+
+static void test_full_queue_refuses(void) {
+    for (uintptr_t i = 0; i < UI_THREAD_POST_SIZE; i++) {
+        TEST_ASSERT_TRUE(ui_post(record, (void *)i));
+    }
+    TEST_ASSERT_FALSE(ui_post(record, NULL));
+    TEST_ASSERT_FALSE(ui_post(NULL, NULL));
+    // a refused post does not wake the loop
+    TEST_ASSERT_EQUAL_UINT32(UI_THREAD_POST_SIZE, __atomic_load_n(&wakes, __ATOMIC_RELAXED));
+
+    TEST_ASSERT_EQUAL_UINT32(UI_THREAD_POST_SIZE, ui_thread_drain());
+    TEST_ASSERT_TRUE(ui_post(record, NULL));
+}
+
+// a closure posted while draining waits for the next drain
+static void test_post_from_a_closure_runs_next_drain(void) {
+    ui_post(repost, (void *)10);
+    TEST_ASSERT_EQUAL_UINT32(1, ui_thread_drain());
+    TEST_ASSERT_EQUAL_UINT32(1, ranCount);
+    TEST_ASSERT_EQUAL_UINT32(1, ui_thread_drain());
+    TEST_ASSERT_EQUAL_UINT32(11, ran[1]);
+}
+
+static bool otherLocked;
+
+static void *take_lock(void *arg) {
+    (void)arg;
+    ui_lock();
+    otherLocked = true;
+    ui_unlock();
+    return NULL;
+}
+
+static void test_lock_is_recursive_and_exclusive(void) {
+    pthread_t other;
+    otherLocked = false;
+
+    ui_lock();
+    ui_lock();
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&other, NULL, take_lock, NULL));
+    ui_unlock();
+    // still held once, the other thread has to wait
+    for (int i = 0; i < 1000; i++) {
+        sched_yield();
+    }
+    bool early = otherLocked;
+    ui_unlock();
+    pthread_join(other, NULL);
+
+    TEST_ASSERT_FALSE(early);
+    TEST_ASSERT_TRUE(otherLocked);
+}
+
+static bool workOnUi;
+
+static void job_work(void *arg) {
+    uint32_t *value = (uint32_t *)arg;
+    workOnUi = ui_thread_is_current();
+    *value = *value * 2 + 1;
+}
+
+static void job_done(void *arg) {
+    record((void *)(uintptr_t)*(uint32_t *)arg);
+}
+
+static void test_worker_runs_off_the_ui_thread(void) {
+    uint32_t value = 20;
+    workOnUi = true;
+    TEST_ASSERT_TRUE(ui_worker_run(job_work, job_done, &value));
+    TEST_ASSERT_FALSE(ui_worker_run(NULL, job_done, &value));
+
+    while (ranCount == 0) {
+        if (ui_thread_drain() == 0) sched_yield();
+    }
+    TEST_ASSERT_FALSE(workOnUi);
+    TEST_ASSERT_EQUAL_UINT32(41, ran[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+}
+
+static uint32_t stressPosted;   // UI thread only
+static uint32_t stressJobsDone; // UI thread only
+static uint32_t lockedCounter;  // stands in for LVGL state, only touched under the UI lock
+static uint32_t jobValues[STRESS_JOBS];
+
+static void stress_post(void *arg) {
+    (void)arg;
+    if (!ui_thread_is_current()) errors++;
+    stressPosted++;
+}
+
+static void stress_job_work(void *arg) {
+    uint32_t *value = (uint32_t *)arg;
+    *value = *value * 2 + 1;
+}
+
+static void stress_job_done(void *arg) {
+    uint32_t index = (uint32_t)((uint32_t *)arg - jobValues);
+    if (!ui_thread_is_current() || *(uint32_t *)arg != index * 2 + 1) errors++;
+    stressJobsDone++;
+}
+
+static void *stress_poster(void *arg) {
+    (void)arg;
+    for (uint32_t n = 0; n < STRESS_POSTS; n++) {
+        while (!ui_post(stress_post, NULL)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// the ENABLE_GAME_TASK game loop, taking the UI lock around its LVGL calls
+static void *stress_game(void *arg) {
+    (void)arg;
+    for (uint32_t n = 0; n < STRESS_POSTS; n++) {
+        ui_lock();
+        lockedCounter++;
+        ui_unlock();
+    }
+    return NULL;
+}
+
+// posters, a game thread taking the UI lock and worker jobs against a UI loop that
+// holds the lock while it drains: every closure and completion runs once on the UI
+// thread and the locked counter adds up. Run it in env:native_tsan to check the
+// pthread backend for races
+static void test_threads(void) {
+    pthread_t posters[STRESS_POSTERS];
+    pthread_t game;
+    uint32_t loopSteps = 0;
+    uint32_t jobsQueued = 0;
+
+    stressPosted = 0;
+    stressJobsDone = 0;
+    lockedCounter = 0;
+    for (uint32_t i = 0; i < STRESS_JOBS; i++) {
+        jobValues[i] = i;
+    }
+
+    timing_t start = timing_start();
+    for (int i = 0; i < STRESS_POSTERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&posters[i], NULL, stress_poster, NULL));
+    }
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&game, NULL, stress_game, NULL));
+
+    while (stressPosted < STRESS_POSTS * STRESS_POSTERS || stressJobsDone < STRESS_JOBS) {
+        ui_lock();
+        lockedCounter++;
+        loopSteps++;
+        if (jobsQueued < STRESS_JOBS && ui_worker_run(stress_job_work, stress_job_done, &jobValues[jobsQueued])) {
+            jobsQueued++;
+        }
+        uint32_t drained = ui_thread_drain();
+        ui_unlock();
+        if (drained == 0) sched_yield();
+    }
+    for (int i = 0; i < STRESS_POSTERS; i++) {
+        pthread_join(posters[i], NULL);
+    }
+    pthread_join(game, NULL);
+    timing_report("closure posted and drained", start, STRESS_POSTS * STRESS_POSTERS);
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_POSTS * STRESS_POSTERS, stressPosted);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_JOBS, stressJobsDone);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_POSTS + loopSteps, lockedCounter);
+}
+
+int main(void) {
+    // once, as the UI loop does, the worker thread outlives the tests
+    ui_thread_init(wake);
+    UNITY_BEGIN();
+    RUN_TEST(test_posts_run_in_order_on_drain);
+    RUN_TEST(test_full_queue_refuses);
+    RUN_TEST(test_post_from_a_closure_runs_next_drain);
+    RUN_TEST(test_lock_is_recursive_and_exclusive);
+    RUN_TEST(test_worker_runs_off_the_ui_thread);
+    RUN_TEST(test_threads);
+    return UNITY_END();
+}
@@ -0,0 +1,255 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "common/wrist_wake/wrist_wake.h"
+#include "../common/test_helpers.h"
+#include "../common/imu_trace.h"
+
+#define SOURCE_HZ 100   // synthetic traces, averaged down to each rate checked
+#define MAX_SECONDS 60  // longest trace
+#define STEP_MS 100     // sample spacing of the hand made poses, WRIST_WAKE_RATE_HZ
+
+// Trace next to this file in the SENSOR_CSV format at 25 Hz, so the emulator can replay
+// it too. It is synthetic, written by support/imu_traces.py with the true raises and
+// tilts in its header; a recording with counted gestures fits the same.
+#define WAKE_CSV "wake.csv"
+#define WAKE_RAISES 3
+#define WAKE_TILTS 3
+
+#define PI_F 3.14159265f
+#define RAD 0.0174532925f
+
+typedef struct {
+    const char *name;
+    int seconds;
+    int raises; // expected wakes
+    int tilts;
+} trace_t;
+
+static const trace_t traces[] = {
+    {"raise", 35, 5, 0},
+    {"tilt", 23, 0, 5},
+    {"walk", 60, 0, 0},
+    {"typing", 60, 0, 0},
+    {"turn over", 45, 0, 0},
+};
+
+static wrist_wake_t detector;
+static imu_sample_t samples[MAX_SECONDS * 2 * 25];
+static uint32_t nowUs;
+static int raises;
+static int tilts;
+
+static float ramp(float t, float from, float to, float start, float length) {
+    float k = (t - start) / length;
+    k = k < 0 ? 0 : k > 1 ? 1 : k;
+    return from + (to - from) * k;
+}
+
+// pitch and roll in degrees of trace at t, plus the extra acceleration along the
+// screen normal from steps or typing
+static void pose(int trace, float t, uint32_t *seed, float *pitch, float *roll, float *shake) {
+    const float hang = -80, up = 20;
+    *shake = 0;
+    switch (trace) {
+    case 0: {
+        // 3 s hanging, raised in 0.5 s, looked at for 3 s, lowered in 0.5 s
+        float p = fmodf(t, 7.0f);
+        *pitch = p < 3.5f ? ramp(p, 0, up, 3.0f, 0.5f) : ramp(p, up, 0, 6.5f, 0.5f);
+        *roll = p < 3.5f ? ramp(p, hang, 0, 3.0f, 0.5f) : ramp(p, 0, hang, 6.5f, 0.5f);
+        break;
+    }
+    case 1: {
+        // on the desk, every 4.5 s the wrist turns away in 0.25 s, stays for 0.2 s and
+        // comes back in 0.25 s
+        float p = fmodf(t, 4.5f);
+        *pitch = up;
+        *roll = p < 4.25f ? ramp(p, 0, -90, 3.8f, 0.25f) : ramp(p, -90, 0, 4.25f, 0.25f);
+        break;
+    }
+    case 2:
+        // arm swinging at 0.9 Hz, a step at twice that
+        *pitch = 10 * sinf(2 * PI_F * 0.9f * t);
+        *roll = hang + 25 * sinf(2 * PI_F * 0.9f * t);
+        *shake = 0.3f * sinf(2 * PI_F * 1.8f * t);
+        break;
+    case 3:
+        // wrist on the desk moving with the hand, key strokes
+        *pitch = 15 + 5 * sinf(0.7f * t);
+        *roll = 10 * sinf(0.3f * t);
+        *shake = noise(seed, 0.15f);
+        break;
+    default:
+        // turned face down over 20 s and back
+        *pitch = 0;
+        *roll = t < 22.5f ? ramp(t, 0, 180, 1.0f, 20.0f) : ramp(t, 180, 0, 24.0f, 20.0f);
+        break;
+    }
+}
+
+// the trace at rate Hz as the sensor service averages it, returns the sample count
+static int synthesize(int trace, int rate, imu_sample_t *out) {
+    const int ratio = SOURCE_HZ / rate;
+    const int total = traces[trace].seconds * SOURCE_HZ;
+    uint32_t seed = 11;
+    imu_sample_t sum;
+    int count = 0;
+    memset(&sum, 0, sizeof(sum));
+
+    for (int i = 0; i < total; i++) {
+        float pitch, roll, shake;
+        pose(trace, (float)i / SOURCE_HZ, &seed, &pitch, &roll, &shake);
+        sum.ax += -sinf(pitch * RAD) + noise(&seed, 0.03f);
+        sum.ay += cosf(pitch * RAD) * sinf(roll * RAD) + noise(&seed, 0.03f);
+        sum.az += cosf(pitch * RAD) * cosf(roll * RAD) + shake + noise(&seed, 0.03f);
+        if ((i + 1) % ratio == 0) {
+            imu_sample_t *s = &out[count++];
+            *s = sum;
+            s->ax /= ratio;
+            s->ay /= ratio;
+            s->az /= ratio;
+            s->time_us = (uint32_t)((uint64_t)(i + 1) * 1000000 / SOURCE_HZ);
+            s->temp = 25.0f;
+            memset(&sum, 0, sizeof(sum));
+        }
+    }
+    return count;
+}
+
+static void count(wrist_wake_event_t event) {
+    raises += event == WRIST_WAKE_RAISE ? 1 : 0;
+    tilts += event == WRIST_WAKE_TILT ? 1 : 0;
+}
+
+// the watch held at pitch and roll for ms, with shake g added along the screen normal
+// on every other sample
+static void hold(float pitch, float roll, float shake, uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += STEP_MS) {
+        imu_sample_t s;
+        memset(&s, 0, sizeof(s));
+        s.ax = -sinf(pitch * RAD);
+        s.ay = cosf(pitch * RAD) * sinf(roll * RAD);
+        s.az = cosf(pitch * RAD) * cosf(roll * RAD) + ((t / STEP_MS) % 2 ? shake : -shake);
+        s.time_us = nowUs;
+        nowUs += STEP_MS * 1000;
+        count(wrist_wake_feed(&detector, &s));
+    }
+}
+
+void setUp(void) {
+    wrist_wake_init(&detector);
+    nowUs = 5000;
+    raises = 0;
+    tilts = 0;
+}
+
+void tearDown(void) {
+}
+
+// the wakes of each trace at the stream rate and at denser and sparser ones
+static void test_synthetic_traces_at_each_rate(void) {
+    static const int rates[] = {25, WRIST_WAKE_RATE_HZ, 5};
+    char message[64];
+
+    for (size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            int n = synthesize((int)t, rates[r], samples);
+            wrist_wake_init(&detector);
+            raises = 0;
+            tilts = 0;
+            for (int i = 0; i < n; i++) {
+                count(wrist_wake_feed(&detector, &samples[i]));
+            }
+            snprintf(message, sizeof(message), "%s at %d Hz: %d raises, %d tilts", traces[t].name, rates[r], raises,
+                     tilts);
+            TEST_ASSERT_TRUE_MESSAGE(raises == traces[t].raises && tilts == traces[t].tilts, message);
+        }
+    }
+}
+
+static void test_up_at_start_is_not_a_raise(void) {
+    hold(20, 0, 0, 3000);
+    TEST_ASSERT_EQUAL_INT(0, raises + tilts);
+}
+
+static void test_raise_and_tilt_by_time_away(void) {
+    hold(0, -80, 0, WRIST_RAISE_MS + 400);
+    hold(20, 0, 0, 1000);
+    TEST_ASSERT_EQUAL_INT(1, raises);
+
+    // after the refractory time, a short flick away and back is a tilt
+    hold(20, 0, 0, WRIST_REFRACTORY_MS);
+    hold(20, -90, 0, 200);
+    hold(20, 0, 0, 1000);
+    TEST_ASSERT_EQUAL_INT(1, raises);
+    TEST_ASSERT_EQUAL_INT(1, tilts);
+}
+
+static void test_no_second_wake_within_refractory(void) {
+    hold(0, -80, 0, 1000);
+    hold(20, 0, 0, 500);
+    hold(20, -90, 0, 200);
+    hold(20, 0, 0, 500);
+    TEST_ASSERT_EQUAL_INT(1, raises);
+    TEST_ASSERT_EQUAL_INT(0, tilts);
+}
+
+// facing but shaking does not count towards the hold, and too late after being away
+// is not a gesture any more
+static void test_shaking_never_holds(void) {
+    hold(0, -80, 0, 1000);
+    // facing on every sample, but 0.25g off 1g
+    hold(0, 0, 0.25f, WRIST_WINDOW_MS + WRIST_HOLD_MS + 500);
+    hold(20, 0, 0, 1000);
+    TEST_ASSERT_EQUAL_INT(0, raises + tilts);
+}
+
+// a lost sample or a stalled stream does not bridge the window
+static void test_gap_is_not_a_gesture(void) {
+    hold(0, -80, 0, 1000);
+    nowUs += (WRIST_WINDOW_MS + WRIST_HOLD_MS) * 1000;
+    hold(20, 0, 0, 1000);
+    TEST_ASSERT_EQUAL_INT(0, raises + tilts);
+}
+
+// the committed trace as it is, and averaged down to 5 Hz as the sensor service would
+static void test_wake_trace(void) {
+    const int ratio = 5;
+    int n = imu_trace_load(__FILE__, WAKE_CSV, samples, sizeof(samples) / sizeof(samples[0]));
+    TEST_ASSERT_GREATER_THAN(0, n);
+
+    for (int i = 0; i < n; i++) {
+        count(wrist_wake_feed(&detector, &samples[i]));
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(WAKE_RAISES, raises, "raises at 25 Hz");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(WAKE_TILTS, tilts, "tilts at 25 Hz");
+
+    wrist_wake_init(&detector);
+    raises = 0;
+    tilts = 0;
+    for (int i = 0; i + ratio <= n; i += ratio) {
+        imu_sample_t s = samples[i + ratio - 1];
+        s.ax = s.ay = s.az = 0;
+        for (int j = i; j < i + ratio; j++) {
+            s.ax += samples[j].ax / ratio;
+            s.ay += samples[j].ay / ratio;
+            s.az += samples[j].az / ratio;
+        }
+        count(wrist_wake_feed(&detector, &s));
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(WAKE_RAISES, raises, "raises at 5 Hz");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(WAKE_TILTS, tilts, "tilts at 5 Hz");
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_synthetic_traces_at_each_rate);
+    RUN_TEST(test_up_at_start_is_not_a_raise);
+    RUN_TEST(test_raise_and_tilt_by_time_away);
+    RUN_TEST(test_no_second_wake_within_refractory);
+    RUN_TEST(test_shaking_never_holds);
+    RUN_TEST(test_gap_is_not_a_gesture);
+    RUN_TEST(test_wake_trace);
+    return UNITY_END();
+}